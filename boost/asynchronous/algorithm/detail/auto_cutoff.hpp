@@ -0,0 +1,131 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNCHRONOUS_AUTO_CUTOFF_HPP
+#define BOOST_ASYNCHRONOUS_AUTO_CUTOFF_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// duration of a leaf task aimed at by auto_cutoff, in microseconds.
+// Long enough to make the task overhead negligible, short enough to keep all threads busy
+#ifndef BOOST_ASYNCHRONOUS_AUTO_CUTOFF_TARGET_US
+#define BOOST_ASYNCHRONOUS_AUTO_CUTOFF_TARGET_US 100
+#endif
+// cutoff used by auto_cutoff until the first leaf tasks have been measured,
+// and by algorithms which do not measure their leaf tasks
+#ifndef BOOST_ASYNCHRONOUS_AUTO_CUTOFF_INITIAL
+#define BOOST_ASYNCHRONOUS_AUTO_CUTOFF_INITIAL 8192
+#endif
+
+namespace boost { namespace asynchronous
+{
+// pass as cutoff to let parallel algorithms find the size of their leaf tasks themselves.
+// parallel_for, parallel_reduce, parallel_transform, parallel_sort and parallel_scan measure how long their leaf tasks take
+// and adapt the cutoff to reach BOOST_ASYNCHRONOUS_AUTO_CUTOFF_TARGET_US per task.
+// Other algorithms use BOOST_ASYNCHRONOUS_AUTO_CUTOFF_INITIAL.
+const long auto_cutoff = -1;
+
+namespace detail
+{
+// cutoff learnt by one algorithm. Tag is the task type doing the leaf work, so that each algorithm / functor / data type
+// combination learns its own cutoff, which is then reused by the next calls.
+template <class Tag>
+struct adaptive_cutoff
+{
+    static std::atomic<long>& value()
+    {
+        static std::atomic<long> cutoff(BOOST_ASYNCHRONOUS_AUTO_CUTOFF_INITIAL);
+        return cutoff;
+    }
+    // a leaf task processed elements in duration. Move the cutoff towards the one which would have reached the target,
+    // at most by a factor 2 per leaf task so that an outlier (task preempted, cold cache) does little harm
+    static void record(std::size_t elements, std::chrono::nanoseconds duration)
+    {
+        const double target = BOOST_ASYNCHRONOUS_AUTO_CUTOFF_TARGET_US * 1000.0;
+        double per_element = (duration.count() > 0 ? (double)duration.count() : 1.0) / (double)elements;
+        double wanted = target / per_element;
+        long current = value().load(std::memory_order_relaxed);
+        long next = (wanted > 2.0 * current) ? 2 * current
+                  : (wanted < current / 2.0) ? current / 2
+                  : (long)wanted;
+        if (next < 1)
+            next = 1;
+        if (next > (1L << 30))
+            next = (1L << 30);
+        // concurrent updates can get lost, which is fine, another leaf will report soon
+        value().store(next,std::memory_order_relaxed);
+    }
+};
+
+// cutoff to use: the given one, or the one learnt by this algorithm if auto_cutoff
+template <class Tag>
+long effective_cutoff(long cutoff)
+{
+    return (cutoff == boost::asynchronous::auto_cutoff) ? adaptive_cutoff<Tag>::value().load(std::memory_order_relaxed) : cutoff;
+}
+// used by algorithms not measuring their leaf tasks
+template <class Distance>
+Distance default_cutoff(Distance cutoff)
+{
+    return (cutoff == (Distance)boost::asynchronous::auto_cutoff) ? (Distance)BOOST_ASYNCHRONOUS_AUTO_CUTOFF_INITIAL : cutoff;
+}
+
+template <class Iterator>
+std::size_t leaf_size(Iterator beg, Iterator end, typename std::enable_if<!std::is_integral<Iterator>::value>::type* = 0)
+{
+    return (std::size_t)std::distance(beg,end);
+}
+template <class Iterator>
+std::size_t leaf_size(Iterator beg, Iterator end, typename std::enable_if<std::is_integral<Iterator>::value>::type* = 0)
+{
+    return (std::size_t)(end - beg);
+}
+
+// to be created just before a leaf task does its work, stop() to be called when the work is done, before setting the task result
+// (which can execute the continuation). Reports the duration of the leaf task if auto_cutoff, costs nothing otherwise.
+template <class Tag>
+struct cutoff_timer
+{
+    template <class Iterator>
+    cutoff_timer(long cutoff, Iterator beg, Iterator end)
+        : m_elements(cutoff == boost::asynchronous::auto_cutoff ? boost::asynchronous::detail::leaf_size(beg,end) : 0)
+    {
+        if (m_elements != 0)
+            m_start = std::chrono::steady_clock::now();
+    }
+    cutoff_timer(long cutoff, std::size_t elements)
+        : m_elements(cutoff == boost::asynchronous::auto_cutoff ? elements : 0)
+    {
+        if (m_elements != 0)
+            m_start = std::chrono::steady_clock::now();
+    }
+    cutoff_timer(cutoff_timer const&) = delete;
+    cutoff_timer& operator=(cutoff_timer const&) = delete;
+    void stop()
+    {
+        if (m_elements != 0)
+        {
+            boost::asynchronous::detail::adaptive_cutoff<Tag>::record(
+                        m_elements,
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start));
+            m_elements = 0;
+        }
+    }
+private:
+    std::size_t m_elements;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+}
+}}
+#endif // BOOST_ASYNCHRONOUS_AUTO_CUTOFF_HPP
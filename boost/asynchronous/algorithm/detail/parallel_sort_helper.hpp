@@ -10,6 +10,11 @@
 #define BOOST_ASYNCHRONOUS_PARALLEL_SORT_HELPER_HPP
 
 #include <algorithm>
+#include <string>
+#include <tuple>
+
+#include <boost/asynchronous/detail/continuation_impl.hpp>
+#include <boost/asynchronous/continuation_task.hpp>
 #ifdef BOOST_ASYNCHRONOUS_USE_BOOST_SPREADSORT
 #include <boost/sort/spreadsort/spreadsort.hpp>
 #endif
@@ -83,6 +88,69 @@ struct std_stable_sort
 // version for moved ranges => will return the range as continuation
 namespace detail
 {
+// calls func(i) for i in [beg,end), each in its own task. Used by sorts working in several phases over chunks or buckets
+template <class Func, class Job>
+struct parallel_sort_for_index_helper: public boost::asynchronous::continuation_task<void>
+{
+    parallel_sort_for_index_helper(std::size_t beg, std::size_t end,Func func,const std::string& task_name, std::size_t prio)
+        : boost::asynchronous::continuation_task<void>(task_name)
+        , beg_(beg),end_(end),func_(std::move(func)),prio_(prio)
+    {
+    }
+    void operator()()
+    {
+        boost::asynchronous::continuation_result<void> task_res = this_task_result();
+        try
+        {
+            if (end_ - beg_ <= 1)
+            {
+                if (end_ != beg_)
+                    func_(beg_);
+                task_res.set_value();
+            }
+            else
+            {
+                std::size_t middle = beg_ + (end_ - beg_)/2;
+                boost::asynchronous::create_callback_continuation_job<Job>(
+                            // called when subtasks are done, set our result
+                            [task_res](std::tuple<boost::asynchronous::expected<void>,boost::asynchronous::expected<void> > res) mutable
+                            {
+                                try
+                                {
+                                    // get to check that no exception
+                                    std::get<0>(res).get();
+                                    std::get<1>(res).get();
+                                    task_res.set_value();
+                                }
+                                catch(...)
+                                {
+                                    task_res.set_exception(std::current_exception());
+                                }
+                            },
+                            // recursive tasks
+                            boost::asynchronous::detail::parallel_sort_for_index_helper<Func,Job>(beg_,middle,func_,this->get_name(),prio_),
+                            boost::asynchronous::detail::parallel_sort_for_index_helper<Func,Job>(middle,end_,func_,this->get_name(),prio_)
+                );
+            }
+        }
+        catch(...)
+        {
+            task_res.set_exception(std::current_exception());
+        }
+    }
+    std::size_t beg_;
+    std::size_t end_;
+    Func func_;
+    std::size_t prio_;
+};
+template <class Job, class Func>
+boost::asynchronous::detail::callback_continuation<void,Job>
+parallel_sort_for_index(std::size_t count,Func func,const std::string& task_name, std::size_t prio)
+{
+    return boost::asynchronous::top_level_callback_continuation_job<void,Job>
+            (boost::asynchronous::detail::parallel_sort_for_index_helper<Func,Job>(0,count,std::move(func),task_name,prio));
+}
+
 template <class Continuation, class Range1>
 struct parallel_sort_range_move_helper : public boost::asynchronous::continuation_task<Range1>
 {
@@ -13,6 +13,8 @@
 #include <iterator>
 #include <type_traits>
 
+#include <boost/asynchronous/algorithm/detail/auto_cutoff.hpp>
+
 namespace boost { namespace asynchronous
 {
 namespace detail
@@ -63,12 +65,14 @@ Iterator find_cutoff_helper(Iterator it, Distance n, Iterator end,std::input_ite
 template <class Iterator, class Distance>
 Iterator find_cutoff(Iterator it, Distance n, Iterator end, typename std::enable_if<!std::is_integral<Iterator>::value>::type* = 0)
 {
+    n = boost::asynchronous::detail::default_cutoff(n);
     return find_cutoff_helper(it,n,end,typename std::iterator_traits<Iterator>::iterator_category());
 }
 
 template <class Iterator, class Distance>
 Iterator find_cutoff(Iterator it, Distance n, Iterator end, typename std::enable_if<std::is_integral<Iterator>::value>::type* = 0)
 {
+    n = boost::asynchronous::detail::default_cutoff(n);
     // handle cutoff 1
     if (n == 1)
         n=2;
@@ -104,6 +108,7 @@ std::pair<It,It> find_cutoff_and_prev_helper(It it, Distance n, It end,std::inpu
 template <class It, class Distance>
 std::pair<It,It> find_cutoff_and_prev(It it, Distance n, It end)
 {
+    n = boost::asynchronous::detail::default_cutoff(n);
     return find_cutoff_and_prev_helper(it,n,end,typename std::iterator_traits<It>::iterator_category());
 }
 
@@ -0,0 +1,862 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNCHRONOUS_ALGORITHM_DETAIL_SIMD_KERNELS_HPP
+#define BOOST_ASYNCHRONOUS_ALGORITHM_DETAIL_SIMD_KERNELS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/asynchronous/algorithm/value_predicates.hpp>
+
+// The leaf loops of parallel_count(_if), parallel_find_all, parallel_equal, parallel_mismatch, parallel_extremum,
+// parallel_all_of/any_of/none_of, parallel_inner_product and parallel_kmp use SSE2, AVX2 or AVX-512 kernels, chosen at
+// runtime, when they work on pointers, std::vector or std::string iterators to arithmetic types with a known predicate.
+// Define BOOST_ASYNCHRONOUS_NO_SIMD to always use the element by element loops.
+#if !defined(BOOST_ASYNCHRONOUS_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) && \
+    ((defined(__clang__) && __clang_major__ >= 10) || (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 6))
+#define BOOST_ASYNCHRONOUS_HAS_SIMD_KERNELS
+#endif
+
+namespace boost { namespace asynchronous
+{
+namespace detail
+{
+// parallel_extremum's reduction function
+template <typename Comparison, typename T>
+struct selector2;
+
+namespace simd
+{
+enum class level
+{
+    none,
+    sse2,
+    avx2,
+    avx512
+};
+
+#ifdef BOOST_ASYNCHRONOUS_HAS_SIMD_KERNELS
+inline boost::asynchronous::detail::simd::level detect_level()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+        return boost::asynchronous::detail::simd::level::avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return boost::asynchronous::detail::simd::level::avx2;
+    if (__builtin_cpu_supports("sse2"))
+        return boost::asynchronous::detail::simd::level::sse2;
+    return boost::asynchronous::detail::simd::level::none;
+}
+#else
+inline boost::asynchronous::detail::simd::level detect_level()
+{
+    return boost::asynchronous::detail::simd::level::none;
+}
+#endif
+// the best instruction set of this cpu
+inline boost::asynchronous::detail::simd::level detected_level()
+{
+    static const boost::asynchronous::detail::simd::level l = boost::asynchronous::detail::simd::detect_level();
+    return l;
+}
+// the instruction set used by the kernels. Can be lowered, for example to compare them
+inline std::atomic<boost::asynchronous::detail::simd::level>& active_level()
+{
+    static std::atomic<boost::asynchronous::detail::simd::level> l(boost::asynchronous::detail::simd::detected_level());
+    return l;
+}
+
+// element types supported by the kernels
+template <class T>
+struct is_simd_type : std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T,bool>::value &&
+                                                   (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)>
+{};
+
+// std::string iterators, only std::basic_string<char> is instantiated
+template <class Iterator, class T>
+struct is_string_iterator : std::false_type
+{};
+template <class Iterator>
+struct is_string_iterator<Iterator,char>
+    : std::integral_constant<bool, std::is_same<Iterator,std::string::iterator>::value || std::is_same<Iterator,std::string::const_iterator>::value>
+{};
+
+// iterators on contiguous elements of a supported type
+template <class Iterator, class Enable=void>
+struct is_simd_iterator : std::false_type
+{};
+template <class Iterator>
+struct is_simd_iterator<Iterator,
+                        typename std::enable_if<boost::asynchronous::detail::simd::is_simd_type<
+                            typename std::remove_cv<typename std::iterator_traits<Iterator>::value_type>::type>::value>::type>
+    : std::integral_constant<bool,
+        std::is_pointer<Iterator>::value ||
+        std::is_same<Iterator,typename std::vector<typename std::remove_cv<typename std::iterator_traits<Iterator>::value_type>::type>::iterator>::value ||
+        std::is_same<Iterator,typename std::vector<typename std::remove_cv<typename std::iterator_traits<Iterator>::value_type>::type>::const_iterator>::value ||
+        boost::asynchronous::detail::simd::is_string_iterator<Iterator,typename std::remove_cv<typename std::iterator_traits<Iterator>::value_type>::type>::value>
+{};
+
+template <class Iterator>
+using simd_value_t = typename std::remove_cv<typename std::iterator_traits<Iterator>::value_type>::type;
+
+// only for dereferenceable iterators
+template <class Iterator>
+boost::asynchronous::detail::simd::simd_value_t<Iterator> const* address(Iterator it)
+{
+    return &*it;
+}
+
+enum class compare
+{
+    equal,
+    less,
+    greater
+};
+template <boost::asynchronous::detail::simd::compare Kind>
+struct compare_with;
+template <>
+struct compare_with<boost::asynchronous::detail::simd::compare::equal>
+{
+    // for scalars and vectors, the result is an out parameter as returning a vector would depend on the instruction set
+    template <class V, class M>
+    static void apply(V const& v, V const& x, M& m)
+    {
+        m = (v == x);
+    }
+};
+template <>
+struct compare_with<boost::asynchronous::detail::simd::compare::less>
+{
+    template <class V, class M>
+    static void apply(V const& v, V const& x, M& m)
+    {
+        m = (v < x);
+    }
+};
+template <>
+struct compare_with<boost::asynchronous::detail::simd::compare::greater>
+{
+    template <class V, class M>
+    static void apply(V const& v, V const& x, M& m)
+    {
+        m = (v > x);
+    }
+};
+
+// recognized unary predicates
+template <class Pred>
+struct value_predicate : std::false_type
+{};
+template <class T>
+struct value_predicate<boost::asynchronous::equal_to_value<T>> : std::true_type
+{
+    typedef T value_type;
+    static const boost::asynchronous::detail::simd::compare kind = boost::asynchronous::detail::simd::compare::equal;
+};
+template <class T>
+struct value_predicate<boost::asynchronous::less_than_value<T>> : std::true_type
+{
+    typedef T value_type;
+    static const boost::asynchronous::detail::simd::compare kind = boost::asynchronous::detail::simd::compare::less;
+};
+template <class T>
+struct value_predicate<boost::asynchronous::greater_than_value<T>> : std::true_type
+{
+    typedef T value_type;
+    static const boost::asynchronous::detail::simd::compare kind = boost::asynchronous::detail::simd::compare::greater;
+};
+template <class Iterator, class Pred, class Enable=void>
+struct use_value_kernel : std::false_type
+{};
+template <class Iterator, class Pred>
+struct use_value_kernel<Iterator,Pred,
+                        typename std::enable_if<boost::asynchronous::detail::simd::is_simd_iterator<Iterator>::value &&
+                                                boost::asynchronous::detail::simd::value_predicate<Pred>::value>::type>
+    : std::is_same<typename boost::asynchronous::detail::simd::value_predicate<Pred>::value_type,
+                   boost::asynchronous::detail::simd::simd_value_t<Iterator>>
+{};
+
+// recognized binary predicates
+template <class Pred, class T>
+struct is_equal_to : std::integral_constant<bool, std::is_same<Pred,std::equal_to<T>>::value || std::is_same<Pred,std::equal_to<>>::value>
+{};
+template <class Pred, class T>
+struct is_less : std::integral_constant<bool, std::is_same<Pred,std::less<T>>::value || std::is_same<Pred,std::less<>>::value>
+{};
+template <class Pred, class T>
+struct is_greater : std::integral_constant<bool, std::is_same<Pred,std::greater<T>>::value || std::is_same<Pred,std::greater<>>::value>
+{};
+template <class Pred, class T>
+struct is_plus : std::integral_constant<bool, std::is_same<Pred,std::plus<T>>::value || std::is_same<Pred,std::plus<>>::value>
+{};
+template <class Pred, class T>
+struct is_multiplies : std::integral_constant<bool, std::is_same<Pred,std::multiplies<T>>::value || std::is_same<Pred,std::multiplies<>>::value>
+{};
+template <class Iterator1, class Iterator2, class Pred, class Enable=void>
+struct use_equal_kernel : std::false_type
+{};
+template <class Iterator1, class Iterator2, class Pred>
+struct use_equal_kernel<Iterator1,Iterator2,Pred,
+                        typename std::enable_if<boost::asynchronous::detail::simd::is_simd_iterator<Iterator1>::value &&
+                                                boost::asynchronous::detail::simd::is_simd_iterator<Iterator2>::value>::type>
+    : std::integral_constant<bool,
+        std::is_same<boost::asynchronous::detail::simd::simd_value_t<Iterator1>,boost::asynchronous::detail::simd::simd_value_t<Iterator2>>::value &&
+        boost::asynchronous::detail::simd::is_equal_to<Pred,boost::asynchronous::detail::simd::simd_value_t<Iterator1>>::value>
+{};
+
+// substring search, elements are compared with memcmp
+template <class HaystackIterator, class NeedleIterator, class Enable=void>
+struct use_search_kernel : std::false_type
+{};
+template <class HaystackIterator, class NeedleIterator>
+struct use_search_kernel<HaystackIterator,NeedleIterator,
+                         typename std::enable_if<boost::asynchronous::detail::simd::is_simd_iterator<HaystackIterator>::value &&
+                                                 boost::asynchronous::detail::simd::is_simd_iterator<NeedleIterator>::value>::type>
+    : std::integral_constant<bool,
+        std::is_same<boost::asynchronous::detail::simd::simd_value_t<HaystackIterator>,boost::asynchronous::detail::simd::simd_value_t<NeedleIterator>>::value &&
+        std::is_integral<boost::asynchronous::detail::simd::simd_value_t<HaystackIterator>>::value>
+{};
+
+#ifdef BOOST_ASYNCHRONOUS_HAS_SIMD_KERNELS
+
+#define BOOST_ASYNCHRONOUS_SIMD_INLINE inline __attribute__((always_inline))
+
+template <class T, std::size_t Bytes>
+struct vector_of
+{
+    typedef T type __attribute__((vector_size(Bytes)));
+};
+
+template <std::size_t Bytes, class V, class T>
+BOOST_ASYNCHRONOUS_SIMD_INLINE void load(V& v, T const* p)
+{
+    std::memcpy(&v,p,Bytes);
+}
+template <std::size_t Bytes, class M>
+BOOST_ASYNCHRONOUS_SIMD_INLINE bool any_lane(M const& m)
+{
+    typename boost::asynchronous::detail::simd::vector_of<std::uint64_t,Bytes>::type u;
+    std::memcpy(&u,&m,Bytes);
+    std::uint64_t res = 0;
+    for (std::size_t i = 0; i < Bytes / 8; ++i)
+    {
+        res |= u[i];
+    }
+    return res != 0;
+}
+
+// The kernels are written with the vector extensions of gcc and clang and get the instruction set
+// of the function they are inlined in: run_sse2, run_avx2 or run_avx512.
+
+// number of elements for which compare(element,value) is true
+template <boost::asynchronous::detail::simd::compare Kind>
+struct count_kernel
+{
+    template <std::size_t Bytes, class T>
+    BOOST_ASYNCHRONOUS_SIMD_INLINE std::size_t run(T const* p, std::size_t n, T value)const
+    {
+        typedef typename boost::asynchronous::detail::simd::vector_of<T,Bytes>::type V;
+        typedef decltype(V() == V()) M;
+        typedef boost::asynchronous::detail::simd::compare_with<Kind> cmp;
+        std::size_t const lanes = Bytes / sizeof(T);
+        // true is -1 in a lane, small lanes are added to the result before they overflow
+        std::size_t const max_block = sizeof(T) == 1 ? 127 : (sizeof(T) == 2 ? 32767 : (std::size_t(1) << 30));
+        V const x = V() + value;
+        std::size_t res = 0;
+        std::size_t i = 0;
+        while (n - i >= lanes)
+        {
+            std::size_t const block_end = i + std::min((n - i) / lanes,max_block) * lanes;
+            M acc = M();
+            for (; i < block_end; i += lanes)
+            {
+                V v;
+                boost::asynchronous::detail::simd::load<Bytes>(v,p + i);
+                M m;
+                cmp::apply(v,x,m);
+                acc -= m;
+            }
+            for (std::size_t j = 0; j < lanes; ++j)
+            {
+                res += static_cast<std::size_t>(acc[j]);
+            }
+        }
+        for (; i < n; ++i)
+        {
+            bool b;
+            cmp::apply(p[i],value,b);
+            if (b)
+                ++res;
+        }
+        return res;
+    }
+};
+
+// index of the first element for which compare(element,value) == expected, n if none
+template <boost::asynchronous::detail::simd::compare Kind>
+struct find_kernel
+{
+    template <std::size_t Bytes, class T>
+    BOOST_ASYNCHRONOUS_SIMD_INLINE std::size_t run(T const* p, std::size_t n, T value, bool expected)const
+    {
+        typedef typename boost::asynchronous::detail::simd::vector_of<T,Bytes>::type V;
+        typedef decltype(V() == V()) M;
+        typedef boost::asynchronous::detail::simd::compare_with<Kind> cmp;
+        std::size_t const lanes = Bytes / sizeof(T);
+        V const x = V() + value;
+        std::size_t i = 0;
+        for (; i + lanes <= n; i += lanes)
+        {
+            V v;
+            boost::asynchronous::detail::simd::load<Bytes>(v,p + i);
+            M m;
+            cmp::apply(v,x,m);
+            if (!expected)
+                m = ~m;
+            if (boost::asynchronous::detail::simd::any_lane<Bytes>(m))
+            {
+                for (std::size_t j = 0; j < lanes; ++j)
+                {
+                    if (m[j])
+                        return i + j;
+                }
+            }
+        }
+        for (; i < n; ++i)
+        {
+            bool b;
+            cmp::apply(p[i],value,b);
+            if (b == expected)
+                return i;
+        }
+        return n;
+    }
+};
+
+// copies the elements for which compare(element,value) is true
+template <boost::asynchronous::detail::simd::compare Kind>
+struct copy_if_kernel
+{
+    template <std::size_t Bytes, class T, class OutputIterator>
+    BOOST_ASYNCHRONOUS_SIMD_INLINE OutputIterator run(T const* p, std::size_t n, T value, OutputIterator out)const
+    {
+        typedef typename boost::asynchronous::detail::simd::vector_of<T,Bytes>::type V;
+        typedef decltype(V() == V()) M;
+        typedef boost::asynchronous::detail::simd::compare_with<Kind> cmp;
+        std::size_t const lanes = Bytes / sizeof(T);
+        V const x = V() + value;
+        std::size_t i = 0;
+        for (; i + lanes <= n; i += lanes)
+        {
+            V v;
+            boost::asynchronous::detail::simd::load<Bytes>(v,p + i);
+            M m;
+            cmp::apply(v,x,m);
+            if (boost::asynchronous::detail::simd::any_lane<Bytes>(m))
+            {
+                for (std::size_t j = 0; j < lanes; ++j)
+                {
+                    if (m[j])
+                        *out++ = p[i + j];
+                }
+            }
+        }
+        for (; i < n; ++i)
+        {
+            bool b;
+            cmp::apply(p[i],value,b);
+            if (b)
+                *out++ = p[i];
+        }
+        return out;
+    }
+};
+
+// index of the first position where the ranges differ, n if none
+struct mismatch_kernel
+{
+    template <std::size_t Bytes, class T>
+    BOOST_ASYNCHRONOUS_SIMD_INLINE std::size_t run(T const* p1, T const* p2, std::size_t n)const
+    {
+        typedef typename boost::asynchronous::detail::simd::vector_of<T,Bytes>::type V;
+        typedef decltype(V() == V()) M;
+        std::size_t const lanes = Bytes / sizeof(T);
+        std::size_t i = 0;
+        for (; i + lanes <= n; i += lanes)
+        {
+            V v1;
+            V v2;
+            boost::asynchronous::detail::simd::load<Bytes>(v1,p1 + i);
+            boost::asynchronous::detail::simd::load<Bytes>(v2,p2 + i);
+            M m = ~(v1 == v2);
+            if (boost::asynchronous::detail::simd::any_lane<Bytes>(m))
+            {
+                for (std::size_t j = 0; j < lanes; ++j)
+                {
+                    if (m[j])
+                        return i + j;
+                }
+            }
+        }
+        for (; i < n; ++i)
+        {
+            if (!(p1[i] == p2[i]))
+                return i;
+        }
+        return n;
+    }
+};
+
+// same result as the sequential reduction t = compare(t,x) ? t : x. Returns false if a NaN was found,
+// the sequential reduction must then be used as the result depends on the position of the NaN.
+template <bool Greater>
+struct extremum_kernel
+{
+    template <std::size_t Bytes, class T>
+    BOOST_ASYNCHRONOUS_SIMD_INLINE bool run(T const* p, std::size_t n, T* res)const
+    {
+        typedef typename boost::asynchronous::detail::simd::vector_of<T,Bytes>::type V;
+        typedef decltype(V() == V()) M;
+        typedef boost::asynchronous::detail::simd::compare_with<Greater ? boost::asynchronous::detail::simd::compare::greater
+                                                                        : boost::asynchronous::detail::simd::compare::less> cmp;
+        std::size_t const lanes = Bytes / sizeof(T);
+        T t = p[0];
+        std::size_t i = 1;
+        if (n >= lanes)
+        {
+            V acc;
+            boost::asynchronous::detail::simd::load<Bytes>(acc,p);
+            M nan = (acc != acc);
+            for (i = lanes; i + lanes <= n; i += lanes)
+            {
+                V v;
+                boost::asynchronous::detail::simd::load<Bytes>(v,p + i);
+                nan |= (v != v);
+                M keep;
+                cmp::apply(acc,v,keep);
+                acc = keep ? acc : v;
+            }
+            if (std::is_floating_point<T>::value && boost::asynchronous::detail::simd::any_lane<Bytes>(nan))
+                return false;
+            t = acc[0];
+            for (std::size_t j = 1; j < lanes; ++j)
+            {
+                bool keep;
+                cmp::apply(t,static_cast<T>(acc[j]),keep);
+                t = keep ? t : static_cast<T>(acc[j]);
+            }
+        }
+        for (; i < n; ++i)
+        {
+            if (p[i] != p[i])
+                return false;
+            bool keep;
+            cmp::apply(t,p[i],keep);
+            t = keep ? t : p[i];
+        }
+        *res = t;
+        return true;
+    }
+};
+
+// sum of the products
+struct dot_kernel
+{
+    template <std::size_t Bytes, class T>
+    BOOST_ASYNCHRONOUS_SIMD_INLINE T run(T const* p1, T const* p2, std::size_t n)const
+    {
+        typedef typename boost::asynchronous::detail::simd::vector_of<T,Bytes>::type V;
+        std::size_t const lanes = Bytes / sizeof(T);
+        // two accumulators hide the latency of the additions
+        V acc1 = V();
+        V acc2 = V();
+        std::size_t i = 0;
+        for (; i + 2 * lanes <= n; i += 2 * lanes)
+        {
+            V a1;
+            V b1;
+            V a2;
+            V b2;
+            boost::asynchronous::detail::simd::load<Bytes>(a1,p1 + i);
+            boost::asynchronous::detail::simd::load<Bytes>(b1,p2 + i);
+            boost::asynchronous::detail::simd::load<Bytes>(a2,p1 + i + lanes);
+            boost::asynchronous::detail::simd::load<Bytes>(b2,p2 + i + lanes);
+            acc1 += a1 * b1;
+            acc2 += a2 * b2;
+        }
+        acc1 += acc2;
+        T res = T();
+        for (std::size_t j = 0; j < lanes; ++j)
+        {
+            res = static_cast<T>(res + acc1[j]);
+        }
+        for (; i < n; ++i)
+        {
+            res = static_cast<T>(res + static_cast<T>(p1[i] * p2[i]));
+        }
+        return res;
+    }
+};
+
+// Calls (*f)(i) in increasing order for each position i where the needle (m >= 1 elements) starts.
+// Only the positions where the first and last elements of the needle match are compared. As this is quadratic
+// for some inputs, the kernel gives up if the failed comparisons cost too much and returns the first position
+// it did not look at, n if it looked at all of them.
+struct substring_kernel
+{
+    template <std::size_t Bytes, class T, class F>
+    BOOST_ASYNCHRONOUS_SIMD_INLINE std::size_t run(T const* h, std::size_t n, T const* needle, std::size_t m, F* f)const
+    {
+        typedef typename boost::asynchronous::detail::simd::vector_of<T,Bytes>::type V;
+        typedef decltype(V() == V()) M;
+        std::size_t const lanes = Bytes / sizeof(T);
+        std::size_t const positions = n - m + 1;
+        std::size_t const middle = m > 2 ? (m - 2) * sizeof(T) : 0;
+        V const first = V() + needle[0];
+        V const last = V() + needle[m - 1];
+        std::uint64_t const lane_mask = sizeof(T) == 8 ? ~std::uint64_t(0) : ((std::uint64_t(1) << (8 * (sizeof(T) % 8))) - 1);
+        // elements compared without finding a match
+        std::size_t wasted = 0;
+        std::size_t i = 0;
+        for (; i + lanes <= positions; i += lanes)
+        {
+            if (wasted > 4 * i + 4096)
+                return i;
+            V vf;
+            V vl;
+            boost::asynchronous::detail::simd::load<Bytes>(vf,h + i);
+            boost::asynchronous::detail::simd::load<Bytes>(vl,h + i + m - 1);
+            // a single comparison, gcc does not vectorize a & of two comparisons of bytes with avx512
+            M c = (((vf ^ first) | (vl ^ last)) == V());
+            // only the set lanes are visited, in increasing order
+            typename boost::asynchronous::detail::simd::vector_of<std::uint64_t,Bytes>::type words;
+            std::memcpy(&words,&c,Bytes);
+            for (std::size_t w = 0; w < Bytes / 8; ++w)
+            {
+                std::uint64_t bits = words[w];
+                while (bits != 0)
+                {
+                    std::size_t const lane_in_word = static_cast<std::size_t>(__builtin_ctzll(bits)) / (8 * sizeof(T));
+                    bits &= ~(lane_mask << (lane_in_word * 8 * sizeof(T)));
+                    std::size_t const j = i + w * (8 / sizeof(T)) + lane_in_word;
+                    if (std::memcmp(h + j + 1,needle + 1,middle) == 0)
+                        (*f)(j);
+                    else
+                        wasted += m;
+                }
+            }
+        }
+        for (; i < positions; ++i)
+        {
+            if (h[i] == needle[0] && h[i + m - 1] == needle[m - 1] && std::memcmp(h + i + 1,needle + 1,middle) == 0)
+                (*f)(i);
+        }
+        return n;
+    }
+};
+
+template <class Kernel, class... Args>
+__attribute__((target("sse2")))
+auto run_sse2(Kernel const& k, Args... args) -> decltype(k.template run<16>(args...))
+{
+    return k.template run<16>(args...);
+}
+template <class Kernel, class... Args>
+__attribute__((target("avx2")))
+auto run_avx2(Kernel const& k, Args... args) -> decltype(k.template run<32>(args...))
+{
+    return k.template run<32>(args...);
+}
+template <class Kernel, class... Args>
+__attribute__((target("avx512f,avx512bw")))
+auto run_avx512(Kernel const& k, Args... args) -> decltype(k.template run<64>(args...))
+{
+    return k.template run<64>(args...);
+}
+// call only if active_level() is not none
+template <class Kernel, class... Args>
+auto run(Kernel const& k, Args... args) -> decltype(k.template run<16>(args...))
+{
+    switch (boost::asynchronous::detail::simd::active_level().load(std::memory_order_relaxed))
+    {
+    case boost::asynchronous::detail::simd::level::avx512:
+        return boost::asynchronous::detail::simd::run_avx512(k,args...);
+    case boost::asynchronous::detail::simd::level::avx2:
+        return boost::asynchronous::detail::simd::run_avx2(k,args...);
+    default:
+        return boost::asynchronous::detail::simd::run_sse2(k,args...);
+    }
+}
+
+inline bool enabled()
+{
+    return boost::asynchronous::detail::simd::active_level().load(std::memory_order_relaxed) != boost::asynchronous::detail::simd::level::none;
+}
+
+template <class Iterator, class Pred>
+bool count_if(Iterator beg, Iterator end, Pred const& pred, long& res, std::true_type)
+{
+    if (!boost::asynchronous::detail::simd::enabled())
+        return false;
+    std::size_t const n = static_cast<std::size_t>(std::distance(beg,end));
+    if (n != 0)
+    {
+        res = static_cast<long>(boost::asynchronous::detail::simd::run(
+                    boost::asynchronous::detail::simd::count_kernel<boost::asynchronous::detail::simd::value_predicate<Pred>::kind>(),
+                    boost::asynchronous::detail::simd::address(beg),n,pred.value_));
+    }
+    else
+    {
+        res = 0;
+    }
+    return true;
+}
+template <class Iterator, class Pred>
+bool find_if(Iterator beg, Iterator end, Pred const& pred, bool expected, Iterator& res, std::true_type)
+{
+    if (!boost::asynchronous::detail::simd::enabled())
+        return false;
+    std::size_t const n = static_cast<std::size_t>(std::distance(beg,end));
+    res = beg;
+    if (n != 0)
+    {
+        std::advance(res,boost::asynchronous::detail::simd::run(
+                    boost::asynchronous::detail::simd::find_kernel<boost::asynchronous::detail::simd::value_predicate<Pred>::kind>(),
+                    boost::asynchronous::detail::simd::address(beg),n,pred.value_,expected));
+    }
+    return true;
+}
+template <class Iterator, class Pred, class OutputIterator>
+bool copy_if(Iterator beg, Iterator end, Pred const& pred, OutputIterator out, std::true_type)
+{
+    if (!boost::asynchronous::detail::simd::enabled())
+        return false;
+    std::size_t const n = static_cast<std::size_t>(std::distance(beg,end));
+    if (n != 0)
+    {
+        boost::asynchronous::detail::simd::run(
+                    boost::asynchronous::detail::simd::copy_if_kernel<boost::asynchronous::detail::simd::value_predicate<Pred>::kind>(),
+                    boost::asynchronous::detail::simd::address(beg),n,pred.value_,out);
+    }
+    return true;
+}
+template <class Iterator1, class Iterator2>
+bool mismatch(Iterator1 beg1, Iterator1 end1, Iterator2 beg2, std::pair<Iterator1,Iterator2>& res, std::true_type)
+{
+    if (!boost::asynchronous::detail::simd::enabled())
+        return false;
+    std::size_t const n = static_cast<std::size_t>(std::distance(beg1,end1));
+    std::size_t index = 0;
+    if (n != 0)
+    {
+        index = boost::asynchronous::detail::simd::run(boost::asynchronous::detail::simd::mismatch_kernel(),
+                                                       boost::asynchronous::detail::simd::address(beg1),
+                                                       boost::asynchronous::detail::simd::address(beg2),n);
+    }
+    std::advance(beg1,index);
+    std::advance(beg2,index);
+    res = std::make_pair(beg1,beg2);
+    return true;
+}
+template <bool Greater, class Iterator, class T>
+bool extremum(Iterator beg, Iterator end, T& res)
+{
+    if (!boost::asynchronous::detail::simd::enabled() || beg == end)
+        return false;
+    return boost::asynchronous::detail::simd::run(boost::asynchronous::detail::simd::extremum_kernel<Greater>(),
+                                                  boost::asynchronous::detail::simd::address(beg),
+                                                  static_cast<std::size_t>(std::distance(beg,end)),&res);
+}
+template <class Iterator1, class Iterator2, class T>
+bool inner_product(Iterator1 beg1, Iterator1 end1, Iterator2 beg2, T& res, std::true_type)
+{
+    if (!boost::asynchronous::detail::simd::enabled() || beg1 == end1)
+        return false;
+    res = boost::asynchronous::detail::simd::run(boost::asynchronous::detail::simd::dot_kernel(),
+                                                 boost::asynchronous::detail::simd::address(beg1),
+                                                 boost::asynchronous::detail::simd::address(beg2),
+                                                 static_cast<std::size_t>(std::distance(beg1,end1)));
+    return true;
+}
+template <class HaystackIterator, class NeedleIterator, class F>
+bool search(HaystackIterator hbeg, HaystackIterator hend, NeedleIterator nbeg, NeedleIterator nend, F& f, std::size_t& done, std::true_type)
+{
+    std::size_t const m = static_cast<std::size_t>(std::distance(nbeg,nend));
+    if (!boost::asynchronous::detail::simd::enabled() || m == 0)
+        return false;
+    std::size_t const n = static_cast<std::size_t>(std::distance(hbeg,hend));
+    done = n;
+    if (n >= m)
+    {
+        done = boost::asynchronous::detail::simd::run(boost::asynchronous::detail::simd::substring_kernel(),
+                                                      boost::asynchronous::detail::simd::address(hbeg),n,
+                                                      boost::asynchronous::detail::simd::address(nbeg),m,&f);
+    }
+    return true;
+}
+#else
+inline bool enabled()
+{
+    return false;
+}
+template <class Iterator, class Pred>
+bool count_if(Iterator, Iterator, Pred const&, long&, std::true_type)
+{
+    return false;
+}
+template <class Iterator, class Pred>
+bool find_if(Iterator, Iterator, Pred const&, bool, Iterator&, std::true_type)
+{
+    return false;
+}
+template <class Iterator, class Pred, class OutputIterator>
+bool copy_if(Iterator, Iterator, Pred const&, OutputIterator, std::true_type)
+{
+    return false;
+}
+template <class Iterator1, class Iterator2>
+bool mismatch(Iterator1, Iterator1, Iterator2, std::pair<Iterator1,Iterator2>&, std::true_type)
+{
+    return false;
+}
+template <bool Greater, class Iterator, class T>
+bool extremum(Iterator, Iterator, T&)
+{
+    return false;
+}
+template <class Iterator1, class Iterator2, class T>
+bool inner_product(Iterator1, Iterator1, Iterator2, T&, std::true_type)
+{
+    return false;
+}
+template <class HaystackIterator, class NeedleIterator, class F>
+bool search(HaystackIterator, HaystackIterator, NeedleIterator, NeedleIterator, F&, std::size_t&, std::true_type)
+{
+    return false;
+}
+#endif
+
+// the entry points of the algorithms. They return false if no kernel applies, the caller then uses its own loop.
+template <class Iterator, class Pred>
+bool count_if(Iterator, Iterator, Pred const&, long&, std::false_type)
+{
+    return false;
+}
+template <class Iterator, class Pred>
+bool count_if(Iterator beg, Iterator end, Pred const& pred, long& res)
+{
+    return boost::asynchronous::detail::simd::count_if(beg,end,pred,res,
+                typename boost::asynchronous::detail::simd::use_value_kernel<Iterator,Pred>::type());
+}
+
+template <class Iterator, class Pred>
+bool find_if(Iterator, Iterator, Pred const&, bool, Iterator&, std::false_type)
+{
+    return false;
+}
+// first element for which pred(element) == expected
+template <class Iterator, class Pred>
+bool find_if(Iterator beg, Iterator end, Pred const& pred, bool expected, Iterator& res)
+{
+    return boost::asynchronous::detail::simd::find_if(beg,end,pred,expected,res,
+                typename boost::asynchronous::detail::simd::use_value_kernel<Iterator,Pred>::type());
+}
+
+template <class Iterator, class Pred, class OutputIterator>
+bool copy_if(Iterator, Iterator, Pred const&, OutputIterator, std::false_type)
+{
+    return false;
+}
+template <class Iterator, class Pred, class OutputIterator>
+bool copy_if(Iterator beg, Iterator end, Pred const& pred, OutputIterator out)
+{
+    return boost::asynchronous::detail::simd::copy_if(beg,end,pred,out,
+                typename boost::asynchronous::detail::simd::use_value_kernel<Iterator,Pred>::type());
+}
+
+template <class Iterator1, class Iterator2>
+bool mismatch(Iterator1, Iterator1, Iterator2, std::pair<Iterator1,Iterator2>&, std::false_type)
+{
+    return false;
+}
+template <class Iterator1, class Iterator2, class Pred>
+bool mismatch(Iterator1 beg1, Iterator1 end1, Iterator2 beg2, Pred const&, std::pair<Iterator1,Iterator2>& res)
+{
+    return boost::asynchronous::detail::simd::mismatch(beg1,end1,beg2,res,
+                typename boost::asynchronous::detail::simd::use_equal_kernel<Iterator1,Iterator2,Pred>::type());
+}
+template <class Iterator1, class Iterator2, class Pred>
+bool equal(Iterator1 beg1, Iterator1 end1, Iterator2 beg2, Pred const& pred, bool& res)
+{
+    std::pair<Iterator1,Iterator2> m;
+    if (!boost::asynchronous::detail::simd::mismatch(beg1,end1,beg2,pred,m))
+        return false;
+    res = (m.first == end1);
+    return true;
+}
+
+// parallel_extremum with std::less or std::greater
+template <class Iterator, class Func, class T>
+bool reduce(Iterator, Iterator, Func const&, T&)
+{
+    return false;
+}
+template <class Iterator, class Comparison, class T>
+typename std::enable_if<boost::asynchronous::detail::simd::is_simd_iterator<Iterator>::value &&
+                        std::is_same<T,boost::asynchronous::detail::simd::simd_value_t<Iterator>>::value &&
+                        (boost::asynchronous::detail::simd::is_less<Comparison,T>::value ||
+                         boost::asynchronous::detail::simd::is_greater<Comparison,T>::value),bool>::type
+reduce(Iterator beg, Iterator end, boost::asynchronous::detail::selector2<Comparison,T> const&, T& res)
+{
+    return boost::asynchronous::detail::simd::extremum<boost::asynchronous::detail::simd::is_greater<Comparison,T>::value>(beg,end,res);
+}
+
+template <class Iterator1, class Iterator2, class T>
+bool inner_product(Iterator1, Iterator1, Iterator2, T&, std::false_type)
+{
+    return false;
+}
+// parallel_inner_product with std::multiplies and std::plus, all of the same type
+template <class Iterator1, class Iterator2, class BinaryOperation, class Reduce, class T>
+bool inner_product(Iterator1 beg1, Iterator1 end1, Iterator2 beg2, BinaryOperation const&, Reduce const&, T& res)
+{
+    return boost::asynchronous::detail::simd::inner_product(beg1,end1,beg2,res,
+                std::integral_constant<bool,
+                    boost::asynchronous::detail::simd::use_equal_kernel<Iterator1,Iterator2,std::equal_to<>>::value &&
+                    std::is_same<T,boost::asynchronous::detail::simd::simd_value_t<Iterator1>>::value &&
+                    boost::asynchronous::detail::simd::is_multiplies<BinaryOperation,T>::value &&
+                    boost::asynchronous::detail::simd::is_plus<Reduce,T>::value>());
+}
+
+template <class HaystackIterator, class NeedleIterator, class F>
+bool search(HaystackIterator, HaystackIterator, NeedleIterator, NeedleIterator, F&, std::size_t&, std::false_type)
+{
+    return false;
+}
+// calls f(index) for the positions where [nbeg,nend) starts in [hbeg,hend), in increasing order,
+// up to done. The caller has to search the positions from done on.
+template <class HaystackIterator, class NeedleIterator, class F>
+bool search(HaystackIterator hbeg, HaystackIterator hend, NeedleIterator nbeg, NeedleIterator nend, F& f, std::size_t& done)
+{
+    return boost::asynchronous::detail::simd::search(hbeg,hend,nbeg,nend,f,done,
+                typename boost::asynchronous::detail::simd::use_search_kernel<HaystackIterator,NeedleIterator>::type());
+}
+
+}}}} // boost::asynchronous::detail::simd
+
+#endif // BOOST_ASYNCHRONOUS_ALGORITHM_DETAIL_SIMD_KERNELS_HPP
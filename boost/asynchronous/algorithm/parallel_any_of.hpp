@@ -28,6 +28,7 @@
 #include <boost/asynchronous/algorithm/detail/safe_advance.hpp>
 #include <boost/asynchronous/algorithm/detail/parallel_all_of_helper.hpp>
 #include <boost/asynchronous/detail/metafunctions.hpp>
+#include <boost/asynchronous/algorithm/detail/simd_kernels.hpp>
 
 #include <boost/range/begin.hpp>
 #include <boost/range/end.hpp>
@@ -44,6 +45,9 @@ struct any_of_operator
     template <class Iterator, class Func>
     bool algorithm(Iterator beg, Iterator end, Func& f)
     {
+        Iterator it;
+        if (boost::asynchronous::detail::simd::find_if(beg,end,f,true,it))
+            return it != end;
         return std::any_of(beg,end,f);
     }
     constexpr bool merge(bool b1, bool b2)const
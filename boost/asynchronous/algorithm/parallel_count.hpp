@@ -27,6 +27,7 @@
 #include <boost/asynchronous/scheduler/serializable_task.hpp>
 #include <boost/asynchronous/algorithm/detail/safe_advance.hpp>
 #include <boost/asynchronous/detail/metafunctions.hpp>
+#include <boost/asynchronous/algorithm/detail/simd_kernels.hpp>
 
 #include <boost/range/begin.hpp>
 #include <boost/range/end.hpp>
@@ -49,6 +50,8 @@ typename boost::range_difference<Range>::type count(Range const& r, Func fn) {
 template <class Range, class Func>
 long count(Range const& r, Func fn) {
     long c = 0;
+    if (boost::asynchronous::detail::simd::count_if(boost::begin(r), boost::end(r), fn, c))
+        return c;
     for (auto it = boost::begin(r); it != boost::end(r); ++it) {
         if (fn(*it))
             ++c;
@@ -139,10 +142,7 @@ parallel_count(Iterator beg, Iterator end,T const& value,long cutoff,
              const std::string& task_name="", std::size_t prio=0)
 #endif
 {
-    auto l = [value](const typename std::iterator_traits<Iterator>::value_type& i)
-    {
-        return i == value;
-    };
+    boost::asynchronous::equal_to_value<T> l(value);
     return boost::asynchronous::top_level_callback_continuation_job<long,Job>
             (boost::asynchronous::detail::parallel_count_helper<Iterator,decltype(l),Job>(beg,end,std::move(l),cutoff,task_name,prio));
 }
@@ -397,10 +397,7 @@ parallel_count(Range&& range,const T& value,long cutoff,
     auto r = std::make_shared<Range>(std::forward<Range>(range));
     auto beg = boost::begin(*r);
     auto end = boost::end(*r);
-    auto l = [value](decltype(*beg) i)
-    {
-        return i == value;
-    };
+    boost::asynchronous::equal_to_value<T> l(value);
     return boost::asynchronous::top_level_callback_continuation_job<long,Job>
             (boost::asynchronous::parallel_count_range_move_helper<Range,decltype(l),Job>(r,beg,end,std::move(l),cutoff,task_name,prio));
 }
@@ -528,10 +525,7 @@ parallel_count(Range range,T const& value,long cutoff,
                const std::string& task_name="", std::size_t prio=0)
 #endif
 {
-    auto l = [value](decltype(*boost::begin(std::declval<typename Range::return_type>())) i)
-    {
-        return i == value;
-    };
+    boost::asynchronous::equal_to_value<T> l(value);
     return boost::asynchronous::top_level_continuation_job<long,Job>
             (boost::asynchronous::detail::parallel_count_continuation_range_helper<Range,decltype(l),Job>
              (range,std::move(l),cutoff,task_name,prio));
@@ -27,11 +27,29 @@
 #include <boost/asynchronous/algorithm/detail/safe_advance.hpp>
 #include <boost/asynchronous/algorithm/detail/parallel_all_of_helper.hpp>
 #include <boost/asynchronous/detail/metafunctions.hpp>
+#include <boost/asynchronous/algorithm/detail/simd_kernels.hpp>
 
 namespace boost { namespace asynchronous
 {
 namespace detail
 {
+// sequential part, uses a SIMD kernel for contiguous arithmetic ranges and std::equal_to
+template <class Iterator1, class Iterator2, class Func>
+bool equal(Iterator1 beg1, Iterator1 end1, Iterator2 beg2, Func& func)
+{
+    bool res = false;
+    if (boost::asynchronous::detail::simd::equal(beg1,end1,beg2,func,res))
+        return res;
+    return std::equal(beg1,end1,beg2,func);
+}
+template <class Iterator1, class Iterator2>
+bool equal(Iterator1 beg1, Iterator1 end1, Iterator2 beg2)
+{
+    bool res = false;
+    if (boost::asynchronous::detail::simd::equal(beg1,end1,beg2,std::equal_to<>(),res))
+        return res;
+    return std::equal(beg1,end1,beg2);
+}
 // version for iterators
 template <class Iterator1, class Iterator2, class Func,class Job>
 struct parallel_equal_helper: public boost::asynchronous::continuation_task<bool>
@@ -52,7 +70,7 @@ struct parallel_equal_helper: public boost::asynchronous::continuation_task<bool
             // if not at end, recurse, otherwise execute here
             if (it == end1_)
             {
-                task_res.set_value(std::equal(beg1_,end1_,beg2_,func_));
+                task_res.set_value(boost::asynchronous::detail::equal(beg1_,end1_,beg2_,func_));
             }
             else
             {
@@ -110,7 +128,7 @@ struct parallel_equal_helper2: public boost::asynchronous::continuation_task<boo
             // if not at end, recurse, otherwise execute here
             if (it == end1_)
             {
-                task_res.set_value(std::equal(beg1_,end1_,beg2_));
+                task_res.set_value(boost::asynchronous::detail::equal(beg1_,end1_,beg2_));
             }
             else
             {
@@ -27,6 +27,7 @@
 #include <boost/asynchronous/scheduler/serializable_task.hpp>
 #include <boost/asynchronous/algorithm/detail/safe_advance.hpp>
 #include <boost/asynchronous/detail/metafunctions.hpp>
+#include <boost/asynchronous/algorithm/detail/simd_kernels.hpp>
 
 #include <boost/range/begin.hpp>
 #include <boost/range/end.hpp>
@@ -62,6 +63,26 @@ template <class Range, class Func>
 void find_all(Range& rng, Func fn) {
     boost::remove_erase_if(rng , boost::asynchronous::detail::not_<Func>(std::move(fn)));
 }
+
+// copy of the elements of [beg,end) satisfying fn
+template <class ReturnRange, class Iterator, class Func>
+ReturnRange find_all_copy(Iterator beg, Iterator end, Func const& fn, std::false_type) {
+    ReturnRange ret(beg,end);
+    boost::asynchronous::detail::find_all(ret,fn);
+    return ret;
+}
+template <class ReturnRange, class Iterator, class Func>
+ReturnRange find_all_copy(Iterator beg, Iterator end, Func const& fn, std::true_type) {
+    ReturnRange ret;
+    if (boost::asynchronous::detail::simd::copy_if(beg,end,fn,std::back_inserter(ret)))
+        return ret;
+    return boost::asynchronous::detail::find_all_copy<ReturnRange>(beg,end,fn,std::false_type());
+}
+template <class ReturnRange, class Iterator, class Func>
+ReturnRange find_all_copy(Iterator beg, Iterator end, Func const& fn) {
+    return boost::asynchronous::detail::find_all_copy<ReturnRange>(beg,end,fn,
+                typename boost::asynchronous::detail::simd::use_value_kernel<Iterator,Func>::type());
+}
     
 }
 
@@ -86,8 +107,7 @@ struct parallel_find_all_helper: public boost::asynchronous::continuation_task<R
             // if not at end, recurse, otherwise execute here
             if (it == end_)
             {
-                ReturnRange ret(beg_,it);
-                boost::asynchronous::detail::find_all(ret,func_);
+                ReturnRange ret = boost::asynchronous::detail::find_all_copy<ReturnRange>(beg_,it,func_);
                 task_res.set_value(std::move(ret));
             }
             else
@@ -162,8 +182,7 @@ struct parallel_find_all_range_helper: public boost::asynchronous::continuation_
             // if not at end, recurse, otherwise execute here
             if (it == boost::end(range_))
             {
-                ReturnRange ret(boost::begin(range_),it);
-                boost::asynchronous::detail::find_all(ret,func_);
+                ReturnRange ret = boost::asynchronous::detail::find_all_copy<ReturnRange>(boost::begin(range_),it,func_);
                 task_res.set_value(std::move(ret));
             }
             else
@@ -237,8 +256,7 @@ struct parallel_find_all_range_move_helper: public boost::asynchronous::continua
             // if not at end, recurse, otherwise execute here
             if (it == boost::end(*range))
             {
-                ReturnRange ret(boost::begin(*range),it);
-                boost::asynchronous::detail::find_all(ret,func_);
+                ReturnRange ret = boost::asynchronous::detail::find_all_copy<ReturnRange>(boost::begin(*range),it,func_);
                 task_res.set_value(std::move(ret));
             }
             else
@@ -304,8 +322,7 @@ struct parallel_find_all_range_move_helper<Range,Func,ReturnRange,Job,typename s
             // if not at end, recurse, otherwise execute here
             if (it == end_)
             {
-                ReturnRange ret(begin_,it);
-                boost::asynchronous::detail::find_all(ret,func_);
+                ReturnRange ret = boost::asynchronous::detail::find_all_copy<ReturnRange>(begin_,it,func_);
                 task_res.set_value(std::move(ret));
             }
             else
@@ -99,7 +99,7 @@ parallel_flatten(
                 [results_container](boost::asynchronous::expected<void> result)
                 {
                     result.get();
-                    return *results_container;
+                    return std::move(*results_container);
                 },
                 task_name + ": unwrapping"
             );
@@ -178,7 +178,7 @@ parallel_flatten(
                 [results_container](boost::asynchronous::expected<void> result)
                 {
                     result.get();
-                    return *results_container;
+                    return std::move(*results_container);
                 },
                 task_name + ": unwrapping"
             );
@@ -257,7 +257,7 @@ parallel_flatten(
                 [results_container](boost::asynchronous::expected<void> result)
                 {
                     result.get();
-                    return *results_container;
+                    return std::move(*results_container);
                 },
                 task_name + ": unwrapping"
             );
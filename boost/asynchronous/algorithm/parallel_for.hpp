@@ -83,12 +83,15 @@ struct parallel_for_helper: public boost::asynchronous::continuation_task<void>
         try
         {
             // advance up to cutoff
-            Iterator it = boost::asynchronous::detail::find_cutoff(beg_,cutoff_,end_);
+            Iterator it = boost::asynchronous::detail::find_cutoff(
+                        beg_,boost::asynchronous::detail::effective_cutoff<parallel_for_helper>(cutoff_),end_);
             // if not at end, recurse, otherwise execute here
             if (it == end_)
             {
+                boost::asynchronous::detail::cutoff_timer<parallel_for_helper> timer(cutoff_,beg_,it);
                 boost::asynchronous::detail::for_helper<
                         boost::asynchronous::function_traits<Func>::arity,Iterator,Func>()(beg_,it,func_);
+                timer.stop();
                 task_res.set_value();
             }
             else
@@ -162,13 +165,17 @@ struct parallel_for_range_move_helper: public boost::asynchronous::continuation_
         boost::asynchronous::continuation_result<Range> task_res = this->this_task_result();
         try
         {
+            typedef boost::asynchronous::detail::parallel_for_helper<decltype(boost::begin(*range)),Func,Job> leaf_type;
             // advance up to cutoff
-            auto it = boost::asynchronous::detail::find_cutoff(boost::begin(*range),cutoff_,boost::end(*range));
+            auto it = boost::asynchronous::detail::find_cutoff(
+                        boost::begin(*range),boost::asynchronous::detail::effective_cutoff<leaf_type>(cutoff_),boost::end(*range));
             // if not at end, recurse, otherwise execute here
             if (it == boost::end(*range))
             {
+                boost::asynchronous::detail::cutoff_timer<leaf_type> timer(cutoff_,boost::begin(*range),it);
                 boost::asynchronous::detail::for_helper<
                         boost::asynchronous::function_traits<Func>::arity,decltype(it),Func>()(boost::begin(*range),it,func_);
+                timer.stop();
                 task_res.set_value(std::move(*range));
             }
             else
@@ -235,12 +242,15 @@ struct parallel_for_range_move_helper<Range,Func,Job,typename std::enable_if<boo
         try
         {
             // advance up to cutoff
-            auto it = boost::asynchronous::detail::find_cutoff(begin_,cutoff_,end_);
+            auto it = boost::asynchronous::detail::find_cutoff(
+                        begin_,boost::asynchronous::detail::effective_cutoff<parallel_for_range_move_helper>(cutoff_),end_);
             // if not at end, recurse, otherwise execute here
             if (it == end_)
             {
+                boost::asynchronous::detail::cutoff_timer<parallel_for_range_move_helper> timer(cutoff_,begin_,it);
                 boost::asynchronous::detail::for_helper<
                         boost::asynchronous::function_traits<Func>::arity,decltype(it),Func>()(begin_,it,func_);
+                timer.stop();
                 Range res;
                 std::move(begin_,it,std::back_inserter(res));
                 task_res.set_value(std::move(res));
@@ -348,13 +358,17 @@ struct parallel_for_range_helper: public boost::asynchronous::continuation_task<
         boost::asynchronous::continuation_result<void> task_res = this->this_task_result();
         try
         {
+            typedef parallel_for_helper<decltype(boost::begin(range_)),Func,Job> leaf_type;
             // advance up to cutoff
-            auto it = boost::asynchronous::detail::find_cutoff(boost::begin(range_),cutoff_,boost::end(range_));
+            auto it = boost::asynchronous::detail::find_cutoff(
+                        boost::begin(range_),boost::asynchronous::detail::effective_cutoff<leaf_type>(cutoff_),boost::end(range_));
             // if not at end, recurse, otherwise execute here
             if (it == boost::end(range_))
             {
+                boost::asynchronous::detail::cutoff_timer<leaf_type> timer(cutoff_,boost::begin(range_),it);
                 boost::asynchronous::detail::for_helper<
                         boost::asynchronous::function_traits<Func>::arity,decltype(it),Func>()(boost::begin(range_),it,func_);
+                timer.stop();
                 task_res.set_value();
             }
             else
@@ -18,6 +18,7 @@
 #include <boost/range/iterator_range.hpp>
 
 #include <boost/asynchronous/algorithm/detail/safe_advance.hpp>
+#include <boost/asynchronous/algorithm/detail/simd_kernels.hpp>
 #include <boost/asynchronous/algorithm/invoke.hpp>
 #include <boost/asynchronous/continuation_task.hpp>
 #include <boost/asynchronous/detail/continuation_impl.hpp>
@@ -37,7 +38,12 @@ namespace detail
 template <class Iterator1, class Iterator2, class T, class BinaryOperation, class Reduce>
 T inner_product_helper(Iterator1 beg1, Iterator1 end1, Iterator2 beg2, BinaryOperation op, Reduce red)
 {
-    T store = op(*beg1++, *beg2++);
+    T store = op(*beg1, *beg2);
+    // std::multiplies and std::plus on contiguous arithmetic ranges
+    if (boost::asynchronous::detail::simd::inner_product(beg1, end1, beg2, op, red, store))
+        return store;
+    ++beg1;
+    ++beg2;
     while (beg1 != end1) {
         store = red(store, op(*beg1++, *beg2++));
     }
@@ -16,6 +16,7 @@
 #include <type_traits>
 
 #include <boost/asynchronous/algorithm/detail/safe_advance.hpp>
+#include <boost/asynchronous/algorithm/detail/simd_kernels.hpp>
 #include <boost/asynchronous/algorithm/then.hpp>
 #include <boost/asynchronous/continuation_task.hpp>
 #include <boost/asynchronous/detail/job_type_from.hpp>
@@ -84,6 +85,15 @@ struct kmp_matcher
         HaystackIndex haystack_offset = 0;
         HaystackIndex haystack_chunk_size = std::distance(begin, end);
         ssize_t needle_offset = 0;
+
+        // For contiguous integral elements (strings), first compare only the first and last elements of the needle,
+        // many positions at once. KMP then searches the positions this filter did not handle.
+        auto on_match = [&functor, begin_index](std::size_t index) { functor(begin_index + static_cast<HaystackIndex>(index)); };
+        std::size_t filtered = 0;
+        if (boost::asynchronous::detail::simd::search(begin, end, needle_begin, needle_end, on_match, filtered))
+        {
+            haystack_offset = static_cast<HaystackIndex>(filtered);
+        }
         while (haystack_offset != haystack_chunk_size)
         {
             if (*(begin + haystack_offset) == *(needle_begin + needle_offset))
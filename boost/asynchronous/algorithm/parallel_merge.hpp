@@ -40,9 +40,11 @@ struct parallel_merge_helper: public boost::asynchronous::continuation_task<void
             auto length1 = std::distance(beg1_,end1_);
             auto length2 = std::distance(beg2_,end2_);
             // if not at end, recurse, otherwise execute here
-            if ((length1+length2) <= cutoff_)
+            if ((length1+length2) <= boost::asynchronous::detail::effective_cutoff<parallel_merge_helper>(cutoff_))
             {
+                boost::asynchronous::detail::cutoff_timer<parallel_merge_helper> timer(cutoff_,(std::size_t)(length1+length2));
                 std::merge(beg1_,end1_,beg2_,end2_,out_,func_);
+                timer.stop();
                 task_res.set_value();
             }
             else
@@ -27,12 +27,30 @@
 #include <boost/asynchronous/algorithm/detail/safe_advance.hpp>
 #include <boost/asynchronous/algorithm/detail/parallel_all_of_helper.hpp>
 #include <boost/asynchronous/detail/metafunctions.hpp>
+#include <boost/asynchronous/algorithm/detail/simd_kernels.hpp>
 
 
 namespace boost { namespace asynchronous
 {
 namespace detail
 {
+// sequential part, uses a SIMD kernel for contiguous arithmetic ranges and std::equal_to
+template <class Iterator1, class Iterator2, class Func>
+std::pair<Iterator1,Iterator2> mismatch(Iterator1 beg1, Iterator1 end1, Iterator2 beg2, Func& func)
+{
+    std::pair<Iterator1,Iterator2> res;
+    if (boost::asynchronous::detail::simd::mismatch(beg1,end1,beg2,func,res))
+        return res;
+    return std::mismatch(beg1,end1,beg2,func);
+}
+template <class Iterator1, class Iterator2>
+std::pair<Iterator1,Iterator2> mismatch(Iterator1 beg1, Iterator1 end1, Iterator2 beg2)
+{
+    std::pair<Iterator1,Iterator2> res;
+    if (boost::asynchronous::detail::simd::mismatch(beg1,end1,beg2,std::equal_to<>(),res))
+        return res;
+    return std::mismatch(beg1,end1,beg2);
+}
 // version for iterators
 template <class Iterator1, class Iterator2, class Func,class Job>
 struct parallel_mismatch_helper: public boost::asynchronous::continuation_task<std::pair<Iterator1,Iterator2>>
@@ -53,7 +71,7 @@ struct parallel_mismatch_helper: public boost::asynchronous::continuation_task<s
             // if not at end, recurse, otherwise execute here
             if (it == end1_)
             {
-                task_res.set_value(std::mismatch(beg1_,end1_,beg2_,func_));
+                task_res.set_value(boost::asynchronous::detail::mismatch(beg1_,end1_,beg2_,func_));
             }
             else
             {
@@ -112,7 +130,7 @@ struct parallel_mismatch_helper2: public boost::asynchronous::continuation_task<
             // if not at end, recurse, otherwise execute here
             if (it == end1_)
             {
-                task_res.set_value(std::mismatch(beg1_,end1_,beg2_));
+                task_res.set_value(boost::asynchronous::detail::mismatch(beg1_,end1_,beg2_));
             }
             else
             {
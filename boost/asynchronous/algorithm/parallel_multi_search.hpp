@@ -0,0 +1,410 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNCHRONOUS_PARALLEL_MULTI_SEARCH_HPP
+#define BOOST_ASYNCHRONOUS_PARALLEL_MULTI_SEARCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/asynchronous/algorithm/detail/safe_advance.hpp>
+#include <boost/asynchronous/algorithm/then.hpp>
+#include <boost/asynchronous/continuation_task.hpp>
+#include <boost/asynchronous/detail/continuation_impl.hpp>
+#include <boost/asynchronous/detail/metafunctions.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+
+// Searches a range (such as a string) for many patterns at once with the Aho-Corasick algorithm.
+// Like parallel_kmp, the haystack is cut in chunks searched in parallel. A chunk is searched a bit further than its end
+// so that the matches crossing its end are found, but only the matches starting in the chunk are reported.
+
+namespace boost { namespace asynchronous
+{
+namespace detail
+{
+// Maps the elements of the patterns to dense symbols 1..size()-1, any other element to 0,
+// so that the transition table only has a column per element really used.
+template <class T, class Enable=void>
+struct multi_search_alphabet
+{
+    void add(T const& t)
+    {
+        values_.push_back(t);
+    }
+    void finish()
+    {
+        std::sort(values_.begin(),values_.end());
+        values_.erase(std::unique(values_.begin(),values_.end()),values_.end());
+    }
+    std::size_t size()const
+    {
+        return values_.size() + 1;
+    }
+    std::size_t symbol(T const& t)const
+    {
+        auto it = std::lower_bound(values_.begin(),values_.end(),t);
+        return (it != values_.end() && !(t < *it)) ? static_cast<std::size_t>(it - values_.begin()) + 1 : 0;
+    }
+    std::vector<T> values_;
+};
+// bytes use a lookup table
+template <class T>
+struct multi_search_alphabet<T,typename std::enable_if<std::is_integral<T>::value && sizeof(T) == 1>::type>
+{
+    multi_search_alphabet()
+        : size_(1)
+    {
+        symbols_.fill(0);
+    }
+    void add(T const& t)
+    {
+        std::uint16_t& s = symbols_[static_cast<unsigned char>(t)];
+        if (s == 0)
+            s = static_cast<std::uint16_t>(size_++);
+    }
+    void finish()
+    {
+    }
+    std::size_t size()const
+    {
+        return size_;
+    }
+    std::size_t symbol(T const& t)const
+    {
+        return symbols_[static_cast<unsigned char>(t)];
+    }
+    std::array<std::uint16_t,256> symbols_;
+    std::size_t size_;
+};
+
+// Aho-Corasick automaton, stored as a complete DFA: one row of transitions per state, one column per symbol.
+// States are numbered breadth first, so that the states close to the root, where a search spends most of
+// its time, share the same cache lines. A transition holds the offset of the row of the next state, so that
+// a step is a single lookup, and a flag if this state finds patterns.
+template <class T>
+struct multi_search_automaton
+{
+    typedef std::uint32_t state_type;
+    static const state_type output_flag = state_type(1) << 31;
+
+    template <class Patterns>
+    explicit multi_search_automaton(Patterns const& patterns)
+        : max_length_(0)
+    {
+        std::vector<std::vector<T>> words;
+        for (auto const& p : patterns)
+        {
+            using std::begin;
+            using std::end;
+            words.emplace_back(begin(p),end(p));
+            for (auto const& t : words.back())
+            {
+                alphabet_.add(t);
+            }
+            lengths_.push_back(words.back().size());
+            max_length_ = std::max(max_length_,words.back().size());
+        }
+        alphabet_.finish();
+        std::size_t const symbols = alphabet_.size();
+
+        // trie, 0 is the root and means "no child"
+        std::vector<state_type> trie(symbols,0);
+        std::vector<std::vector<std::uint32_t>> found(1);
+        for (std::size_t w = 0; w < words.size(); ++w)
+        {
+            // an empty pattern is never found
+            if (words[w].empty())
+                continue;
+            std::size_t s = 0;
+            for (auto const& t : words[w])
+            {
+                std::size_t const a = alphabet_.symbol(t);
+                if (trie[s * symbols + a] == 0)
+                {
+                    if (found.size() > static_cast<std::size_t>(std::numeric_limits<state_type>::max()))
+                        throw std::length_error("parallel_multi_search: too many states");
+                    trie[s * symbols + a] = static_cast<state_type>(found.size());
+                    found.emplace_back();
+                    trie.resize(trie.size() + symbols,0);
+                }
+                s = trie[s * symbols + a];
+            }
+            found[s].push_back(static_cast<std::uint32_t>(w));
+        }
+        std::size_t const states = found.size();
+
+        // breadth first: failure links and missing transitions. The transitions of a state are completed
+        // with those of its failure state, which is closer to the root and therefore already complete.
+        std::vector<state_type> failure(states,0);
+        std::vector<state_type> order;
+        order.reserve(states);
+        order.push_back(0);
+        for (std::size_t next = 0; next < order.size(); ++next)
+        {
+            std::size_t const s = order[next];
+            for (std::size_t a = 0; a < symbols; ++a)
+            {
+                state_type const child = trie[s * symbols + a];
+                if (child != 0)
+                {
+                    failure[child] = (s == 0) ? 0 : trie[failure[s] * symbols + a];
+                    // a state also finds the patterns of its failure state
+                    found[child].insert(found[child].end(),found[failure[child]].begin(),found[failure[child]].end());
+                    order.push_back(child);
+                }
+                else if (s != 0)
+                {
+                    trie[s * symbols + a] = trie[failure[s] * symbols + a];
+                }
+            }
+        }
+
+        // renumber in breadth first order
+        std::vector<state_type> renumbered(states);
+        for (std::size_t i = 0; i < states; ++i)
+        {
+            renumbered[order[i]] = static_cast<state_type>(i);
+        }
+        if (states * symbols >= static_cast<std::size_t>(output_flag))
+            throw std::length_error("parallel_multi_search: too many states");
+        transitions_.resize(states * symbols);
+        output_begin_.reserve(states + 1);
+        for (std::size_t i = 0; i < states; ++i)
+        {
+            std::size_t const s = order[i];
+            for (std::size_t a = 0; a < symbols; ++a)
+            {
+                std::size_t const next = trie[s * symbols + a];
+                transitions_[i * symbols + a] = static_cast<state_type>(renumbered[next] * symbols) | (found[next].empty() ? 0 : output_flag);
+            }
+            output_begin_.push_back(static_cast<std::uint32_t>(outputs_.size()));
+            outputs_.insert(outputs_.end(),found[s].begin(),found[s].end());
+        }
+        output_begin_.push_back(static_cast<std::uint32_t>(outputs_.size()));
+    }
+
+    bool empty()const
+    {
+        return outputs_.empty();
+    }
+
+    // Calls functor(offset + position, pattern index) for the matches in [beg,end) starting before limit
+    template <class Iterator, class IndexType, class Functor>
+    void operator()(Iterator beg, Iterator end, IndexType offset, IndexType limit, Functor& functor)const
+    {
+        std::size_t const symbols = alphabet_.size();
+        std::size_t row = 0;
+        IndexType position = 0;
+        for (; beg != end; ++beg)
+        {
+            state_type const next = transitions_[row + alphabet_.symbol(*beg)];
+            row = next & ~output_flag;
+            ++position;
+            if ((next & output_flag) != 0)
+            {
+                std::size_t const state = row / symbols;
+                for (std::uint32_t o = output_begin_[state]; o != output_begin_[state + 1]; ++o)
+                {
+                    IndexType const start = position - static_cast<IndexType>(lengths_[outputs_[o]]);
+                    if (start < limit)
+                        functor(offset + start, static_cast<std::size_t>(outputs_[o]));
+                }
+            }
+        }
+    }
+
+    boost::asynchronous::detail::multi_search_alphabet<T> alphabet_;
+    std::vector<state_type> transitions_;
+    // patterns found in state s: outputs_[output_begin_[s]] to outputs_[output_begin_[s+1]]
+    std::vector<std::uint32_t> output_begin_;
+    std::vector<std::uint32_t> outputs_;
+    std::vector<std::size_t> lengths_;
+    std::size_t max_length_;
+};
+
+template <class Iterator, class Automaton, class Functor, class IndexType, class Job>
+struct parallel_multi_search_helper : public boost::asynchronous::continuation_task<Functor>
+{
+    parallel_multi_search_helper(Iterator first, Iterator last, Iterator haystack_end, std::shared_ptr<const Automaton> automaton,
+                                 Functor functor, IndexType offset, long cutoff, const std::string& task_name, std::size_t prio)
+        : boost::asynchronous::continuation_task<Functor>(task_name)
+        , first_(first)
+        , last_(last)
+        , haystack_end_(haystack_end)
+        , automaton_(std::move(automaton))
+        , functor_(std::move(functor))
+        , offset_(offset)
+        , cutoff_(cutoff)
+        , prio_(prio)
+    {}
+
+    void operator()()
+    {
+        boost::asynchronous::continuation_result<Functor> task_res = this->this_task_result();
+        try
+        {
+            if (automaton_->empty())
+            {
+                task_res.set_value(std::move(functor_));
+                return;
+            }
+            Iterator middle = boost::asynchronous::detail::find_cutoff(first_, cutoff_, last_);
+            if (middle == last_)
+            {
+                // matches starting in this chunk can end up to the length of the longest pattern - 1 after it
+                Iterator padded = last_;
+                boost::asynchronous::detail::safe_advance(padded, static_cast<IndexType>(automaton_->max_length_) - 1, haystack_end_);
+                (*automaton_)(first_, padded, offset_, static_cast<IndexType>(std::distance(first_, last_)), functor_);
+                task_res.set_value(std::move(functor_));
+            }
+            else
+            {
+                IndexType middle_offset = offset_ + std::distance(first_, middle);
+                boost::asynchronous::create_callback_continuation_job<Job>(
+                    [task_res](std::tuple<boost::asynchronous::expected<Functor>, boost::asynchronous::expected<Functor>> result) mutable
+                    {
+                        try
+                        {
+                            auto functor = std::get<0>(result).get();
+                            functor.merge(std::move(std::get<1>(result).get()));
+                            task_res.set_value(std::move(functor));
+                        }
+                        catch (...)
+                        {
+                            task_res.set_exception(std::current_exception());
+                        }
+                    },
+                    parallel_multi_search_helper<Iterator, Automaton, Functor, IndexType, Job>(
+                        first_, middle, haystack_end_, automaton_, functor_, offset_, cutoff_, this->get_name(), prio_),
+                    parallel_multi_search_helper<Iterator, Automaton, Functor, IndexType, Job>(
+                        middle, last_, haystack_end_, automaton_, functor_, middle_offset, cutoff_, this->get_name(), prio_)
+                );
+            }
+        }
+        catch (...)
+        {
+            task_res.set_exception(std::current_exception());
+        }
+    }
+
+    Iterator    first_;
+    Iterator    last_;
+    Iterator    haystack_end_;
+    std::shared_ptr<const Automaton> automaton_;
+    Functor     functor_;
+    IndexType   offset_;
+    long        cutoff_;
+    std::size_t prio_;
+};
+
+template <class Job, class Iterator, class Automaton, class Functor>
+boost::asynchronous::detail::callback_continuation<Functor, Job>
+parallel_multi_search_impl(Iterator beg, Iterator end, std::shared_ptr<const Automaton> automaton, Functor functor, long cutoff,
+                           const std::string& task_name, std::size_t prio)
+{
+    typedef typename std::iterator_traits<Iterator>::difference_type index_type;
+    return boost::asynchronous::top_level_callback_continuation_job<Functor, Job>(
+        boost::asynchronous::detail::parallel_multi_search_helper<Iterator, Automaton, Functor, index_type, Job>(
+            beg, end, end, std::move(automaton), std::move(functor), 0, cutoff, task_name, prio));
+}
+
+template <class T, class Patterns>
+std::shared_ptr<const boost::asynchronous::detail::multi_search_automaton<T>> make_multi_search_automaton(Patterns const& patterns)
+{
+    return std::make_shared<const boost::asynchronous::detail::multi_search_automaton<T>>(patterns);
+}
+} // detail
+
+// The functor is called with void operator()(index_type position, std::size_t pattern) for each match,
+// pattern being the index of the pattern in patterns. Like for parallel_kmp, it must provide void merge(Functor&&),
+// which is called on the functor of a chunk with the functor of the following chunk.
+// Patterns is a range of ranges of the element type of the haystack, for example a std::vector<std::string>.
+
+// version for iterators
+template <class Iterator, class Patterns, class Functor, class Job=BOOST_ASYNCHRONOUS_DEFAULT_JOB>
+boost::asynchronous::detail::callback_continuation<Functor,Job>
+parallel_multi_search(Iterator beg, Iterator end, Patterns const& patterns, Functor functor, long cutoff,
+#ifdef BOOST_ASYNCHRONOUS_REQUIRE_ALL_ARGUMENTS
+                      const std::string& task_name, std::size_t prio=0)
+#else
+                      const std::string& task_name="", std::size_t prio=0)
+#endif
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+    return boost::asynchronous::detail::parallel_multi_search_impl<Job>(
+                beg, end, boost::asynchronous::detail::make_multi_search_automaton<value_type>(patterns),
+                std::move(functor), cutoff, task_name, prio);
+}
+
+// version for moved ranges
+template <class Range, class Patterns, class Functor, class Job=BOOST_ASYNCHRONOUS_DEFAULT_JOB>
+typename std::enable_if<!boost::asynchronous::detail::has_is_continuation_task<Range>::value,
+                        boost::asynchronous::detail::callback_continuation<Functor,Job>>::type
+parallel_multi_search(Range&& range, Patterns const& patterns, Functor functor, long cutoff,
+#ifdef BOOST_ASYNCHRONOUS_REQUIRE_ALL_ARGUMENTS
+                      const std::string& task_name, std::size_t prio=0)
+#else
+                      const std::string& task_name="", std::size_t prio=0)
+#endif
+{
+    auto r = std::make_shared<typename std::decay<Range>::type>(std::forward<Range>(range));
+    typedef typename std::iterator_traits<decltype(boost::begin(*r))>::value_type value_type;
+    return boost::asynchronous::then_job<Job>(
+                boost::asynchronous::detail::parallel_multi_search_impl<Job>(
+                    boost::begin(*r), boost::end(*r), boost::asynchronous::detail::make_multi_search_automaton<value_type>(patterns),
+                    std::move(functor), cutoff, task_name, prio),
+                // keeps the range alive until the search is done
+                [r](boost::asynchronous::expected<Functor> res) { return res.get(); },
+                task_name + ": parallel_multi_search: keep-alive of moved range");
+}
+
+// version taking a continuation of a range as first argument
+template <class Range, class Patterns, class Functor, class Job=typename Range::job_type>
+typename std::enable_if<boost::asynchronous::detail::has_is_continuation_task<Range>::value,
+                        boost::asynchronous::detail::callback_continuation<Functor,Job>>::type
+parallel_multi_search(Range range, Patterns const& patterns, Functor functor, long cutoff,
+#ifdef BOOST_ASYNCHRONOUS_REQUIRE_ALL_ARGUMENTS
+                      const std::string& task_name, std::size_t prio=0)
+#else
+                      const std::string& task_name="", std::size_t prio=0)
+#endif
+{
+    typedef typename Range::return_type range_type;
+    typedef typename std::iterator_traits<decltype(boost::begin(std::declval<range_type&>()))>::value_type value_type;
+    // the automaton is built now, while the range is being computed
+    auto automaton = boost::asynchronous::detail::make_multi_search_automaton<value_type>(patterns);
+    return boost::asynchronous::then_job<Job>(
+                std::move(range),
+                [automaton, functor, cutoff, task_name, prio](boost::asynchronous::expected<range_type> res) mutable
+                {
+                    auto r = std::make_shared<range_type>(std::move(res.get()));
+                    return boost::asynchronous::then_job<Job>(
+                                boost::asynchronous::detail::parallel_multi_search_impl<Job>(
+                                    boost::begin(*r), boost::end(*r), automaton, std::move(functor), cutoff, task_name, prio),
+                                [r](boost::asynchronous::expected<Functor> res) { return res.get(); },
+                                task_name + ": parallel_multi_search: keep-alive of moved range");
+                },
+                task_name + ": parallel_multi_search: argument callback");
+}
+
+}} // boost::asynchronous
+
+#endif // BOOST_ASYNCHRONOUS_PARALLEL_MULTI_SEARCH_HPP
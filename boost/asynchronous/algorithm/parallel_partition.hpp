@@ -11,9 +11,12 @@
 #define BOOST_ASYNCHRONOUS_PARALLEL_PARTITION_HPP
 
 #include <atomic>
+#include <cstdint>
 #include <list>
 #include <memory>
+#include <numeric>
 #include <utility>
+#include <vector>
 #include <algorithm>
 
 #include <boost/range/begin.hpp>
@@ -30,21 +33,20 @@ namespace boost { namespace asynchronous
 {
 namespace detail
 {
+// returns the position of the median of 3 elements, without moving or copying them
 template <class It, class Func>
-void median_of_three(It it1, It it2, It it3, Func& func)
+It median_of_three_position(It it1, It it2, It it3, Func& func)
 {
     if (func(*it2,*it1))
     {
-        std::iter_swap(it1,it2);
-    }
-    if (func(*it3,*it1))
-    {
-        std::iter_swap(it1,it3);
+        std::swap(it1,it2);
     }
+    // *it1 <= *it2
     if (func(*it3,*it2))
     {
-        std::iter_swap(it2,it3);
+        return func(*it3,*it1) ? it1 : it3;
     }
+    return it2;
 }
 template <class It, class Func>
 auto median_of_medians(It beg, It end, Func& func)
@@ -56,27 +58,100 @@ auto median_of_medians(It beg, It end, Func& func)
     if (dist < 16)
     {
         std::size_t offset = dist/2;
-        std::vector<typename std::remove_reference<decltype(*beg)>::type> temp1 = {*beg, *(beg+offset), *(end-1)};
-        boost::asynchronous::detail::median_of_three(temp1.begin(),temp1.begin()+1,temp1.begin()+2,func);
-        return *(temp1.begin()+1);
+        return *boost::asynchronous::detail::median_of_three_position(beg,beg+offset,end-1,func);
     }
 
     std::size_t offset = dist/8;
-    std::vector<typename std::remove_reference<decltype(*beg)>::type> temp1 = {*beg, *(beg+offset), *(beg+offset*2)};
-    boost::asynchronous::detail::median_of_three(temp1.begin(),temp1.begin()+1,temp1.begin()+2,func);
-
-    std::vector<typename std::remove_reference<decltype(*beg)>::type> temp2 = {*(beg+ 3*offset), *(beg+offset*4), *(end-(3*offset+1))};
-    boost::asynchronous::detail::median_of_three(temp2.begin(),temp2.begin()+1,temp2.begin()+2,func);
-
-    std::vector<typename std::remove_reference<decltype(*beg)>::type> temp3 = {*(end-(2*offset+1)), *(end-(offset+1)), *(end-1)};
-    boost::asynchronous::detail::median_of_three(temp3.begin(),temp3.begin()+1,temp3.begin()+2,func);
-
-    std::vector<typename std::remove_reference<decltype(*beg)>::type> res = {*(temp1.begin()+1), *(temp2.begin()+1), *(temp3.begin()+1)};
-    boost::asynchronous::detail::median_of_three(res.begin(),res.begin()+1,res.begin()+2,func);
+    It m1 = boost::asynchronous::detail::median_of_three_position(beg,beg+offset,beg+offset*2,func);
+    It m2 = boost::asynchronous::detail::median_of_three_position(beg+3*offset,beg+offset*4,end-(3*offset+1),func);
+    It m3 = boost::asynchronous::detail::median_of_three_position(end-(2*offset+1),end-(offset+1),end-1,func);
+    return *boost::asynchronous::detail::median_of_three_position(m1,m2,m3,func);
+}
 
-    return *(res.begin()+1);
+// Neutralizes a left block (which must only contain elements satisfying the relation) against a right block
+// (which must only contain elements not satisfying it), in the style of BlockQuicksort:
+// the offsets of misplaced elements are collected without branches, 64 elements at a time on each side, then swapped.
+// Stops when a block is done. Elements before lbs (rbs) are then correctly placed,
+// [lbs,lbe) and [rbs,rbe) still have to be checked.
+template <class Iterator, class Relation>
+void neutralize_blocks(Iterator& lbs, Iterator lbe, Iterator& rbs, Iterator rbe, Relation const& r)
+{
+    constexpr std::ptrdiff_t block_size = 64;
+    unsigned char offsets_l[block_size];
+    unsigned char offsets_r[block_size];
+    std::ptrdiff_t num_l = 0, start_l = 0, size_l = 0;
+    std::ptrdiff_t num_r = 0, start_r = 0, size_r = 0;
+    bool skip_l = false, skip_r = false;
+    while (lbs != lbe && rbs != rbe)
+    {
+        if (num_l == 0)
+        {
+            // the last scanned part was correctly placed, the input is probably (nearly) partitioned.
+            // Skipping with a branch is cheaper in this case
+            if (skip_l)
+            {
+                while (lbs != lbe && static_cast<bool>(r(*lbs)))
+                {
+                    ++lbs;
+                }
+                if (lbs == lbe)
+                {
+                    break;
+                }
+            }
+            start_l = 0;
+            size_l = std::min<std::ptrdiff_t>(block_size,lbe - lbs);
+            for (std::ptrdiff_t i = 0; i < size_l; ++i)
+            {
+                offsets_l[num_l] = static_cast<unsigned char>(i);
+                num_l += !static_cast<bool>(r(lbs[i]));
+            }
+            skip_l = (num_l == 0);
+        }
+        if (num_r == 0)
+        {
+            if (skip_r)
+            {
+                while (rbs != rbe && !static_cast<bool>(r(*rbs)))
+                {
+                    ++rbs;
+                }
+                if (rbs == rbe)
+                {
+                    break;
+                }
+            }
+            start_r = 0;
+            size_r = std::min<std::ptrdiff_t>(block_size,rbe - rbs);
+            for (std::ptrdiff_t i = 0; i < size_r; ++i)
+            {
+                offsets_r[num_r] = static_cast<unsigned char>(i);
+                num_r += static_cast<bool>(r(rbs[i]));
+            }
+            skip_r = (num_r == 0);
+        }
+        std::ptrdiff_t swaps = std::min(num_l,num_r);
+        for (std::ptrdiff_t i = 0; i < swaps; ++i)
+        {
+            std::iter_swap(lbs + offsets_l[start_l + i],rbs + offsets_r[start_r + i]);
+        }
+        num_l -= swaps;
+        num_r -= swaps;
+        start_l += swaps;
+        start_r += swaps;
+        if (num_l == 0)
+        {
+            lbs += size_l;
+        }
+        if (num_r == 0)
+        {
+            rbs += size_r;
+        }
+    }
 }
 
+// phase 1: every worker takes blocks from both ends and neutralizes them until no block is left.
+// Returns the blocks it could not complete.
 template <class iterator, class relation, class shared_data, class JobType>
 struct partition_worker : public boost::asynchronous::continuation_task<std::pair<std::list<std::pair<iterator, iterator>>, std::list<std::pair<iterator, iterator>>>>
 {
@@ -99,70 +174,23 @@ struct partition_worker : public boost::asynchronous::continuation_task<std::pai
             }
             else
             {
-                auto sd = m_sd;
                 boost::asynchronous::create_callback_continuation_job<JobType>(
-                [task_res, sd]
+                [task_res]
                 (std::tuple<boost::asynchronous::expected<std::pair<std::list<std::pair<iterator, iterator>>, std::list<std::pair<iterator, iterator>>>>,boost::asynchronous::expected<std::pair<std::list<std::pair<iterator, iterator>>, std::list<std::pair<iterator, iterator>>>> > res)
                 mutable
                 {
                     try
                     {
-                        //MERGE
+                        // remaining blocks are fixed in parallel at the end
                         std::pair<std::list<std::pair<iterator, iterator>>, std::list<std::pair<iterator, iterator>>> LR = std::move(std::get<0>(res).get());
-                        std::list<std::pair<iterator, iterator>> l_rest = std::move(LR.first);
-                        std::list<std::pair<iterator, iterator>> r_rest = std::move(LR.second);
                         std::pair<std::list<std::pair<iterator, iterator>>, std::list<std::pair<iterator, iterator>>> RR = std::move(std::get<1>(res).get());
-                        l_rest.splice(l_rest.end(), RR.first);
-                        r_rest.splice(r_rest.end(), RR.second);
-
-                        iterator lbs = sd->m_left, rbs = sd->m_right, lbe = sd->m_left, rbe = sd->m_right;
-                        while((!r_rest.empty() || rbs != rbe) && (!l_rest.empty() || lbs != lbe))
-                        {
-                            if (rbs == rbe)
-                            {
-                                rbs = r_rest.front().first;
-                                rbe = r_rest.front().second;
-                                r_rest.pop_front();
-                            }
-                            if (lbs == lbe)
-                            {
-                                lbs = l_rest.front().first;
-                                lbe = l_rest.front().second;
-                                l_rest.pop_front();
-                            }
-
-                            for(;;)
-                            {
-                                //while (lbs < lbe && sd->m_r(*(lbs))) ++lbs;
-                                //while (rbs < rbe && !sd->m_r(*(rbs))) ++rbs;
-                                for(auto i = lbs; i != lbe;++i)
-                                {
-                                    if (!sd->m_r(*(i)))
-                                        break;
-                                    ++lbs;
-
-                                }
-                                for(auto i = rbs; i != rbe;++i)
-                                {
-                                    if (sd->m_r(*(i)))
-                                        break;
-                                    ++rbs;
-                                }
-                                if (lbs == lbe || rbs == rbe) break;
-                                std::swap(*lbs,*rbs);
-                            }
-                        }
-                        if (lbs != lbe)
-                            l_rest.push_back(std::make_pair(lbs,lbe));
-                        if (rbs != rbe)
-                            r_rest.push_back(std::make_pair(rbs,rbe));
-                        task_res.set_value(std::make_pair(std::move(l_rest), std::move(r_rest)));
-                        return;
+                        LR.first.splice(LR.first.end(), RR.first);
+                        LR.second.splice(LR.second.end(), RR.second);
+                        task_res.set_value(std::move(LR));
                     }
-                    catch (std::exception& e)
+                    catch (...)
                     {
                         task_res.set_exception(std::current_exception());
-                        return;
                     }
                 },
                 // future results of recursive tasks
@@ -183,71 +211,108 @@ private:
 
     std::pair<std::list<std::pair<iterator, iterator>>, std::list<std::pair<iterator, iterator>>> part_parallel()
     {
-        iterator lbs = m_sd->m_left, rbs = m_sd->m_right, lbe = m_sd->m_left, rbe = m_sd->m_right;
-        int mlstart = 0, mrstart = 0;
-        int myrtrue = 0;
+        iterator lbs = m_sd->m_left, lbe = m_sd->m_left, rbs = m_sd->m_right, rbe = m_sd->m_right;
+        int64_t claimed_left = 0;
 
         while(m_sd->m_size > 0)
         {
-            int mysize = m_sd->m_size.fetch_sub(m_sd->m_BS);
+            int64_t mysize = m_sd->m_size.fetch_sub(m_sd->m_BS);
             if (mysize <= 0) break;
             if (mysize > m_sd->m_BS) mysize = m_sd->m_BS;
 
             if (lbs == lbe)
             {
-                mlstart = m_sd->m_lmove.fetch_add(mysize);
+                int64_t mlstart = m_sd->m_lmove.fetch_add(mysize);
                 lbs = m_sd->m_left + mlstart;
                 lbe = lbs + mysize;
+                claimed_left += mysize;
             }
             else
-                //if (rbs == rbe)
             {
-                mrstart = m_sd->m_rmove.fetch_sub(mysize);
-                rbs = m_sd->m_left + mrstart;
-                rbe = rbs - mysize;
-                --rbs;
-                --rbe;
+                int64_t mrstart = m_sd->m_rmove.fetch_sub(mysize);
+                rbe = m_sd->m_left + mrstart;
+                rbs = rbe - mysize;
             }
+            boost::asynchronous::detail::neutralize_blocks(lbs,lbe,rbs,rbe,m_sd->m_r);
+        }
 
-            for(;;)
+        // completed left blocks only contain elements satisfying the relation, completed right blocks none
+        int64_t myrtrue = claimed_left - (lbe - lbs);
+        for(auto i = lbs; i != lbe ; ++i) if(m_sd->m_r(*(i))) ++myrtrue;
+        for(auto i = rbs; i != rbe ; ++i) if(m_sd->m_r(*(i))) ++myrtrue;
+        m_sd->m_rtrue += myrtrue;
+
+        std::list<std::pair<iterator, iterator>> L,R;
+        if (lbs != lbe)
+            L.push_back(std::make_pair(lbs,lbe));
+        if (rbs != rbe)
+            R.push_back(std::make_pair(rbs,rbe));
+        return std::make_pair(std::move(L), std::move(R));
+    }
+};
+
+// phase 2: counts the misplaced elements of the remaining pieces, finds where every task starts, then swaps them.
+// Every stage is parallel.
+enum class partition_fixup_stage
+{
+    count,
+    locate,
+    swap
+};
+template <class shared_data, class JobType>
+struct partition_fixup_worker : public boost::asynchronous::continuation_task<void>
+{
+    partition_fixup_worker(shared_data* sd, partition_fixup_stage stage, std::size_t first, std::size_t last)
+        : boost::asynchronous::continuation_task<void>("partition_fixup_worker")
+        , m_sd(sd), m_stage(stage), m_first(first), m_last(last) { }
+
+    void operator()()
+    {
+        boost::asynchronous::continuation_result<void> task_res = this->this_task_result();
+        try
+        {
+            if (m_last - m_first <= 1)
             {
-                //while (lbs < lbe && m_sd->m_r(*(lbs))) {++myrtrue; ++lbs;}
-                //while (rbs > rbe && !m_sd->m_r(*(rbs))) --rbs;
-                for(auto i = lbs; i != lbe;++i)
+                for (std::size_t i = m_first; i != m_last; ++i)
                 {
-                    if (!m_sd->m_r(*(i)))
-                        break;
-                    ++myrtrue;
-                    ++lbs;
+                    m_sd->fixup(m_stage,i);
                 }
-                for(auto i = rbs; i != rbe;--i)
+                task_res.set_value();
+            }
+            else
+            {
+                std::size_t middle = m_first + (m_last - m_first) / 2;
+                boost::asynchronous::create_callback_continuation_job<JobType>(
+                [task_res]
+                (std::tuple<boost::asynchronous::expected<void>,boost::asynchronous::expected<void> > res) mutable
                 {
-                    if (m_sd->m_r(*(i)))
-                        break;
-                    --rbs;
-                }
-                if (lbs == lbe || rbs == rbe) break;
-                std::swap(*lbs,*rbs);
+                    try
+                    {
+                        std::get<0>(res).get();
+                        std::get<1>(res).get();
+                        task_res.set_value();
+                    }
+                    catch(...)
+                    {
+                        task_res.set_exception(std::current_exception());
+                    }
+                },
+                partition_fixup_worker<shared_data, JobType>(m_sd, m_stage, m_first, middle),
+                partition_fixup_worker<shared_data, JobType>(m_sd, m_stage, middle, m_last)
+                );
             }
         }
-
-        std::list<std::pair<iterator, iterator>> L,R;
-        if (lbs != lbe)
-        {
-            for(auto i = lbs; i < lbe ; ++i) if(m_sd->m_r(*(i))) ++myrtrue;
-            L.push_back(std::make_pair(lbs,lbe));
-        }
-        if (rbs != rbe)
+        catch(...)
         {
-            ++rbe;
-            ++rbs;
-            for(auto i = rbe; i < rbs ; ++i) if(m_sd->m_r(*(i))) ++myrtrue;
-            R.push_back(std::make_pair(rbe,rbs));
+            task_res.set_exception(std::current_exception());
         }
-        m_sd->m_rtrue += myrtrue;
-
-        return std::make_pair(std::move(L), std::move(R));
     }
+
+private:
+    shared_data* m_sd;
+    partition_fixup_stage m_stage;
+    std::size_t m_first;
+    std::size_t m_last;
 };
 
 template <class Iterator, class relation, class JobType>
@@ -257,7 +322,9 @@ struct parallel_partition_helper : public boost::asynchronous::continuation_task
     {
         shared_data(const Iterator left, const Iterator right, relation r, const uint32_t open_threads)
             : m_r(std::move(r)), m_BS(std::max((int)std::distance(left,right) / 1000, (int)1000)), m_left(left), m_right(right)
+            , m_threads(std::max(open_threads,(uint32_t)1))
             , m_open_threads(open_threads), m_size(right-left), m_lmove(0), m_rmove(right-left), m_rtrue(0)
+            , m_misplaced(0), m_fixup_tasks(0)
         {
             if (m_size < 10000)
                 m_open_threads = 1;
@@ -268,18 +335,159 @@ struct parallel_partition_helper : public boost::asynchronous::continuation_task
         }
         shared_data(const Iterator left, const Iterator right, relation r, const unsigned BS, const uint32_t open_threads)
             : m_r(std::move(r)), m_BS(BS), m_left(left), m_right(right)
+            , m_threads(std::max(open_threads,(uint32_t)1))
             , m_open_threads(open_threads), m_size(right-left), m_lmove(0), m_rmove(right-left), m_rtrue(0)
+            , m_misplaced(0), m_fixup_tasks(0)
         {
             if (m_size < 10000) m_open_threads = 1;
             if (m_open_threads < 1) m_open_threads = 1;
             if (m_open_threads > m_size) m_open_threads = 1;
         }
 
+        // collects the ranges which can still contain misplaced elements after phase 1 and cuts them into pieces
+        // of at most m_BS elements.
+        // Returns the partition point
+        Iterator prepare_fixup(std::list<std::pair<Iterator, Iterator>> l_rest, std::list<std::pair<Iterator, Iterator>> r_rest)
+        {
+            Iterator split = m_left + m_rtrue.load();
+            // left blocks end and right blocks start at m_lmove. Between it and split, complete blocks are on the wrong side.
+            Iterator moved = m_left + m_lmove.load();
+            std::vector<std::pair<Iterator, Iterator>> rest(l_rest.begin(),l_rest.end());
+            rest.insert(rest.end(),r_rest.begin(),r_rest.end());
+            if (moved != split)
+                rest.push_back(std::make_pair(std::min(moved,split),std::max(moved,split)));
+            std::sort(rest.begin(),rest.end());
+
+            Iterator merged_beg = m_left, merged_end = m_left;
+            auto add_pieces = [this,split](Iterator beg, Iterator end)
+            {
+                for (Iterator it = beg; it < end && it < split; it += std::min<int64_t>(m_BS,std::min(end,split) - it))
+                    m_fix_left.push_back(std::make_pair(it,it + std::min<int64_t>(m_BS,std::min(end,split) - it)));
+                for (Iterator it = std::max(beg,split); it < end; it += std::min<int64_t>(m_BS,end - it))
+                    m_fix_right.push_back(std::make_pair(it,it + std::min<int64_t>(m_BS,end - it)));
+            };
+            for (auto const& r : rest)
+            {
+                if (r.first > merged_end)
+                {
+                    add_pieces(merged_beg,merged_end);
+                    merged_beg = r.first;
+                }
+                merged_end = std::max(merged_end,r.second);
+            }
+            add_pieces(merged_beg,merged_end);
+            m_count_left.resize(m_fix_left.size(),0);
+            m_count_right.resize(m_fix_right.size(),0);
+            return split;
+        }
+        std::size_t fixup_tasks(boost::asynchronous::detail::partition_fixup_stage stage) const
+        {
+            return stage == boost::asynchronous::detail::partition_fixup_stage::count ?
+                        m_fix_left.size() + m_fix_right.size() : m_fixup_tasks;
+        }
+        void fixup(boost::asynchronous::detail::partition_fixup_stage stage, std::size_t i)
+        {
+            switch (stage)
+            {
+            case boost::asynchronous::detail::partition_fixup_stage::count:
+                fixup_count(i);
+                break;
+            case boost::asynchronous::detail::partition_fixup_stage::locate:
+                m_start_left[i] = locate(i,m_fix_left,m_count_left,false);
+                m_start_right[i] = locate(i,m_fix_right,m_count_right,true);
+                break;
+            case boost::asynchronous::detail::partition_fixup_stage::swap:
+                fixup_swap(i);
+                break;
+            }
+        }
+        void fixup_count(std::size_t i)
+        {
+            std::size_t count = 0;
+            if (i < m_fix_left.size())
+            {
+                for (Iterator it = m_fix_left[i].first; it != m_fix_left[i].second; ++it)
+                    count += !static_cast<bool>(m_r(*it));
+                m_count_left[i] = count;
+            }
+            else
+            {
+                i -= m_fix_left.size();
+                for (Iterator it = m_fix_right[i].first; it != m_fix_right[i].second; ++it)
+                    count += static_cast<bool>(m_r(*it));
+                m_count_right[i] = count;
+            }
+        }
+        // computes the ranks of misplaced elements and shares them among tasks
+        void prepare_swaps()
+        {
+            std::partial_sum(m_count_left.begin(),m_count_left.end(),m_count_left.begin());
+            std::partial_sum(m_count_right.begin(),m_count_right.end(),m_count_right.begin());
+            // there are as many misplaced elements on each side
+            m_misplaced = std::min(m_count_left.back(),m_count_right.back());
+            m_fixup_tasks = std::min<std::size_t>((m_misplaced + m_BS - 1) / m_BS,m_threads);
+            // the last task ends with the last pieces
+            m_start_left.resize(m_fixup_tasks + 1);
+            m_start_right.resize(m_fixup_tasks + 1);
+            m_start_left.back() = std::make_pair(m_fix_left.size() - 1,m_fix_left.back().second);
+            m_start_right.back() = std::make_pair(m_fix_right.size() - 1,m_fix_right.back().second);
+        }
+        // finds the piece and position of the first misplaced element of a task, before any swap
+        std::pair<std::size_t, Iterator> locate(std::size_t task, std::vector<std::pair<Iterator, Iterator>> const& pieces,
+                                                std::vector<std::size_t> const& counts, bool misplaced_value) const
+        {
+            std::size_t rank = m_misplaced * task / m_fixup_tasks;
+            std::size_t piece = std::upper_bound(counts.begin(),counts.end(),rank) - counts.begin();
+            Iterator it = pieces[piece].first;
+            for (std::size_t skip = rank - (piece == 0 ? 0 : counts[piece-1]); skip > 0; ++it)
+                skip -= (static_cast<bool>(m_r(*it)) == misplaced_value);
+            return std::make_pair(piece,it);
+        }
+        // swaps the misplaced elements between the start of this task and the start of the next one
+        void fixup_swap(std::size_t task)
+        {
+            std::size_t il = m_start_left[task].first, il_end = m_start_left[task+1].first;
+            std::size_t ir = m_start_right[task].first, ir_end = m_start_right[task+1].first;
+            Iterator lbs = m_start_left[task].second;
+            Iterator lbe = (il == il_end) ? m_start_left[task+1].second : m_fix_left[il].second;
+            Iterator rbs = m_start_right[task].second;
+            Iterator rbe = (ir == ir_end) ? m_start_right[task+1].second : m_fix_right[ir].second;
+            for(;;)
+            {
+                boost::asynchronous::detail::neutralize_blocks(lbs,lbe,rbs,rbe,m_r);
+                if (lbs == lbe)
+                {
+                    if (il == il_end)
+                        break;
+                    ++il;
+                    lbs = m_fix_left[il].first;
+                    lbe = (il == il_end) ? m_start_left[task+1].second : m_fix_left[il].second;
+                }
+                if (rbs == rbe)
+                {
+                    if (ir == ir_end)
+                        break;
+                    ++ir;
+                    rbs = m_fix_right[ir].first;
+                    rbe = (ir == ir_end) ? m_start_right[task+1].second : m_fix_right[ir].second;
+                }
+            }
+        }
+
         const relation m_r;
         const int m_BS;
         const Iterator m_left, m_right;
+        const uint32_t m_threads;
         std::atomic<uint32_t> m_open_threads;
         std::atomic<int64_t> m_size, m_lmove, m_rmove, m_rtrue;
+        // phase 2: pieces of [m_left,split) which can contain elements not satisfying the relation,
+        // and of [split,m_right) which can contain elements satisfying it, with the number of these elements
+        std::vector<std::pair<Iterator, Iterator>> m_fix_left, m_fix_right;
+        std::vector<std::size_t> m_count_left, m_count_right;
+        // where every task starts (piece, position)
+        std::vector<std::pair<std::size_t, Iterator>> m_start_left, m_start_right;
+        std::size_t m_misplaced;
+        std::size_t m_fixup_tasks;
     };
 
     parallel_partition_helper(const Iterator a, const Iterator b, relation r, const uint32_t thread_num,const std::string& task_name)
@@ -309,62 +517,21 @@ struct parallel_partition_helper : public boost::asynchronous::continuation_task
                (std::tuple<boost::asynchronous::expected<std::pair<std::list<std::pair<Iterator, Iterator>>, std::list<std::pair<Iterator, Iterator>>>> > res)
                 mutable
             {
-
-                std::pair<std::list<std::pair<Iterator, Iterator>>, std::list<std::pair<Iterator, Iterator>>> R = std::move(std::get<0>(res).get());
-                std::list<std::pair<Iterator, Iterator>> l_rest = std::move(R.first);
-                std::list<std::pair<Iterator, Iterator>> r_rest = std::move(R.second);
-
-                auto it_left_plus_rtrue = sd->m_left;
-                auto it_left_plus_lmove = sd->m_left;
-                std::advance(it_left_plus_rtrue,sd->m_rtrue.load());
-                std::advance(it_left_plus_lmove,sd->m_lmove.load());
-
-                if (sd->m_lmove < sd->m_rtrue)
-                {
-                    for(auto& r : r_rest)
-                    {
-                        if(r.first < it_left_plus_rtrue) r.first = it_left_plus_rtrue;
-                        if(r.second < it_left_plus_rtrue) r.second = it_left_plus_rtrue;
-                    }
-                    l_rest.push_back(std::make_pair(it_left_plus_lmove,it_left_plus_rtrue));
-                }
-                if (sd->m_lmove > sd->m_rtrue)
+                try
                 {
-                    for(auto& l : l_rest)
+                    std::pair<std::list<std::pair<Iterator, Iterator>>, std::list<std::pair<Iterator, Iterator>>> R = std::move(std::get<0>(res).get());
+                    Iterator split = sd->prepare_fixup(std::move(R.first),std::move(R.second));
+                    if (sd->m_fix_left.empty() || sd->m_fix_right.empty())
                     {
-                        if(l.first > it_left_plus_rtrue) l.first = it_left_plus_rtrue;
-                        if(l.second > it_left_plus_rtrue) l.second = it_left_plus_rtrue;
+                        task_res.set_value(split);
+                        return;
                     }
-                    r_rest.push_back(std::make_pair(it_left_plus_rtrue,it_left_plus_lmove));
+                    parallel_partition_helper::run_fixup(task_res,msd,split,boost::asynchronous::detail::partition_fixup_stage::count);
                 }
-
-                Iterator lbs = sd->m_left, rbs = sd->m_right, lbe = sd->m_left, rbe = sd->m_right;
-                while((!r_rest.empty() || rbs != rbe) && (!l_rest.empty() || lbs != lbe))
+                catch(...)
                 {
-                    if (rbs == rbe)
-                    {
-                        rbs = r_rest.front().first;
-                        rbe = r_rest.front().second;
-                        r_rest.pop_front();
-                    }
-                    if (lbs == lbe)
-                    {
-                        lbs = l_rest.front().first;
-                        lbe = l_rest.front().second;
-                        l_rest.pop_front();
-                    }
-
-                    for(;;)
-                    {
-                        while (lbs < lbe && sd->m_r(*(lbs))) ++lbs;
-                        while (rbs < rbe && !sd->m_r(*(rbs))) ++rbs;
-                        if (lbs == lbe || rbs == rbe) break;
-                        std::swap(*lbs,*rbs);
-                    }
+                    task_res.set_exception(std::current_exception());
                 }
-
-                task_res.set_value(it_left_plus_rtrue);
-                return;
             });
         }
         catch(...)
@@ -373,6 +540,44 @@ struct parallel_partition_helper : public boost::asynchronous::continuation_task
         }
     }
 private:
+    // runs a stage of phase 2, then the next ones
+    static void run_fixup(boost::asynchronous::continuation_result<Iterator> task_res, std::shared_ptr<shared_data> msd,
+                          Iterator split, boost::asynchronous::detail::partition_fixup_stage stage)
+    {
+        auto c = boost::asynchronous::top_level_callback_continuation_job<void, JobType>
+                (boost::asynchronous::detail::partition_fixup_worker<shared_data, JobType>(msd.get(),stage,0,msd->fixup_tasks(stage)));
+        c.on_done(
+           [task_res, msd, split, stage]
+           (std::tuple<boost::asynchronous::expected<void> > res) mutable
+        {
+            try
+            {
+                std::get<0>(res).get();
+                switch (stage)
+                {
+                case boost::asynchronous::detail::partition_fixup_stage::count:
+                    msd->prepare_swaps();
+                    if (msd->m_misplaced == 0)
+                    {
+                        task_res.set_value(split);
+                        return;
+                    }
+                    parallel_partition_helper::run_fixup(task_res,msd,split,boost::asynchronous::detail::partition_fixup_stage::locate);
+                    break;
+                case boost::asynchronous::detail::partition_fixup_stage::locate:
+                    parallel_partition_helper::run_fixup(task_res,msd,split,boost::asynchronous::detail::partition_fixup_stage::swap);
+                    break;
+                case boost::asynchronous::detail::partition_fixup_stage::swap:
+                    task_res.set_value(split);
+                    break;
+                }
+            }
+            catch(...)
+            {
+                task_res.set_exception(std::current_exception());
+            }
+        });
+    }
     std::shared_ptr<shared_data> m_sd;
 };
 }
@@ -12,6 +12,7 @@
 
 #include <new>
 #include <exception>
+#include <cstdint>
 #include <boost/utility/enable_if.hpp>
 #include <boost/shared_array.hpp>
 
@@ -21,6 +22,10 @@
 #include <boost/asynchronous/algorithm/detail/safe_advance.hpp>
 #include <boost/asynchronous/detail/metafunctions.hpp>
 
+#ifndef BOOST_ASYNCHRONOUS_PAGE_SIZE
+#define BOOST_ASYNCHRONOUS_PAGE_SIZE 4096
+#endif
+
 namespace boost { namespace asynchronous
 {
 namespace detail
@@ -99,6 +104,23 @@ void serial_dtor(Iterator beg, Iterator end,char* data)
     }
 }
 
+// splits [beg,end) close to its middle but on a page boundary of data.
+// Every page is then constructed, i.e. first touched, by a single worker, so that the OS places it
+// on the NUMA node of this worker instead of the node of whichever neighbour touched it first.
+template <class T>
+std::size_t placement_split(std::size_t beg, std::size_t end, char const* data)
+{
+    const std::size_t middle = beg + (end-beg)/2;
+    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(data);
+    const std::uintptr_t middle_address = base + middle * sizeof(T);
+    const std::uintptr_t page = middle_address - middle_address % BOOST_ASYNCHRONOUS_PAGE_SIZE;
+    if (page <= base)
+        return middle;
+    // first element starting on this page
+    const std::size_t split = static_cast<std::size_t>((page - base + sizeof(T) - 1) / sizeof(T));
+    return (split > beg && split < end) ? split : middle;
+}
+
 template <class T, class Job>
 struct parallel_placement_helper: public boost::asynchronous::continuation_task<boost::asynchronous::detail::parallel_placement_helper_result>
 {
@@ -113,7 +135,8 @@ struct parallel_placement_helper: public boost::asynchronous::continuation_task<
         try
         {
             // advance up to cutoff
-            auto it =(end_-beg_ <= (std::size_t)cutoff_)? end_: beg_ + (end_-beg_)/2;
+            auto it =(end_-beg_ <= (std::size_t)boost::asynchronous::detail::default_cutoff(cutoff_))? end_:
+                        boost::asynchronous::detail::placement_split<T>(beg_,end_,(char const*)data_.get());
             // if not at end, recurse, otherwise execute here
             if (it == end_)
             {
@@ -237,7 +260,8 @@ struct parallel_placement_helper_raw: public boost::asynchronous::continuation_t
         try
         {
             // advance up to cutoff
-            auto it =(end_-beg_ <= (std::size_t)cutoff_)? end_: beg_ + (end_-beg_)/2;
+            auto it =(end_-beg_ <= (std::size_t)boost::asynchronous::detail::default_cutoff(cutoff_))? end_:
+                        boost::asynchronous::detail::placement_split<T>(beg_,end_,(char const*)data_);
             // if not at end, recurse, otherwise execute here
             if (it == end_)
             {
@@ -362,7 +386,8 @@ struct parallel_placement_iterators_helper: public boost::asynchronous::continua
         try
         {
             // advance up to cutoff
-            auto it =(end_-beg_ <= (std::size_t)cutoff_)? end_: beg_ + (end_-beg_)/2;
+            auto it =(end_-beg_ <= (std::size_t)boost::asynchronous::detail::default_cutoff(cutoff_))? end_:
+                        boost::asynchronous::detail::placement_split<T>(beg_,end_,(char const*)data_.get());
             auto it2 = beg2_;
             // if not at end, recurse, otherwise execute here
             if (it == end_)
@@ -489,7 +514,7 @@ struct parallel_placement_delete_helper: public boost::asynchronous::continuatio
         try
         {
             // advance up to cutoff
-            auto it =(end_-beg_ <= (std::size_t)cutoff_)? end_: beg_ + (end_-beg_)/2;
+            auto it =(end_-beg_ <= (std::size_t)boost::asynchronous::detail::default_cutoff(cutoff_))? end_: beg_ + (end_-beg_)/2;
             // if not at end, recurse, otherwise execute here
             if (it == end_)
             {
@@ -0,0 +1,741 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+#ifndef BOOST_ASYNCHRONOUS_PARALLEL_RADIX_SORT_HPP
+#define BOOST_ASYNCHRONOUS_PARALLEL_RADIX_SORT_HPP
+
+#include <vector>
+#include <memory>
+#include <iterator> // for std::iterator_traits
+#include <type_traits>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+#include <boost/asynchronous/callable_any.hpp>
+#include <boost/asynchronous/detail/continuation_impl.hpp>
+#include <boost/asynchronous/continuation_task.hpp>
+#include <boost/asynchronous/algorithm/detail/safe_advance.hpp>
+#include <boost/asynchronous/detail/metafunctions.hpp>
+#include <boost/asynchronous/algorithm/detail/parallel_sort_helper.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+
+// size of the per-bucket buffers used to write sorted elements by blocks instead of one by one
+#ifndef BOOST_ASYNCHRONOUS_RADIX_SORT_WRITE_COMBINING_BYTES
+#define BOOST_ASYNCHRONOUS_RADIX_SORT_WRITE_COMBINING_BYTES 256
+#endif
+// upper limit of histograms per pass, bigger inputs get bigger chunks than cutoff
+#ifndef BOOST_ASYNCHRONOUS_RADIX_SORT_MAX_CHUNKS
+#define BOOST_ASYNCHRONOUS_RADIX_SORT_MAX_CHUNKS 512
+#endif
+// inputs from this number of elements are sorted MSD first if their most significant byte spreads them evenly enough
+#ifndef BOOST_ASYNCHRONOUS_RADIX_SORT_MSD_MIN_SIZE
+#define BOOST_ASYNCHRONOUS_RADIX_SORT_MSD_MIN_SIZE 1000000
+#endif
+// MSD is not used if a bucket of the most significant byte gets more than 1/BOOST_ASYNCHRONOUS_RADIX_SORT_MSD_MAX_BUCKET_SHARE of the elements
+#ifndef BOOST_ASYNCHRONOUS_RADIX_SORT_MSD_MAX_BUCKET_SHARE
+#define BOOST_ASYNCHRONOUS_RADIX_SORT_MSD_MAX_BUCKET_SHARE 16
+#endif
+
+namespace boost { namespace asynchronous
+{
+// maps a key to an unsigned integer of the same size, ordered like the key
+template <class Key, class Enable=void>
+struct radix_key_traits;
+
+template <class Key>
+struct radix_key_traits<Key,typename std::enable_if<std::is_integral<Key>::value && std::is_unsigned<Key>::value &&
+                                                    !std::is_same<Key,bool>::value>::type>
+{
+    typedef Key unsigned_type;
+    static unsigned_type to_unsigned(Key k)
+    {
+        return k;
+    }
+};
+template <class Key>
+struct radix_key_traits<Key,typename std::enable_if<std::is_integral<Key>::value && std::is_signed<Key>::value>::type>
+{
+    typedef typename std::make_unsigned<Key>::type unsigned_type;
+    static unsigned_type to_unsigned(Key k)
+    {
+        // negative numbers before positive ones
+        return static_cast<unsigned_type>(k) ^ (unsigned_type(1) << (sizeof(Key)*8-1));
+    }
+};
+template <class Key>
+struct radix_key_traits<Key,typename std::enable_if<std::is_floating_point<Key>::value && (sizeof(Key)==4 || sizeof(Key)==8)>::type>
+{
+    typedef typename std::conditional<sizeof(Key)==4,std::uint32_t,std::uint64_t>::type unsigned_type;
+    static unsigned_type to_unsigned(Key k)
+    {
+        unsigned_type u;
+        std::memcpy(&u,&k,sizeof(Key));
+        // IEEE 754: negative numbers are ordered backwards, flip them all, positive numbers only get the sign bit
+        const unsigned_type sign = unsigned_type(1) << (sizeof(Key)*8-1);
+        return (u & sign) ? static_cast<unsigned_type>(~u) : static_cast<unsigned_type>(u | sign);
+    }
+};
+
+// key function for elements which are their own key
+struct radix_identity
+{
+    template <class T>
+    T const& operator()(T const& t)const
+    {
+        return t;
+    }
+};
+
+namespace detail
+{
+// keys are sorted one byte per pass
+const std::size_t radix_buckets = 256;
+// buckets of the MSD pass up to this size are sorted with std::stable_sort
+const std::size_t radix_small_bucket = 64;
+
+// state shared by all tasks of a sort.
+// The input is cut in chunks. Each pass sorts on one byte of the key:
+// every chunk counts its keys per bucket, the offsets of every chunk in every bucket are calculated from these histograms
+// and every chunk moves its elements to their bucket in the other buffer.
+template <class Iterator, class KeyFunc>
+struct parallel_radix_sort_data
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+    typedef typename std::decay<decltype(std::declval<KeyFunc>()(*std::declval<Iterator>()))>::type key_type;
+    typedef boost::asynchronous::radix_key_traits<key_type> key_traits;
+    typedef typename key_traits::unsigned_type unsigned_key;
+    static const std::size_t digits = sizeof(unsigned_key);
+    static const std::size_t write_combining_size =
+            (BOOST_ASYNCHRONOUS_RADIX_SORT_WRITE_COMBINING_BYTES / sizeof(value_type)) > 0 ?
+                (BOOST_ASYNCHRONOUS_RADIX_SORT_WRITE_COMBINING_BYTES / sizeof(value_type)) : 1;
+
+    parallel_radix_sort_data(Iterator beg, std::size_t size, KeyFunc key, std::size_t chunk_size)
+        : beg_(beg), size_(size), key_(std::move(key)), chunk_size_(chunk_size)
+        , chunks_((size + chunk_size - 1) / chunk_size)
+        , scratch_(new value_type[size])
+        , counts_(chunks_ * digits * radix_buckets,0)
+        , offsets_(chunks_ * radix_buckets,0)
+        , bucket_begin_(digits * radix_buckets,0)
+        , moves_(0)
+    {
+    }
+    std::size_t digit(value_type const& v, std::size_t d)const
+    {
+        return static_cast<std::size_t>((key_traits::to_unsigned(key_(v)) >> (d*8)) & 0xFF);
+    }
+    std::size_t* counts(std::size_t chunk, std::size_t d)
+    {
+        return &counts_[(chunk * digits + d) * radix_buckets];
+    }
+    std::size_t chunk_begin(std::size_t chunk)const
+    {
+        return chunk * chunk_size_;
+    }
+    std::size_t chunk_end(std::size_t chunk)const
+    {
+        return std::min(size_,(chunk + 1) * chunk_size_);
+    }
+    // histograms of all bytes of the keys of a chunk, in one reading
+    void count_all(std::size_t chunk)
+    {
+        for (std::size_t i = chunk_begin(chunk); i < chunk_end(chunk); ++i)
+        {
+            unsigned_key k = key_traits::to_unsigned(key_(beg_[i]));
+            for (std::size_t d = 0; d < digits; ++d)
+            {
+                ++counts(chunk,d)[(k >> (d*8)) & 0xFF];
+            }
+        }
+    }
+    // the total count of every bucket does not depend on the order of the elements, its start is known after count_all
+    void calculate_bucket_begins()
+    {
+        for (std::size_t d = 0; d < digits; ++d)
+        {
+            std::size_t sum = 0;
+            for (std::size_t b = 0; b < radix_buckets; ++b)
+            {
+                bucket_begin_[d * radix_buckets + b] = sum;
+                for (std::size_t c = 0; c < chunks_; ++c)
+                {
+                    sum += counts(c,d)[b];
+                }
+            }
+        }
+    }
+    std::size_t bucket_size(std::size_t d, std::size_t b)const
+    {
+        std::size_t const end = (b + 1 < radix_buckets) ? bucket_begin_[d * radix_buckets + b + 1] : size_;
+        return end - bucket_begin_[d * radix_buckets + b];
+    }
+    // highest byte which is not the same for all keys, digits if none
+    std::size_t top_digit()const
+    {
+        for (std::size_t d = digits; d > 0; --d)
+        {
+            if (!is_trivial(d-1))
+                return d-1;
+        }
+        return digits;
+    }
+    // MSD first: one parallel pass on the top byte, then every bucket is sorted on its own, in cache, without synchronization.
+    // Only if the input is big enough to gain from it and the buckets are balanced enough to keep all threads busy
+    bool use_msd(std::size_t top)const
+    {
+        if (top == 0 || top == digits || size_ < BOOST_ASYNCHRONOUS_RADIX_SORT_MSD_MIN_SIZE)
+            return false;
+        for (std::size_t b = 0; b < radix_buckets; ++b)
+        {
+            if (bucket_size(top,b) * BOOST_ASYNCHRONOUS_RADIX_SORT_MSD_MAX_BUCKET_SHARE > size_)
+                return false;
+        }
+        return true;
+    }
+    // a pass is useless if all keys have the same byte
+    bool is_trivial(std::size_t d)const
+    {
+        for (std::size_t b = 0; b < radix_buckets; ++b)
+        {
+            std::size_t const end = (b + 1 < radix_buckets) ? bucket_begin_[d * radix_buckets + b + 1] : size_;
+            std::size_t const count = end - bucket_begin_[d * radix_buckets + b];
+            if (count == size_)
+                return true;
+            if (count != 0)
+                return false;
+        }
+        return false;
+    }
+    template <class It>
+    void count(It src, std::size_t chunk, std::size_t d)
+    {
+        std::size_t* c = counts(chunk,d);
+        std::fill(c,c+radix_buckets,0);
+        for (std::size_t i = chunk_begin(chunk); i < chunk_end(chunk); ++i)
+        {
+            ++c[digit(src[i],d)];
+        }
+    }
+    // offsets of chunks within one bucket: prefix sum over the chunks
+    void calculate_offsets(std::size_t bucket, std::size_t d)
+    {
+        std::size_t pos = bucket_begin_[d * radix_buckets + bucket];
+        for (std::size_t c = 0; c < chunks_; ++c)
+        {
+            offsets_[c * radix_buckets + bucket] = pos;
+            pos += counts(c,d)[bucket];
+        }
+    }
+    template <class It, class Out>
+    void scatter(It src, Out dst, std::size_t chunk, std::size_t d)
+    {
+        std::size_t* offsets = &offsets_[chunk * radix_buckets];
+        if (write_combining_size == 1)
+        {
+            for (std::size_t i = chunk_begin(chunk); i < chunk_end(chunk); ++i)
+            {
+                dst[offsets[digit(src[i],d)]++] = std::move(src[i]);
+            }
+            return;
+        }
+        // software write-combining: elements are gathered per bucket and written by blocks of a few cache lines,
+        // which keeps the writes sequential instead of touching a new cache line for every element
+        std::unique_ptr<value_type[]> buffer(new value_type[radix_buckets * write_combining_size]);
+        std::size_t filled[radix_buckets] = {0};
+        for (std::size_t i = chunk_begin(chunk); i < chunk_end(chunk); ++i)
+        {
+            std::size_t const b = digit(src[i],d);
+            value_type* bucket_buffer = buffer.get() + b * write_combining_size;
+            bucket_buffer[filled[b]++] = std::move(src[i]);
+            if (filled[b] == write_combining_size)
+            {
+                std::move(bucket_buffer,bucket_buffer + write_combining_size,dst + offsets[b]);
+                offsets[b] += write_combining_size;
+                filled[b] = 0;
+            }
+        }
+        for (std::size_t b = 0; b < radix_buckets; ++b)
+        {
+            value_type* bucket_buffer = buffer.get() + b * write_combining_size;
+            std::move(bucket_buffer,bucket_buffer + filled[b],dst + offsets[b]);
+            offsets[b] += filled[b];
+        }
+    }
+
+    // after the MSD pass: sequential LSD radix sort of one bucket of the top byte on the lower bytes, from scratch_ to the input
+    void sort_bucket(std::size_t bucket, std::size_t top)
+    {
+        std::size_t const first = bucket_begin_[top * radix_buckets + bucket];
+        std::size_t const n = bucket_size(top,bucket);
+        value_type* src = scratch_.get() + first;
+        Iterator dst = beg_ + first;
+        if (n <= radix_small_bucket)
+        {
+            KeyFunc const& key = key_;
+            std::stable_sort(src,src + n,
+                             [&key](value_type const& lhs, value_type const& rhs)
+                             {
+                                 return key_traits::to_unsigned(key(lhs)) < key_traits::to_unsigned(key(rhs));
+                             });
+            std::move(src,src + n,dst);
+            return;
+        }
+        // histograms of all lower bytes in one reading
+        std::vector<std::size_t> counts(top * radix_buckets,0);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            unsigned_key k = key_traits::to_unsigned(key_(src[i]));
+            for (std::size_t d = 0; d < top; ++d)
+            {
+                ++counts[d * radix_buckets + ((k >> (d*8)) & 0xFF)];
+            }
+        }
+        bool in_scratch = true;
+        std::size_t offsets[radix_buckets];
+        for (std::size_t d = 0; d < top; ++d)
+        {
+            std::size_t const* c = &counts[d * radix_buckets];
+            std::size_t sum = 0;
+            bool trivial = false;
+            for (std::size_t b = 0; b < radix_buckets; ++b)
+            {
+                trivial = trivial || c[b] == n;
+                offsets[b] = sum;
+                sum += c[b];
+            }
+            if (trivial)
+                continue;
+            if (in_scratch)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    dst[offsets[digit(src[i],d)]++] = std::move(src[i]);
+                }
+            }
+            else
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    src[offsets[digit(dst[i],d)]++] = std::move(dst[i]);
+                }
+            }
+            in_scratch = !in_scratch;
+        }
+        if (in_scratch)
+            std::move(src,src + n,dst);
+    }
+
+    Iterator beg_;
+    std::size_t size_;
+    KeyFunc key_;
+    std::size_t chunk_size_;
+    std::size_t chunks_;
+    std::unique_ptr<value_type[]> scratch_;
+    // per chunk and byte, the number of elements of every bucket
+    std::vector<std::size_t> counts_;
+    // per chunk, the next position in every bucket of the current pass
+    std::vector<std::size_t> offsets_;
+    // per byte, the first position of every bucket
+    std::vector<std::size_t> bucket_begin_;
+    // number of passes executed, if odd, the data is in scratch_
+    std::size_t moves_;
+};
+
+template <class Data,class Job>
+void parallel_radix_sort_pass(std::shared_ptr<Data> data, std::size_t d,
+                              boost::asynchronous::continuation_result<void> task_res,
+                              std::string const& task_name, std::size_t prio);
+
+// moves back to the input if needed, then done
+template <class Data,class Job>
+void parallel_radix_sort_done(std::shared_ptr<Data> data,
+                              boost::asynchronous::continuation_result<void> task_res,
+                              std::string const& task_name, std::size_t prio)
+{
+    if (data->moves_ % 2 == 0)
+    {
+        task_res.set_value();
+        return;
+    }
+    auto cont = boost::asynchronous::detail::parallel_sort_for_index<Job>(data->chunks_,
+                    [data](std::size_t chunk)
+                    {
+                        std::move(data->scratch_.get() + data->chunk_begin(chunk),data->scratch_.get() + data->chunk_end(chunk),
+                                  data->beg_ + data->chunk_begin(chunk));
+                    },
+                    task_name,prio);
+    cont.on_done([task_res](std::tuple<boost::asynchronous::expected<void> >&& res) mutable
+    {
+        try
+        {
+            std::get<0>(res).get();
+            task_res.set_value();
+        }
+        catch(...)
+        {
+            task_res.set_exception(std::current_exception());
+        }
+    });
+}
+
+// after the MSD pass, every bucket gets sorted into the input
+template <class Data,class Job>
+void parallel_radix_sort_buckets(std::shared_ptr<Data> data, std::size_t top,
+                                 boost::asynchronous::continuation_result<void> task_res,
+                                 std::string const& task_name, std::size_t prio)
+{
+    auto cont = boost::asynchronous::detail::parallel_sort_for_index<Job>(radix_buckets,
+                    [data,top](std::size_t bucket)
+                    {
+                        data->sort_bucket(bucket,top);
+                    },
+                    task_name,prio);
+    cont.on_done([task_res](std::tuple<boost::asynchronous::expected<void> >&& res) mutable
+    {
+        try
+        {
+            std::get<0>(res).get();
+            task_res.set_value();
+        }
+        catch(...)
+        {
+            task_res.set_exception(std::current_exception());
+        }
+    });
+}
+
+// after counting digit d: offsets, then moving the elements to their buckets,
+// then the next digit (LSD) or the sort of every bucket (MSD)
+template <class Data,class Job>
+void parallel_radix_sort_move(std::shared_ptr<Data> data, std::size_t d, bool msd,
+                              boost::asynchronous::continuation_result<void> task_res,
+                              std::string const& task_name, std::size_t prio)
+{
+    // one task per 16 buckets
+    const std::size_t bucket_group = 16;
+    auto cont = boost::asynchronous::detail::parallel_sort_for_index<Job>(radix_buckets / bucket_group,
+                    [data,d](std::size_t group)
+                    {
+                        for (std::size_t b = group * bucket_group; b < (group + 1) * bucket_group; ++b)
+                        {
+                            data->calculate_offsets(b,d);
+                        }
+                    },
+                    task_name,prio);
+    cont.on_done([data,d,msd,task_res,task_name,prio](std::tuple<boost::asynchronous::expected<void> >&& res) mutable
+    {
+        try
+        {
+            std::get<0>(res).get();
+            auto cont2 = boost::asynchronous::detail::parallel_sort_for_index<Job>(data->chunks_,
+                            [data,d](std::size_t chunk)
+                            {
+                                if (data->moves_ % 2 == 0)
+                                    data->scatter(data->beg_,data->scratch_.get(),chunk,d);
+                                else
+                                    data->scatter(data->scratch_.get(),data->beg_,chunk,d);
+                            },
+                            task_name,prio);
+            cont2.on_done([data,d,msd,task_res,task_name,prio](std::tuple<boost::asynchronous::expected<void> >&& res2) mutable
+            {
+                try
+                {
+                    std::get<0>(res2).get();
+                    ++data->moves_;
+                    if (msd)
+                        boost::asynchronous::detail::parallel_radix_sort_buckets<Data,Job>(data,d,task_res,task_name,prio);
+                    else
+                        boost::asynchronous::detail::parallel_radix_sort_pass<Data,Job>(data,d+1,task_res,task_name,prio);
+                }
+                catch(...)
+                {
+                    task_res.set_exception(std::current_exception());
+                }
+            });
+        }
+        catch(...)
+        {
+            task_res.set_exception(std::current_exception());
+        }
+    });
+}
+
+template <class Data,class Job>
+void parallel_radix_sort_pass(std::shared_ptr<Data> data, std::size_t d,
+                              boost::asynchronous::continuation_result<void> task_res,
+                              std::string const& task_name, std::size_t prio)
+{
+    // skip bytes which are the same for all keys
+    while (d < Data::digits && data->is_trivial(d))
+    {
+        ++d;
+    }
+    if (d == Data::digits)
+    {
+        boost::asynchronous::detail::parallel_radix_sort_done<Data,Job>(data,task_res,task_name,prio);
+        return;
+    }
+    if (data->moves_ == 0)
+    {
+        // the histograms of the first pass are still valid
+        boost::asynchronous::detail::parallel_radix_sort_move<Data,Job>(data,d,false,task_res,task_name,prio);
+        return;
+    }
+    auto cont = boost::asynchronous::detail::parallel_sort_for_index<Job>(data->chunks_,
+                    [data,d](std::size_t chunk)
+                    {
+                        if (data->moves_ % 2 == 0)
+                            data->count(data->beg_,chunk,d);
+                        else
+                            data->count(data->scratch_.get(),chunk,d);
+                    },
+                    task_name,prio);
+    cont.on_done([data,d,task_res,task_name,prio](std::tuple<boost::asynchronous::expected<void> >&& res) mutable
+    {
+        try
+        {
+            std::get<0>(res).get();
+            boost::asynchronous::detail::parallel_radix_sort_move<Data,Job>(data,d,false,task_res,task_name,prio);
+        }
+        catch(...)
+        {
+            task_res.set_exception(std::current_exception());
+        }
+    });
+}
+
+template <class Iterator,class KeyFunc, class Job>
+struct parallel_radix_sort_helper: public boost::asynchronous::continuation_task<void>
+{
+    parallel_radix_sort_helper(Iterator beg, Iterator end,KeyFunc key,long cutoff,const std::string& task_name, std::size_t prio)
+        : boost::asynchronous::continuation_task<void>(task_name)
+        , beg_(beg),end_(end),key_(std::move(key)),cutoff_(cutoff),prio_(prio)
+    {
+    }
+    void operator()()
+    {
+        typedef boost::asynchronous::detail::parallel_radix_sort_data<Iterator,KeyFunc> data_type;
+        boost::asynchronous::continuation_result<void> task_res = this_task_result();
+        try
+        {
+            std::size_t const size = static_cast<std::size_t>(std::distance(beg_,end_));
+            std::size_t const cutoff = static_cast<std::size_t>(boost::asynchronous::detail::default_cutoff(cutoff_));
+            if (size <= cutoff)
+            {
+                // not worth the buffers, radix sort is stable, so is this one
+                auto key = key_;
+                std::stable_sort(beg_,end_,
+                                 [&key](typename data_type::value_type const& lhs, typename data_type::value_type const& rhs)
+                                 {
+                                     return data_type::key_traits::to_unsigned(key(lhs)) < data_type::key_traits::to_unsigned(key(rhs));
+                                 });
+                task_res.set_value();
+                return;
+            }
+            std::size_t const chunk_size = std::max(cutoff,(size + BOOST_ASYNCHRONOUS_RADIX_SORT_MAX_CHUNKS - 1) / BOOST_ASYNCHRONOUS_RADIX_SORT_MAX_CHUNKS);
+            auto data = std::make_shared<data_type>(beg_,size,std::move(key_),chunk_size);
+            auto task_name = this->get_name();
+            auto prio = prio_;
+            auto cont = boost::asynchronous::detail::parallel_sort_for_index<Job>(data->chunks_,
+                            [data](std::size_t chunk)
+                            {
+                                data->count_all(chunk);
+                            },
+                            task_name,prio);
+            cont.on_done([data,task_res,task_name,prio](std::tuple<boost::asynchronous::expected<void> >&& res) mutable
+            {
+                try
+                {
+                    std::get<0>(res).get();
+                    data->calculate_bucket_begins();
+                    std::size_t const top = data->top_digit();
+                    if (data->use_msd(top))
+                        boost::asynchronous::detail::parallel_radix_sort_move<data_type,Job>(data,top,true,task_res,task_name,prio);
+                    else
+                        boost::asynchronous::detail::parallel_radix_sort_pass<data_type,Job>(data,0,task_res,task_name,prio);
+                }
+                catch(...)
+                {
+                    task_res.set_exception(std::current_exception());
+                }
+            });
+        }
+        catch(...)
+        {
+            task_res.set_exception(std::current_exception());
+        }
+    }
+    Iterator beg_;
+    Iterator end_;
+    KeyFunc key_;
+    long cutoff_;
+    std::size_t prio_;
+};
+}
+
+/*!
+ * \brief Stable radix sort of a random access range of integral or floating point keys or of elements with such a key.
+ * \brief Big ranges evenly spread by the most significant byte are sorted MSD first, other ranges LSD.
+ * \brief Needs a buffer as big as the range.
+ * \param key returns the key of an element, radix_identity for elements which are keys
+ * \param cutoff minimum number of elements per task. Smaller ranges are sorted with std::stable_sort
+ */
+// fast version for iterators => will return nothing
+template <class Iterator,class KeyFunc, class Job=BOOST_ASYNCHRONOUS_DEFAULT_JOB>
+boost::asynchronous::detail::callback_continuation<void,Job>
+parallel_radix_sort(Iterator beg, Iterator end,KeyFunc key,long cutoff,
+#ifdef BOOST_ASYNCHRONOUS_REQUIRE_ALL_ARGUMENTS
+                    const std::string& task_name, std::size_t prio=0)
+#else
+                    const std::string& task_name="", std::size_t prio=0)
+#endif
+{
+    return boost::asynchronous::top_level_callback_continuation_job<void,Job>
+            (boost::asynchronous::detail::parallel_radix_sort_helper<Iterator,KeyFunc,Job>
+              (beg,end,std::move(key),cutoff,task_name,prio));
+}
+
+// version for moved ranges => will return the range as continuation
+template <class Range, class KeyFunc, class Job=BOOST_ASYNCHRONOUS_DEFAULT_JOB>
+typename std::enable_if<!boost::asynchronous::detail::has_is_continuation_task<Range>::value,
+                        boost::asynchronous::detail::callback_continuation<Range,Job> >::type
+parallel_radix_sort(Range&& range,KeyFunc key,long cutoff,
+#ifdef BOOST_ASYNCHRONOUS_REQUIRE_ALL_ARGUMENTS
+                    const std::string& task_name, std::size_t prio=0)
+#else
+                    const std::string& task_name="", std::size_t prio=0)
+#endif
+{
+    auto r = std::make_shared<Range>(std::forward<Range>(range));
+    auto beg = boost::begin(*r);
+    auto end = boost::end(*r);
+    return boost::asynchronous::top_level_callback_continuation_job<Range,Job>
+            (boost::asynchronous::detail::parallel_sort_range_move_helper<boost::asynchronous::detail::callback_continuation<void,Job>,Range>
+             (boost::asynchronous::parallel_radix_sort<decltype(boost::begin(*r)),KeyFunc,Job>
+                                (beg,end,std::move(key),cutoff,task_name,prio),r,task_name));
+}
+
+// version for ranges given as continuation => will return the range as continuation
+namespace detail
+{
+// adapter to non-callback continuations
+template <class Continuation, class KeyFunc, class Job,class Enable=void>
+struct parallel_radix_sort_continuation_range_helper: public boost::asynchronous::continuation_task<typename Continuation::return_type>
+{
+    parallel_radix_sort_continuation_range_helper(Continuation const& c,KeyFunc key,long cutoff,
+                                                  const std::string& task_name, std::size_t prio)
+        :boost::asynchronous::continuation_task<typename Continuation::return_type>(task_name)
+        ,cont_(c),key_(std::move(key)),cutoff_(cutoff),prio_(prio)
+    {}
+    void operator()()
+    {
+        boost::asynchronous::continuation_result<typename Continuation::return_type> task_res = this->this_task_result();
+        try
+        {
+            auto key(std::move(key_));
+            auto cutoff = cutoff_;
+            auto task_name = this->get_name();
+            auto prio = prio_;
+            cont_.on_done([task_res,key,cutoff,task_name,prio](std::tuple<std::future<typename Continuation::return_type> >&& continuation_res)
+            {
+                try
+                {
+                    auto new_continuation = boost::asynchronous::parallel_radix_sort<typename Continuation::return_type, KeyFunc, Job>
+                            (std::move(std::get<0>(continuation_res).get()),key,cutoff,task_name,prio);
+                    new_continuation.on_done([task_res](std::tuple<boost::asynchronous::expected<typename Continuation::return_type> >&& new_continuation_res) mutable
+                    {
+                        task_res.set_value(std::move(std::get<0>(new_continuation_res).get()));
+                    });
+                }
+                catch(...)
+                {
+                    task_res.set_exception(std::current_exception());
+                }
+            }
+            );
+            boost::asynchronous::any_continuation ac(std::move(cont_));
+            boost::asynchronous::get_continuations().emplace_front(std::move(ac));
+        }
+        catch(...)
+        {
+            task_res.set_exception(std::current_exception());
+        }
+    }
+    Continuation cont_;
+    KeyFunc key_;
+    long cutoff_;
+    std::size_t prio_;
+};
+// Continuation is a callback continuation
+template <class Continuation, class KeyFunc, class Job>
+struct parallel_radix_sort_continuation_range_helper<Continuation,KeyFunc,Job,
+                                                     typename std::enable_if< boost::asynchronous::detail::has_is_callback_continuation_task<Continuation>::value >::type>:
+        public boost::asynchronous::continuation_task<typename Continuation::return_type>
+{
+    parallel_radix_sort_continuation_range_helper(Continuation const& c,KeyFunc key,long cutoff,
+                                                  const std::string& task_name, std::size_t prio)
+        :boost::asynchronous::continuation_task<typename Continuation::return_type>(task_name)
+        ,cont_(c),key_(std::move(key)),cutoff_(cutoff),prio_(prio)
+    {}
+    void operator()()
+    {
+        boost::asynchronous::continuation_result<typename Continuation::return_type> task_res = this->this_task_result();
+        try
+        {
+            auto key(std::move(key_));
+            auto cutoff = cutoff_;
+            auto task_name = this->get_name();
+            auto prio = prio_;
+            cont_.on_done([task_res,key,cutoff,task_name,prio](std::tuple<boost::asynchronous::expected<typename Continuation::return_type> >&& continuation_res)
+            {
+                try
+                {
+                    auto new_continuation = boost::asynchronous::parallel_radix_sort<typename Continuation::return_type, KeyFunc, Job>
+                            (std::move(std::get<0>(continuation_res).get()),key,cutoff,task_name,prio);
+                    new_continuation.on_done([task_res](std::tuple<boost::asynchronous::expected<typename Continuation::return_type> >&& new_continuation_res) mutable
+                    {
+                        task_res.set_value(std::move(std::get<0>(new_continuation_res).get()));
+                    });
+                }
+                catch(...)
+                {
+                    task_res.set_exception(std::current_exception());
+                }
+            }
+            );
+        }
+        catch(...)
+        {
+            task_res.set_exception(std::current_exception());
+        }
+    }
+    Continuation cont_;
+    KeyFunc key_;
+    long cutoff_;
+    std::size_t prio_;
+};
+}
+template <class Range, class KeyFunc, class Job=typename Range::job_type>
+typename std::enable_if<boost::asynchronous::detail::has_is_continuation_task<Range>::value,
+                        boost::asynchronous::detail::callback_continuation<typename Range::return_type,Job> >::type
+parallel_radix_sort(Range range,KeyFunc key,long cutoff,
+#ifdef BOOST_ASYNCHRONOUS_REQUIRE_ALL_ARGUMENTS
+                    const std::string& task_name, std::size_t prio=0)
+#else
+                    const std::string& task_name="", std::size_t prio=0)
+#endif
+{
+    return boost::asynchronous::top_level_callback_continuation_job<typename Range::return_type,Job>
+            (boost::asynchronous::detail::parallel_radix_sort_continuation_range_helper<Range,KeyFunc,Job>
+             (range,std::move(key),cutoff,task_name,prio));
+}
+
+}}
+#endif // BOOST_ASYNCHRONOUS_PARALLEL_RADIX_SORT_HPP
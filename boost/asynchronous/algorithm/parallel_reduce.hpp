@@ -24,6 +24,7 @@
 #include <boost/asynchronous/scheduler/serializable_task.hpp>
 #include <boost/asynchronous/algorithm/detail/safe_advance.hpp>
 #include <boost/asynchronous/detail/metafunctions.hpp>
+#include <boost/asynchronous/algorithm/detail/simd_kernels.hpp>
 #include <boost/asynchronous/detail/function_traits.hpp>
 
 #include <boost/range/begin.hpp>
@@ -40,7 +41,11 @@ ReturnType reduce(Iterator begin, Iterator end, Func fn) {
     // if range is empty, return a default-constructed element
     if (begin == end)
         return ReturnType();
-    ReturnType t = *(begin++);
+    ReturnType t = *begin;
+    // parallel_extremum on contiguous arithmetic ranges
+    if (boost::asynchronous::detail::simd::reduce(begin, end, fn, t))
+        return t;
+    ++begin;
     for (; begin != end; ++begin) {
         t = fn(t, *begin);
     }
@@ -90,11 +95,15 @@ struct parallel_reduce_helper: public boost::asynchronous::continuation_task<Ret
         try
         {
             // advance up to cutoff
-            Iterator it = boost::asynchronous::detail::find_cutoff(beg_,cutoff_,end_);
+            Iterator it = boost::asynchronous::detail::find_cutoff(
+                        beg_,boost::asynchronous::detail::effective_cutoff<parallel_reduce_helper>(cutoff_),end_);
             // if not at end, recurse, otherwise execute here
             if (it == end_)
             {
-                task_res.set_value(std::move(boost::asynchronous::detail::reduce_helper<Iterator, Func, ReturnType>()(beg_,it,std::move(func_))));
+                boost::asynchronous::detail::cutoff_timer<parallel_reduce_helper> timer(cutoff_,beg_,it);
+                ReturnType res = boost::asynchronous::detail::reduce_helper<Iterator, Func, ReturnType>()(beg_,it,std::move(func_));
+                timer.stop();
+                task_res.set_value(std::move(res));
             }
             else
             {
@@ -183,12 +192,17 @@ struct parallel_reduce_range_move_helper: public boost::asynchronous::continuati
         try
         {
             std::shared_ptr<Range> range = std::move(range_);
+            typedef boost::asynchronous::detail::parallel_reduce_helper<decltype(boost::begin(*range)),Func,Func2,ReturnType,Job> leaf_type;
             // advance up to cutoff
-            auto it = boost::asynchronous::detail::find_cutoff(boost::begin(*range),cutoff_,boost::end(*range));
+            auto it = boost::asynchronous::detail::find_cutoff(
+                        boost::begin(*range),boost::asynchronous::detail::effective_cutoff<leaf_type>(cutoff_),boost::end(*range));
             // if not at end, recurse, otherwise execute here
             if (it == boost::end(*range))
             {
-                task_res.set_value(std::move(boost::asynchronous::detail::reduce_helper<decltype(it), Func, ReturnType>()(boost::begin(*range),it,std::move(func_))));
+                boost::asynchronous::detail::cutoff_timer<leaf_type> timer(cutoff_,boost::begin(*range),it);
+                ReturnType res = boost::asynchronous::detail::reduce_helper<decltype(it), Func, ReturnType>()(boost::begin(*range),it,std::move(func_));
+                timer.stop();
+                task_res.set_value(std::move(res));
             }
             else
             {
@@ -250,11 +264,15 @@ struct parallel_reduce_range_move_helper<Range,Func,Func2,ReturnType,Job,typenam
         try
         {
             // advance up to cutoff
-            auto it = boost::asynchronous::detail::find_cutoff(begin_,cutoff_,end_);
+            auto it = boost::asynchronous::detail::find_cutoff(
+                        begin_,boost::asynchronous::detail::effective_cutoff<parallel_reduce_range_move_helper>(cutoff_),end_);
             // if not at end, recurse, otherwise execute here
             if (it == end_)
             {
-                task_res.set_value(std::move(boost::asynchronous::detail::reduce_helper<decltype(it), Func, ReturnType>()(begin_,it,std::move(func_))));
+                boost::asynchronous::detail::cutoff_timer<parallel_reduce_range_move_helper> timer(cutoff_,begin_,it);
+                ReturnType res = boost::asynchronous::detail::reduce_helper<decltype(it), Func, ReturnType>()(begin_,it,std::move(func_));
+                timer.stop();
+                task_res.set_value(std::move(res));
             }
             else
             {
@@ -380,12 +398,17 @@ struct parallel_reduce_range_helper: public boost::asynchronous::continuation_ta
         boost::asynchronous::continuation_result<ReturnType> task_res = this->this_task_result();
         try
         {
+            typedef parallel_reduce_helper<decltype(boost::begin(range_)),Func,Func2,ReturnType,Job> leaf_type;
             // advance up to cutoff
-            auto it = boost::asynchronous::detail::find_cutoff(boost::begin(range_),cutoff_,boost::end(range_));
+            auto it = boost::asynchronous::detail::find_cutoff(
+                        boost::begin(range_),boost::asynchronous::detail::effective_cutoff<leaf_type>(cutoff_),boost::end(range_));
             // if not at end, recurse, otherwise execute here
             if (it == boost::end(range_))
             {
-                task_res.set_value(std::move(boost::asynchronous::detail::reduce_helper<decltype(it), Func, ReturnType>()(boost::begin(range_),it,std::move(func_))));
+                boost::asynchronous::detail::cutoff_timer<leaf_type> timer(cutoff_,boost::begin(range_),it);
+                ReturnType res = boost::asynchronous::detail::reduce_helper<decltype(it), Func, ReturnType>()(boost::begin(range_),it,std::move(func_));
+                timer.stop();
+                task_res.set_value(std::move(res));
             }
             else
             {
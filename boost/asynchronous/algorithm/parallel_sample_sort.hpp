@@ -0,0 +1,611 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+#ifndef BOOST_ASYNCHRONOUS_PARALLEL_SAMPLE_SORT_HPP
+#define BOOST_ASYNCHRONOUS_PARALLEL_SAMPLE_SORT_HPP
+
+#include <vector>
+#include <memory>
+#include <iterator> // for std::iterator_traits
+#include <type_traits>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+
+#include <boost/thread/thread.hpp>
+
+#include <boost/asynchronous/callable_any.hpp>
+#include <boost/asynchronous/detail/continuation_impl.hpp>
+#include <boost/asynchronous/continuation_task.hpp>
+#include <boost/asynchronous/algorithm/detail/safe_advance.hpp>
+#include <boost/asynchronous/detail/metafunctions.hpp>
+#include <boost/asynchronous/algorithm/detail/parallel_sort_helper.hpp>
+#include <boost/asynchronous/algorithm/parallel_partition.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+
+// buckets per thread. More buckets than threads balance the bucket sorts
+#ifndef BOOST_ASYNCHRONOUS_SAMPLE_SORT_BUCKETS_PER_THREAD
+#define BOOST_ASYNCHRONOUS_SAMPLE_SORT_BUCKETS_PER_THREAD 4
+#endif
+// upper limit of buckets (not counting buckets of equal elements)
+#ifndef BOOST_ASYNCHRONOUS_SAMPLE_SORT_MAX_BUCKETS
+#define BOOST_ASYNCHRONOUS_SAMPLE_SORT_MAX_BUCKETS 256
+#endif
+// sample elements taken per bucket to choose the splitters
+#ifndef BOOST_ASYNCHRONOUS_SAMPLE_SORT_OVERSAMPLING
+#define BOOST_ASYNCHRONOUS_SAMPLE_SORT_OVERSAMPLING 16
+#endif
+// upper limit of histograms of the distribution pass, bigger inputs get bigger chunks than cutoff
+#ifndef BOOST_ASYNCHRONOUS_SAMPLE_SORT_MAX_CHUNKS
+#define BOOST_ASYNCHRONOUS_SAMPLE_SORT_MAX_CHUNKS 512
+#endif
+
+namespace boost { namespace asynchronous
+{
+namespace detail
+{
+// splitters chosen from a sorted random sample, without duplicates.
+// A splitter found more than once in the sample is likely to be frequent, its elements get their own bucket
+template <class Value>
+struct sample_sort_splitters
+{
+    std::vector<Value> values_;
+    // values_[i] was duplicated in the sample
+    std::vector<char> frequent_;
+    bool has_frequent_ = false;
+};
+
+template <class Iterator, class Func>
+boost::asynchronous::detail::sample_sort_splitters<typename std::iterator_traits<Iterator>::value_type>
+make_sample_sort_splitters(Iterator beg, std::size_t size, std::size_t buckets, Func& func)
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+    boost::asynchronous::detail::sample_sort_splitters<value_type> res;
+    std::size_t const oversampling = BOOST_ASYNCHRONOUS_SAMPLE_SORT_OVERSAMPLING;
+    // fixed seed: same input, same buckets
+    std::minstd_rand rng(static_cast<std::minstd_rand::result_type>(size));
+    std::uniform_int_distribution<std::size_t> dis(0,size-1);
+    std::vector<value_type> sample;
+    sample.reserve(buckets * oversampling);
+    for (std::size_t i = 0; i < buckets * oversampling; ++i)
+    {
+        sample.push_back(beg[dis(rng)]);
+    }
+    std::sort(sample.begin(),sample.end(),func);
+    for (std::size_t i = 1; i < buckets; ++i)
+    {
+        value_type const& s = sample[i * oversampling];
+        if (!res.values_.empty() && !func(res.values_.back(),s))
+        {
+            res.frequent_.back() = 1;
+            res.has_frequent_ = true;
+        }
+        else
+        {
+            res.values_.push_back(s);
+            res.frequent_.push_back(0);
+        }
+    }
+    return res;
+}
+
+// state shared by all tasks of a sort with a scratch buffer.
+// The input is cut in chunks. Every chunk finds the bucket of its elements and counts them,
+// the position of every chunk in every bucket is calculated from these histograms,
+// then every chunk moves its elements to their bucket in the scratch buffer.
+// The buckets are then sorted independently and moved back.
+template <class Iterator, class Func>
+struct parallel_sample_sort_data
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+    parallel_sample_sort_data(Iterator beg, std::size_t size, Func func, std::size_t chunk_size,
+                              boost::asynchronous::detail::sample_sort_splitters<value_type> splitters)
+        : beg_(beg), size_(size), func_(std::move(func)), chunk_size_(chunk_size)
+        , chunks_((size + chunk_size - 1) / chunk_size)
+        , splitters_(std::move(splitters))
+        // with frequent splitters, every splitter has a bucket for itself, between the buckets of the values around it
+        , buckets_(splitters_.has_frequent_ ? 2 * splitters_.values_.size() + 1 : splitters_.values_.size() + 1)
+        , oracle_(size)
+        , counts_(chunks_ * buckets_,0)
+        , bucket_begin_(buckets_ + 1,0)
+        , sorted_(chunks_,0)
+        , reverse_sorted_(chunks_,0)
+    {
+    }
+    std::size_t chunk_begin(std::size_t chunk)const
+    {
+        return chunk * chunk_size_;
+    }
+    std::size_t chunk_end(std::size_t chunk)const
+    {
+        return std::min(size_,(chunk + 1) * chunk_size_);
+    }
+    std::size_t find_bucket(value_type const& v)
+    {
+        std::vector<value_type> const& s = splitters_.values_;
+        std::size_t const j = static_cast<std::size_t>(std::upper_bound(s.begin(),s.end(),v,func_) - s.begin());
+        if (!splitters_.has_frequent_)
+            return j;
+        // v >= s[j-1], if not greater, it is equal
+        if (j > 0 && !func_(s[j-1],v))
+            return 2 * j - 1;
+        return 2 * j;
+    }
+    // elements of an equal bucket need no sorting
+    bool is_equal_bucket(std::size_t bucket)const
+    {
+        return splitters_.has_frequent_ && (bucket % 2 == 1);
+    }
+    // one reading of the input: bucket of every element and histogram of the chunk.
+    // Also checks if the chunk is already sorted or reverse sorted
+    void classify(std::size_t chunk)
+    {
+        std::size_t* counts = &counts_[chunk * buckets_];
+        bool sorted = true;
+        bool reverse_sorted = true;
+        for (std::size_t i = chunk_begin(chunk); i < chunk_end(chunk); ++i)
+        {
+            std::size_t const b = find_bucket(beg_[i]);
+            oracle_[i] = static_cast<std::uint16_t>(b);
+            ++counts[b];
+            if ((sorted || reverse_sorted) && i > chunk_begin(chunk))
+            {
+                sorted = sorted && !func_(beg_[i],beg_[i-1]);
+                reverse_sorted = reverse_sorted && !func_(beg_[i-1],beg_[i]);
+            }
+        }
+        sorted_[chunk] = sorted;
+        reverse_sorted_[chunk] = reverse_sorted;
+    }
+    // checks the borders between chunks
+    bool is_sorted()
+    {
+        for (std::size_t c = 0; c < chunks_; ++c)
+        {
+            if (!sorted_[c] || (c > 0 && func_(beg_[chunk_begin(c)],beg_[chunk_begin(c)-1])))
+                return false;
+        }
+        return true;
+    }
+    bool is_reverse_sorted()
+    {
+        for (std::size_t c = 0; c < chunks_; ++c)
+        {
+            if (!reverse_sorted_[c] || (c > 0 && func_(beg_[chunk_begin(c)-1],beg_[chunk_begin(c)])))
+                return false;
+        }
+        return true;
+    }
+    // swaps a chunk of the first half with its mirror in the second half
+    void reverse(std::size_t chunk)
+    {
+        std::size_t const end = std::min(size_ / 2,chunk_end(chunk));
+        for (std::size_t i = chunk_begin(chunk); i < end; ++i)
+        {
+            std::iter_swap(beg_ + i,beg_ + (size_ - 1 - i));
+        }
+    }
+    // prefix sum over buckets then chunks. Afterwards counts_ contains the position of every chunk in every bucket
+    void calculate_offsets()
+    {
+        std::size_t pos = 0;
+        for (std::size_t b = 0; b < buckets_; ++b)
+        {
+            bucket_begin_[b] = pos;
+            for (std::size_t c = 0; c < chunks_; ++c)
+            {
+                std::size_t const count = counts_[c * buckets_ + b];
+                counts_[c * buckets_ + b] = pos;
+                pos += count;
+            }
+        }
+        bucket_begin_[buckets_] = pos;
+    }
+    void scatter(std::size_t chunk)
+    {
+        std::size_t* offsets = &counts_[chunk * buckets_];
+        for (std::size_t i = chunk_begin(chunk); i < chunk_end(chunk); ++i)
+        {
+            scratch_[offsets[oracle_[i]]++] = std::move(beg_[i]);
+        }
+    }
+    // sorts a bucket while it is in the cache, then moves it back at the same position
+    void sort_bucket(std::size_t bucket)
+    {
+        value_type* first = scratch_.get() + bucket_begin_[bucket];
+        value_type* last = scratch_.get() + bucket_begin_[bucket+1];
+        if (!is_equal_bucket(bucket))
+        {
+            std::sort(first,last,func_);
+        }
+        std::move(first,last,beg_ + bucket_begin_[bucket]);
+    }
+
+    Iterator beg_;
+    std::size_t size_;
+    Func func_;
+    std::size_t chunk_size_;
+    std::size_t chunks_;
+    boost::asynchronous::detail::sample_sort_splitters<value_type> splitters_;
+    std::size_t buckets_;
+    // bucket of every element, saves a second search when scattering
+    std::vector<std::uint16_t> oracle_;
+    // per chunk, the number of elements of every bucket, then the next position in every bucket
+    std::vector<std::size_t> counts_;
+    // first position of every bucket, and size_
+    std::vector<std::size_t> bucket_begin_;
+    // allocated only if the input needs to be distributed
+    std::unique_ptr<value_type[]> scratch_;
+    std::vector<char> sorted_;
+    std::vector<char> reverse_sorted_;
+};
+
+// number of buckets for a given input
+inline std::size_t sample_sort_buckets(std::size_t size, std::size_t cutoff, uint32_t thread_num)
+{
+    // a cutoff of 0 means every element could be a task
+    cutoff = std::max<std::size_t>(cutoff,1);
+    std::size_t buckets = std::max<std::size_t>(1,thread_num) * BOOST_ASYNCHRONOUS_SAMPLE_SORT_BUCKETS_PER_THREAD;
+    buckets = std::min<std::size_t>(buckets,BOOST_ASYNCHRONOUS_SAMPLE_SORT_MAX_BUCKETS);
+    buckets = std::min<std::size_t>(buckets,std::max<std::size_t>(2,size / cutoff));
+    return buckets;
+}
+
+template <class Iterator,class Func, class Job>
+struct parallel_sample_sort_helper: public boost::asynchronous::continuation_task<void>
+{
+    parallel_sample_sort_helper(Iterator beg, Iterator end,Func func,long cutoff,uint32_t thread_num,
+                                const std::string& task_name, std::size_t prio)
+        : boost::asynchronous::continuation_task<void>(task_name)
+        , beg_(beg),end_(end),func_(std::move(func)),cutoff_(cutoff),thread_num_(thread_num),prio_(prio)
+    {
+    }
+    void operator()()
+    {
+        typedef boost::asynchronous::detail::parallel_sample_sort_data<Iterator,Func> data_type;
+        boost::asynchronous::continuation_result<void> task_res = this_task_result();
+        try
+        {
+            std::size_t const size = static_cast<std::size_t>(std::distance(beg_,end_));
+            std::size_t const cutoff = static_cast<std::size_t>(boost::asynchronous::detail::default_cutoff(cutoff_));
+            if (size <= cutoff)
+            {
+                std::sort(beg_,end_,func_);
+                task_res.set_value();
+                return;
+            }
+            std::size_t const buckets = boost::asynchronous::detail::sample_sort_buckets(size,cutoff,thread_num_);
+            auto splitters = boost::asynchronous::detail::make_sample_sort_splitters(beg_,size,buckets,func_);
+            std::size_t const chunk_size =
+                    std::max(cutoff,(size + BOOST_ASYNCHRONOUS_SAMPLE_SORT_MAX_CHUNKS - 1) / BOOST_ASYNCHRONOUS_SAMPLE_SORT_MAX_CHUNKS);
+            auto data = std::make_shared<data_type>(beg_,size,std::move(func_),chunk_size,std::move(splitters));
+            auto task_name = this->get_name();
+            auto prio = prio_;
+            auto cont = boost::asynchronous::detail::parallel_sort_for_index<Job>(data->chunks_,
+                            [data](std::size_t chunk)
+                            {
+                                data->classify(chunk);
+                            },
+                            task_name,prio);
+            cont.on_done([data,task_res,task_name,prio](std::tuple<boost::asynchronous::expected<void> >&& res) mutable
+            {
+                try
+                {
+                    std::get<0>(res).get();
+                    if (data->is_sorted())
+                    {
+                        task_res.set_value();
+                        return;
+                    }
+                    if (data->is_reverse_sorted())
+                    {
+                        auto cont_reverse = boost::asynchronous::detail::parallel_sort_for_index<Job>(
+                                        (data->size_ / 2 + data->chunk_size_ - 1) / data->chunk_size_,
+                                        [data](std::size_t chunk)
+                                        {
+                                            data->reverse(chunk);
+                                        },
+                                        task_name,prio);
+                        cont_reverse.on_done([data,task_res](std::tuple<boost::asynchronous::expected<void> >&& res_reverse) mutable
+                        {
+                            try
+                            {
+                                std::get<0>(res_reverse).get();
+                                task_res.set_value();
+                            }
+                            catch(...)
+                            {
+                                task_res.set_exception(std::current_exception());
+                            }
+                        });
+                        return;
+                    }
+                    data->calculate_offsets();
+                    data->scratch_.reset(new typename data_type::value_type[data->size_]);
+                    auto cont2 = boost::asynchronous::detail::parallel_sort_for_index<Job>(data->chunks_,
+                                    [data](std::size_t chunk)
+                                    {
+                                        data->scatter(chunk);
+                                    },
+                                    task_name,prio);
+                    cont2.on_done([data,task_res,task_name,prio](std::tuple<boost::asynchronous::expected<void> >&& res2) mutable
+                    {
+                        try
+                        {
+                            std::get<0>(res2).get();
+                            auto cont3 = boost::asynchronous::detail::parallel_sort_for_index<Job>(data->buckets_,
+                                            [data](std::size_t bucket)
+                                            {
+                                                data->sort_bucket(bucket);
+                                            },
+                                            task_name,prio);
+                            cont3.on_done([data,task_res](std::tuple<boost::asynchronous::expected<void> >&& res3) mutable
+                            {
+                                try
+                                {
+                                    std::get<0>(res3).get();
+                                    task_res.set_value();
+                                }
+                                catch(...)
+                                {
+                                    task_res.set_exception(std::current_exception());
+                                }
+                            });
+                        }
+                        catch(...)
+                        {
+                            task_res.set_exception(std::current_exception());
+                        }
+                    });
+                }
+                catch(...)
+                {
+                    task_res.set_exception(std::current_exception());
+                }
+            });
+        }
+        catch(...)
+        {
+            task_res.set_exception(std::current_exception());
+        }
+    }
+    Iterator beg_;
+    Iterator end_;
+    Func func_;
+    long cutoff_;
+    uint32_t thread_num_;
+    std::size_t prio_;
+};
+
+// in-place version: partitions around the middle splitter, then both halves with the remaining splitters
+template <class Iterator,class Func, class Job>
+struct parallel_sample_sort_inplace_helper: public boost::asynchronous::continuation_task<void>
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+    typedef boost::asynchronous::detail::sample_sort_splitters<value_type> splitters_type;
+
+    parallel_sample_sort_inplace_helper(Iterator beg, Iterator end,Func func,long cutoff,uint32_t thread_num,
+                                        std::shared_ptr<splitters_type> splitters, std::size_t splitter_beg, std::size_t splitter_end,
+                                        const std::string& task_name, std::size_t prio)
+        : boost::asynchronous::continuation_task<void>(task_name)
+        , beg_(beg),end_(end),func_(std::move(func)),cutoff_(cutoff),thread_num_(thread_num)
+        , splitters_(std::move(splitters)),splitter_beg_(splitter_beg),splitter_end_(splitter_end),prio_(prio)
+    {
+    }
+    void operator()()
+    {
+        boost::asynchronous::continuation_result<void> task_res = this_task_result();
+        try
+        {
+            std::size_t const size = static_cast<std::size_t>(std::distance(beg_,end_));
+            std::size_t const cutoff = static_cast<std::size_t>(boost::asynchronous::detail::default_cutoff(cutoff_));
+            if (!splitters_)
+            {
+                // top-level task
+                if (size > cutoff)
+                {
+                    std::size_t const buckets = boost::asynchronous::detail::sample_sort_buckets(size,cutoff,thread_num_);
+                    splitters_ = std::make_shared<splitters_type>(
+                                boost::asynchronous::detail::make_sample_sort_splitters(beg_,size,buckets,func_));
+                    splitter_end_ = splitters_->values_.size();
+                }
+            }
+            if (size <= cutoff || splitter_beg_ == splitter_end_)
+            {
+                // one bucket
+                std::sort(beg_,end_,func_);
+                task_res.set_value();
+                return;
+            }
+            std::size_t const middle = splitter_beg_ + (splitter_end_ - splitter_beg_) / 2;
+            value_type const pivot = splitters_->values_[middle];
+            bool const frequent = splitters_->frequent_[middle] != 0;
+            auto func = func_;
+            auto l = [pivot,func](value_type const& i)
+            {
+                return func(i,pivot);
+            };
+            auto beg = beg_;
+            auto end = end_;
+            auto cutoff_in = cutoff_;
+            auto thread_num = thread_num_;
+            auto splitters = splitters_;
+            auto splitter_beg = splitter_beg_;
+            auto splitter_end = splitter_end_;
+            auto task_name = this->get_name();
+            auto prio = prio_;
+            auto cont = boost::asynchronous::parallel_partition<Iterator,decltype(l),Job>(beg,end,std::move(l),thread_num,task_name,prio);
+            cont.on_done([task_res,beg,end,pivot,frequent,func,cutoff_in,thread_num,splitters,splitter_beg,middle,splitter_end,task_name,prio]
+                         (std::tuple<boost::asynchronous::expected<Iterator> >&& res) mutable
+            {
+                try
+                {
+                    Iterator it = std::get<0>(res).get();
+                    if (!frequent)
+                    {
+                        // [beg,it) gets the splitters before the pivot, [it,end) the pivot and those after it
+                        boost::asynchronous::detail::parallel_sample_sort_inplace_helper<Iterator,Func,Job>::recurse(
+                                    task_res,beg,it,it,end,func,cutoff_in,thread_num,splitters,
+                                    splitter_beg,middle,middle+1,splitter_end,task_name,prio);
+                        return;
+                    }
+                    // the pivot is frequent, move its equal elements out of the way, they are sorted
+                    auto equal = [pivot,func](value_type const& i)
+                    {
+                        return !func(pivot,i);
+                    };
+                    auto cont2 = boost::asynchronous::parallel_partition<Iterator,decltype(equal),Job>(it,end,std::move(equal),thread_num,task_name,prio);
+                    cont2.on_done([task_res,beg,it,end,func,cutoff_in,thread_num,splitters,splitter_beg,middle,splitter_end,task_name,prio]
+                                  (std::tuple<boost::asynchronous::expected<Iterator> >&& res2) mutable
+                    {
+                        try
+                        {
+                            Iterator it2 = std::get<0>(res2).get();
+                            boost::asynchronous::detail::parallel_sample_sort_inplace_helper<Iterator,Func,Job>::recurse(
+                                        task_res,beg,it,it2,end,func,cutoff_in,thread_num,splitters,
+                                        splitter_beg,middle,middle+1,splitter_end,task_name,prio);
+                        }
+                        catch(...)
+                        {
+                            task_res.set_exception(std::current_exception());
+                        }
+                    });
+                }
+                catch(...)
+                {
+                    task_res.set_exception(std::current_exception());
+                }
+            });
+        }
+        catch(...)
+        {
+            task_res.set_exception(std::current_exception());
+        }
+    }
+    // sorts [beg1,end1) with splitters [s1,e1) and [beg2,end2) with splitters [s2,e2)
+    static void recurse(boost::asynchronous::continuation_result<void> task_res,
+                        Iterator beg1, Iterator end1, Iterator beg2, Iterator end2, Func const& func, long cutoff, uint32_t thread_num,
+                        std::shared_ptr<splitters_type> const& splitters, std::size_t s1, std::size_t e1, std::size_t s2, std::size_t e2,
+                        std::string const& task_name, std::size_t prio)
+    {
+        boost::asynchronous::create_callback_continuation_job<Job>(
+                    [task_res](std::tuple<boost::asynchronous::expected<void>,boost::asynchronous::expected<void> > res) mutable
+                    {
+                        try
+                        {
+                            // get to check that no exception
+                            std::get<0>(res).get();
+                            std::get<1>(res).get();
+                            task_res.set_value();
+                        }
+                        catch(...)
+                        {
+                            task_res.set_exception(std::current_exception());
+                        }
+                    },
+                    // recursive tasks
+                    boost::asynchronous::detail::parallel_sample_sort_inplace_helper<Iterator,Func,Job>
+                            (beg1,end1,func,cutoff,thread_num,splitters,s1,e1,task_name,prio),
+                    boost::asynchronous::detail::parallel_sample_sort_inplace_helper<Iterator,Func,Job>
+                            (beg2,end2,func,cutoff,thread_num,splitters,s2,e2,task_name,prio)
+        );
+    }
+    Iterator beg_;
+    Iterator end_;
+    Func func_;
+    long cutoff_;
+    uint32_t thread_num_;
+    std::shared_ptr<splitters_type> splitters_;
+    std::size_t splitter_beg_;
+    std::size_t splitter_end_;
+    std::size_t prio_;
+};
+}
+
+/*!
+ * \brief Sample sort: distributes the elements into buckets delimited by splitters taken from a random sample in one parallel pass,
+ * \brief then sorts the buckets independently. Needs a buffer as big as the range.
+ * \param cutoff minimum number of elements per task. Smaller ranges are sorted with std::sort
+ * \param thread_num the sort uses thread_num * BOOST_ASYNCHRONOUS_SAMPLE_SORT_BUCKETS_PER_THREAD buckets
+ */
+// fast version for iterators => will return nothing
+template <class Iterator,class Func, class Job=BOOST_ASYNCHRONOUS_DEFAULT_JOB>
+boost::asynchronous::detail::callback_continuation<void,Job>
+parallel_sample_sort(Iterator beg, Iterator end,Func func,long cutoff,
+#ifdef BOOST_ASYNCHRONOUS_REQUIRE_ALL_ARGUMENTS
+                     const uint32_t thread_num,const std::string& task_name, std::size_t prio=0)
+#else
+                     const uint32_t thread_num = boost::thread::hardware_concurrency(),const std::string& task_name="", std::size_t prio=0)
+#endif
+{
+    return boost::asynchronous::top_level_callback_continuation_job<void,Job>
+            (boost::asynchronous::detail::parallel_sample_sort_helper<Iterator,Func,Job>
+              (beg,end,std::move(func),cutoff,thread_num,task_name,prio));
+}
+
+/*!
+ * \brief Sample sort without buffer: the range is partitioned in place around the splitters,
+ * \brief which needs log2(buckets) partitioning passes instead of one.
+ */
+template <class Iterator,class Func, class Job=BOOST_ASYNCHRONOUS_DEFAULT_JOB>
+boost::asynchronous::detail::callback_continuation<void,Job>
+parallel_sample_sort_inplace(Iterator beg, Iterator end,Func func,long cutoff,
+#ifdef BOOST_ASYNCHRONOUS_REQUIRE_ALL_ARGUMENTS
+                             const uint32_t thread_num,const std::string& task_name, std::size_t prio=0)
+#else
+                             const uint32_t thread_num = boost::thread::hardware_concurrency(),const std::string& task_name="", std::size_t prio=0)
+#endif
+{
+    return boost::asynchronous::top_level_callback_continuation_job<void,Job>
+            (boost::asynchronous::detail::parallel_sample_sort_inplace_helper<Iterator,Func,Job>
+              (beg,end,std::move(func),cutoff,thread_num,nullptr,0,0,task_name,prio));
+}
+
+// version for moved ranges => will return the range as continuation
+template <class Range, class Func, class Job=BOOST_ASYNCHRONOUS_DEFAULT_JOB>
+typename std::enable_if<!boost::asynchronous::detail::has_is_continuation_task<Range>::value,
+                        boost::asynchronous::detail::callback_continuation<Range,Job> >::type
+parallel_sample_sort(Range&& range,Func func,long cutoff,
+#ifdef BOOST_ASYNCHRONOUS_REQUIRE_ALL_ARGUMENTS
+                     const uint32_t thread_num,const std::string& task_name, std::size_t prio=0)
+#else
+                     const uint32_t thread_num = boost::thread::hardware_concurrency(),const std::string& task_name="", std::size_t prio=0)
+#endif
+{
+    auto r = std::make_shared<Range>(std::forward<Range>(range));
+    auto beg = boost::begin(*r);
+    auto end = boost::end(*r);
+    return boost::asynchronous::top_level_callback_continuation_job<Range,Job>
+            (boost::asynchronous::detail::parallel_sort_range_move_helper<boost::asynchronous::detail::callback_continuation<void,Job>,Range>
+             (boost::asynchronous::parallel_sample_sort<decltype(boost::begin(*r)),Func,Job>
+                                (beg,end,std::move(func),cutoff,thread_num,task_name,prio),r,task_name));
+}
+template <class Range, class Func, class Job=BOOST_ASYNCHRONOUS_DEFAULT_JOB>
+typename std::enable_if<!boost::asynchronous::detail::has_is_continuation_task<Range>::value,
+                        boost::asynchronous::detail::callback_continuation<Range,Job> >::type
+parallel_sample_sort_inplace(Range&& range,Func func,long cutoff,
+#ifdef BOOST_ASYNCHRONOUS_REQUIRE_ALL_ARGUMENTS
+                             const uint32_t thread_num,const std::string& task_name, std::size_t prio=0)
+#else
+                             const uint32_t thread_num = boost::thread::hardware_concurrency(),const std::string& task_name="", std::size_t prio=0)
+#endif
+{
+    auto r = std::make_shared<Range>(std::forward<Range>(range));
+    auto beg = boost::begin(*r);
+    auto end = boost::end(*r);
+    return boost::asynchronous::top_level_callback_continuation_job<Range,Job>
+            (boost::asynchronous::detail::parallel_sort_range_move_helper<boost::asynchronous::detail::callback_continuation<void,Job>,Range>
+             (boost::asynchronous::parallel_sample_sort_inplace<decltype(boost::begin(*r)),Func,Job>
+                                (beg,end,std::move(func),cutoff,thread_num,task_name,prio),r,task_name));
+}
+
+}}
+#endif // BOOST_ASYNCHRONOUS_PARALLEL_SAMPLE_SORT_HPP
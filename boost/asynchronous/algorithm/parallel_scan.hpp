@@ -11,6 +11,9 @@
 #define BOOST_ASYNCHRONOUS_PARALLEL_SCAN_HPP
 
 #include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
 
 #include <type_traits>
 #include <boost/range/begin.hpp>
@@ -45,9 +48,9 @@ template <class Iterator, class T, class Reduce, class Combine, class Job>
 struct parallel_scan_part1_helper: public boost::asynchronous::continuation_task<boost::asynchronous::detail::scan_data<T>>
 {
     parallel_scan_part1_helper(Iterator beg, Iterator end, Reduce r, Combine c,
-                            long cutoff, const std::string& task_name, std::size_t prio)
+                            long cutoff, const std::string& task_name, std::size_t prio, bool adapt_cutoff=false)
         : boost::asynchronous::continuation_task<boost::asynchronous::detail::scan_data<T>>(task_name)
-        , beg_(beg),end_(end), reduce_(std::move(r)), combine_(std::move(c)), cutoff_(cutoff),prio_(prio)
+        , beg_(beg),end_(end), reduce_(std::move(r)), combine_(std::move(c)), cutoff_(cutoff),prio_(prio),adapt_cutoff_(adapt_cutoff)
     {}
     void operator()()
     {
@@ -58,7 +61,11 @@ struct parallel_scan_part1_helper: public boost::asynchronous::continuation_task
             Iterator it = boost::asynchronous::detail::find_cutoff(beg_,cutoff_,end_);
             if (it == end_)
             {
-                task_res.set_value(boost::asynchronous::detail::scan_data<T>(std::move(reduce_(beg_,end_))));
+                boost::asynchronous::detail::cutoff_timer<parallel_scan_part1_helper> timer(
+                            adapt_cutoff_ ? boost::asynchronous::auto_cutoff : cutoff_,beg_,end_);
+                boost::asynchronous::detail::scan_data<T> res(std::move(reduce_(beg_,end_)));
+                timer.stop();
+                task_res.set_value(std::move(res));
             }
             else
             {
@@ -85,9 +92,9 @@ struct parallel_scan_part1_helper: public boost::asynchronous::continuation_task
                             },
                             // recursive tasks
                             parallel_scan_part1_helper<Iterator,T,Reduce,Combine,Job>
-                                (beg_,it,reduce_,combine_,cutoff_,this->get_name(),prio_),
+                                (beg_,it,reduce_,combine_,cutoff_,this->get_name(),prio_,adapt_cutoff_),
                             parallel_scan_part1_helper<Iterator,T,Reduce,Combine,Job>
-                                (it,end_,reduce_,combine_,cutoff_,this->get_name(),prio_)
+                                (it,end_,reduce_,combine_,cutoff_,this->get_name(),prio_,adapt_cutoff_)
                 );
             }
         }
@@ -103,6 +110,8 @@ struct parallel_scan_part1_helper: public boost::asynchronous::continuation_task
     Combine combine_;
     long cutoff_;
     std::size_t prio_;
+    // cutoff_ was chosen by auto_cutoff, leaf tasks report their duration
+    bool adapt_cutoff_;
 };
 
 template <class Iterator, class T, class Reduce, class Combine, class Job=BOOST_ASYNCHRONOUS_DEFAULT_JOB>
@@ -110,14 +119,14 @@ boost::asynchronous::detail::callback_continuation<boost::asynchronous::detail::
 parallel_scan_part1(Iterator beg, Iterator end, T /*init*/,
                     Reduce r, Combine c,long cutoff,
 #ifdef BOOST_ASYNCHRONOUS_REQUIRE_ALL_ARGUMENTS
-                    const std::string& task_name, std::size_t prio=0)
+                    const std::string& task_name, std::size_t prio=0, bool adapt_cutoff=false)
 #else
-                    const std::string& task_name="", std::size_t prio=0)
+                    const std::string& task_name="", std::size_t prio=0, bool adapt_cutoff=false)
 #endif
 {
     return boost::asynchronous::top_level_callback_continuation_job<boost::asynchronous::detail::scan_data<T>,Job>
             (boost::asynchronous::detail::parallel_scan_part1_helper<Iterator,T,Reduce,Combine,Job>
-                (beg,end,std::move(r),std::move(c),cutoff,task_name,prio));
+                (beg,end,std::move(r),std::move(c),cutoff,task_name,prio,adapt_cutoff));
 
 }
 
@@ -254,12 +263,15 @@ struct parallel_scan_helper: public boost::asynchronous::continuation_task<T>
         boost::asynchronous::continuation_result<T> task_res = this->this_task_result();
         try
         {
+            // part 2 walks the tree built by part 1, so both have to split with the same cutoff
+            auto cutoff = boost::asynchronous::detail::effective_cutoff<
+                    boost::asynchronous::detail::parallel_scan_part1_helper<Iterator,T,Reduce,Combine,Job>>(cutoff_);
             auto cont = boost::asynchronous::detail::parallel_scan_part1<Iterator,T,Reduce,Combine,Job>
-                    (beg_,end_,init_,reduce_,combine_,cutoff_,this->get_name()+"_part1",prio_);
+                    (beg_,end_,init_,reduce_,combine_,cutoff,this->get_name()+"_part1",prio_,
+                     cutoff_ == boost::asynchronous::auto_cutoff);
             auto beg = beg_;
             auto end = end_;
             auto out = out_;
-            auto cutoff = cutoff_;
             auto task_name = this->get_name();
             auto prio = prio_;
             auto scan = scan_;
@@ -310,8 +322,224 @@ struct parallel_scan_helper: public boost::asynchronous::continuation_task<T>
     std::size_t prio_;
 };
 
+// single pass scan with decoupled look-back, for random access iterators.
+// The range is cut in chunks of cutoff elements. Leaf tasks take the next chunk in order (a ticket),
+// reduce it and publish its aggregate, then look back at the previous chunks, combining their aggregates
+// until finding one which already published its inclusive prefix. They publish their own inclusive prefix
+// and scan their chunk, which is still in cache. No intermediate tree, input is read from memory once.
+// A task only waits for chunks taken before its own, by tasks which are already executing, so this cannot deadlock.
+template <class T>
+struct scan_chunk_status
+{
+    enum {empty=0, aggregate_ready=1, prefix_ready=2, failed=3};
+    scan_chunk_status(): flag_(empty), aggregate_(), inclusive_(){}
+    std::atomic<int> flag_;
+    T aggregate_;
+    T inclusive_;
+};
+template <class T>
+struct scan_single_pass_data
+{
+    explicit scan_single_pass_data(std::size_t chunks)
+        : next_chunk_(0), chunks_(chunks), status_(new boost::asynchronous::detail::scan_chunk_status<T>[chunks])
+    {}
+    std::atomic<std::size_t> next_chunk_;
+    std::size_t chunks_;
+    std::unique_ptr<boost::asynchronous::detail::scan_chunk_status<T>[]> status_;
+};
+// thrown when a previous chunk failed, the exception of the failed chunk is reported instead
+struct scan_predecessor_failed{};
+
+template <class Iterator, class OutIterator, class T, class Reduce, class Combine, class Scan, class Job>
+struct parallel_scan_single_pass_helper: public boost::asynchronous::continuation_task<T>
+{
+    parallel_scan_single_pass_helper(Iterator beg, Iterator end, OutIterator out, T init,
+                                     Reduce r, Combine c, Scan s,
+                                     std::shared_ptr<boost::asynchronous::detail::scan_single_pass_data<T>> data,
+                                     std::size_t first_leaf, std::size_t last_leaf,
+                                     long cutoff, bool adapt_cutoff, const std::string& task_name, std::size_t prio)
+        : boost::asynchronous::continuation_task<T>(task_name)
+        , beg_(beg),end_(end), out_(out), init_(std::move(init))
+        , reduce_(std::move(r)), combine_(std::move(c)), scan_(std::move(s))
+        , data_(std::move(data)), first_leaf_(first_leaf), last_leaf_(last_leaf)
+        , cutoff_(cutoff), adapt_cutoff_(adapt_cutoff), prio_(prio)
+    {}
+    void operator()()
+    {
+        boost::asynchronous::continuation_result<T> task_res = this->this_task_result();
+        try
+        {
+            bool top_level = (first_leaf_ == 0 && last_leaf_ == data_->chunks_);
+            if (last_leaf_ - first_leaf_ == 1)
+            {
+                process_chunk();
+                // save performance by only setting result when top-level task
+                task_res.set_value(top_level ? data_->status_[data_->chunks_-1].inclusive_ : T());
+            }
+            else
+            {
+                std::size_t middle = first_leaf_ + (last_leaf_ - first_leaf_) / 2;
+                auto data = data_;
+                boost::asynchronous::create_callback_continuation_job<Job>(
+                            // called when subtasks are done, set our result
+                            [task_res,data,top_level](std::tuple<boost::asynchronous::expected<T>,
+                                                                 boost::asynchronous::expected<T>> res)mutable
+                            {
+                                try
+                                {
+                                    std::get<0>(res).get();
+                                    std::get<1>(res).get();
+                                    task_res.set_value(top_level ? data->status_[data->chunks_-1].inclusive_ : T());
+                                }
+                                catch(...)
+                                {
+                                    task_res.set_exception(std::current_exception());
+                                }
+                            },
+                            // recursive tasks
+                            parallel_scan_single_pass_helper<Iterator,OutIterator,T,Reduce,Combine,Scan,Job>
+                                (beg_,end_,out_,init_,reduce_,combine_,scan_,data_,first_leaf_,middle,
+                                 cutoff_,adapt_cutoff_,this->get_name(),prio_),
+                            parallel_scan_single_pass_helper<Iterator,OutIterator,T,Reduce,Combine,Scan,Job>
+                                (beg_,end_,out_,init_,reduce_,combine_,scan_,data_,middle,last_leaf_,
+                                 cutoff_,adapt_cutoff_,this->get_name(),prio_)
+                );
+            }
+        }
+        catch(...)
+        {
+            task_res.set_exception(std::current_exception());
+        }
+    }
+    // takes the next chunk in order and scans it
+    void process_chunk()
+    {
+        std::size_t chunk = data_->next_chunk_++;
+        boost::asynchronous::detail::scan_chunk_status<T>& status = data_->status_[chunk];
+        Iterator beg = beg_ + chunk * cutoff_;
+        Iterator end = (chunk + 1 == data_->chunks_) ? end_ : beg + cutoff_;
+        OutIterator out = out_ + chunk * cutoff_;
+        try
+        {
+            boost::asynchronous::detail::cutoff_timer<parallel_scan_single_pass_helper> timer(
+                        adapt_cutoff_ ? boost::asynchronous::auto_cutoff : cutoff_,beg,end);
+            T aggregate = reduce_(beg,end);
+            if (chunk == 0)
+            {
+                status.inclusive_ = aggregate;
+                status.flag_.store(boost::asynchronous::detail::scan_chunk_status<T>::prefix_ready,std::memory_order_release);
+                scan_(beg,end,out,init_);
+            }
+            else
+            {
+                status.aggregate_ = aggregate;
+                status.flag_.store(boost::asynchronous::detail::scan_chunk_status<T>::aggregate_ready,std::memory_order_release);
+                T exclusive = look_back(chunk);
+                status.inclusive_ = combine_(exclusive,aggregate);
+                status.flag_.store(boost::asynchronous::detail::scan_chunk_status<T>::prefix_ready,std::memory_order_release);
+                scan_(beg,end,out,combine_(init_,exclusive));
+            }
+            timer.stop();
+        }
+        catch(boost::asynchronous::detail::scan_predecessor_failed&)
+        {
+            // the chunk which failed reports its exception
+            status.flag_.store(boost::asynchronous::detail::scan_chunk_status<T>::failed,std::memory_order_release);
+        }
+        catch(...)
+        {
+            status.flag_.store(boost::asynchronous::detail::scan_chunk_status<T>::failed,std::memory_order_release);
+            throw;
+        }
+    }
+    // combines the aggregates of the previous chunks, up to the first one having published its inclusive prefix
+    T look_back(std::size_t chunk)
+    {
+        std::size_t pos = chunk - 1;
+        int flag = wait_for_chunk(pos);
+        T exclusive = (flag == boost::asynchronous::detail::scan_chunk_status<T>::prefix_ready) ?
+                    data_->status_[pos].inclusive_ : data_->status_[pos].aggregate_;
+        while (flag != boost::asynchronous::detail::scan_chunk_status<T>::prefix_ready)
+        {
+            // chunk 0 always publishes its prefix, we cannot go further
+            flag = wait_for_chunk(--pos);
+            exclusive = combine_((flag == boost::asynchronous::detail::scan_chunk_status<T>::prefix_ready) ?
+                                    data_->status_[pos].inclusive_ : data_->status_[pos].aggregate_,
+                                 exclusive);
+        }
+        return exclusive;
+    }
+    // the chunk has been taken by an executing task, which is reducing it
+    int wait_for_chunk(std::size_t pos)
+    {
+        int flag;
+        while ((flag = data_->status_[pos].flag_.load(std::memory_order_acquire)) ==
+               boost::asynchronous::detail::scan_chunk_status<T>::empty)
+        {
+            boost::this_thread::yield();
+        }
+        if (flag == boost::asynchronous::detail::scan_chunk_status<T>::failed)
+        {
+            throw boost::asynchronous::detail::scan_predecessor_failed();
+        }
+        return flag;
+    }
+
+    Iterator beg_;
+    Iterator end_;
+    OutIterator out_;
+    T init_;
+    Reduce reduce_;
+    Combine combine_;
+    Scan scan_;
+    std::shared_ptr<boost::asynchronous::detail::scan_single_pass_data<T>> data_;
+    std::size_t first_leaf_;
+    std::size_t last_leaf_;
+    long cutoff_;
+    // cutoff_ was chosen by auto_cutoff, leaf tasks report their duration
+    bool adapt_cutoff_;
+    std::size_t prio_;
+};
+
+// single pass needs to find chunks and cannot give the total to the scan functor before the end
+template <class Iterator, class OutIterator, class Scan>
+struct use_single_pass_scan : std::integral_constant<bool,
+        std::is_base_of<std::random_access_iterator_tag,typename std::iterator_traits<Iterator>::iterator_category>::value &&
+        std::is_base_of<std::random_access_iterator_tag,typename std::iterator_traits<OutIterator>::iterator_category>::value &&
+        boost::asynchronous::function_traits<Scan>::arity == 4>
+{};
+
+template <class Iterator, class OutIterator, class T, class Reduce, class Combine, class Scan, class Job>
+boost::asynchronous::detail::callback_continuation<T,Job>
+make_parallel_scan(Iterator beg, Iterator end, OutIterator out, T init, Reduce r, Combine c, Scan s,
+                   long cutoff, const std::string& task_name, std::size_t prio, std::true_type /*single pass*/)
+{
+    long chunk_size = boost::asynchronous::detail::effective_cutoff<
+            boost::asynchronous::detail::parallel_scan_single_pass_helper<Iterator,OutIterator,T,Reduce,Combine,Scan,Job>>(cutoff);
+    if (chunk_size < 1)
+        chunk_size = 1;
+    std::size_t size = static_cast<std::size_t>(std::distance(beg,end));
+    std::size_t chunks = std::max<std::size_t>(1,(size + chunk_size - 1) / chunk_size);
+    auto data = std::make_shared<boost::asynchronous::detail::scan_single_pass_data<T>>(chunks);
+    return boost::asynchronous::top_level_callback_continuation_job<T,Job>
+            (boost::asynchronous::detail::parallel_scan_single_pass_helper<Iterator,OutIterator,T,Reduce,Combine,Scan,Job>
+                (beg,end,out,std::move(init),std::move(r),std::move(c),std::move(s),std::move(data),0,chunks,
+                 chunk_size,cutoff == boost::asynchronous::auto_cutoff,task_name,prio));
+}
+template <class Iterator, class OutIterator, class T, class Reduce, class Combine, class Scan, class Job>
+boost::asynchronous::detail::callback_continuation<T,Job>
+make_parallel_scan(Iterator beg, Iterator end, OutIterator out, T init, Reduce r, Combine c, Scan s,
+                   long cutoff, const std::string& task_name, std::size_t prio, std::false_type /*single pass*/)
+{
+    return boost::asynchronous::top_level_callback_continuation_job<T,Job>
+            (boost::asynchronous::detail::parallel_scan_helper<Iterator,OutIterator,T,Reduce,Combine,Scan,Job>
+                (beg,end,out,std::move(init),std::move(r),std::move(c),std::move(s),cutoff,task_name,prio));
 }
 
+}
+
+// Random access ranges with a scan functor taking 4 arguments use a single pass with decoupled look-back,
+// other ranges reduce, then scan
 template <class Iterator, class OutIterator, class T, class Reduce, class Combine, class Scan,
           class Job=BOOST_ASYNCHRONOUS_DEFAULT_JOB>
 boost::asynchronous::detail::callback_continuation<T,Job>
@@ -324,10 +552,9 @@ parallel_scan(Iterator beg, Iterator end, OutIterator out, T init,
                     const std::string& task_name="", std::size_t prio=0)
 #endif
 {
-    return boost::asynchronous::top_level_callback_continuation_job<T,Job>
-            (boost::asynchronous::detail::parallel_scan_helper<Iterator,OutIterator,T,Reduce,Combine,Scan,Job>
-                (beg,end,out,std::move(init),std::move(r),std::move(c),std::move(s),cutoff,task_name,prio));
-
+    return boost::asynchronous::detail::make_parallel_scan<Iterator,OutIterator,T,Reduce,Combine,Scan,Job>
+            (beg,end,out,std::move(init),std::move(r),std::move(c),std::move(s),cutoff,task_name,prio,
+             boost::asynchronous::detail::use_single_pass_scan<Iterator,OutIterator,Scan>());
 }
 // version for moved ranges => will return the ranges (input + output) as continuation
 template <class Range, class OutRange, class T, class Reduce, class Combine, class Scan, class Job,class Enable=void>
@@ -66,10 +66,12 @@ struct parallel_sort_fast_helper: public boost::asynchronous::continuation_task<
         try
         {
             // advance up to cutoff
-            Iterator it = boost::asynchronous::detail::find_cutoff(beg,cutoff,end);
+            Iterator it = boost::asynchronous::detail::find_cutoff(
+                        beg,boost::asynchronous::detail::effective_cutoff<parallel_sort_fast_helper>(cutoff),end);
             // if not at end, recurse, otherwise execute here
             if ((it == end)&&(depth %2 == 0))
             {
+                boost::asynchronous::detail::cutoff_timer<parallel_sort_fast_helper> timer(cutoff,beg,it);
                 // if already reverse sorted, only reverse
                 if (std::is_sorted(beg,it,boost::asynchronous::detail::reverse_sorted<Func>(func)))
                 {
@@ -80,6 +82,7 @@ struct parallel_sort_fast_helper: public boost::asynchronous::continuation_task<
                 {
                     Sort()(beg,it,func);
                 }
+                timer.stop();
                 task_res.set_value();
             }
             else
@@ -185,9 +188,11 @@ struct parallel_sort_fast_helper: public boost::asynchronous::continuation_task<
         try
         {
             // do we need to parallelize? If not, no need to allocate memory and we save ourselves the else clause
-            auto it = boost::asynchronous::detail::find_cutoff(beg_,cutoff_,end_);
+            auto it = boost::asynchronous::detail::find_cutoff(
+                        beg_,boost::asynchronous::detail::effective_cutoff<parallel_sort_fast_helper>(cutoff_),end_);
             if ((depth_ == 0) && (end_ == it))
             {
+                boost::asynchronous::detail::cutoff_timer<parallel_sort_fast_helper> timer(cutoff_,beg_,it);
                 // if already reverse sorted, only reverse
                 if (std::is_sorted(beg_,it,boost::asynchronous::detail::reverse_sorted<Func>(func_)))
                 {
@@ -198,6 +203,7 @@ struct parallel_sort_fast_helper: public boost::asynchronous::continuation_task<
                 {
                     Sort()(beg_,it,func_);
                 }
+                timer.stop();
                 task_res.set_value();
                 return;
             }
@@ -551,12 +557,14 @@ struct parallel_sort_range_move_helper_serializable
                        boost::asynchronous::continuation_result<Range> task_res)
     {
         // advance up to cutoff
-        auto it = boost::asynchronous::detail::find_cutoff(beg,cutoff,end);
+        auto it = boost::asynchronous::detail::find_cutoff(
+                    beg,boost::asynchronous::detail::effective_cutoff<parallel_sort_range_move_helper_serializable>(cutoff),end);
         try
         {
             // if not at end, recurse, otherwise execute here
             if (it == end)
             {
+                boost::asynchronous::detail::cutoff_timer<parallel_sort_range_move_helper_serializable> timer(cutoff,beg,it);
                 // if already reverse sorted, only reverse
                 if (std::is_sorted(beg,it,boost::asynchronous::detail::reverse_sorted<Func>(func)))
                 {
@@ -567,6 +575,7 @@ struct parallel_sort_range_move_helper_serializable
                 {
                     Sort()(beg,it,func);
                 }
+                timer.stop();
                 Range res (std::distance(beg,end));
                 std::move(beg,it,boost::begin(res));
                 task_res.set_value(std::move(res));
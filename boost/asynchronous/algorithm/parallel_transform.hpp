@@ -118,7 +118,8 @@ struct parallel_transform_helper : public boost::asynchronous::continuation_task
         try
         {
             // advance up to cutoff
-            Iterator it = boost::asynchronous::detail::find_cutoff(begin_, cutoff_, end_);
+            Iterator it = boost::asynchronous::detail::find_cutoff(
+                        begin_, boost::asynchronous::detail::effective_cutoff<parallel_transform_helper>(cutoff_), end_);
 
             // distance between begin and it
             std::size_t dist = std::distance(begin_, it);
@@ -126,7 +127,10 @@ struct parallel_transform_helper : public boost::asynchronous::continuation_task
             // if not at end, recurse, otherwise execute here
             if (it == end_)
             {
-                task_res.set_value(Transform()(begin_, it, result_, func_));
+                boost::asynchronous::detail::cutoff_timer<parallel_transform_helper> timer(cutoff_, begin_, it);
+                ResultIterator res = Transform()(begin_, it, result_, func_);
+                timer.stop();
+                task_res.set_value(std::move(res));
             }
             else
             {
@@ -210,7 +214,8 @@ struct parallel_transform2_helper : public boost::asynchronous::continuation_tas
         try
         {
             // advance first up to cutoff
-            Iterator1 it1 = boost::asynchronous::detail::find_cutoff(begin1_, cutoff_, end1_);
+            Iterator1 it1 = boost::asynchronous::detail::find_cutoff(
+                        begin1_, boost::asynchronous::detail::effective_cutoff<parallel_transform2_helper>(cutoff_), end1_);
 
             // distance between begin and it
             std::size_t dist = std::distance(begin1_, it1);
@@ -222,7 +227,10 @@ struct parallel_transform2_helper : public boost::asynchronous::continuation_tas
             // if not at end, recurse, otherwise execute here
             if (it1 == end1_)
             {
-                task_res.set_value(Transform()(begin1_, it1, begin2_, result_, func_));
+                boost::asynchronous::detail::cutoff_timer<parallel_transform2_helper> timer(cutoff_, begin1_, it1);
+                ResultIterator res = Transform()(begin1_, it1, begin2_, result_, func_);
+                timer.stop();
+                task_res.set_value(std::move(res));
             }
             else
             {
@@ -297,8 +305,10 @@ struct parallel_transform_range_helper : public boost::asynchronous::continuatio
         boost::asynchronous::continuation_result<ResultIterator> task_res = this->this_task_result();
         try
         {
+            typedef parallel_transform_helper<decltype(boost::begin(range_)), ResultIterator, Func, Job, Transform> leaf_type;
             // advance up to cutoff
-            auto it = boost::asynchronous::detail::find_cutoff(boost::begin(range_), cutoff_, boost::end(range_));
+            auto it = boost::asynchronous::detail::find_cutoff(
+                        boost::begin(range_), boost::asynchronous::detail::effective_cutoff<leaf_type>(cutoff_), boost::end(range_));
 
             // distance between begin and it
             std::size_t dist = std::distance(boost::begin(range_), it);
@@ -306,7 +316,10 @@ struct parallel_transform_range_helper : public boost::asynchronous::continuatio
             // if not at end, recurse, otherwise execute here
             if (it == boost::end(range_))
             {
-                task_res.set_value(Transform()(boost::begin(range_), it, result_, func_));
+                boost::asynchronous::detail::cutoff_timer<leaf_type> timer(cutoff_, boost::begin(range_), it);
+                ResultIterator res = Transform()(boost::begin(range_), it, result_, func_);
+                timer.stop();
+                task_res.set_value(std::move(res));
             }
             else
             {
@@ -385,8 +398,10 @@ struct parallel_transform2_range_helper : public boost::asynchronous::continuati
         boost::asynchronous::continuation_result<ResultIterator> task_res = this->this_task_result();
         try
         {
+            typedef parallel_transform2_helper<decltype(boost::begin(range1_)), decltype(boost::begin(range2_)), ResultIterator, Func, Job, Transform> leaf_type;
             // advance first up to cutoff
-            auto it1 = boost::asynchronous::detail::find_cutoff(boost::begin(range1_), cutoff_, boost::end(range1_));
+            auto it1 = boost::asynchronous::detail::find_cutoff(
+                        boost::begin(range1_), boost::asynchronous::detail::effective_cutoff<leaf_type>(cutoff_), boost::end(range1_));
 
             // distance between begin and it
             std::size_t dist = std::distance(boost::begin(range1_), it1);
@@ -397,7 +412,10 @@ struct parallel_transform2_range_helper : public boost::asynchronous::continuati
             // if not at end, recurse, otherwise execute here
             if (it1 == boost::end(range1_))
             {
-                task_res.set_value(Transform()(boost::begin(range1_), it1, boost::begin(range2_), result_, func_));
+                boost::asynchronous::detail::cutoff_timer<leaf_type> timer(cutoff_, boost::begin(range1_), it1);
+                ResultIterator res = Transform()(boost::begin(range1_), it1, boost::begin(range2_), result_, func_);
+                timer.stop();
+                task_res.set_value(std::move(res));
             }
             else
             {
@@ -478,12 +496,16 @@ struct parallel_transform_any_iterators_helper : public boost::asynchronous::con
         try
         {
             // advance first up to cutoff
-            Iterator it = boost::asynchronous::detail::find_cutoff(begin_, cutoff_, end_);
+            Iterator it = boost::asynchronous::detail::find_cutoff(
+                        begin_, boost::asynchronous::detail::effective_cutoff<parallel_transform_any_iterators_helper>(cutoff_), end_);
 
             // if not at end, recurse, otherwise execute here
             if (it == end_)
             {
-                task_res.set_value(Transform()(begin_, it, iterators_, result_, func_));
+                boost::asynchronous::detail::cutoff_timer<parallel_transform_any_iterators_helper> timer(cutoff_, begin_, it);
+                ResultIterator res = Transform()(begin_, it, iterators_, result_, func_);
+                timer.stop();
+                task_res.set_value(std::move(res));
             }
             else
             {
@@ -0,0 +1,72 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNCHRONOUS_ALGORITHM_VALUE_PREDICATES_HPP
+#define BOOST_ASYNCHRONOUS_ALGORITHM_VALUE_PREDICATES_HPP
+
+namespace boost { namespace asynchronous
+{
+// Unary predicates comparing an element to a value.
+// Unlike lambdas, they are recognized by parallel_count_if, parallel_find_all, parallel_all_of, parallel_any_of
+// and parallel_none_of, which use SIMD kernels for contiguous ranges of T.
+template <class T>
+struct equal_to_value
+{
+    equal_to_value() = default;
+    explicit equal_to_value(T const& value): value_(value){}
+    template <class U>
+    bool operator()(U const& u)const
+    {
+        return u == value_;
+    }
+    template <class Archive>
+    void serialize(Archive & ar, const unsigned int /*version*/)
+    {
+        ar & value_;
+    }
+    T value_;
+};
+template <class T>
+struct less_than_value
+{
+    less_than_value() = default;
+    explicit less_than_value(T const& value): value_(value){}
+    template <class U>
+    bool operator()(U const& u)const
+    {
+        return u < value_;
+    }
+    template <class Archive>
+    void serialize(Archive & ar, const unsigned int /*version*/)
+    {
+        ar & value_;
+    }
+    T value_;
+};
+template <class T>
+struct greater_than_value
+{
+    greater_than_value() = default;
+    explicit greater_than_value(T const& value): value_(value){}
+    template <class U>
+    bool operator()(U const& u)const
+    {
+        return u > value_;
+    }
+    template <class Archive>
+    void serialize(Archive & ar, const unsigned int /*version*/)
+    {
+        ar & value_;
+    }
+    T value_;
+};
+
+}} // boost::asynchronous
+
+#endif // BOOST_ASYNCHRONOUS_ALGORITHM_VALUE_PREDICATES_HPP
@@ -15,6 +15,7 @@
 
 #include <boost/mpl/vector.hpp>
 #include <memory>
+#include <type_traits>
 #include <boost/thread/thread.hpp>
 
 #include <boost/type_erasure/any.hpp>
@@ -344,7 +345,9 @@ public:
     any_shared_scheduler_proxy():my_ptr(){}
     any_shared_scheduler_proxy(any_shared_scheduler_proxy const& ) = default;
     any_shared_scheduler_proxy(any_shared_scheduler_proxy&& ) = default;
-    template <class U>
+    template <class U,
+              class Enable = typename std::enable_if<
+                std::is_constructible<std::shared_ptr<boost::asynchronous::any_shared_scheduler_proxy_concept<JOB> >,U const&>::value>::type>
     any_shared_scheduler_proxy(U const& u):
         my_ptr (u){}
 
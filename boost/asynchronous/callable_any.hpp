@@ -23,6 +23,8 @@
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 
+#include <boost/asynchronous/small_callable.hpp>
+
 // the basic and minimum job type of every scheduler
 // The minimum a job has to do is to be callable: void task()
 
@@ -51,7 +51,7 @@ struct push_back_task: public boost::asynchronous::continuation_task<Container>
             // reallocate
             std::shared_ptr<Container> c = std::make_shared<Container>(std::move(m_container));
             auto v = m_value;
-            auto capacity = c->calc_new_capacity(c->size());
+            auto capacity = c->calc_new_capacity(c->size()+1);
             auto cont = c->async_reallocate(capacity,c->size());
             cont.on_done([task_res,c,v,capacity]
                            (std::tuple<boost::asynchronous::expected<typename Container::internal_data_type> >&& res)mutable
@@ -677,7 +677,7 @@ struct async_merge_task: public boost::asynchronous::continuation_task<Container
             auto name = this->get_name();
 
             auto cont = boost::asynchronous::async_resize(std::move(m_container1),s1+s2);
-            cont.on_done([task_res,name,c2]
+            cont.on_done([task_res,name,c2,s1]
                            (std::tuple<boost::asynchronous::expected<Container> >&& res)mutable
             {
                 try
@@ -685,7 +685,7 @@ struct async_merge_task: public boost::asynchronous::continuation_task<Container
                     std::shared_ptr<Container> c1 = std::make_shared<Container>(std::move(std::get<0>(res).get()));
                     using iterator = typename Container::iterator;
                     auto cont_move = boost::asynchronous::parallel_move_if_noexcept<iterator,iterator,Job>
-                                                (c2->begin(),c2->end(),c1->end(),c2->get_cutoff(),
+                                                (c2->begin(),c2->end(),c1->begin()+s1,c2->get_cutoff(),
                                                  name+"_parallel_move_if_noexcept",c2->get_prio());
                     cont_move.on_done([task_res,c1,c2]
                                    (std::tuple<boost::asynchronous::expected<void> >&& res_move)mutable
@@ -758,10 +758,11 @@ struct async_merge_container_of_containers_task: public boost::asynchronous::con
                 s += c.size();
             }
             auto name = this->get_name();
+            auto s0 = m_container[0].size();
             auto cont = boost::asynchronous::async_resize(std::move(m_container[0]),s);
             std::shared_ptr<Container> c = std::make_shared<Container>(std::move(m_container));
 
-            cont.on_done([task_res,name,c]
+            cont.on_done([task_res,name,c,s0]
                            (std::tuple<boost::asynchronous::expected<typename Container::value_type> >&& res)mutable
             {
                 try
@@ -770,11 +771,14 @@ struct async_merge_container_of_containers_task: public boost::asynchronous::con
                             std::make_shared<typename Container::value_type>(std::move(std::get<0>(res).get()));
                     using iterator = typename Container::value_type::iterator;
                     std::vector<boost::asynchronous::detail::callback_continuation<void>> subs;
+                    // each container is moved after the previous ones
+                    auto offset = s0;
                     for (auto it = c->begin()+1; it != c->end();++it)
                     {
                         subs.push_back(boost::asynchronous::parallel_move_if_noexcept<iterator,iterator,Job>
-                                       ((*it).begin(),(*it).end(),c1->end(),c1->get_cutoff(),
+                                       ((*it).begin(),(*it).end(),c1->begin()+offset,c1->get_cutoff(),
                                         name+"_parallel_move_if_noexcept",c1->get_prio()));
+                        offset += (*it).size();
                     }
                     boost::asynchronous::create_callback_continuation(
                          [task_res,c,c1]
@@ -0,0 +1,753 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2015
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNCHRONOUS_CONTAINER_SEGMENTED_VECTOR_HPP
+#define BOOST_ASYNCHRONOUS_CONTAINER_SEGMENTED_VECTOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/asynchronous/algorithm/parallel_flatten.hpp>
+#include <boost/asynchronous/container/vector.hpp>
+
+namespace boost { namespace asynchronous
+{
+namespace detail
+{
+// fixed capacity storage of a segmented_vector.
+// Elements are constructed in place and never move, moving a segment only moves the pointer to its memory
+template <class T, class Alloc>
+class vector_segment
+{
+public:
+    typedef std::allocator_traits<Alloc>    alloc_traits;
+    typedef T                               value_type;
+    typedef std::size_t                     size_type;
+    typedef T*                              iterator;
+    typedef T const*                        const_iterator;
+
+    vector_segment(size_type capacity, Alloc const& alloc)
+        : m_data(nullptr)
+        , m_size(0)
+        , m_capacity(capacity)
+        , m_allocator(alloc)
+    {
+        m_data = alloc_traits::allocate(m_allocator,capacity);
+    }
+    // if a copy throws, our destructor cleans up what was already copied
+    vector_segment(vector_segment const& rhs)
+        : vector_segment(rhs.m_capacity,rhs.m_allocator)
+    {
+        for (auto const& t : rhs)
+        {
+            emplace_back(t);
+        }
+    }
+    vector_segment(vector_segment&& rhs) noexcept
+        : m_data(rhs.m_data)
+        , m_size(rhs.m_size)
+        , m_capacity(rhs.m_capacity)
+        , m_allocator(rhs.m_allocator)
+    {
+        rhs.m_data = nullptr;
+        rhs.m_size = 0;
+        rhs.m_capacity = 0;
+    }
+    vector_segment& operator=(vector_segment const& rhs)
+    {
+        vector_segment tmp(rhs);
+        swap(tmp);
+        return *this;
+    }
+    vector_segment& operator=(vector_segment&& rhs) noexcept
+    {
+        swap(rhs);
+        return *this;
+    }
+    ~vector_segment()
+    {
+        release();
+    }
+    void swap(vector_segment& rhs) noexcept
+    {
+        std::swap(m_data,rhs.m_data);
+        std::swap(m_size,rhs.m_size);
+        std::swap(m_capacity,rhs.m_capacity);
+        std::swap(m_allocator,rhs.m_allocator);
+    }
+
+    template< class... Args >
+    T& emplace_back( Args&&... args )
+    {
+        T* p = new (m_data + m_size) T(std::forward<Args>(args)...);
+        ++m_size;
+        return *p;
+    }
+    void pop_back()
+    {
+        --m_size;
+        (m_data + m_size)->~T();
+    }
+    void clear()
+    {
+        for (size_type i = 0; i < m_size; ++i)
+        {
+            (m_data + i)->~T();
+        }
+        m_size = 0;
+    }
+
+    iterator begin() { return m_data; }
+    iterator end() { return m_data + m_size; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + m_size; }
+    T& operator[](size_type pos) { return m_data[pos]; }
+    T const& operator[](size_type pos) const { return m_data[pos]; }
+    size_type size() const { return m_size; }
+    size_type capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+    bool full() const { return m_size == m_capacity; }
+
+private:
+    void release()
+    {
+        if (m_data != nullptr)
+        {
+            clear();
+            alloc_traits::deallocate(m_allocator,m_data,m_capacity);
+            m_data = nullptr;
+        }
+    }
+
+    T* m_data;
+    size_type m_size;
+    size_type m_capacity;
+    Alloc m_allocator;
+};
+
+// random-access iterator of a segmented_vector.
+// It caches the segment it points into, moving inside a segment costs the same as a pointer,
+// jumping to another one a binary search on the segment offsets.
+template <class Value, class Segment>
+class segmented_iterator
+{
+public:
+    typedef std::random_access_iterator_tag             iterator_category;
+    typedef typename std::remove_const<Value>::type     value_type;
+    typedef std::ptrdiff_t                              difference_type;
+    typedef Value*                                      pointer;
+    typedef Value&                                      reference;
+
+    segmented_iterator()
+        : m_segments(nullptr), m_offsets(nullptr), m_segment_count(0), m_total(0)
+        , m_index(0), m_segment(0), m_begin(0), m_end(0), m_data(nullptr)
+    {}
+    segmented_iterator(Segment* segments, std::size_t const* offsets, std::size_t segment_count, std::size_t total, std::size_t index)
+        : m_segments(segments), m_offsets(offsets), m_segment_count(segment_count), m_total(total)
+        , m_index(index), m_segment(0), m_begin(0), m_end(0), m_data(nullptr)
+    {
+        seek(index);
+    }
+    // iterator to const_iterator
+    template <class OtherValue, class OtherSegment,
+              class Enable = typename std::enable_if<std::is_convertible<OtherValue*,Value*>::value>::type>
+    segmented_iterator(segmented_iterator<OtherValue,OtherSegment> const& rhs)
+        : segmented_iterator(rhs.m_segments, rhs.m_offsets, rhs.m_segment_count, rhs.m_total, rhs.m_index)
+    {}
+
+    reference operator*() const
+    {
+        return m_data[m_index - m_begin];
+    }
+    pointer operator->() const
+    {
+        return m_data + (m_index - m_begin);
+    }
+    reference operator[](difference_type n) const
+    {
+        return *(*this + n);
+    }
+
+    segmented_iterator& operator++()
+    {
+        if (++m_index == m_end)
+        {
+            if (m_segment + 1 < m_segment_count)
+            {
+                // no empty segment, the next one starts here
+                set_segment(m_segment + 1);
+            }
+            else
+            {
+                seek(m_index);
+            }
+        }
+        return *this;
+    }
+    segmented_iterator operator++(int)
+    {
+        segmented_iterator tmp(*this);
+        ++(*this);
+        return tmp;
+    }
+    segmented_iterator& operator--()
+    {
+        if (m_index-- == m_begin)
+        {
+            seek(m_index);
+        }
+        return *this;
+    }
+    segmented_iterator operator--(int)
+    {
+        segmented_iterator tmp(*this);
+        --(*this);
+        return tmp;
+    }
+    segmented_iterator& operator+=(difference_type n)
+    {
+        m_index += n;
+        if (m_index < m_begin || m_index >= m_end)
+        {
+            seek(m_index);
+        }
+        return *this;
+    }
+    segmented_iterator& operator-=(difference_type n)
+    {
+        return *this += -n;
+    }
+    friend segmented_iterator operator+(segmented_iterator it, difference_type n)
+    {
+        return it += n;
+    }
+    friend segmented_iterator operator+(difference_type n, segmented_iterator it)
+    {
+        return it += n;
+    }
+    friend segmented_iterator operator-(segmented_iterator it, difference_type n)
+    {
+        return it -= n;
+    }
+    template <class OtherValue, class OtherSegment>
+    difference_type operator-(segmented_iterator<OtherValue,OtherSegment> const& rhs) const
+    {
+        return static_cast<difference_type>(m_index) - static_cast<difference_type>(rhs.m_index);
+    }
+    template <class OtherValue, class OtherSegment>
+    bool operator==(segmented_iterator<OtherValue,OtherSegment> const& rhs) const
+    {
+        return m_index == rhs.m_index;
+    }
+    template <class OtherValue, class OtherSegment>
+    bool operator!=(segmented_iterator<OtherValue,OtherSegment> const& rhs) const
+    {
+        return m_index != rhs.m_index;
+    }
+    template <class OtherValue, class OtherSegment>
+    bool operator<(segmented_iterator<OtherValue,OtherSegment> const& rhs) const
+    {
+        return m_index < rhs.m_index;
+    }
+    template <class OtherValue, class OtherSegment>
+    bool operator>(segmented_iterator<OtherValue,OtherSegment> const& rhs) const
+    {
+        return m_index > rhs.m_index;
+    }
+    template <class OtherValue, class OtherSegment>
+    bool operator<=(segmented_iterator<OtherValue,OtherSegment> const& rhs) const
+    {
+        return m_index <= rhs.m_index;
+    }
+    template <class OtherValue, class OtherSegment>
+    bool operator>=(segmented_iterator<OtherValue,OtherSegment> const& rhs) const
+    {
+        return m_index >= rhs.m_index;
+    }
+
+private:
+    template <class OtherValue, class OtherSegment>
+    friend class segmented_iterator;
+
+    void set_segment(std::size_t segment)
+    {
+        m_segment = segment;
+        m_begin = m_offsets[segment];
+        m_end = m_begin + m_segments[segment].size();
+        m_data = &*m_segments[segment].begin();
+    }
+    void seek(std::size_t index)
+    {
+        if (index >= m_total)
+        {
+            // past the end, every move will seek again
+            m_segment = m_segment_count;
+            m_begin = m_end = m_total;
+            m_data = nullptr;
+            return;
+        }
+        set_segment(static_cast<std::size_t>(std::upper_bound(m_offsets, m_offsets + m_segment_count, index) - m_offsets) - 1);
+    }
+
+    Segment* m_segments;
+    std::size_t const* m_offsets;
+    std::size_t m_segment_count;
+    std::size_t m_total;
+    // position in the whole container
+    std::size_t m_index;
+    // current segment, which holds [m_begin, m_end)
+    std::size_t m_segment;
+    std::size_t m_begin;
+    std::size_t m_end;
+    Value* m_data;
+};
+}
+
+template <class T, std::size_t SegmentSize, class Alloc>
+class segmented_collector;
+
+// A container made of fixed-size segments.
+// Elements never move once appended, push_back never reallocates elements, and splice appends the segments of another
+// segmented_vector without touching its elements. It offers random-access iterators usable with the parallel algorithms.
+// Like std::vector, it is not thread-safe. Tasks fill their own segmented_vector and splice them together,
+// or append concurrently through a segmented_collector.
+template <class T, std::size_t SegmentSize = 1024, class Alloc = std::allocator<T> >
+class segmented_vector
+{
+    static_assert(SegmentSize > 0,"segmented_vector needs non-empty segments");
+public:
+    typedef boost::asynchronous::detail::vector_segment<T,Alloc>    segment_type;
+    typedef std::size_t                                             size_type;
+    typedef std::ptrdiff_t                                          difference_type;
+    typedef T                                                       value_type;
+    typedef T&                                                      reference;
+    typedef T const&                                                const_reference;
+    typedef T*                                                      pointer;
+    typedef T const*                                                const_pointer;
+    typedef Alloc                                                   allocator_type;
+    typedef boost::asynchronous::detail::segmented_iterator<T,segment_type>                 iterator;
+    typedef boost::asynchronous::detail::segmented_iterator<T const,segment_type const>     const_iterator;
+
+    enum { segment_size = SegmentSize };
+
+    segmented_vector() noexcept(std::is_nothrow_default_constructible<Alloc>::value)
+        : segmented_vector(Alloc())
+    {
+    }
+    explicit segmented_vector(const Alloc& alloc) noexcept
+        : m_size(0)
+        , m_allocator(alloc)
+    {
+    }
+    explicit segmented_vector(size_type n, const T& value = T(), const Alloc& alloc = Alloc())
+        : segmented_vector(alloc)
+    {
+        for (size_type i = 0; i < n; ++i)
+        {
+            push_back(value);
+        }
+    }
+    segmented_vector(segmented_vector const& other) = default;
+    segmented_vector(segmented_vector&& other) noexcept
+        : m_segments(std::move(other.m_segments))
+        , m_offsets(std::move(other.m_offsets))
+        , m_size(other.m_size)
+        , m_allocator(other.m_allocator)
+    {
+        other.clear();
+    }
+    segmented_vector& operator=(segmented_vector const& other) = default;
+    segmented_vector& operator=(segmented_vector&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+    void swap(segmented_vector& other) noexcept
+    {
+        std::swap(m_segments,other.m_segments);
+        std::swap(m_offsets,other.m_offsets);
+        std::swap(m_size,other.m_size);
+        std::swap(m_allocator,other.m_allocator);
+    }
+
+    void push_back( const T& value )
+    {
+        emplace_back(value);
+    }
+    void push_back( T&& value )
+    {
+        emplace_back(std::move(value));
+    }
+    // elements never move, value can be one of ours
+    template< class... Args >
+    reference emplace_back( Args&&... args )
+    {
+        if (m_segments.empty() || m_segments.back().full())
+        {
+            add_segment();
+        }
+        reference res = m_segments.back().emplace_back(std::forward<Args>(args)...);
+        ++m_size;
+        return res;
+    }
+    void pop_back()
+    {
+        m_segments.back().pop_back();
+        --m_size;
+        if (m_segments.back().empty())
+        {
+            // no empty segment, iterators rely on it
+            m_segments.pop_back();
+            m_offsets.pop_back();
+        }
+    }
+    // appends the elements of other, which becomes empty. Only the segments are moved, not the elements,
+    // references to the elements of other stay valid and now refer to our elements.
+    void splice(segmented_vector&& other)
+    {
+        m_segments.reserve(m_segments.size() + other.m_segments.size());
+        m_offsets.reserve(m_segments.size() + other.m_segments.size());
+        for (auto& s : other.m_segments)
+        {
+            if (!s.empty())
+            {
+                m_offsets.push_back(m_size);
+                m_size += s.size();
+                m_segments.push_back(std::move(s));
+            }
+        }
+        other.clear();
+    }
+    // gives away our segments, for example to parallel_flatten
+    std::vector<segment_type> release_segments()
+    {
+        std::vector<segment_type> res = std::move(m_segments);
+        clear();
+        return res;
+    }
+    void clear() noexcept
+    {
+        m_segments.clear();
+        m_offsets.clear();
+        m_size = 0;
+    }
+
+    iterator begin()
+    {
+        return iterator(m_segments.data(),m_offsets.data(),m_segments.size(),m_size,0);
+    }
+    iterator end()
+    {
+        return iterator(m_segments.data(),m_offsets.data(),m_segments.size(),m_size,m_size);
+    }
+    const_iterator begin() const
+    {
+        return const_iterator(m_segments.data(),m_offsets.data(),m_segments.size(),m_size,0);
+    }
+    const_iterator end() const
+    {
+        return const_iterator(m_segments.data(),m_offsets.data(),m_segments.size(),m_size,m_size);
+    }
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    reference operator[]( size_type pos )
+    {
+        size_type s = find_segment(pos);
+        return m_segments[s][pos - m_offsets[s]];
+    }
+    const_reference operator[]( size_type pos ) const
+    {
+        size_type s = find_segment(pos);
+        return m_segments[s][pos - m_offsets[s]];
+    }
+    reference at( size_type pos )
+    {
+        if (pos >= m_size)
+        {
+            throw std::out_of_range("segmented_vector::at");
+        }
+        return (*this)[pos];
+    }
+    const_reference at( size_type pos ) const
+    {
+        if (pos >= m_size)
+        {
+            throw std::out_of_range("segmented_vector::at");
+        }
+        return (*this)[pos];
+    }
+    reference front()
+    {
+        return *m_segments.front().begin();
+    }
+    const_reference front() const
+    {
+        return *m_segments.front().begin();
+    }
+    reference back()
+    {
+        return *(m_segments.back().end() - 1);
+    }
+    const_reference back() const
+    {
+        return *(m_segments.back().end() - 1);
+    }
+
+    size_type size() const noexcept
+    {
+        return m_size;
+    }
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+    std::vector<segment_type> const& segments() const noexcept
+    {
+        return m_segments;
+    }
+    allocator_type get_allocator() const
+    {
+        return m_allocator;
+    }
+
+    bool operator==(segmented_vector const& rhs) const
+    {
+        return size() == rhs.size() && std::equal(begin(),end(),rhs.begin());
+    }
+    bool operator!=(segmented_vector const& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+private:
+    friend class boost::asynchronous::segmented_collector<T,SegmentSize,Alloc>;
+
+    void add_segment()
+    {
+        add_segment(segment_type(SegmentSize,m_allocator));
+    }
+    void add_segment(segment_type&& s)
+    {
+        // both tables grow together or not at all
+        m_offsets.reserve(m_segments.size() + 1);
+        m_segments.push_back(std::move(s));
+        m_offsets.push_back(m_size);
+        m_size += m_segments.back().size();
+    }
+    size_type find_segment(size_type pos) const
+    {
+        return static_cast<size_type>(std::upper_bound(m_offsets.begin(),m_offsets.end(),pos) - m_offsets.begin()) - 1;
+    }
+
+    std::vector<segment_type> m_segments;
+    // index of the first element of each segment
+    std::vector<size_type> m_offsets;
+    size_type m_size;
+    Alloc m_allocator;
+};
+
+// Collects the elements appended concurrently by many tasks into a segmented_vector.
+// Every task appends through its own appender, which fills a private segment and publishes it with a single
+// compare-and-swap once it is full. Appending never takes a lock and tasks never share a segment.
+// Elements appended through one appender keep their order, elements of different appenders are in no particular order.
+template <class T, std::size_t SegmentSize = 1024, class Alloc = std::allocator<T> >
+class segmented_collector
+{
+public:
+    typedef boost::asynchronous::segmented_vector<T,SegmentSize,Alloc>  container_type;
+    typedef typename container_type::segment_type                       segment_type;
+
+private:
+    struct node
+    {
+        explicit node(Alloc const& alloc)
+            : segment(SegmentSize,alloc)
+            , next(nullptr)
+        {}
+        segment_type segment;
+        node* next;
+    };
+
+public:
+    class appender
+    {
+    public:
+        appender(appender&& rhs) noexcept
+            : m_collector(rhs.m_collector)
+            , m_node(std::move(rhs.m_node))
+        {
+            rhs.m_collector = nullptr;
+        }
+        appender& operator=(appender&& rhs) noexcept
+        {
+            flush();
+            m_collector = rhs.m_collector;
+            m_node = std::move(rhs.m_node);
+            rhs.m_collector = nullptr;
+            return *this;
+        }
+        appender(appender const&) = delete;
+        appender& operator=(appender const&) = delete;
+        ~appender()
+        {
+            flush();
+        }
+
+        void push_back( const T& value )
+        {
+            emplace_back(value);
+        }
+        void push_back( T&& value )
+        {
+            emplace_back(std::move(value));
+        }
+        template< class... Args >
+        void emplace_back( Args&&... args )
+        {
+            if (!m_node || m_node->segment.full())
+            {
+                flush();
+                m_node.reset(new node(m_collector->m_allocator));
+            }
+            m_node->segment.emplace_back(std::forward<Args>(args)...);
+        }
+        // publishes the elements appended until now
+        void flush() noexcept
+        {
+            if (!!m_node && !m_node->segment.empty())
+            {
+                m_collector->publish(m_node.release());
+            }
+        }
+
+    private:
+        friend class segmented_collector;
+        explicit appender(segmented_collector* collector)
+            : m_collector(collector)
+        {}
+
+        segmented_collector* m_collector;
+        std::unique_ptr<node> m_node;
+    };
+
+    explicit segmented_collector(Alloc const& alloc = Alloc())
+        : m_published(nullptr)
+        , m_allocator(alloc)
+    {
+    }
+    segmented_collector(segmented_collector const&) = delete;
+    segmented_collector& operator=(segmented_collector const&) = delete;
+    ~segmented_collector()
+    {
+        node* n = m_published.exchange(nullptr,std::memory_order_acquire);
+        while (n != nullptr)
+        {
+            std::unique_ptr<node> current(n);
+            n = n->next;
+        }
+    }
+
+    // the collector must outlive its appenders
+    appender make_appender()
+    {
+        return appender(this);
+    }
+
+    // moves the published segments into a segmented_vector, the elements themselves are not moved.
+    // Elements still in appenders are not part of the result until they are flushed.
+    container_type take()
+    {
+        // unlink everything published until now, then restore the publication order
+        node* n = m_published.exchange(nullptr,std::memory_order_acquire);
+        node* ordered = nullptr;
+        while (n != nullptr)
+        {
+            node* next = n->next;
+            n->next = ordered;
+            ordered = n;
+            n = next;
+        }
+        container_type res(m_allocator);
+        while (ordered != nullptr)
+        {
+            std::unique_ptr<node> current(ordered);
+            ordered = ordered->next;
+            try
+            {
+                res.add_segment(std::move(current->segment));
+            }
+            catch(...)
+            {
+                // give back what we could not take
+                publish(current.release());
+                while (ordered != nullptr)
+                {
+                    node* next = ordered->next;
+                    publish(ordered);
+                    ordered = next;
+                }
+                throw;
+            }
+        }
+        return res;
+    }
+
+private:
+    void publish(node* n) noexcept
+    {
+        node* head = m_published.load(std::memory_order_relaxed);
+        do
+        {
+            n->next = head;
+        }
+        while (!m_published.compare_exchange_weak(head,n,std::memory_order_release,std::memory_order_relaxed));
+    }
+
+    // published segments, in reverse order
+    std::atomic<node*> m_published;
+    Alloc m_allocator;
+};
+
+// Moves the elements of a segmented_vector into a single contiguous container, by default a boost::asynchronous::vector.
+// cutoff is a number of elements, each task moves whole segments.
+template <class T, std::size_t SegmentSize, class Alloc,
+          class Result = boost::asynchronous::vector<T>, class Job = BOOST_ASYNCHRONOUS_DEFAULT_JOB>
+boost::asynchronous::detail::callback_continuation<Result,Job>
+parallel_flatten(boost::asynchronous::segmented_vector<T,SegmentSize,Alloc>&& v,
+                 long cutoff,
+#ifdef BOOST_ASYNCHRONOUS_REQUIRE_ALL_ARGUMENTS
+                 const std::string& task_name, std::size_t prio
+#else
+                 const std::string& task_name="", std::size_t prio=0
+#endif
+                 )
+{
+    typedef typename boost::asynchronous::segmented_vector<T,SegmentSize,Alloc>::segment_type segment_type;
+    long segment_cutoff = std::max(1L,cutoff / static_cast<long>(SegmentSize));
+    return boost::asynchronous::parallel_flatten<std::vector<segment_type>,Result,Job>
+            (v.release_segments(),segment_cutoff,segment_cutoff,task_name,prio);
+}
+
+}} // boost::asynchronous
+
+#endif // BOOST_ASYNCHRONOUS_CONTAINER_SEGMENTED_VECTOR_HPP
@@ -15,6 +15,7 @@
 #include <type_traits>
 
 #include <memory>
+#include <boost/asynchronous/algorithm/detail/auto_cutoff.hpp>
 #include <boost/asynchronous/algorithm/parallel_placement.hpp>
 #include <boost/asynchronous/algorithm/parallel_move_if_noexcept.hpp>
 #include <boost/asynchronous/algorithm/parallel_move.hpp>
@@ -100,15 +101,14 @@ public:
     // standard ctors (no scheduler)
     explicit vector(const Alloc& alloc)noexcept
     : m_data()
-    , m_cutoff(1000)
-    , m_task_name("")
-    , m_prio(0)
     , m_size(0)
     , m_capacity(default_capacity)
+    , m_cutoff(1000)
+    , m_prio(0)
+    , m_task_name("")
     , m_allocator(alloc)
     {
-        std::shared_ptr<T> raw (m_allocator.allocate(default_capacity),
-                                  [this](T* p){this->m_allocator.deallocate(p,default_capacity);});
+        std::shared_ptr<T> raw = allocate_raw(default_capacity);
 
         m_data =  std::make_shared<boost::asynchronous::placement_deleter<T,Job,std::shared_ptr<T>>>(0,raw,m_cutoff,m_task_name,m_prio);
     }
@@ -124,7 +124,7 @@ public:
         , m_capacity(n)
         , m_allocator(alloc)
     {
-        std::shared_ptr<T> raw (m_allocator.allocate(n),[this,n](T* p){this->m_allocator.deallocate(p,n);});
+        std::shared_ptr<T> raw = allocate_raw(n);
         m_data =  std::make_shared<boost::asynchronous::placement_deleter<T,Job,std::shared_ptr<T>>>(n,raw,m_cutoff,m_task_name,m_prio);
         boost::asynchronous::detail::serial_placement<T,std::size_t>((std::size_t)0,n,(char*)raw.get(),value);
     }
@@ -132,29 +132,29 @@ public:
     template< class InputIt >
     vector(InputIt first, InputIt last,const Alloc& alloc = Alloc())noexcept
         : m_cutoff(1000)
-        , m_task_name("")
         , m_prio(0)
+        , m_task_name("")
         , m_allocator(alloc)
     {
         auto n = std::distance(first,last);
         m_size=n;
         m_capacity=n;
-        std::shared_ptr<T> raw (m_allocator.allocate(n),[this,n](T* p){this->m_allocator.deallocate(p,n);});
+        std::shared_ptr<T> raw = allocate_raw(n);
         m_data =  std::make_shared<boost::asynchronous::placement_deleter<T,Job,std::shared_ptr<T>>>(n,raw,m_cutoff,m_task_name,m_prio);
         boost::asynchronous::detail::serial_placement_it<T,std::size_t,InputIt>((std::size_t)0,n,(char*)raw.get(),first);
     }
 
     vector( std::initializer_list<T> init,const Alloc& alloc= Alloc() )noexcept
      : m_cutoff(1000)
-     , m_task_name("")
      , m_prio(0)
+     , m_task_name("")
      , m_allocator(alloc)
     {
         auto n = std::distance(init.begin(),init.end());
         auto first = init.begin();
         m_size=n;
         m_capacity=n;
-        std::shared_ptr<T> raw (m_allocator.allocate(n),[this,n](T* p){this->m_allocator.deallocate(p,n);});
+        std::shared_ptr<T> raw = allocate_raw(n);
         m_data =  std::make_shared<boost::asynchronous::placement_deleter<T,Job,std::shared_ptr<T>>>(n,raw,m_cutoff,m_task_name,m_prio);
         boost::asynchronous::detail::serial_placement_it<T,std::size_t,decltype(first)>((std::size_t)0,n,(char*)raw.get(),first);
     }
@@ -166,11 +166,11 @@ public:
 #else
            const std::string& task_name="", std::size_t prio=0)noexcept
 #endif
-        : m_cutoff(cutoff)
-        , m_task_name(task_name)
-        , m_prio(prio)
-        , m_size(n)
+        : m_size(n)
         , m_capacity(n)
+        , m_cutoff(cutoff)
+        , m_prio(prio)
+        , m_task_name(task_name)
     {
     }
 
@@ -181,15 +181,15 @@ public:
 #else
            const std::string& task_name="", std::size_t prio=0,const Alloc& alloc = Alloc())
 #endif
-        : m_scheduler(scheduler)
+        : m_size(n)
+        , m_capacity(n)
+        , m_scheduler(scheduler)
         , m_cutoff(cutoff)
-        , m_task_name(task_name)
         , m_prio(prio)
-        , m_size(n)
-        , m_capacity(n)
+        , m_task_name(task_name)
         , m_allocator(alloc)
     {
-        std::shared_ptr<T> raw (m_allocator.allocate(n),[this,n](T* p){this->m_allocator.deallocate(p,n);});
+        std::shared_ptr<T> raw = allocate_raw(n);
         m_data =  std::make_shared<boost::asynchronous::placement_deleter<T,Job,std::shared_ptr<T>>>(n,raw,cutoff,task_name,prio);
         if (m_scheduler.is_valid())
         {
@@ -213,16 +213,15 @@ public:
 #else
            const std::string& task_name="", std::size_t prio=0,const Alloc& alloc = Alloc())noexcept
 #endif
-        : m_scheduler(scheduler)
+        : m_size(0)
+        , m_capacity(default_capacity)
+        , m_scheduler(scheduler)
         , m_cutoff(cutoff)
-        , m_task_name(task_name)
         , m_prio(prio)
-        , m_size(0)
-        , m_capacity(default_capacity)
+        , m_task_name(task_name)
         , m_allocator(alloc)
     {
-        std::shared_ptr<T> raw (m_allocator.allocate(default_capacity),
-                                  [this](T* p){this->m_allocator.deallocate(p,default_capacity);});
+        std::shared_ptr<T> raw = allocate_raw(default_capacity);
 
         m_data =  std::make_shared<boost::asynchronous::placement_deleter<T,Job,std::shared_ptr<T>>>(0,raw,cutoff,task_name,prio);
     }
@@ -234,15 +233,15 @@ public:
 #else
            const std::string& task_name="", std::size_t prio=0,const Alloc& alloc = Alloc())
 #endif
-        : m_scheduler(scheduler)
+        : m_size(n)
+        , m_capacity(n)
+        , m_scheduler(scheduler)
         , m_cutoff(cutoff)
-        , m_task_name(task_name)
         , m_prio(prio)
-        , m_size(n)
-        , m_capacity(n)
+        , m_task_name(task_name)
         , m_allocator(alloc)
     {
-        std::shared_ptr<T> raw (m_allocator.allocate(n),[this,n](T* p){this->m_allocator.deallocate(p,n);});
+        std::shared_ptr<T> raw = allocate_raw(n);
 
         m_data =  std::make_shared<boost::asynchronous::placement_deleter<T,Job,std::shared_ptr<T>>>(n,raw,cutoff,task_name,prio);
         if (m_scheduler.is_valid())
@@ -271,14 +270,14 @@ public:
 #endif
         : m_scheduler(scheduler)
         , m_cutoff(cutoff)
-        , m_task_name(task_name)
         , m_prio(prio)
+        , m_task_name(task_name)
         , m_allocator(alloc)
     {
         auto n = std::distance(first,last);
         m_size=n;
         m_capacity=n;
-        std::shared_ptr<T> raw (m_allocator.allocate(n),[this,n](T* p){this->m_allocator.deallocate(p,n);});
+        std::shared_ptr<T> raw = allocate_raw(n);
         m_data =  std::make_shared<boost::asynchronous::placement_deleter<T,Job,std::shared_ptr<T>>>(n,raw,cutoff,task_name,prio);
         if (m_scheduler.is_valid())
         {
@@ -298,30 +297,31 @@ public:
         }
     }
     vector( vector&& other )noexcept
-        : m_scheduler(std::move(other.m_scheduler))
-        , m_data(std::move(other.m_data))
-        , m_cutoff(other.m_cutoff)
-        , m_task_name(std::move(other.m_task_name))
-        , m_prio(other.m_prio)
+        : m_data(std::move(other.m_data))
         , m_size(other.m_size)
         , m_capacity(other.m_capacity)
+        , m_scheduler(std::move(other.m_scheduler))
+        , m_cutoff(other.m_cutoff)
+        , m_prio(other.m_prio)
+        , m_task_name(std::move(other.m_task_name))
         , m_allocator(other.m_allocator)
     {
         other.m_data.reset();
         other.m_size = 0;
+        other.m_capacity = 0;
     }
     vector( vector const& other )
         : m_scheduler(other.m_scheduler)
         , m_cutoff(other.m_cutoff)
-        , m_task_name(other.m_task_name)
         , m_prio(other.m_prio)
+        , m_task_name(other.m_task_name)
         , m_allocator(other.m_allocator)
     {
         // resize to other's size
         auto n = other.size();
         m_size=n;
         m_capacity=n;
-        std::shared_ptr<T> raw (m_allocator.allocate(n),[this,n](T* p){this->m_allocator.deallocate(p,n);});
+        std::shared_ptr<T> raw = allocate_raw(n);
         auto cutoff = m_cutoff;
         auto task_name = m_task_name;
         auto prio = m_prio;
@@ -374,14 +374,14 @@ public:
            ,const Alloc& = Alloc() )
      : m_scheduler(scheduler)
      , m_cutoff(cutoff)
-     , m_task_name(task_name)
      , m_prio(prio)
+     , m_task_name(task_name)
     {
         auto n = std::distance(init.begin(),init.end());
         auto first = init.begin();
         m_size=n;
         m_capacity=n;
-        std::shared_ptr<T> raw (m_allocator.allocate(n),[this,n](T* p){this->m_allocator.deallocate(p,n);});
+        std::shared_ptr<T> raw = allocate_raw(n);
         m_data =  std::make_shared<boost::asynchronous::placement_deleter<T,Job,std::shared_ptr<T>>>(n,raw,cutoff,task_name,prio);
         if (m_scheduler.is_valid())
         {
@@ -405,7 +405,7 @@ public:
     {
         // if in threadpool (algorithms) already, nothing to do, placement deleter will handle dtors and freeing of memory
         // else we need to handle destruction
-        if (m_scheduler.is_valid() && !!m_data)
+        if (use_scheduler(m_size) && !!m_data)
         {
             try
             {
@@ -706,7 +706,7 @@ public:
 
     void clear()
     {
-        if (m_scheduler.is_valid() && !!m_data)
+        if (use_scheduler(m_size) && !!m_data)
         {
             try
             {
@@ -737,54 +737,32 @@ public:
 
     void push_back( const T& value )
     {
-        if (m_size + 1 <= m_capacity )
-        {
-            new (end()) T(value);
-            ++m_size;
-            ++m_data->size_;            
-        }
-        else
-        {
-            // reallocate memory
-            auto new_memory = reallocate_helper(calc_new_capacity(size()));
-            // add new element, update size and capacity
-            m_capacity = new_memory;
-            push_back(value);
-        }
+        emplace_back(value);
     }
     void push_back( T&& value )
     {
-        if (m_size + 1 <= m_capacity )
-        {
-            new (end()) T(std::forward<T>(value));
-            ++m_size;
-            ++m_data->size_;
-        }
-        else
-        {
-            // reallocate memory
-            auto new_memory = reallocate_helper(calc_new_capacity(size()));
-            // add new element, update size and capacity
-            m_capacity = new_memory;
-            push_back(std::forward<T>(value));
-        }
+        emplace_back(std::move(value));
     }
     template< class... Args >
     void emplace_back( Args&&... args )
     {
         if (m_size + 1 <= m_capacity )
         {
-            new (end()) T(std::forward<Args...>(args...));
+            new (end()) T(std::forward<Args>(args)...);
             ++m_size;
             ++m_data->size_;
         }
         else
         {
+            // args could refer to one of our elements, create the new one before reallocating
+            T value(std::forward<Args>(args)...);
             // reallocate memory
-            auto new_memory = reallocate_helper(calc_new_capacity(size()));
+            auto new_memory = reallocate_helper(calc_new_capacity(size()+1));
             // add new element, update size and capacity
             m_capacity = new_memory;
-            push_back(std::forward<Args...>(args...));
+            new (end()) T(std::move(value));
+            ++m_size;
+            ++m_data->size_;
         }
     }
     void pop_back()
@@ -833,7 +811,7 @@ public:
             // add count - size() elements
             auto s = size();
             char* raw = (char*) begin();
-            if (m_scheduler.is_valid())
+            if (use_scheduler(count - s))
             {
                 auto fu = boost::asynchronous::post_future(m_scheduler,
                 [s,count,raw,value,cutoff,task_name,prio]()mutable
@@ -862,7 +840,7 @@ public:
             m_size = count;
             m_data->size_ = count;
             auto raw = m_data->data_;
-            if (m_scheduler.is_valid())
+            if (use_scheduler(s - count))
             {
                 auto fu =
                 boost::asynchronous::post_future(m_scheduler,
@@ -1123,7 +1101,7 @@ public:
 
         // add input using placement new
         ((T*) pos)->~T();
-        new ((T*) pos) T(std::forward<Args...>(args...));
+        new ((T*) pos) T(std::forward<Args>(args)...);
 
         // move back from temporary
         auto temp_end = temp_begin + n;
@@ -1850,9 +1828,10 @@ public:
     }
 
 
-    std::size_t calc_new_capacity(size_type hint) const
+    // geometric growth: amortized constant time push_back, without over-allocating for large inserts
+    std::size_t calc_new_capacity(size_type required) const
     {
-        return (hint *2) + 10;
+        return std::max<std::size_t>({required, 2 * m_capacity, (std::size_t)default_capacity});
     }
 
     // asynchronous members
@@ -1915,9 +1894,45 @@ public:
 
 private:
 
+    // memory for n elements, given back to the allocator when the last user (vector or algorithm) is done
+    struct raw_deleter
+    {
+        void operator()(T* p)
+        {
+            m_allocator.deallocate(p,m_capacity);
+        }
+        Alloc m_allocator;
+        std::size_t m_capacity;
+    };
+    std::shared_ptr<T> allocate_raw(size_type n)
+    {
+        return std::shared_ptr<T>(m_allocator.allocate(n),raw_deleter{m_allocator,n});
+    }
+
+    // operations on at most cutoff elements would be executed by a single task anyway.
+    // They are done in the calling thread, which saves the scheduler round-trips
+    bool use_scheduler(size_type n) const
+    {
+        return m_scheduler.is_valid() &&
+               n > static_cast<size_type>(boost::asynchronous::detail::default_cutoff(m_cutoff));
+    }
+
+    static T&& move_element(T& t, std::true_type /*force_move*/)
+    {
+        return std::move(t);
+    }
+    static auto move_element(T& t, std::false_type /*force_move*/) -> decltype(std::move_if_noexcept(t))
+    {
+        return std::move_if_noexcept(t);
+    }
+
     std::size_t reallocate_helper(size_type new_memory)
     {
-        std::shared_ptr<T> raw (m_allocator.allocate(new_memory),[this,new_memory](T* p){this->m_allocator.deallocate(p,new_memory);});
+        if (!use_scheduler(m_size))
+        {
+            return sequential_reallocate(new_memory);
+        }
+        std::shared_ptr<T> raw = allocate_raw(new_memory);
 
         // create our current number of objects with placement new
         auto n = m_size;
@@ -2005,6 +2020,35 @@ private:
 
         return new_memory;
     }
+    // moves our elements into new memory with placement new, no default construction and assignment
+    std::size_t sequential_reallocate(size_type new_memory)
+    {
+        std::shared_ptr<T> raw = allocate_raw(new_memory);
+        T* dest = raw.get();
+        std::size_t done = 0;
+        try
+        {
+            for (iterator it = begin(); done < m_size; ++it, ++done)
+            {
+                new (dest + done) T(move_element(*it,std::integral_constant<bool,force_move>()));
+            }
+        }
+        catch(...)
+        {
+            // we are unchanged unless a move constructor threw
+            boost::asynchronous::detail::serial_dtor<T,std::size_t>((std::size_t)0,done,(char*)dest);
+            throw;
+        }
+        auto new_data =  std::make_shared<boost::asynchronous::placement_deleter<T,Job,std::shared_ptr<T>>>
+                (m_size,std::move(raw),m_cutoff,m_task_name,m_prio);
+        if(!!m_data)
+        {
+            boost::asynchronous::detail::serial_dtor<T,std::size_t>((std::size_t)0,m_data->size_,(char*)m_data->data());
+            m_data->size_=0;
+        }
+        std::swap(m_data,new_data);
+        return new_memory;
+    }
 
     struct async_reallocate_task: public boost::asynchronous::continuation_task<internal_data_type>
     {
@@ -2028,7 +2072,7 @@ private:
                 auto prio = m_prio;
                 auto beg = m_begin; auto end =m_end;
 
-                std::shared_ptr<T> raw (m_allocator.allocate(new_memory),[this,new_memory,alloc](T* p)mutable{alloc.deallocate(p,new_memory);});
+                std::shared_ptr<T> raw (m_allocator.allocate(new_memory),raw_deleter{alloc,new_memory});
 
                 auto cont_p = boost::asynchronous::parallel_placement<T,Job>
                         (0,m_size,(char*)raw.get(),T(),m_cutoff,this->get_name()+"vector_reallocate_placement",m_prio);
@@ -2189,14 +2233,15 @@ private:
     {
         return (lhs != rhs) && !(lhs < rhs);
     }
+    // used by every push_back, kept together
+    internal_data_type m_data;
+    std::size_t m_size;
+    std::size_t m_capacity;
     // only used from "outside" (i.e. not algorithms)
     boost::asynchronous::any_shared_scheduler_proxy<Job> m_scheduler;
-    internal_data_type m_data;
     long m_cutoff;
-    std::string m_task_name;
     std::size_t m_prio;
-    std::size_t m_size;
-    std::size_t m_capacity;
+    std::string m_task_name;
     Alloc m_allocator;
 };
 
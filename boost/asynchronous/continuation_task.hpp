@@ -76,8 +76,12 @@ create_continuation(OnDone&& on_done, Args&&... args)
     boost::asynchronous::detail::continuation<void,BOOST_ASYNCHRONOUS_DEFAULT_JOB,future_type> c (
                 state,boost::asynchronous::detail::make_future_tuple(args...), std::chrono::milliseconds(0), std::forward<Args>(args)...);
     c.on_done(std::forward<OnDone>(on_done));
-    boost::asynchronous::any_continuation a(std::move(c));
-    boost::asynchronous::get_continuations().emplace_front(std::move(a));
+    // sub-tasks post the continuation when done, no need of registration
+    if (!c.post_when_ready())
+    {
+        boost::asynchronous::any_continuation a(std::move(c));
+        boost::asynchronous::get_continuations().emplace_front(std::move(a));
+    }
 }
 
 /*! \fn void create_continuation(OnDone&& on_done, boost/std::future<Args>&&... args)
@@ -222,8 +226,12 @@ create_continuation_job(OnDone&& on_done, Args&&... args)
     boost::asynchronous::detail::continuation<void,Job,future_type> c (
                 state,boost::asynchronous::detail::make_future_tuple(args...), std::chrono::milliseconds(0), std::forward<Args>(args)...);
     c.on_done(std::forward<OnDone>(on_done));
-    boost::asynchronous::any_continuation a(std::move(c));
-    boost::asynchronous::get_continuations().emplace_front(std::move(a));
+    // sub-tasks post the continuation when done, no need of registration
+    if (!c.post_when_ready())
+    {
+        boost::asynchronous::any_continuation a(std::move(c));
+        boost::asynchronous::get_continuations().emplace_front(std::move(a));
+    }
 }
 
 /*! \fn void create_continuation(OnDone&& on_done, Seq&& seq)
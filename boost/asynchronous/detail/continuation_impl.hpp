@@ -447,11 +447,74 @@ if (!boost::type_erasure::is_empty(weak_scheduler))                         \
     auto locked_scheduler = weak_scheduler.lock();                          \
     if (locked_scheduler.is_valid())                                        \
     {                                                                       \
+        prepare_ready_hook(weak_scheduler,args...);                         \
         continuation_ctor_helper                                            \
             (locked_scheduler,interruptibles,std::forward<Args>(args)...);  \
     }                                                                       \
 }
 
+// sets a promise from the expected given by a sub-task done functor
+template <class Return>
+void set_promise_from_expected(std::promise<Return>& p, boost::asynchronous::expected<Return>&& r)
+{
+    if (r.has_exception())
+        p.set_exception(r.get_exception_ptr());
+    else
+        p.set_value(std::move(r.get()));
+}
+inline void set_promise_from_expected(std::promise<void>& p, boost::asynchronous::expected<void>&& r)
+{
+    if (r.has_exception())
+        p.set_exception(r.get_exception_ptr());
+    else
+        p.set_value();
+}
+
+// true if a sub-task can tell us when it is done (continuation_task): set_done_func and get_promise
+template <class T, class Enable=void>
+struct has_ready_hook : std::false_type {};
+template <class T>
+struct has_ready_hook<T,typename std::enable_if<
+        std::is_same<decltype(std::declval<T&>().set_done_func(
+                                  std::function<void(boost::asynchronous::expected<typename T::return_type>)>())),void>::value &&
+        std::is_same<decltype(std::declval<T const&>().get_promise()),
+                     std::shared_ptr<std::promise<typename T::return_type>>>::value>::type>
+    : std::true_type {};
+
+template <typename... Args>
+struct all_have_ready_hook : std::true_type {};
+template <typename Front, typename... Tail>
+struct all_have_ready_hook<Front,Tail...>
+    : std::integral_constant<bool, has_ready_hook<typename std::decay<Front>::type>::value &&
+                                   all_have_ready_hook<Tail...>::value> {};
+
+// posted instead of a sub-task which tells us when it is done (push mode).
+// If the sub-task throws, its result is set with the exception so that the continuation still gets posted.
+template <class Task>
+struct ready_hook_task : public Task
+{
+    ready_hook_task(Task t)
+        : Task(std::move(t))
+    {
+    }
+    void operator()()
+    {
+        try
+        {
+            Task::operator()();
+        }
+        catch(...)
+        {
+            try
+            {
+                this->this_task_result().set_exception(std::current_exception());
+            }
+            // the sub-task had already set its result before throwing, it is done
+            catch(std::future_error&){}
+        }
+    }
+};
+
 // the continuation task implementation
 template <class Return, typename Job=BOOST_ASYNCHRONOUS_DEFAULT_JOB, typename Tuple=std::tuple<std::future<Return> > , typename Duration = std::chrono::milliseconds >
 struct continuation
@@ -480,6 +543,8 @@ struct continuation
         , m_state(std::move(rhs.m_state))
         , m_timeout(std::move(rhs.m_timeout))
         , m_start(std::move(rhs.m_start))
+        , m_finished(std::move(rhs.m_finished))
+        , m_post_ready(std::move(rhs.m_post_ready))
     {
     }
     continuation(continuation const& rhs)noexcept
@@ -489,6 +554,8 @@ struct continuation
         , m_state(std::move((const_cast<continuation&>(rhs)).m_state))
         , m_timeout(std::move((const_cast<continuation&>(rhs)).m_timeout))
         , m_start(std::move((const_cast<continuation&>(rhs)).m_start))
+        , m_finished(std::move((const_cast<continuation&>(rhs)).m_finished))
+        , m_post_ready(std::move((const_cast<continuation&>(rhs)).m_post_ready))
     {
     }
 
@@ -500,6 +567,8 @@ struct continuation
         std::swap(m_state,rhs.m_state);
         std::swap(m_timeout,rhs.m_timeout);
         std::swap(m_start,rhs.m_start);
+        std::swap(m_finished,rhs.m_finished);
+        std::swap(m_post_ready,rhs.m_post_ready);
         return *this;
     }
     continuation& operator= (continuation const& rhs)noexcept
@@ -510,6 +579,8 @@ struct continuation
         std::swap(m_state,(const_cast<continuation&>(rhs)).m_state);
         std::swap(m_timeout,(const_cast<continuation&>(rhs)).m_timeout);
         std::swap(m_start,(const_cast<continuation&>(rhs)).m_start);
+        std::swap(m_finished,(const_cast<continuation&>(rhs)).m_finished);
+        std::swap(m_post_ready,(const_cast<continuation&>(rhs)).m_post_ready);
         return *this;
     }
 
@@ -546,6 +617,117 @@ struct continuation
         m_start = std::chrono::high_resolution_clock::now();
         //TODO interruptible
     }
+    // called by the last sub-task to complete (push mode), the continuation then gets posted
+    struct subtask_finished
+    {
+        explicit subtask_finished(std::size_t pending)
+            : m_pending(pending), m_ready()
+        {
+        }
+        void done()
+        {
+            if (--m_pending == 0)
+            {
+                // m_ready holds the continuation, which is not needed here any more
+                std::function<void()> ready(std::move(m_ready));
+                ready();
+            }
+        }
+        // sub-tasks + 1 for post_when_ready, as sub-tasks could be done before the continuation is complete
+        std::atomic<std::size_t> m_pending;
+        std::function<void()> m_ready;
+    };
+    // the job executing the continuation once all sub-tasks are done
+    template <class JobType>
+    struct ready_job : public boost::asynchronous::job_traits<JobType>::diagnostic_type
+    {
+        ready_job(std::shared_ptr<continuation> c)
+            : boost::asynchronous::job_traits<JobType>::diagnostic_type()
+            , m_continuation(std::move(c))
+        {
+        }
+        void operator()()
+        {
+            (*m_continuation)();
+        }
+        std::shared_ptr<continuation> m_continuation;
+    };
+    // if all sub-tasks can tell us when they are done, they do and we do not need to be polled.
+    // Not possible with timeout or interruption as the scheduler has to check these.
+    template <typename Weak,typename... Args>
+    typename std::enable_if<boost::asynchronous::detail::all_have_ready_hook<Args...>::value,void>::type
+    prepare_ready_hook(Weak const& weak_scheduler,Args&... args)
+    {
+        if (!!m_state || m_timeout.count() != 0)
+            return;
+        m_finished = std::make_shared<subtask_finished>(sizeof...(Args) + 1);
+        set_ready_hook(args...);
+        m_post_ready = [weak_scheduler](std::shared_ptr<continuation> c)
+        {
+            auto scheduler = weak_scheduler.lock();
+            if (scheduler.is_valid())
+            {
+                typedef typename decltype(scheduler)::job_type job_type;
+                typename boost::asynchronous::job_traits<job_type>::wrapper_type w(ready_job<job_type>(std::move(c)));
+                // we are in the thread of the last sub-task, keep its queue for locality
+                scheduler.post(std::move(w),boost::asynchronous::get_own_queue_index<>());
+            }
+        };
+    }
+    template <typename Weak,typename... Args>
+    typename std::enable_if<!boost::asynchronous::detail::all_have_ready_hook<Args...>::value,void>::type
+    prepare_ready_hook(Weak const&,Args&...)
+    {
+        // polling
+    }
+    void set_ready_hook()
+    {
+    }
+    template <typename Front,typename... Tail>
+    void set_ready_hook(Front& front,Tail&... tail)
+    {
+        auto promise = front.get_promise();
+        auto finished = m_finished;
+        front.set_done_func([promise,finished](boost::asynchronous::expected<typename Front::return_type> r)
+                            {
+                                boost::asynchronous::detail::set_promise_from_expected(*promise,std::move(r));
+                                finished->done();
+                            });
+        set_ready_hook(tail...);
+    }
+    // to be called once on_done is set. Returns false if the continuation has to be added to the waiting continuations
+    bool post_when_ready()
+    {
+        if (!m_finished)
+            return false;
+        std::shared_ptr<subtask_finished> finished = std::move(m_finished);
+        auto post_ready = std::move(m_post_ready);
+        auto self = std::make_shared<continuation>(std::move(*this));
+        finished->m_ready = [self,post_ready](){post_ready(self);};
+        finished->done();
+        return true;
+    }
+    // in push mode, a sub-task has to tell us it is done even if it throws
+    template <typename T,typename Task>
+    typename std::enable_if<boost::asynchronous::detail::has_ready_hook<typename std::decay<Task>::type>::value,void>::type
+    post_subtask(T& sched,Task&& t,std::string const& n)
+    {
+        if (m_finished)
+        {
+            typedef boost::asynchronous::detail::ready_hook_task<typename std::decay<Task>::type> task_type;
+            boost::asynchronous::post_future(sched,task_type(std::forward<Task>(t)),n,boost::asynchronous::get_own_queue_index<>());
+        }
+        else
+        {
+            boost::asynchronous::post_future(sched,std::forward<Task>(t),n,boost::asynchronous::get_own_queue_index<>());
+        }
+    }
+    template <typename T,typename Task>
+    typename std::enable_if<!boost::asynchronous::detail::has_ready_hook<typename std::decay<Task>::type>::value,void>::type
+    post_subtask(T& sched,Task&& t,std::string const& n)
+    {
+        boost::asynchronous::post_future(sched,std::forward<Task>(t),n,boost::asynchronous::get_own_queue_index<>());
+    }
     template <typename T,typename Interruptibles,typename Last>
     void continuation_ctor_helper(T& sched, Interruptibles& interruptibles,Last&& l)
     {
@@ -553,7 +735,7 @@ struct continuation
         if (!m_state)
         {
             // no interruptible requested
-            boost::asynchronous::post_future(sched,std::forward<Last>(l),n,boost::asynchronous::get_own_queue_index<>());
+            post_subtask(sched,std::forward<Last>(l),n);
         }
         else if(!m_state->is_interrupted())
         {
@@ -569,7 +751,7 @@ struct continuation
         if (!m_state)
         {
             // no interruptible requested
-            boost::asynchronous::post_future(sched,std::forward<Front>(front),n,boost::asynchronous::get_own_queue_index<>());
+            post_subtask(sched,std::forward<Front>(front),n);
         }
         else
         {
@@ -596,8 +778,7 @@ struct continuation
             return true;
         }
         // if timeout, we are ready too
-        typename std::chrono::high_resolution_clock::time_point time_now = std::chrono::high_resolution_clock::now();
-        if (m_timeout.count() != 0 && (time_now - m_start >= m_timeout))
+        if (m_timeout.count() != 0 && (std::chrono::high_resolution_clock::now() - m_start >= m_timeout))
         {
             return true;
         }
@@ -615,6 +796,9 @@ struct continuation
     std::shared_ptr<boost::asynchronous::detail::interrupt_state> m_state;
     Duration m_timeout;
     typename std::chrono::high_resolution_clock::time_point m_start;
+    // push mode only
+    std::shared_ptr<subtask_finished> m_finished;
+    std::function<void(std::shared_ptr<continuation>)> m_post_ready;
 
     template<std::size_t I = 0, typename... Tp>
     inline typename std::enable_if<I == sizeof...(Tp), void>::type
@@ -680,6 +864,92 @@ if (!boost::type_erasure::is_empty(weak_scheduler))                         \
     }                                                                       \
 }
 
+// job executing a sub-task of a callback continuation. The result is given to the continuation by the done functor
+// of the task, so unlike post_future, no promise / future is needed.
+template <class Task, class Job>
+struct continuation_subtask_job : public boost::asynchronous::job_traits<Job>::diagnostic_type
+{
+    continuation_subtask_job(Task t)
+        : boost::asynchronous::job_traits<Job>::diagnostic_type()
+        , m_task(std::move(t))
+    {}
+    continuation_subtask_job(continuation_subtask_job&& rhs)noexcept
+        : boost::asynchronous::job_traits<Job>::diagnostic_type()
+        , m_task(std::move(rhs.m_task))
+    {}
+    continuation_subtask_job& operator= (continuation_subtask_job&& rhs)noexcept
+    {
+        std::swap(m_task,rhs.m_task);
+        return *this;
+    }
+    continuation_subtask_job(continuation_subtask_job const& rhs)
+        : boost::asynchronous::job_traits<Job>::diagnostic_type()
+        , m_task(std::move(const_cast<continuation_subtask_job&>(rhs).m_task))
+    {}
+    void operator()()
+    {
+        try
+        {
+            m_task();
+        }
+        catch(boost::thread_interrupted&)
+        {
+            boost::asynchronous::task_aborted_exception ta;
+            m_task.this_task_result().set_exception(std::make_exception_ptr(ta));
+            this->set_failed();
+        }
+        catch(...)
+        {
+            m_task.this_task_result().set_exception(std::current_exception());
+            this->set_failed();
+        }
+    }
+    Task m_task;
+};
+
+// tasks which can be posted as continuation_subtask_job: they report their result through this_task_result()
+template <class T, class Enable=void>
+struct has_lean_subtask_post : std::false_type {};
+template <class T>
+struct has_lean_subtask_post<T,typename std::enable_if<
+        !boost::asynchronous::detail::is_serializable<T>::value &&
+        std::is_same<void,decltype(std::declval<T&>()())>::value &&
+        std::is_same<decltype(std::declval<T const&>().this_task_result()),
+                     boost::asynchronous::continuation_result<typename T::return_type>>::value>::type>
+    : std::true_type {};
+
+// jobs without diagnostics never read their name (see job_traits<any_callable>)
+template <class Job>
+struct job_ignores_name : std::integral_constant<bool,
+        std::is_same<Job,boost::asynchronous::any_callable>::value ||
+        std::is_same<typename boost::asynchronous::job_traits<Job>::diagnostic_type,boost::asynchronous::no_diagnostics>::value>
+{};
+
+// posts a sub-task of a callback continuation.
+// Serializable tasks and tasks without this_task_result (any_continuation_task) still go through post_future.
+template <class S, class Task>
+typename std::enable_if<boost::asynchronous::detail::has_lean_subtask_post<typename std::decay<Task>::type>::value>::type
+post_continuation_subtask(S const& scheduler, Task&& t, std::size_t prio)
+{
+    typedef typename S::job_type job_type;
+    // copy the name only if the job can make use of it
+    std::string name;
+    if (!boost::asynchronous::detail::job_ignores_name<job_type>::value)
+        name = t.get_name();
+    typename boost::asynchronous::job_traits<job_type>::wrapper_type w(
+                boost::asynchronous::detail::continuation_subtask_job<typename std::decay<Task>::type,job_type>(std::forward<Task>(t)));
+    if (!boost::asynchronous::detail::job_ignores_name<job_type>::value)
+        w.set_name(std::move(name));
+    scheduler.post(std::move(w),prio);
+}
+template <class S, class Task>
+typename std::enable_if<!boost::asynchronous::detail::has_lean_subtask_post<typename std::decay<Task>::type>::value>::type
+post_continuation_subtask(S const& scheduler, Task&& t, std::size_t prio)
+{
+    std::string name = t.get_name();
+    boost::asynchronous::post_future(scheduler,std::forward<Task>(t),name,prio);
+}
+
 template <class Return,
           typename Job=BOOST_ASYNCHRONOUS_DEFAULT_JOB,
           typename Tuple=std::tuple<boost::asynchronous::expected<Return> > ,
@@ -714,13 +984,14 @@ struct callback_continuation
                           Args&&... args)
     : m_state(state)
     , m_timeout(d)
-    , m_finished(std::make_shared<subtask_finished>(std::move(t),!!m_state,(m_timeout.count() != 0)))
+    , m_finished(std::make_shared<subtask_finished_with<Func>>(std::move(t),std::move(f)))
     , m_post_policy(post_policy)
     {
         // remember when we started
         m_start = std::chrono::high_resolution_clock::now();
 
-        on_done(std::move(f));
+        // the done functor is there
+        m_finished->done();
         std::vector<boost::asynchronous::any_interruptible> interruptibles;
         BOOST_ASYNCHRONOUS_TRY_OTHER_JOB_TYPES(Job)
         else
@@ -742,7 +1013,7 @@ struct callback_continuation
                           Args&&... args)
     : m_state(state)
     , m_timeout(d)
-    , m_finished(std::make_shared<subtask_finished>(std::move(t),!!m_state,(m_timeout.count() != 0)))
+    , m_finished(std::make_shared<subtask_finished_deferred>(std::move(t)))
     , m_post_policy(post_policy)
     {
         // remember when we started
@@ -768,13 +1039,14 @@ struct callback_continuation
                           std::tuple<Args...> args)
     : m_state(state)
     , m_timeout(d)
-    , m_finished(std::make_shared<subtask_finished>(std::move(t),!!m_state,(m_timeout.count() != 0)))
+    , m_finished(std::make_shared<subtask_finished_with<Func>>(std::move(t),std::move(f)))
     , m_post_policy(post_policy)
     {
         // remember when we started
         m_start = std::chrono::high_resolution_clock::now();
 
-        on_done(std::move(f));
+        // the done functor is there
+        m_finished->done();
         std::vector<boost::asynchronous::any_interruptible> interruptibles;
         BOOST_ASYNCHRONOUS_TRY_OTHER_JOB_TYPES2(Job)
         else
@@ -798,7 +1070,6 @@ struct callback_continuation
                               std::shared_ptr<boost::asynchronous::detail::interrupt_state> state,bool last_task,
                               boost::asynchronous::continuation_post_policy post_policy,Task&& t)
         {
-            std::string n(std::move(t.get_name()));
             auto finished = func;
             t.set_done_func([finished](boost::asynchronous::expected<typename Task::return_type> r)
                             {
@@ -825,12 +1096,13 @@ struct callback_continuation
                 else
                 {
                     // no interruptible requested
-                    boost::asynchronous::post_future(sched,std::forward<Task>(t),n,boost::asynchronous::get_own_queue_index<>());
+                    boost::asynchronous::detail::post_continuation_subtask(sched,std::forward<Task>(t),boost::asynchronous::get_own_queue_index<>());
                 }
             }
             else if(!state->is_interrupted())
             {
                 // interruptible requested
+                std::string n(std::move(t.get_name()));
                 interruptibles.push_back(std::get<1>(
                                              boost::asynchronous::interruptible_post_future(sched,std::forward<Task>(t),n,
                                                                                             boost::asynchronous::get_own_queue_index<>())));
@@ -913,14 +1185,14 @@ struct callback_continuation
                                std::get<I>((*finished).m_futures) = std::move(r);
                                finished->done();
                             });
-        std::string n(std::move(std::get<I>(front).get_name()));
         if (!m_state)
         {
             // no interruptible requested
-            boost::asynchronous::post_future(sched,std::move(std::get<I>(front)),n,boost::asynchronous::get_own_queue_index<>());
+            boost::asynchronous::detail::post_continuation_subtask(sched,std::move(std::get<I>(front)),boost::asynchronous::get_own_queue_index<>());
         }
         else
         {
+            std::string n(std::move(std::get<I>(front).get_name()));
             interruptibles.push_back(std::get<1>(
                                          boost::asynchronous::interruptible_post_future(sched,std::move(std::get<I>(front)),n,
                                                                                         boost::asynchronous::get_own_queue_index<>())));
@@ -938,10 +1210,11 @@ struct callback_continuation
     void operator()()
     {
     }
+    // only for the version where done functor is set later
     template <class Func>
     void on_done(Func f)
     {
-        m_finished->on_done(std::move(f));
+        static_cast<subtask_finished_deferred&>(*m_finished).on_done(std::move(f));
     }
     bool is_ready()
     {
@@ -960,13 +1233,14 @@ struct callback_continuation
         }
         return m_finished->is_ready();
     }
-    // called each time a subtask gives us a ready future. When all are here, we are done
+    // called each time a subtask gives us a ready future. When all are here (+1 for the done functor), we are done
     struct subtask_finished
     {
-        subtask_finished(Tuple t, bool , bool )
-            :m_futures(std::move(t)),m_ready_futures(0),m_done()
+        subtask_finished(Tuple t)
+            :m_futures(std::move(t)),m_ready_futures(0)
         {
         }
+        virtual ~subtask_finished(){}
         void done()
         {
             if (++m_ready_futures == (std::tuple_size<Tuple>::value + 1))
@@ -974,15 +1248,6 @@ struct callback_continuation
                 return_result();
             }
         }
-        template <class Func>
-        void on_done(Func f)
-        {
-            m_done = std::move(f);
-            if (++m_ready_futures == (std::tuple_size<Tuple>::value + 1))
-            {
-                return_result();
-            }
-        }
         bool is_ready()
         {
             return (m_ready_futures == (std::tuple_size<Tuple>::value+1));
@@ -991,13 +1256,42 @@ struct callback_continuation
         {
             // not supported
         }
-        void return_result()
-        {
-            m_done(std::move(m_futures));
-        }
+        virtual void return_result()=0;
 
         Tuple m_futures;
         std::atomic<std::size_t> m_ready_futures;
+    };
+    // done functor known at construction, stored as is
+    template <class Func>
+    struct subtask_finished_with : public subtask_finished
+    {
+        subtask_finished_with(Tuple t, Func f)
+            : subtask_finished(std::move(t)), m_done(std::move(f))
+        {
+        }
+        void return_result() override
+        {
+            m_done(std::move(this->m_futures));
+        }
+        Func m_done;
+    };
+    // done functor given later with on_done
+    struct subtask_finished_deferred : public subtask_finished
+    {
+        subtask_finished_deferred(Tuple t)
+            : subtask_finished(std::move(t)), m_done()
+        {
+        }
+        template <class Func>
+        void on_done(Func f)
+        {
+            m_done = std::move(f);
+            this->done();
+        }
+        void return_result() override
+        {
+            m_done(std::move(this->m_futures));
+        }
         std::function<void(Tuple)> m_done;
     };
 
@@ -1098,8 +1392,7 @@ struct continuation_as_seq
             return true;
         }
         // if timeout, we are ready too
-        typename std::chrono::high_resolution_clock::time_point time_now = std::chrono::high_resolution_clock::now();
-        if (m_timeout.count() != 0 && (time_now - m_start >= m_timeout))
+        if (m_timeout.count() != 0 && (std::chrono::high_resolution_clock::now() - m_start >= m_timeout))
         {
             return true;
         }
@@ -1295,7 +1588,6 @@ struct callback_continuation_as_seq
         unsigned index = 0;
         for(auto& elem : l)
         {
-            std::string n(elem.get_name());
             auto finished = m_finished;
             elem.set_done_func([finished,index](boost::asynchronous::expected<typename ArgsVec::return_type> r)
                             {
@@ -1320,11 +1612,12 @@ struct callback_continuation_as_seq
             else if (!m_state)
             {
                 // no interruptible requested
-                boost::asynchronous::post_future(sched,std::move(elem),n,boost::asynchronous::get_own_queue_index<>());
+                boost::asynchronous::detail::post_continuation_subtask(sched,std::move(elem),boost::asynchronous::get_own_queue_index<>());
             }
             else if(!m_state->is_interrupted())
             {
                 // interruptible requested
+                std::string n(elem.get_name());
                 interruptibles.push_back(std::get<1>(
                                              boost::asynchronous::interruptible_post_future(sched,std::move(elem),n,
                                                                                             boost::asynchronous::get_own_queue_index<>())));
@@ -43,7 +43,7 @@ struct job_traits< boost::asynchronous::any_loggable_serializable >
             diagnostic_type,boost::asynchronous::any_loggable_serializable >        wrapper_type;
 
     typedef typename diagnostic_type::diagnostic_item_type                          diagnostic_item_type;
-    typedef boost::asynchronous::diagnostics_table<
+    typedef boost::asynchronous::diagnostics_ring_table<
             std::string,diagnostic_item_type>                                       diagnostic_table_type;
 
     static bool get_failed(boost::asynchronous::any_loggable_serializable const& job)
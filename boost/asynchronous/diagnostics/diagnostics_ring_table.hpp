@@ -0,0 +1,453 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNC_DIAGNOSTICS_DIAGNOSTICS_RING_TABLE_HPP
+#define BOOST_ASYNC_DIAGNOSTICS_DIAGNOSTICS_RING_TABLE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/asynchronous/queue/detail/cache_aligned_storage.hpp>
+#include <boost/asynchronous/diagnostics/latency_histogram.hpp>
+
+// number of finished jobs kept per worker thread. Older ones are overwritten and counted as dropped.
+// 0 keeps no job at all, only the latency histograms
+#ifndef BOOST_ASYNCHRONOUS_DIAGNOSTICS_RETENTION
+#define BOOST_ASYNCHRONOUS_DIAGNOSTICS_RETENTION 4096
+#endif
+// number of job names with latency histograms. Jobs with names seen later are only kept in the rings
+#ifndef BOOST_ASYNCHRONOUS_DIAGNOSTICS_MAX_LATENCY_NAMES
+#define BOOST_ASYNCHRONOUS_DIAGNOSTICS_MAX_LATENCY_NAMES 256
+#endif
+
+namespace boost { namespace asynchronous
+{
+
+// Diagnostics storage with bounded memory and no lock shared between worker threads.
+// Each writing thread gets its own ring of the last "retention" finished jobs, get_map() / get_current() read the rings
+// without blocking writers (an entry overwritten while being read is skipped).
+// Job names are stored once in a name table and replaced by an index in the rings.
+// A ring is given back when its thread ends, so threads created later (for example by an io_threadpool_scheduler) reuse it.
+// Threads beyond number_of_threads writing at the same time share a ring protected by a mutex.
+// Besides, every ring keeps wait and run time histograms per job name of all jobs since the last clear, whatever the retention.
+// Same interface as diagnostics_table, plus dropped().
+// Value must provide get_posted_time(), get_started_time() and get_finished_time() (see diagnostic_item).
+template<typename Key,typename Value,typename Hash=std::hash<Key> >
+class diagnostics_ring_table
+{
+private:
+    static_assert(std::is_trivially_copyable<Value>::value,"diagnostics_ring_table needs a trivially copyable diagnostic item");
+
+    struct entry
+    {
+        // 2*index+1 while being written, 2*index+2 when entry at index is complete
+        std::atomic<std::uint64_t> seq;
+        std::uint32_t key;
+        Value value;
+    };
+
+    struct latency_slot
+    {
+        boost::asynchronous::concurrent_latency_histogram wait;
+        boost::asynchronous::concurrent_latency_histogram run;
+    };
+
+    struct ring
+    {
+        explicit ring(std::size_t capacity)
+            : m_owner(std::make_shared<std::atomic<std::uint64_t>>(0)), m_head(0), m_cleared(0), m_clear_generation(0), m_latency_generation(0)
+            , m_capacity(capacity), m_entries(new entry[capacity])
+            , m_latencies(new std::atomic<latency_slot*>[BOOST_ASYNCHRONOUS_DIAGNOSTICS_MAX_LATENCY_NAMES])
+        {
+            for (std::size_t i = 0; i < capacity; ++i)
+            {
+                m_entries[i].seq.store(0,std::memory_order_relaxed);
+            }
+            for (std::size_t i = 0; i < BOOST_ASYNCHRONOUS_DIAGNOSTICS_MAX_LATENCY_NAMES; ++i)
+            {
+                m_latencies[i].store(nullptr,std::memory_order_relaxed);
+            }
+        }
+        // single writer
+        void push(std::uint32_t key, Value const& value)
+        {
+            record_latency(key,value);
+            if (m_capacity == 0)
+                return;
+            std::uint64_t index = m_head.load(std::memory_order_relaxed);
+            entry& e = m_entries[index % m_capacity];
+            e.seq.store(2*index+1,std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            e.key = key;
+            e.value = value;
+            e.seq.store(2*index+2,std::memory_order_release);
+            m_head.store(index+1,std::memory_order_release);
+        }
+        void record_latency(std::uint32_t key, Value const& value)
+        {
+            // clear() asks the writer to reset its histograms
+            std::uint64_t generation = m_clear_generation.load(std::memory_order_acquire);
+            if (generation != m_latency_generation.load(std::memory_order_relaxed))
+            {
+                for (auto const& slot : m_latency_slots)
+                {
+                    slot->wait.reset();
+                    slot->run.reset();
+                }
+                m_latency_generation.store(generation,std::memory_order_release);
+            }
+            if (key >= BOOST_ASYNCHRONOUS_DIAGNOSTICS_MAX_LATENCY_NAMES)
+                return;
+            latency_slot* slot = m_latencies[key].load(std::memory_order_relaxed);
+            if (!slot)
+            {
+                m_latency_slots.emplace_back(new latency_slot);
+                slot = m_latency_slots.back().get();
+                m_latencies[key].store(slot,std::memory_order_release);
+            }
+            slot->wait.record(std::chrono::duration_cast<std::chrono::nanoseconds>(value.get_started_time() - value.get_posted_time()));
+            slot->run.record(std::chrono::duration_cast<std::chrono::nanoseconds>(value.get_finished_time() - value.get_started_time()));
+        }
+        template <class F>
+        void for_each_latency(std::size_t keys, F&& f)const
+        {
+            // not reset by the writer since the last clear
+            if (m_latency_generation.load(std::memory_order_acquire) != m_clear_generation.load(std::memory_order_acquire))
+                return;
+            for (std::size_t key = 0; key < keys && key < BOOST_ASYNCHRONOUS_DIAGNOSTICS_MAX_LATENCY_NAMES; ++key)
+            {
+                latency_slot* slot = m_latencies[key].load(std::memory_order_acquire);
+                if (slot)
+                    f(key,*slot);
+            }
+        }
+        template <class F>
+        void for_each(F&& f)const
+        {
+            std::uint64_t head = m_head.load(std::memory_order_acquire);
+            std::uint64_t first = m_cleared.load(std::memory_order_acquire);
+            if (head > m_capacity && head - m_capacity > first)
+                first = head - m_capacity;
+            for (std::uint64_t index = first; index < head; ++index)
+            {
+                entry const& e = m_entries[index % m_capacity];
+                if (e.seq.load(std::memory_order_acquire) != 2*index+2)
+                    continue;
+                std::uint32_t key = e.key;
+                Value value = e.value;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                // overwritten by the writer while we were reading
+                if (e.seq.load(std::memory_order_relaxed) != 2*index+2)
+                    continue;
+                f(key,value);
+            }
+        }
+        std::uint64_t dropped()const
+        {
+            std::uint64_t head = m_head.load(std::memory_order_acquire);
+            std::uint64_t cleared = m_cleared.load(std::memory_order_acquire);
+            return (head - cleared > m_capacity) ? head - cleared - m_capacity : 0;
+        }
+        void clear()
+        {
+            m_cleared.store(m_head.load(std::memory_order_acquire),std::memory_order_release);
+            ++m_clear_generation;
+        }
+
+        // thread writing into this ring, 0 if none. Shared with the releaser of the owning thread, which can outlive the table
+        std::shared_ptr<std::atomic<std::uint64_t>> m_owner;
+        std::atomic<std::uint64_t> m_head;
+        std::atomic<std::uint64_t> m_cleared;
+        std::atomic<std::uint64_t> m_clear_generation;
+        std::atomic<std::uint64_t> m_latency_generation;
+        const std::size_t m_capacity;
+        std::unique_ptr<entry[]> m_entries;
+        // histograms per name index, allocated by the writer when a name first shows up
+        std::unique_ptr<std::atomic<latency_slot*>[]> m_latencies;
+        std::vector<std::unique_ptr<latency_slot>> m_latency_slots;
+        // name => index, private to the writer
+        std::unordered_map<Key,std::uint32_t,Hash> m_keys;
+        // keep rings of different threads on different cache lines
+        char m_pad[BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE];
+    };
+
+    // job currently executed by a worker thread, written only by the worker of this index
+    struct current_type
+    {
+        current_type(): seq(0), is_set(false), key(0), value(){}
+        std::atomic<std::uint64_t> seq;
+        bool is_set;
+        std::uint32_t key;
+        Value value;
+        char m_pad[BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE];
+    };
+
+    static std::uint64_t next_id()
+    {
+        static std::atomic<std::uint64_t> id(1);
+        return id++;
+    }
+    static std::uint64_t thread_token()
+    {
+        static thread_local std::uint64_t token = next_id();
+        return token;
+    }
+    // gives back the rings of a thread when it ends
+    struct ring_releaser
+    {
+        ~ring_releaser()
+        {
+            for (auto const& o : m_owned)
+            {
+                std::shared_ptr<std::atomic<std::uint64_t>> owner = o.lock();
+                if (owner)
+                    owner->store(0,std::memory_order_release);
+            }
+        }
+        void add(std::shared_ptr<std::atomic<std::uint64_t>> const& owner)
+        {
+            // forget rings of destroyed tables
+            m_owned.erase(std::remove_if(m_owned.begin(),m_owned.end(),
+                                         [](std::weak_ptr<std::atomic<std::uint64_t>> const& o){return o.expired();}),
+                          m_owned.end());
+            m_owned.push_back(owner);
+        }
+        std::vector<std::weak_ptr<std::atomic<std::uint64_t>>> m_owned;
+    };
+    static ring_releaser& releaser()
+    {
+        static thread_local ring_releaser r;
+        return r;
+    }
+
+    // ring owned by the calling thread, nullptr if all are taken by other threads.
+    // A worker thread first shows up through set_current with its index, it gets the ring of the same index
+    ring* own_ring(std::size_t preferred)const
+    {
+        // most threads always write into the same table
+        static thread_local std::pair<std::uint64_t,ring*> last(0,nullptr);
+        if (last.first == m_id)
+            return last.second;
+        std::uint64_t token = thread_token();
+        ring* found = nullptr;
+        for (auto const& r : m_rings)
+        {
+            if (r->m_owner->load(std::memory_order_acquire) == token)
+            {
+                found = r.get();
+                break;
+            }
+        }
+        if (!found && preferred < m_rings.size())
+        {
+            std::uint64_t expected = 0;
+            if (m_rings[preferred]->m_owner->compare_exchange_strong(expected,token))
+            {
+                found = m_rings[preferred].get();
+                releaser().add(found->m_owner);
+            }
+        }
+        for (auto it = m_rings.begin(); !found && it != m_rings.end(); ++it)
+        {
+            std::uint64_t expected = 0;
+            if ((*it)->m_owner->compare_exchange_strong(expected,token))
+            {
+                found = it->get();
+                releaser().add(found->m_owner);
+            }
+        }
+        if (found)
+            last = std::make_pair(m_id,found);
+        return found;
+    }
+    std::uint32_t register_key(Key const& key)const
+    {
+        std::lock_guard<std::mutex> lock(m_keys_mutex);
+        auto it = m_key_index.find(key);
+        if (it != m_key_index.end())
+            return it->second;
+        std::uint32_t index = static_cast<std::uint32_t>(m_keys.size());
+        m_keys.push_back(key);
+        m_key_index.emplace(key,index);
+        return index;
+    }
+    std::uint32_t key_index(ring* r, Key const& key)const
+    {
+        auto it = r->m_keys.find(key);
+        if (it != r->m_keys.end())
+            return it->second;
+        std::uint32_t index = register_key(key);
+        r->m_keys.emplace(key,index);
+        return index;
+    }
+    std::vector<Key> keys()const
+    {
+        std::lock_guard<std::mutex> lock(m_keys_mutex);
+        return m_keys;
+    }
+
+public:
+    typedef Key key_type;
+    typedef Value mapped_type;
+    typedef Hash hash_type;
+
+    diagnostics_ring_table(size_t number_of_threads, std::size_t retention = BOOST_ASYNCHRONOUS_DIAGNOSTICS_RETENTION)
+        : m_id(next_id())
+        , m_shared_ring(new ring(retention))
+    {
+        for (std::size_t i = 0; i < number_of_threads; ++i)
+        {
+            m_rings.emplace_back(new ring(retention));
+            m_current.emplace_back(new current_type);
+        }
+    }
+    diagnostics_ring_table(diagnostics_ring_table const& other)=delete;
+    diagnostics_ring_table& operator=(diagnostics_ring_table const& other)=delete;
+
+    void add(Key const& key,Value const& value)
+    {
+        ring* r = own_ring(m_rings.size());
+        if (r)
+        {
+            r->push(key_index(r,key),value);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(m_shared_ring_mutex);
+            m_shared_ring->push(key_index(m_shared_ring.get(),key),value);
+        }
+    }
+    void set_current(std::size_t thread_index,Key const& key,Value const& value)
+    {
+        ring* r = own_ring(thread_index);
+        std::uint32_t index = r ? key_index(r,key) : register_key(key);
+        current_type& c = *m_current[thread_index];
+        std::uint64_t seq = c.seq.load(std::memory_order_relaxed);
+        c.seq.store(seq+1,std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        c.is_set = true;
+        c.key = index;
+        c.value = value;
+        c.seq.store(seq+2,std::memory_order_release);
+    }
+    void reset_current(std::size_t thread_index)
+    {
+        current_type& c = *m_current[thread_index];
+        std::uint64_t seq = c.seq.load(std::memory_order_relaxed);
+        c.seq.store(seq+1,std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        c.is_set = false;
+        c.seq.store(seq+2,std::memory_order_release);
+    }
+    std::vector<std::pair<Key,Value>> get_current() const
+    {
+        std::vector<Key> names = keys();
+        std::vector<std::pair<Key,Value>> res;
+        res.reserve(m_current.size());
+        for (auto const& c : m_current)
+        {
+            bool is_set = false;
+            std::uint32_t key = 0;
+            Value value;
+            // the writer does very little between two versions, retry until we get a consistent one
+            for (;;)
+            {
+                std::uint64_t seq = c->seq.load(std::memory_order_acquire);
+                if (seq % 2 != 0)
+                    continue;
+                is_set = c->is_set;
+                key = c->key;
+                value = c->value;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (c->seq.load(std::memory_order_relaxed) == seq)
+                    break;
+            }
+            if (is_set && key < names.size())
+                res.push_back(std::make_pair(names[key],value));
+            else
+                res.push_back(std::pair<Key,Value>());
+        }
+        return res;
+    }
+    std::map<Key,std::list<Value> > get_map() const
+    {
+        std::vector<Key> names = keys();
+        std::map<Key,std::list<Value> > res;
+        auto collect = [&names,&res](std::uint32_t key, Value const& value)
+        {
+            if (key < names.size())
+                res[names[key]].push_back(value);
+        };
+        for (auto const& r : m_rings)
+        {
+            r->for_each(collect);
+        }
+        m_shared_ring->for_each(collect);
+        return res;
+    }
+    // wait and run time distributions per job name since the last clear, including jobs no more in get_map()
+    std::map<Key,boost::asynchronous::job_latency> get_latencies() const
+    {
+        std::vector<Key> names = keys();
+        std::map<Key,boost::asynchronous::job_latency> res;
+        auto collect = [&names,&res](std::size_t key, latency_slot const& slot)
+        {
+            boost::asynchronous::job_latency& latency = res[names[key]];
+            latency.wait.merge(slot.wait.snapshot());
+            latency.run.merge(slot.run.snapshot());
+        };
+        for (auto const& r : m_rings)
+        {
+            r->for_each_latency(names.size(),collect);
+        }
+        m_shared_ring->for_each_latency(names.size(),collect);
+        return res;
+    }
+    // finished jobs overwritten by newer ones since the last clear
+    std::size_t dropped() const
+    {
+        std::uint64_t res = m_shared_ring->dropped();
+        for (auto const& r : m_rings)
+        {
+            res += r->dropped();
+        }
+        return static_cast<std::size_t>(res);
+    }
+    void clear()
+    {
+        for (auto const& r : m_rings)
+        {
+            r->clear();
+        }
+        m_shared_ring->clear();
+    }
+
+private:
+    // unique for every table, even if allocated at the address of a destroyed one
+    const std::uint64_t m_id;
+    std::vector<std::unique_ptr<ring>> m_rings;
+    std::unique_ptr<ring> m_shared_ring;
+    std::mutex m_shared_ring_mutex;
+    std::vector<std::unique_ptr<current_type>> m_current;
+    mutable std::mutex m_keys_mutex;
+    mutable std::vector<Key> m_keys;
+    mutable std::unordered_map<Key,std::uint32_t,Hash> m_key_index;
+};
+}} // boost::asynchronous
+
+#endif // BOOST_ASYNC_DIAGNOSTICS_DIAGNOSTICS_RING_TABLE_HPP
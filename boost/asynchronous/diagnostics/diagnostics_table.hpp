@@ -13,12 +13,14 @@
 #include <memory>
 #include <vector>
 #include <list>
+#include <map>
 
 #include <memory>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/thread/locks.hpp>
 #include <boost/thread/condition.hpp>
+#include <boost/asynchronous/diagnostics/latency_histogram.hpp>
 
 namespace boost { namespace asynchronous
 {
@@ -143,6 +145,25 @@ public:
         }
         return res;
     }
+    // wait and run time distributions per job name
+    std::map<Key,boost::asynchronous::job_latency> get_latencies() const
+    {
+        std::map<Key,boost::asynchronous::job_latency> res;
+        for (auto const& jobs : get_map())
+        {
+            boost::asynchronous::job_latency& latency = res[jobs.first];
+            for (auto const& item : jobs.second)
+            {
+                latency.record(item);
+            }
+        }
+        return res;
+    }
+    // keeps every job, never drops any
+    std::size_t dropped() const
+    {
+        return 0;
+    }
     void clear()
     {
         std::vector<boost::unique_lock<boost::shared_mutex> > locks;
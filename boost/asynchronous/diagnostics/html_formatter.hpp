@@ -54,6 +54,7 @@ struct parameters
     bool filter = true;
     bool add_subheadings = true;
     bool include_most_recent = true;
+    bool include_percentiles = true;
 
     enum _checkboxes {
         CHECKBOXES_DISABLED,
@@ -1275,6 +1276,52 @@ inline void end_table(document & doc) {
              << "      </div>"       << std::endl;
 }
 
+// Table of wait (scheduling) and run (execution) time percentiles per job, from the latency histograms
+inline void latency_table(document & doc, parameters const& params, scheduler_diagnostics::latency_type const& latencies) {
+    if (!params.include_percentiles || latencies.empty()) return;
+
+    doc.body << "      <table class=\"sortable\">"                                                    << std::endl
+             << "        <thead>"                                                                     << std::endl
+             << "          <tr>"                                                                      << std::endl
+             << "            <th rowspan=\"2\" data-column=\"0\">Job name</th>"                      << std::endl
+             << "            <th rowspan=\"2\" data-column=\"1\">count</th>"                         << std::endl
+             << "            <th colspan=\"3\" class=\"spanned scheduling\">Scheduling time percentiles (s.ms.&micro;s)</th>" << std::endl
+             << "            <th colspan=\"3\" class=\"spanned execution\">Execution time percentiles (s.ms.&micro;s)</th>"   << std::endl
+             << "          </tr>"                                                                     << std::endl
+             << "          <tr>"                                                                      << std::endl
+             << "            <th class=\"scheduling\" data-column=\"2\">50%</th>"                    << std::endl
+             << "            <th class=\"scheduling\" data-column=\"3\">99%</th>"                    << std::endl
+             << "            <th class=\"scheduling\" data-column=\"4\">99.9%</th>"                  << std::endl
+             << "            <th class=\"execution\" data-column=\"5\">50%</th>"                     << std::endl
+             << "            <th class=\"execution\" data-column=\"6\">99%</th>"                     << std::endl
+             << "            <th class=\"execution\" data-column=\"7\">99.9%</th>"                   << std::endl
+             << "          </tr>"                                                                     << std::endl
+             << "        </thead>"                                                                    << std::endl
+             << "        <tbody>"                                                                     << std::endl;
+
+#define PERCENTILE(block, hist, p) "            <td class=\"value " block "\" data-sort=\"" << hist.percentile(p).count() << "\">" << format_duration(hist.percentile(p)) << "</td>" << std::endl
+
+    std::size_t id = 0;
+    for (auto it = latencies.begin(); it != latencies.end(); ++it, ++id) {
+        auto const& latency = it->second;
+        doc.body << "          <tr class=\"top_level\">" << std::endl
+                 << "            <td data-sort=\"" << id << "\">" << escape_html(it->first) << "</td>" << std::endl
+                 << "            <td class=\"value\" data-sort=\"" << latency.run.count() << "\">" << latency.run.count() << "</td>" << std::endl
+                 << PERCENTILE("scheduling", latency.wait, 0.5)
+                 << PERCENTILE("scheduling", latency.wait, 0.99)
+                 << PERCENTILE("scheduling", latency.wait, 0.999)
+                 << PERCENTILE("execution", latency.run, 0.5)
+                 << PERCENTILE("execution", latency.run, 0.99)
+                 << PERCENTILE("execution", latency.run, 0.999)
+                 << "          </tr>" << std::endl;
+    }
+
+#undef PERCENTILE
+
+    doc.body << "        </tbody>" << std::endl
+             << "      </table>"   << std::endl;
+}
+
 }
 
 // Function for formatting diagnostics types.
@@ -1371,6 +1418,8 @@ inline void format(document & doc, std::size_t /* index */, std::string const& s
     }
 
     detail::end_table(doc);
+
+    detail::latency_table(doc, params, summary.latencies);
 }
 
 // Summary diagnostics
@@ -1388,6 +1437,8 @@ inline void format(document & doc, std::size_t /* index */, std::string const& s
 
     detail::end_table(doc);
 
+    detail::latency_table(doc, params, data.latencies);
+
 }
 
 // No diagnostics - do not show output
@@ -0,0 +1,236 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNC_DIAGNOSTICS_LATENCY_HISTOGRAM_HPP
+#define BOOST_ASYNC_DIAGNOSTICS_LATENCY_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace boost { namespace asynchronous
+{
+namespace detail
+{
+// Log-linear buckets (as in HdrHistogram): durations below 16ns have their own bucket, then every power of 2 is split
+// into 16 buckets, which gives a relative error below 1/16 for any duration up to about 39 hours (longer ones go into the last bucket).
+struct latency_buckets
+{
+    static const std::size_t sub_bucket_bits = 4;
+    static const std::size_t sub_buckets = 1 << sub_bucket_bits;
+    static const std::size_t max_exponent = 47;
+    static const std::size_t size = (max_exponent - sub_bucket_bits + 2) * sub_buckets;
+
+    static std::size_t highest_bit(std::uint64_t v)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(v);
+#else
+        std::size_t res = 0;
+        while (v >>= 1)
+            ++res;
+        return res;
+#endif
+    }
+    static std::size_t index(std::int64_t nanoseconds)
+    {
+        if (nanoseconds < (std::int64_t)sub_buckets)
+            return nanoseconds < 0 ? 0 : (std::size_t)nanoseconds;
+        std::size_t exponent = highest_bit((std::uint64_t)nanoseconds);
+        if (exponent > max_exponent)
+            return size - 1;
+        std::size_t sub = ((std::uint64_t)nanoseconds >> (exponent - sub_bucket_bits)) & (sub_buckets - 1);
+        return (exponent - sub_bucket_bits + 1) * sub_buckets + sub;
+    }
+    // highest duration going into this bucket
+    static std::int64_t upper_bound(std::size_t index)
+    {
+        if (index < sub_buckets)
+            return (std::int64_t)index;
+        std::size_t shift = index / sub_buckets - 1;
+        std::uint64_t lower = (std::uint64_t)(sub_buckets + index % sub_buckets) << shift;
+        return (std::int64_t)(lower + ((std::uint64_t)1 << shift) - 1);
+    }
+};
+}
+
+// Distribution of durations, with a constant size whatever the number of recorded durations.
+// Histograms of different threads or schedulers can be merged. Percentiles are exact to 1/16 and computed in O(buckets).
+class latency_histogram
+{
+public:
+    typedef std::chrono::nanoseconds duration;
+
+    latency_histogram()
+    {
+        m_buckets.fill(0);
+    }
+    void record(duration const& d)
+    {
+        std::int64_t ns = d.count();
+        ++m_buckets[boost::asynchronous::detail::latency_buckets::index(ns)];
+        if (m_count == 0 || ns < m_min)
+            m_min = ns;
+        if (m_count == 0 || ns > m_max)
+            m_max = ns;
+        ++m_count;
+        m_sum += ns;
+    }
+    void merge(latency_histogram const& other)
+    {
+        if (other.m_count == 0)
+            return;
+        for (std::size_t i = 0; i < m_buckets.size(); ++i)
+        {
+            m_buckets[i] += other.m_buckets[i];
+        }
+        if (m_count == 0 || other.m_min < m_min)
+            m_min = other.m_min;
+        if (m_count == 0 || other.m_max > m_max)
+            m_max = other.m_max;
+        m_count += other.m_count;
+        m_sum += other.m_sum;
+    }
+    std::uint64_t count() const
+    {
+        return m_count;
+    }
+    duration min() const
+    {
+        return duration(m_min);
+    }
+    duration max() const
+    {
+        return duration(m_max);
+    }
+    duration average() const
+    {
+        return duration(m_count == 0 ? 0 : m_sum / (std::int64_t)m_count);
+    }
+    // duration under which the fraction p (0.5 for the median, 0.99...) of the recorded durations are
+    duration percentile(double p) const
+    {
+        if (m_count == 0)
+            return duration(0);
+        std::uint64_t rank = (std::uint64_t)std::ceil(p * (double)m_count);
+        if (rank == 0)
+            rank = 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < m_buckets.size(); ++i)
+        {
+            seen += m_buckets[i];
+            if (seen >= rank)
+            {
+                std::int64_t res = boost::asynchronous::detail::latency_buckets::upper_bound(i);
+                return duration(res < m_min ? m_min : (res > m_max ? m_max : res));
+            }
+        }
+        return duration(m_max);
+    }
+    std::uint64_t bucket_count(std::size_t index) const
+    {
+        return m_buckets[index];
+    }
+
+private:
+    friend class concurrent_latency_histogram;
+    std::array<std::uint64_t,boost::asynchronous::detail::latency_buckets::size> m_buckets;
+    std::uint64_t m_count = 0;
+    std::int64_t m_sum = 0;
+    std::int64_t m_min = 0;
+    std::int64_t m_max = 0;
+};
+
+// latency_histogram written by one thread at a time and read concurrently by others.
+// A reader can see a recording half done (count already updated, bucket not yet), which only makes percentiles slightly off.
+class concurrent_latency_histogram
+{
+public:
+    concurrent_latency_histogram()
+    {
+        reset();
+    }
+    concurrent_latency_histogram(concurrent_latency_histogram const&)=delete;
+    concurrent_latency_histogram& operator=(concurrent_latency_histogram const&)=delete;
+
+    // single writer: no read-modify-write needed
+    void record(std::chrono::nanoseconds const& d)
+    {
+        std::int64_t ns = d.count();
+        auto& bucket = m_buckets[boost::asynchronous::detail::latency_buckets::index(ns)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1,std::memory_order_relaxed);
+        std::uint64_t count = m_count.load(std::memory_order_relaxed);
+        if (count == 0 || ns < m_min.load(std::memory_order_relaxed))
+            m_min.store(ns,std::memory_order_relaxed);
+        if (count == 0 || ns > m_max.load(std::memory_order_relaxed))
+            m_max.store(ns,std::memory_order_relaxed);
+        m_sum.store(m_sum.load(std::memory_order_relaxed) + ns,std::memory_order_relaxed);
+        m_count.store(count + 1,std::memory_order_relaxed);
+    }
+    // only by the writer
+    void reset()
+    {
+        for (auto& b : m_buckets)
+        {
+            b.store(0,std::memory_order_relaxed);
+        }
+        m_count.store(0,std::memory_order_relaxed);
+        m_sum.store(0,std::memory_order_relaxed);
+        m_min.store(0,std::memory_order_relaxed);
+        m_max.store(0,std::memory_order_relaxed);
+    }
+    latency_histogram snapshot() const
+    {
+        latency_histogram res;
+        for (std::size_t i = 0; i < m_buckets.size(); ++i)
+        {
+            res.m_buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        }
+        res.m_count = m_count.load(std::memory_order_relaxed);
+        res.m_sum = m_sum.load(std::memory_order_relaxed);
+        res.m_min = m_min.load(std::memory_order_relaxed);
+        res.m_max = m_max.load(std::memory_order_relaxed);
+        return res;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>,boost::asynchronous::detail::latency_buckets::size> m_buckets;
+    std::atomic<std::uint64_t> m_count;
+    std::atomic<std::int64_t> m_sum;
+    std::atomic<std::int64_t> m_min;
+    std::atomic<std::int64_t> m_max;
+};
+
+// latencies of all jobs with the same name
+struct job_latency
+{
+    // posted => started
+    latency_histogram wait;
+    // started => finished
+    latency_histogram run;
+
+    template <class Item>
+    void record(Item const& item)
+    {
+        wait.record(std::chrono::duration_cast<std::chrono::nanoseconds>(item.get_started_time() - item.get_posted_time()));
+        run.record(std::chrono::duration_cast<std::chrono::nanoseconds>(item.get_finished_time() - item.get_started_time()));
+    }
+    void merge(job_latency const& other)
+    {
+        wait.merge(other.wait);
+        run.merge(other.run);
+    }
+};
+
+}} // boost::asynchronous
+
+#endif // BOOST_ASYNC_DIAGNOSTICS_LATENCY_HISTOGRAM_HPP
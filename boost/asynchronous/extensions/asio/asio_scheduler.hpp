@@ -18,6 +18,7 @@
 
 #include <boost/thread/thread.hpp>
 #include <boost/thread/tss.hpp>
+#include <boost/version.hpp>
 #include <boost/asio.hpp>
 #include <boost/thread/future.hpp>
 
@@ -458,9 +459,25 @@ private:
                             }
                         }
                     }
-                    cpu_load.loop_done_no_job();
-                    // nothing for us to do, give up our time slice
-                    boost::this_thread::yield();
+                    // a policy with blocking support waits for the next handler in our io_service
+                    bool blocked = boost::asynchronous::detail::block_in_reactor(
+                                cpu_load,
+                                [&ioservice](std::chrono::microseconds timeout)
+                                {
+#if BOOST_VERSION >= 106600
+                                    return ioservice->run_one_for(timeout) != 0;
+#else
+                                    boost::this_thread::sleep_for(boost::chrono::microseconds(std::min<long>(timeout.count(),500)));
+                                    return false;
+#endif
+                                },
+                                !waiting.empty() || !other_queues.empty());
+                    if (!blocked)
+                    {
+                        cpu_load.loop_done_no_job();
+                        // nothing for us to do, give up our time slice
+                        boost::this_thread::yield();
+                    }
                 }
                 // remove state from tss
                 boost::asynchronous::get_interrupt_state<>(std::shared_ptr<boost::asynchronous::detail::interrupt_state>(),true);
@@ -15,8 +15,10 @@
 #include <boost/serialization/split_member.hpp>
 #include <boost/asynchronous/diagnostics/any_loggable.hpp>
 #include <boost/asynchronous/callable_any.hpp>
+#include <boost/asynchronous/small_callable.hpp>
 #include <boost/asynchronous/diagnostics/default_loggable_job.hpp>
 #include <boost/asynchronous/diagnostics/diagnostics_table.hpp>
+#include <boost/asynchronous/diagnostics/diagnostics_ring_table.hpp>
 #include <chrono>
 #include <boost/asynchronous/any_serializable.hpp>
 #include <boost/thread/thread.hpp>
@@ -243,6 +245,17 @@ namespace detail
         }
         Fct m_callable;
     };
+    // wrapper for small_callable. Being itself a small_callable, it is moved, not wrapped again, when posted.
+    template <class Base>
+    struct small_base_job : public boost::asynchronous::small_callable, public Base
+    {
+        template <class T>
+        small_base_job(T c) : boost::asynchronous::small_callable(std::move(c))
+        {
+        }
+        small_base_job(small_base_job&&) = default;
+        small_base_job& operator= (small_base_job&&) = default;
+    };
 }
 
 template < class T >
@@ -359,6 +372,64 @@ struct job_traits< boost::asynchronous::any_callable >
     }
 };
 
+template< >
+struct job_traits< boost::asynchronous::small_callable >
+{
+    // no diagnostics to keep tasks small enough to be stored inline
+    typedef boost::asynchronous::no_diagnostics                                     diagnostic_type;
+    typedef boost::asynchronous::detail::small_base_job<diagnostic_type>            wrapper_type;
+
+    typedef boost::asynchronous::diagnostic_item                                    diagnostic_item_type;
+    typedef boost::asynchronous::diagnostics_table<
+            std::string,diagnostic_item_type>                                       diagnostic_table_type;
+
+    static bool get_failed(boost::asynchronous::small_callable const& )
+    {
+        return false;
+    }
+    static void set_posted_time(boost::asynchronous::small_callable& )
+    {
+    }
+    static void set_started_time(boost::asynchronous::small_callable& )
+    {
+    }
+    static void set_failed(boost::asynchronous::small_callable& )
+    {
+    }
+    static void set_finished_time(boost::asynchronous::small_callable& )
+    {
+    }
+    static void set_executing_thread_id(boost::asynchronous::small_callable&, boost::thread::id const&)
+    {
+    }
+    static void set_name(boost::asynchronous::small_callable& , std::string const& )
+    {
+    }
+    static std::string get_name(boost::asynchronous::small_callable& )
+    {
+      return "";
+    }
+    static diagnostic_item_type get_diagnostic_item(boost::asynchronous::small_callable& )
+    {
+      return diagnostic_item_type();
+    }
+    static void set_interrupted(boost::asynchronous::small_callable& , bool )
+    {
+    }
+    template <class Diag>
+    static void add_diagnostic(boost::asynchronous::small_callable& ,Diag* )
+    {
+    }
+    template <class Diag>
+    static void add_current_diagnostic(size_t ,boost::asynchronous::small_callable& ,Diag* )
+    {
+    }
+    template <class Diag>
+    static void reset_current_diagnostic(size_t ,Diag* )
+    {
+    }
+};
+
 template<>
 struct job_traits< boost::asynchronous::any_loggable>
 {
@@ -367,7 +438,7 @@ struct job_traits< boost::asynchronous::any_loggable>
             diagnostic_type,boost::asynchronous::any_loggable>                          wrapper_type;
 
     typedef diagnostic_type::diagnostic_item_type                              diagnostic_item_type;
-    typedef boost::asynchronous::diagnostics_table<
+    typedef boost::asynchronous::diagnostics_ring_table<
             std::string,diagnostic_item_type>                                           diagnostic_table_type;
 
     static bool get_failed(boost::asynchronous::any_loggable const& job)
@@ -435,7 +506,7 @@ struct job_traits< boost::asynchronous::any_serializable >
             diagnostic_type,boost::asynchronous::any_serializable >                     wrapper_type;
 
     typedef diagnostic_type::diagnostic_item_type                              diagnostic_item_type;
-    typedef boost::asynchronous::diagnostics_table<
+    typedef boost::asynchronous::diagnostics_ring_table<
             std::string,diagnostic_item_type>                                           diagnostic_table_type;
 
     static bool get_failed(boost::asynchronous::any_serializable const& )
@@ -0,0 +1,51 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNCHRONOUS_QUEUE_CACHE_ALIGNED_STORAGE_HPP
+#define BOOST_ASYNCHRONOUS_QUEUE_CACHE_ALIGNED_STORAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// size of a cache line on the target architecture. Data written by different threads is placed on different lines
+// to avoid false sharing
+#ifndef BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE
+#define BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE 64
+#endif
+
+namespace boost { namespace asynchronous { namespace detail
+{
+
+// allocates uninitialized memory for n objects of type T, starting on a cache line boundary.
+// T is expected to be declared alignas(BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE) so that each object gets its own line(s).
+// Memory must be released with free_cache_aligned, objects are constructed / destroyed by the caller.
+template <class T>
+T* allocate_cache_aligned(std::size_t n)
+{
+    // room for the alignment and for remembering the raw pointer just in front of the aligned area
+    const std::size_t bytes = n * sizeof(T) + BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE + sizeof(void*);
+    char* raw = static_cast<char*>(::operator new(bytes));
+    std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*) + BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE - 1)
+                             & ~(static_cast<std::uintptr_t>(BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE) - 1);
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+    return reinterpret_cast<T*>(aligned);
+}
+
+template <class T>
+void free_cache_aligned(T* p)
+{
+    if (p)
+    {
+        ::operator delete(reinterpret_cast<void**>(p)[-1]);
+    }
+}
+
+}}} // boost::asynchronous::detail
+#endif // BOOST_ASYNCHRONOUS_QUEUE_CACHE_ALIGNED_STORAGE_HPP
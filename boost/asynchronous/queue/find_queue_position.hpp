@@ -13,6 +13,10 @@
 #include <atomic>
 #include <random>
 #include <cstddef>
+#include <numeric>
+#include <utility>
+
+#include <boost/asynchronous/scheduler/tss_scheduler.hpp>
 
 namespace boost { namespace asynchronous
 {
@@ -57,6 +61,84 @@ struct default_find_position : public RandomPositionPolicy
   }
 };
 
+// Keeps work posted from a worker thread of the pool (without a given position) in this worker's queue,
+// so that sub-tasks of recursive algorithms start on a warm cache and a work-stealing queue can execute them depth-first.
+// Continuations already post their sub-tasks to get_own_queue_index, this position is handled the same way.
+// Posts from outside the pool are distributed randomly like default_find_position.
+// To keep one worker from hoarding all the work, a job goes to a random queue when the local queue holds SpillSize jobs or more.
+// The queue length is only available if the queue knows its size (lockfree_ring_queue, work_stealing_deque, lockfree_size policy),
+// otherwise jobs never spill.
+template <std::size_t SpillSize = 64, class RandomPositionPolicy = boost::asynchronous::default_random_push_policy<> >
+struct local_find_position : public RandomPositionPolicy
+{
+  // used when the queues are not known, a worker of another pool cannot be told apart
+  std::size_t find_position(std::size_t user_pos,std::size_t queue_size)const
+  {
+    if (user_pos == 0)
+    {
+        const std::size_t own = boost::asynchronous::get_own_queue_index<>();
+        return (own != 0 && own <= queue_size) ? own-1 : (this->find_any_position()%queue_size);
+    }
+    return std::min(user_pos-1,queue_size-1);
+  }
+  template <class Queues>
+  std::size_t find_position(std::size_t user_pos,Queues const& queues)const
+  {
+    const std::size_t queue_size = queues.size();
+    const std::size_t own = boost::asynchronous::get_own_queue_index<>();
+    if (user_pos == 0 || user_pos == own)
+    {
+        // check that the poster is a worker of this pool and not of another one
+        if (own != 0 && own <= queue_size && queues[own-1].get() == boost::asynchronous::get_own_queue<>())
+        {
+            if (local_size(*queues[own-1],0) < SpillSize)
+            {
+                return own-1;
+            }
+            return (this->find_any_position()%queue_size);
+        }
+        if (user_pos == 0)
+        {
+            return (this->find_any_position()%queue_size);
+        }
+    }
+    return std::min(user_pos-1,queue_size-1);
+  }
+private:
+  template <class Q>
+  static auto local_size(Q const& q, int) -> decltype(q.size())
+  {
+      return q.size();
+  }
+  template <class Q>
+  static std::size_t local_size(Q const& q, long)
+  {
+      auto vec = q.get_queue_size();
+      return std::accumulate(vec.begin(),vec.end(),std::size_t(0));
+  }
+};
+
+namespace detail
+{
+// calls the queue-aware find_position of a FindPosition policy if it has one, find_position(pos,number of queues) otherwise
+template <class FindPosition, class Queues>
+auto find_queue_position(FindPosition const& policy, std::size_t user_pos, Queues const& queues, int)
+    -> decltype(policy.find_position(user_pos,queues))
+{
+    return policy.find_position(user_pos,queues);
+}
+template <class FindPosition, class Queues>
+std::size_t find_queue_position(FindPosition const& policy, std::size_t user_pos, Queues const& queues, long)
+{
+    return policy.find_position(user_pos,queues.size());
+}
+template <class FindPosition, class Queues>
+std::size_t find_queue_position(FindPosition const& policy, std::size_t user_pos, Queues const& queues)
+{
+    return boost::asynchronous::detail::find_queue_position(policy,user_pos,queues,0);
+}
+}
+
 }}
 
 #endif // BOOST_ASYNC_FIND_QUEUE_POSITION_HPP
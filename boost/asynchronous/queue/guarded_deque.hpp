@@ -90,12 +90,11 @@ public:
         m_not_empty.notify_one();
     }
 
-    //todo move?
     JOB pop()
     {
         lock_type lock(m_mutex);
         m_not_empty.wait(lock, std::bind(&this_type::is_not_empty, this));
-        JOB res = m_jobs.back();
+        JOB res = std::move(m_jobs.back());
         m_jobs.pop_back();
         lock.unlock();
         return res;
@@ -105,7 +104,7 @@ public:
         lock_type lock(m_mutex);
         if (is_not_empty())
         {
-            job = m_jobs.back();
+            job = std::move(m_jobs.back());
             m_jobs.pop_back();
             return true;
         }
@@ -117,7 +116,7 @@ public:
         lock_type lock(m_mutex);
         if (is_not_empty())
         {
-            job = m_jobs.back();
+            job = std::move(m_jobs.back());
             m_jobs.pop_back();
             return true;
         }
@@ -0,0 +1,239 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNC_QUEUE_LOCKFREE_RING_QUEUE_HPP
+#define BOOST_ASYNC_QUEUE_LOCKFREE_RING_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include <boost/thread/thread.hpp>
+
+#include <boost/asynchronous/callable_any.hpp>
+#include <boost/asynchronous/queue/queue_base.hpp>
+#include <boost/asynchronous/queue/any_queue.hpp>
+#include <boost/asynchronous/queue/detail/lockfree_size.hpp>
+#include <boost/asynchronous/queue/detail/cache_aligned_storage.hpp>
+
+namespace boost { namespace asynchronous
+{
+// A bounded multi-producer / multi-consumer queue storing jobs directly inside a pre-allocated ring of cache-line aligned slots
+// (D. Vyukov's bounded MPMC queue).
+// Unlike lockfree_queue, push and pop do not allocate, which makes a difference when posting millions of small jobs.
+// As lockfree_spsc_queue, the queue is bounded: a push to a full queue yields until a consumer makes room,
+// so the capacity (rounded up to a power of 2) has to be chosen according to the expected bursts.
+template <class JOB = BOOST_ASYNCHRONOUS_DEFAULT_JOB, class Size = boost::asynchronous::no_lockfree_size>
+class lockfree_ring_queue:
+#ifndef BOOST_ASYNCHRONOUS_USE_TYPE_ERASURE
+        public boost::asynchronous::any_queue_concept<JOB>,
+#endif
+        public boost::asynchronous::queue_base<JOB>, Size
+{
+public:
+    typedef lockfree_ring_queue<JOB,Size> this_type;
+    typedef JOB job_type;
+
+    lockfree_ring_queue(std::size_t capacity = 1024)
+        : m_mask(round_up_capacity(capacity) - 1)
+        , m_cells(boost::asynchronous::detail::allocate_cache_aligned<cell>(m_mask + 1))
+        , m_enqueue_pos(0)
+        , m_dequeue_pos(0)
+    {
+        for (std::size_t i = 0; i <= m_mask; ++i)
+        {
+            new (&m_cells[i]) cell(i);
+        }
+    }
+    lockfree_ring_queue(const lockfree_ring_queue&) = delete;
+    lockfree_ring_queue& operator=(const lockfree_ring_queue&) = delete;
+    ~lockfree_ring_queue()
+    {
+        // destroy jobs which were never executed
+        JOB job;
+        while (try_pop(job));
+        for (std::size_t i = 0; i <= m_mask; ++i)
+        {
+            m_cells[i].~cell();
+        }
+        boost::asynchronous::detail::free_cache_aligned(m_cells);
+    }
+
+    std::vector<std::size_t> get_queue_size() const
+    {
+        // the difference of both positions is available for free and good enough as an estimate
+        std::vector<std::size_t> res;
+        res.reserve(1);
+        res.push_back(size());
+        return res;
+    }
+    std::vector<std::size_t> get_max_queue_size() const
+    {
+        std::vector<std::size_t> res;
+        res.push_back(Size::max_size());
+        return res;
+    }
+    void reset_max_queue_size()
+    {
+        Size::reset_max_size();
+    }
+    // approximate number of jobs currently waiting
+    std::size_t size() const
+    {
+        const std::size_t enqueued = m_enqueue_pos.load(std::memory_order_relaxed);
+        const std::size_t dequeued = m_dequeue_pos.load(std::memory_order_relaxed);
+        return (enqueued > dequeued) ? enqueued - dequeued : 0;
+    }
+    std::size_t capacity() const
+    {
+        return m_mask + 1;
+    }
+
+    void push(JOB && j, std::size_t)
+    {
+        while (!try_push(std::move(j)))
+        {
+            boost::this_thread::yield();
+        }
+        Size::increase();
+    }
+    void push(JOB && j)
+    {
+        while (!try_push(std::move(j)))
+        {
+            boost::this_thread::yield();
+        }
+        Size::increase();
+    }
+    void push(JOB const& j, std::size_t=0)
+    {
+        JOB copy(j);
+        while (!try_push(std::move(copy)))
+        {
+            boost::this_thread::yield();
+        }
+        Size::increase();
+    }
+
+    JOB pop()
+    {
+        JOB res;
+        while (!try_pop(res))
+        {
+            boost::this_thread::yield();
+        }
+        return res;
+    }
+    bool try_pop(JOB& job)
+    {
+        std::size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+        cell* c = nullptr;
+        for (;;)
+        {
+            c = &m_cells[pos & m_mask];
+            const std::size_t seq = c->m_sequence.load(std::memory_order_acquire);
+            const std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // empty
+                return false;
+            }
+            else
+            {
+                pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        JOB* stored = c->job();
+        job = std::move(*stored);
+        stored->~JOB();
+        // slot free for the producer of the next round
+        c->m_sequence.store(pos + m_mask + 1, std::memory_order_release);
+        Size::decrease();
+        return true;
+    }
+    // multi-consumer, stealing is the same as popping
+    bool try_steal(JOB& job)
+    {
+        return try_pop(job);
+    }
+    // returns false if the queue is full, j is left untouched in this case
+    bool try_push(JOB && j)
+    {
+        std::size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        cell* c = nullptr;
+        for (;;)
+        {
+            c = &m_cells[pos & m_mask];
+            const std::size_t seq = c->m_sequence.load(std::memory_order_acquire);
+            const std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // full
+                return false;
+            }
+            else
+            {
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        new (&c->m_storage) JOB(std::move(j));
+        // publish to consumers
+        c->m_sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static std::size_t round_up_capacity(std::size_t capacity)
+    {
+        std::size_t res = 2;
+        while (res < capacity)
+        {
+            res <<= 1;
+        }
+        return res;
+    }
+    // a slot and its sequence number share the same cache line(s), but no slot shares a line with another one
+    struct alignas(BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE) cell
+    {
+        explicit cell(std::size_t seq): m_sequence(seq){}
+        JOB* job()
+        {
+            return reinterpret_cast<JOB*>(&m_storage);
+        }
+        std::atomic<std::size_t> m_sequence;
+        typename std::aligned_storage<sizeof(JOB),alignof(JOB)>::type m_storage;
+    };
+
+    const std::size_t m_mask;
+    cell* const m_cells;
+    // producers and consumers work on different cache lines.
+    // Padding instead of alignas as the queue itself is allocated with make_shared
+    char m_padding1[BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE];
+    std::atomic<std::size_t> m_enqueue_pos;
+    char m_padding2[BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> m_dequeue_pos;
+    char m_padding3[BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+};
+
+}} // boost::async::queue
+
+#endif // BOOST_ASYNC_QUEUE_LOCKFREE_RING_QUEUE_HPP
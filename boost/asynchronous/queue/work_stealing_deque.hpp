@@ -0,0 +1,273 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNC_QUEUE_WORK_STEALING_DEQUE_HPP
+#define BOOST_ASYNC_QUEUE_WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <boost/thread/thread.hpp>
+
+#include <boost/asynchronous/callable_any.hpp>
+#include <boost/asynchronous/queue/queue_base.hpp>
+#include <boost/asynchronous/queue/any_queue.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/queue/detail/lockfree_size.hpp>
+#include <boost/asynchronous/queue/detail/cache_aligned_storage.hpp>
+
+namespace boost { namespace asynchronous
+{
+// A per-worker work-stealing deque (Chase-Lev) to be used with stealing_multiqueue_threadpool_scheduler.
+// The owner is the worker thread calling try_pop / pop. It pushes and pops at the bottom (LIFO), which gives
+// the sub-tasks of recursive algorithms (posted to get_own_queue_index) depth-first execution and good cache locality.
+// Thieves (try_steal) take the oldest job at the top (FIFO), which is usually the biggest chunk of work left.
+// Pushes from other threads cannot go to the bottom of a Chase-Lev deque, they go to a multi-producer inbox,
+// which is also used when the deque is full.
+template <class JOB = BOOST_ASYNCHRONOUS_DEFAULT_JOB, class Size = boost::asynchronous::no_lockfree_size>
+class work_stealing_deque:
+#ifndef BOOST_ASYNCHRONOUS_USE_TYPE_ERASURE
+        public boost::asynchronous::any_queue_concept<JOB>,
+#endif
+        public boost::asynchronous::queue_base<JOB>, Size
+{
+public:
+    typedef work_stealing_deque<JOB,Size> this_type;
+    typedef JOB job_type;
+
+    work_stealing_deque(std::size_t capacity = 1024)
+        : m_mask(round_up_capacity(capacity) - 1)
+        , m_slots(boost::asynchronous::detail::allocate_cache_aligned<slot>(m_mask + 1))
+        , m_owner(std::thread::id())
+        , m_top(0)
+        , m_bottom(0)
+        , m_inbox()
+    {
+        for (std::size_t i = 0; i <= m_mask; ++i)
+        {
+            new (&m_slots[i]) slot();
+        }
+    }
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+    ~work_stealing_deque()
+    {
+        // destroy jobs which were never executed
+        for (std::int64_t i = m_top.load(); i < m_bottom.load(); ++i)
+        {
+            m_slots[i & m_mask].job()->~JOB();
+        }
+        for (std::size_t i = 0; i <= m_mask; ++i)
+        {
+            m_slots[i].~slot();
+        }
+        boost::asynchronous::detail::free_cache_aligned(m_slots);
+    }
+
+    std::vector<std::size_t> get_queue_size() const
+    {
+        std::vector<std::size_t> res;
+        res.reserve(1);
+        res.push_back(size());
+        return res;
+    }
+    std::vector<std::size_t> get_max_queue_size() const
+    {
+        std::vector<std::size_t> res;
+        res.push_back(Size::max_size());
+        return res;
+    }
+    void reset_max_queue_size()
+    {
+        Size::reset_max_size();
+    }
+    // approximate number of waiting jobs, deque and inbox
+    std::size_t size() const
+    {
+        const std::int64_t deque_size = m_bottom.load(std::memory_order_relaxed) - m_top.load(std::memory_order_relaxed);
+        return (deque_size > 0 ? static_cast<std::size_t>(deque_size) : 0) + m_inbox.get_queue_size()[0];
+    }
+
+    void push(JOB && j, std::size_t)
+    {
+        do_push(std::move(j));
+    }
+    void push(JOB && j)
+    {
+        do_push(std::move(j));
+    }
+    void push(JOB const& j, std::size_t=0)
+    {
+        JOB copy(j);
+        do_push(std::move(copy));
+    }
+
+    JOB pop()
+    {
+        JOB res;
+        while (!try_pop(res))
+        {
+            boost::this_thread::yield();
+        }
+        return res;
+    }
+    // called by the owner only. The first thread calling it becomes the owner.
+    bool try_pop(JOB& job)
+    {
+        if (m_owner.load(std::memory_order_relaxed) != std::this_thread::get_id())
+        {
+            m_owner.store(std::this_thread::get_id(),std::memory_order_relaxed);
+        }
+        // own work first, most recent first
+        if (pop_bottom(job) || m_inbox.try_pop(job))
+        {
+            Size::decrease();
+            return true;
+        }
+        return false;
+    }
+    // called by other workers. Oldest job first.
+    bool try_steal(JOB& job)
+    {
+        if (steal_top(job) || m_inbox.try_steal(job))
+        {
+            Size::decrease();
+            return true;
+        }
+        return false;
+    }
+
+private:
+    static std::size_t round_up_capacity(std::size_t capacity)
+    {
+        std::size_t res = 2;
+        while (res < capacity)
+        {
+            res <<= 1;
+        }
+        return res;
+    }
+    void do_push(JOB && j)
+    {
+        if (m_owner.load(std::memory_order_relaxed) != std::this_thread::get_id() || !push_bottom(std::move(j)))
+        {
+            m_inbox.push(std::move(j));
+        }
+        Size::increase();
+    }
+    // owner only, returns false if full
+    bool push_bottom(JOB && j)
+    {
+        const std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+        const std::int64_t t = m_top.load(std::memory_order_acquire);
+        if (b - t > static_cast<std::int64_t>(m_mask))
+        {
+            return false;
+        }
+        slot& s = m_slots[b & m_mask];
+        // a thief which won this slot in the previous round might still be moving the job out
+        while (s.m_full.load(std::memory_order_acquire))
+        {
+            boost::this_thread::yield();
+        }
+        new (&s.m_storage) JOB(std::move(j));
+        s.m_full.store(true,std::memory_order_release);
+        m_bottom.store(b + 1,std::memory_order_release);
+        return true;
+    }
+    // owner only
+    bool pop_bottom(JOB& job)
+    {
+        const std::int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(b,std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = m_top.load(std::memory_order_relaxed);
+        if (t > b)
+        {
+            // empty
+            m_bottom.store(b + 1,std::memory_order_relaxed);
+            return false;
+        }
+        if (t == b)
+        {
+            // last job, race against thieves
+            const bool won = m_top.compare_exchange_strong(t,t + 1,std::memory_order_seq_cst,std::memory_order_relaxed);
+            m_bottom.store(b + 1,std::memory_order_relaxed);
+            if (!won)
+            {
+                return false;
+            }
+        }
+        take(m_slots[b & m_mask],job);
+        return true;
+    }
+    // any thread
+    bool steal_top(JOB& job)
+    {
+        std::int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = m_bottom.load(std::memory_order_acquire);
+        if (t >= b)
+        {
+            return false;
+        }
+        if (!m_top.compare_exchange_strong(t,t + 1,std::memory_order_seq_cst,std::memory_order_relaxed))
+        {
+            // lost against another thief or the owner
+            return false;
+        }
+        slot& s = m_slots[t & m_mask];
+        // wait until the owner has finished writing the job (it published bottom after, so this should not happen)
+        while (!s.m_full.load(std::memory_order_acquire))
+        {
+            boost::this_thread::yield();
+        }
+        take(s,job);
+        return true;
+    }
+    // the full flag tells the owner when a thief is done moving the job out of a slot it wants to reuse
+    struct alignas(BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE) slot
+    {
+        slot(): m_full(false){}
+        JOB* job()
+        {
+            return reinterpret_cast<JOB*>(&m_storage);
+        }
+        std::atomic<bool> m_full;
+        typename std::aligned_storage<sizeof(JOB),alignof(JOB)>::type m_storage;
+    };
+    static void take(slot& s, JOB& job)
+    {
+        JOB* stored = s.job();
+        job = std::move(*stored);
+        stored->~JOB();
+        s.m_full.store(false,std::memory_order_release);
+    }
+
+    const std::size_t m_mask;
+    slot* const m_slots;
+    std::atomic<std::thread::id> m_owner;
+    // owner and thieves work on different cache lines.
+    char m_padding1[BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE];
+    std::atomic<std::int64_t> m_top;
+    char m_padding2[BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE - sizeof(std::atomic<std::int64_t>)];
+    std::atomic<std::int64_t> m_bottom;
+    char m_padding3[BOOST_ASYNCHRONOUS_CACHE_LINE_SIZE - sizeof(std::atomic<std::int64_t>)];
+    // jobs pushed by other threads than the owner
+    boost::asynchronous::lockfree_queue<JOB,boost::asynchronous::lockfree_size> m_inbox;
+};
+
+}} // boost::async::queue
+
+#endif // BOOST_ASYNC_QUEUE_WORK_STEALING_DEQUE_HPP
@@ -39,6 +39,7 @@
 #include <boost/asynchronous/queue/any_queue.hpp>
 #include <boost/asynchronous/queue/queue_converter.hpp>
 #include <boost/asynchronous/any_scheduler.hpp>
+#include <boost/asynchronous/scheduler/numa_topology.hpp>
 
 namespace boost { namespace asynchronous
 {
@@ -73,6 +74,31 @@ public:
     }
 
 #endif
+    // sub-pools known only at runtime, for example one per NUMA node.
+    // The workers of subpools[i] steal from the sub-pools listed in steal_order[i], in this order.
+    composite_threadpool_scheduler(std::vector<boost::asynchronous::any_shared_scheduler_proxy<Job>> subpools,
+                                   std::vector<std::vector<std::size_t>> const& steal_order)
+        : FindPosition()
+        , m_subpools(std::move(subpools))
+    {
+        std::vector<std::vector<boost::asynchronous::any_queue_ptr<job_type> > > queues;
+        for (auto& s : m_subpools)
+        {
+            add_queue_helper(queues,s);
+        }
+        for (std::size_t i=0; i< m_subpools.size() && i < steal_order.size(); ++i)
+        {
+            std::vector<boost::asynchronous::any_queue_ptr<job_type> > steal_from;
+            for (std::size_t j : steal_order[i])
+            {
+                if (i != j && j < queues.size())
+                {
+                    steal_from.insert(steal_from.end(),queues[j].begin(),queues[j].end());
+                }
+            }
+            (*(m_subpools[i]).get_internal_scheduler_aspect()).set_steal_from_queues(steal_from);
+        }
+    }
 
     ~composite_threadpool_scheduler()
     {
@@ -172,19 +198,12 @@ public:
     {
         if (pos==0)
         {
-            std::map<std::string,
-                     std::list<typename boost::asynchronous::job_traits<job_type>::diagnostic_item_type > > res;
-
-            std::vector<std::pair<std::string,typename boost::asynchronous::job_traits<Job>::diagnostic_item_type>> res2;
+            boost::asynchronous::scheduler_diagnostics res;
             for (typename std::vector<subpool_type>::const_iterator it = m_subpools.begin(); it != m_subpools.end();++it)
             {
-                auto one_diag = (*it).get_diagnostics().totals();
-                res.insert(one_diag.begin(),one_diag.end());
-
-                auto one_diag2 = (*it).get_diagnostics().current();
-                res2.insert(res2.end(),one_diag2.begin(),one_diag2.end());
+                res.merge((*it).get_diagnostics());
             }
-            return boost::asynchronous::scheduler_diagnostics(res,res2);
+            return res;
         }
         else
         {
@@ -577,6 +596,36 @@ make_shared_scheduler_proxy(Args && ... args)
     return composite;
 }
 
+/*!
+ * \brief Creates a composite_threadpool_scheduler with one sub-pool of type Pool per NUMA node.
+ * \brief The workers of a sub-pool are bound to the cpus of their node. Like any pool, they first steal
+ * \brief from their own pool, i.e. their own node, then from the pools of the other nodes, nearest first.
+ * \brief Data first touched by a worker (see parallel_placement) is then allocated on the node processing it.
+ * \brief get_scheduler(i) returns the sub-pool of topology.nodes()[i-1].
+ * \tparam Pool the scheduler used for each node, constructed with its number of threads
+ * \param threads_per_node number of workers of every sub-pool, 0 for a worker per cpu of the node
+ * \param topology the NUMA nodes, by default those of this machine
+ */
+template <class Pool, class FindPosition=boost::asynchronous::default_find_position< >>
+boost::asynchronous::any_shared_scheduler_proxy<typename Pool::job_type>
+make_numa_composite_scheduler(std::size_t threads_per_node = 0,
+                              boost::asynchronous::numa_topology const& topology = boost::asynchronous::numa_topology::system())
+{
+    std::vector<boost::asynchronous::any_shared_scheduler_proxy<typename Pool::job_type>> subpools;
+    std::vector<std::vector<std::size_t>> steal_order;
+    for (std::size_t i = 0; i < topology.size(); ++i)
+    {
+        auto const& node = topology.nodes()[i];
+        auto pool = boost::asynchronous::make_shared_scheduler_proxy<Pool>(
+                        threads_per_node == 0 ? node.m_cpus.size() : threads_per_node);
+        pool.processor_bind(node.cpu_ranges());
+        subpools.push_back(std::move(pool));
+        steal_order.push_back(topology.steal_order(i));
+    }
+    return boost::asynchronous::make_shared_scheduler_proxy<
+            boost::asynchronous::composite_threadpool_scheduler<typename Pool::job_type,FindPosition>>(std::move(subpools),steal_order);
+}
+
 }}
 
 #endif // BOOST_ASYNC_SCHEDULER_COMPOSITE_THREADPOOL_SCHEDULER_HPP
@@ -10,11 +10,16 @@
 #ifndef BOOST_ASYNCHRONOUS_SCHEDULER_CPU_LOAD_POLICIES_HPP
 #define BOOST_ASYNCHRONOUS_SCHEDULER_CPU_LOAD_POLICIES_HPP
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
+#include <memory>
+#include <utility>
 
 #include <boost/thread/thread.hpp>
 
+#include <boost/asynchronous/scheduler/detail/eventcount.hpp>
+
 namespace boost { namespace asynchronous
 {
 
@@ -65,5 +70,195 @@ private:
     std::chrono::high_resolution_clock::time_point m_start;
 };
 
+// Parks idle workers instead of polling: after an adaptive spin phase, a worker sleeps until a job is posted to its scheduler,
+// which wakes exactly one worker. The spin phase grows when spinning pays off (a job arrives while spinning)
+// and shrinks when the worker had to park anyway.
+// A parked worker wakes up after PollUs if continuations are waiting (they are polled),
+// after MaxParkUs otherwise (safety net, for example for jobs stolen by other pools of a composite).
+// Schedulers not supporting parking (multiple_thread_scheduler, basic threads of io_threadpool_scheduler) sleep PollUs after the spin phase.
+template <unsigned MaxSpinLoops=64, unsigned MaxParkUs=100000, unsigned PollUs=500>
+struct parking_cpu_load
+{
+public:
+    parking_cpu_load():m_spin_limit(MaxSpinLoops),m_spins(0){}
+    void set_wakeup(std::shared_ptr<boost::asynchronous::detail::eventcount> wakeup)
+    {
+        m_wakeup = std::move(wakeup);
+    }
+    // called each time a job is popped and executed
+    void popped_job()
+    {
+        if (m_spins != 0)
+        {
+            // spinning was worth it
+            m_spin_limit = std::min<unsigned>(m_spin_limit * 2, MaxSpinLoops);
+            m_spins = 0;
+        }
+    }
+    // for schedulers not supporting parking
+    void loop_done_no_job()
+    {
+        if (++m_spins < m_spin_limit)
+            return;
+        m_spins = 0;
+        std::this_thread::sleep_for(std::chrono::microseconds(PollUs));
+    }
+    // recheck tries to execute a job one last time after announcing that we are going to sleep, returns true if it did
+    template <class Recheck>
+    void loop_done_no_job(Recheck&& recheck, bool continuations_waiting)
+    {
+        if (++m_spins < m_spin_limit)
+            return;
+        m_spins = 0;
+        if (!m_wakeup)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(PollUs));
+            return;
+        }
+        std::uint32_t key = m_wakeup->prepare_wait();
+        bool found = false;
+        try
+        {
+            found = recheck();
+        }
+        catch(...)
+        {
+            m_wakeup->cancel_wait();
+            throw;
+        }
+        if (found)
+        {
+            m_wakeup->cancel_wait();
+            return;
+        }
+        m_wakeup->wait(key,std::chrono::microseconds(continuations_waiting ? PollUs : MaxParkUs));
+        // we had to park, spin less next time
+        m_spin_limit = std::max<unsigned>(m_spin_limit / 2, 1);
+    }
+private:
+    std::shared_ptr<boost::asynchronous::detail::eventcount> m_wakeup;
+    unsigned int m_spin_limit;
+    unsigned int m_spins;
+};
+
+// For schedulers with a reactor (asio_scheduler): after an adaptive spin phase, an idle worker blocks in its reactor
+// (epoll_wait on Linux) until a handler is ready. Posting a job to the io_service wakes it at once through asio's eventfd.
+// Jobs to steal from other pools and waiting continuations cannot wake the reactor, so while there are some,
+// the worker blocks at most PollUs before checking them again, MaxBlockUs otherwise.
+// Schedulers without reactor sleep PollUs after the spin phase.
+template <unsigned MaxSpinLoops=64, unsigned MaxBlockUs=100000, unsigned PollUs=500>
+struct blocking_reactor_cpu_load
+{
+public:
+    blocking_reactor_cpu_load():m_spin_limit(MaxSpinLoops),m_spins(0){}
+    // called each time a job is popped and executed
+    void popped_job()
+    {
+        if (m_spins != 0)
+        {
+            // spinning was worth it
+            m_spin_limit = std::min<unsigned>(m_spin_limit * 2, MaxSpinLoops);
+            m_spins = 0;
+        }
+    }
+    // for schedulers without reactor
+    void loop_done_no_job()
+    {
+        if (++m_spins < m_spin_limit)
+            return;
+        m_spins = 0;
+        std::this_thread::sleep_for(std::chrono::microseconds(PollUs));
+    }
+    // block(timeout) waits in the reactor at most timeout and returns true if it executed a handler
+    template <class Block>
+    void block_in_reactor(Block&& block, bool must_poll)
+    {
+        if (++m_spins < m_spin_limit)
+            return;
+        m_spins = 0;
+        if (block(std::chrono::microseconds(must_poll ? PollUs : MaxBlockUs)))
+        {
+            // blocking paid off, it's the job which made us wait
+            return;
+        }
+        // nothing happened while we were blocked, spin less next time
+        m_spin_limit = std::max<unsigned>(m_spin_limit / 2, 1);
+    }
+private:
+    unsigned int m_spin_limit;
+    unsigned int m_spins;
+};
+
+namespace detail
+{
+// calls block_in_reactor(block,must_poll) if the policy supports it, returns false otherwise
+template <class CPULoad, class Block>
+auto block_in_reactor(CPULoad& cpu_load, Block&& block, bool must_poll, int)
+    -> decltype(cpu_load.block_in_reactor(std::forward<Block>(block),must_poll),bool())
+{
+    cpu_load.block_in_reactor(std::forward<Block>(block),must_poll);
+    return true;
+}
+template <class CPULoad, class Block>
+bool block_in_reactor(CPULoad&, Block&&, bool, long)
+{
+    return false;
+}
+template <class CPULoad, class Block>
+bool block_in_reactor(CPULoad& cpu_load, Block&& block, bool must_poll)
+{
+    return boost::asynchronous::detail::block_in_reactor(cpu_load,std::forward<Block>(block),must_poll,0);
+}
+// true if a CPULoad policy can park workers, schedulers then notify it on every post
+template <class CPULoad>
+struct cpu_load_parks
+{
+    template <class T>
+    static auto test(T* t) -> decltype(t->set_wakeup(std::shared_ptr<boost::asynchronous::detail::eventcount>()),std::true_type());
+    template <class T>
+    static std::false_type test(...);
+    static constexpr bool value = decltype(test<CPULoad>(nullptr))::value;
+};
+template <class CPULoad>
+std::shared_ptr<boost::asynchronous::detail::eventcount> make_wakeup()
+{
+    return boost::asynchronous::detail::cpu_load_parks<CPULoad>::value ?
+                std::make_shared<boost::asynchronous::detail::eventcount>() :
+                std::shared_ptr<boost::asynchronous::detail::eventcount>();
+}
+template <class CPULoad>
+auto set_wakeup(CPULoad& cpu_load, std::shared_ptr<boost::asynchronous::detail::eventcount> wakeup, int)
+    -> decltype(cpu_load.set_wakeup(wakeup))
+{
+    cpu_load.set_wakeup(std::move(wakeup));
+}
+template <class CPULoad>
+void set_wakeup(CPULoad&, std::shared_ptr<boost::asynchronous::detail::eventcount>, long)
+{
+}
+template <class CPULoad>
+void set_wakeup(CPULoad& cpu_load, std::shared_ptr<boost::asynchronous::detail::eventcount> wakeup)
+{
+    boost::asynchronous::detail::set_wakeup(cpu_load,std::move(wakeup),0);
+}
+// calls loop_done_no_job(recheck,continuations_waiting) if the policy supports it, loop_done_no_job() otherwise
+template <class CPULoad, class Recheck>
+auto loop_done_no_job(CPULoad& cpu_load, Recheck&& recheck, bool continuations_waiting, int)
+    -> decltype(cpu_load.loop_done_no_job(std::forward<Recheck>(recheck),continuations_waiting))
+{
+    cpu_load.loop_done_no_job(std::forward<Recheck>(recheck),continuations_waiting);
+}
+template <class CPULoad, class Recheck>
+void loop_done_no_job(CPULoad& cpu_load, Recheck&&, bool, long)
+{
+    cpu_load.loop_done_no_job();
+}
+template <class CPULoad, class Recheck>
+void loop_done_no_job(CPULoad& cpu_load, Recheck&& recheck, bool continuations_waiting)
+{
+    boost::asynchronous::detail::loop_done_no_job(cpu_load,std::forward<Recheck>(recheck),continuations_waiting,0);
+}
+}
+
 }} // boost::asynchronous::scheduler
 #endif // BOOST_ASYNCHRONOUS_SCHEDULER_CPU_LOAD_POLICIES_HPP
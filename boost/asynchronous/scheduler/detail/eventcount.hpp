@@ -0,0 +1,118 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNCHRONOUS_SCHEDULER_DETAIL_EVENTCOUNT_HPP
+#define BOOST_ASYNCHRONOUS_SCHEDULER_DETAIL_EVENTCOUNT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#else
+#include <mutex>
+#include <condition_variable>
+#endif
+
+namespace boost { namespace asynchronous { namespace detail
+{
+// Lets idle worker threads sleep until a job is pushed, without a lock on the push path.
+// A worker announces itself with prepare_wait(), checks its queues one last time, then either cancel_wait() (found a job)
+// or wait() with the key returned by prepare_wait(). A push followed by notify_one() between prepare_wait and wait
+// changes the key and wait returns immediately, so no wakeup gets lost.
+// notify_one costs a fence and a load as long as nobody sleeps.
+// Uses a futex on Linux, a mutex / condition variable elsewhere.
+class eventcount
+{
+public:
+    eventcount(): m_epoch(0), m_waiters(0){}
+    eventcount(const eventcount&) = delete;
+    eventcount& operator=(const eventcount&) = delete;
+
+    std::uint32_t prepare_wait()
+    {
+        m_waiters.fetch_add(1,std::memory_order_seq_cst);
+        // the following queue check must not be reordered before the registration
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return m_epoch.load(std::memory_order_seq_cst);
+    }
+    void cancel_wait()
+    {
+        m_waiters.fetch_sub(1,std::memory_order_seq_cst);
+    }
+    // returns after a notification, a timeout or spuriously. Ends the wait started with prepare_wait
+    void wait(std::uint32_t key, std::chrono::microseconds timeout)
+    {
+        if (m_epoch.load(std::memory_order_seq_cst) == key)
+        {
+#if defined(__linux__)
+            struct timespec ts;
+            ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000);
+            ts.tv_nsec = static_cast<long>((timeout.count() % 1000000) * 1000);
+            ::syscall(SYS_futex,reinterpret_cast<std::uint32_t*>(&m_epoch),FUTEX_WAIT_PRIVATE,key,&ts,nullptr,0);
+#else
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait_for(lock,timeout,[this,key](){return m_epoch.load() != key;});
+#endif
+        }
+        m_waiters.fetch_sub(1,std::memory_order_seq_cst);
+    }
+    // to be called after a job was pushed
+    void notify_one()
+    {
+        notify(1);
+    }
+    void notify_all()
+    {
+        notify(INT_MAX);
+    }
+    std::size_t waiters()const
+    {
+        return m_waiters.load(std::memory_order_relaxed);
+    }
+
+private:
+    void notify(int how_many)
+    {
+        // the pushed job must be visible before we check for sleepers
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_relaxed) == 0)
+        {
+            return;
+        }
+        m_epoch.fetch_add(1,std::memory_order_seq_cst);
+#if defined(__linux__)
+        ::syscall(SYS_futex,reinterpret_cast<std::uint32_t*>(&m_epoch),FUTEX_WAKE_PRIVATE,how_many,nullptr,nullptr,0);
+#else
+        {
+            // a waiter between its check and its wait would miss the notification
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+        if (how_many == 1)
+            m_cond.notify_one();
+        else
+            m_cond.notify_all();
+#endif
+    }
+
+    std::atomic<std::uint32_t> m_epoch;
+    std::atomic<std::size_t> m_waiters;
+#if !defined(__linux__)
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+#endif
+};
+
+}}} // boost::asynchronous::detail
+#endif // BOOST_ASYNCHRONOUS_SCHEDULER_DETAIL_EVENTCOUNT_HPP
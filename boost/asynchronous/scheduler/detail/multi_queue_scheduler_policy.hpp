@@ -11,6 +11,7 @@
 #define BOOST_ASYNC_SCHEDULER_MULTI_QUEUE_SCHEDULER_POLICY_HPP
 
 #include <vector>
+#include <limits>
 #include <atomic>
 #include <numeric>
 #include <memory>
@@ -20,8 +21,10 @@
 #include <boost/thread/tss.hpp>
 
 #include <boost/asynchronous/queue/any_queue.hpp>
+#include <boost/asynchronous/queue/find_queue_position.hpp>
 #include <boost/asynchronous/scheduler/detail/interruptible_job.hpp>
 #include <boost/asynchronous/any_scheduler.hpp>
+#include <boost/asynchronous/scheduler/detail/eventcount.hpp>
 
 namespace boost { namespace asynchronous { namespace detail
 {
@@ -85,16 +88,18 @@ public:
     void post(typename queue_type::job_type job, std::size_t prio) override
     {
         boost::asynchronous::job_traits<typename queue_type::job_type>::set_posted_time(job);
+        // the queue type is known, no need for a virtual call
         if (prio == std::numeric_limits<std::size_t>::max())
         {
             // shutdown jobs have to be sent to all queues
-            m_queues[m_next_shutdown_bucket.load()% m_queues.size()]->push(std::move(job),prio);
+            m_queues[m_next_shutdown_bucket.load()% m_queues.size()]->queue_type::push(std::move(job),prio);
             ++m_next_shutdown_bucket;
         }
         else
         {
-            m_queues[this->find_position(prio,m_queues.size())]->push(std::move(job),prio);
+            m_queues[boost::asynchronous::detail::find_queue_position(static_cast<FindPosition const&>(*this),prio,m_queues)]->queue_type::push(std::move(job),prio);
         }
+        wakeup_worker(prio);
     }    
     void post(typename queue_type::job_type job) override
     {
@@ -128,8 +133,9 @@ public:
         }
         else
         {
-            m_queues[this->find_position(prio,m_queues.size())]->push(std::move(ijob),prio);
+            m_queues[boost::asynchronous::detail::find_queue_position(static_cast<FindPosition const&>(*this),prio,m_queues)]->push(std::move(ijob),prio);
         }
+        wakeup_worker(prio);
 
         std::future<boost::thread*> fu = wpromise->get_future();
         boost::asynchronous::interrupt_helper interruptible(std::move(fu),state);
@@ -177,6 +183,25 @@ public:
     static boost::thread_specific_ptr<thread_ptr_wrapper> m_self_thread;
     
 protected:
+    void wakeup_worker(std::size_t prio)
+    {
+        if (m_wakeup)
+        {
+            // shutdown jobs are for everybody
+            if (prio == std::numeric_limits<std::size_t>::max())
+                m_wakeup->notify_all();
+            else
+                m_wakeup->notify_one();
+        }
+    }
+    // after pushing to private queues
+    void wakeup_all_workers()
+    {
+        if (m_wakeup)
+        {
+            m_wakeup->notify_all();
+        }
+    }
 
     multi_queue_scheduler_policy(std::shared_ptr<queue_type>&& queues)
         : m_queues(std::forward<std::vector<std::shared_ptr<queue_type> > >(queues))
@@ -204,6 +229,8 @@ protected:
     }
     
     std::vector<std::shared_ptr<queue_type> > m_queues;
+    // set by schedulers whose CPULoad policy parks idle workers
+    std::shared_ptr<boost::asynchronous::detail::eventcount> m_wakeup;
     std::atomic<size_t> m_next_shutdown_bucket;
 };
 
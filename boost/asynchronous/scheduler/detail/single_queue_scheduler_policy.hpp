@@ -11,6 +11,7 @@
 #define BOOST_ASYNC_SCHEDULER_SINGLE_QUEUE_SCHEDULER_POLICY_HPP
 
 #include <vector>
+#include <limits>
 #include <memory>
 #include <future>
 
@@ -20,6 +21,7 @@
 #include <boost/asynchronous/queue/any_queue.hpp>
 #include <boost/asynchronous/scheduler/detail/interruptible_job.hpp>
 #include <boost/asynchronous/any_scheduler.hpp>
+#include <boost/asynchronous/scheduler/detail/eventcount.hpp>
 
 namespace boost { namespace asynchronous { namespace detail
 {
@@ -53,7 +55,9 @@ public:
     void post(typename queue_type::job_type job, std::size_t prio) override
     {
         boost::asynchronous::job_traits<typename queue_type::job_type>::set_posted_time(job);
-        m_queue->push(std::move(job),prio);
+        // the queue type is known, no need for a virtual call
+        m_queue->queue_type::push(std::move(job),prio);
+        wakeup_worker(prio);
     }
     void post(typename queue_type::job_type job) override
     {
@@ -71,6 +75,7 @@ public:
                 ijob(std::move(job),wpromise,state);
 
         m_queue->push(std::move(ijob),prio);
+        wakeup_worker(prio);
 
         std::future<boost::thread*> fu = wpromise->get_future();
         boost::asynchronous::interrupt_helper interruptible(std::move(fu),state);
@@ -86,6 +91,7 @@ public:
     {
         boost::asynchronous::job_traits<typename queue_type::job_type>::set_posted_time(job);
         m_queue->push(job,prio);
+        wakeup_worker(prio);
     }
     boost::asynchronous::any_interruptible interruptible_post(typename queue_type::job_type& job, std::size_t prio=0) override
     {
@@ -96,6 +102,7 @@ public:
         boost::asynchronous::interruptible_job<typename queue_type::job_type,this_type> ijob(job,wpromise,state);
 
         m_queue->push(ijob,prio);
+        wakeup_worker(prio);
 
         std::shared_future<boost::thread*> fu = wpromise->get_future();
         boost::asynchronous::interrupt_helper interruptible(fu,state);
@@ -120,6 +127,25 @@ public:
     static boost::thread_specific_ptr<thread_ptr_wrapper> m_self_thread;
     
 protected:
+    void wakeup_worker(std::size_t prio)
+    {
+        if (m_wakeup)
+        {
+            // shutdown jobs are for everybody
+            if (prio == std::numeric_limits<std::size_t>::max())
+                m_wakeup->notify_all();
+            else
+                m_wakeup->notify_one();
+        }
+    }
+    // after pushing to private queues
+    void wakeup_all_workers()
+    {
+        if (m_wakeup)
+        {
+            m_wakeup->notify_all();
+        }
+    }
 
 #ifndef BOOST_NO_RVALUE_REFERENCES
     single_queue_scheduler_policy(std::shared_ptr<queue_type>&& queue)
@@ -141,6 +167,8 @@ protected:
 #endif
 
     std::shared_ptr<queue_type> m_queue;
+    // set by schedulers whose CPULoad policy parks idle workers
+    std::shared_ptr<boost::asynchronous::detail::eventcount> m_wakeup;
 };
 
 template<class Q>
@@ -17,6 +17,9 @@
 #include <numeric>
 #include <functional>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <list>
 
 #include <boost/thread/thread.hpp>
 #include <boost/thread/mutex.hpp>
@@ -35,22 +38,33 @@
 #include <boost/asynchronous/scheduler/detail/any_continuation.hpp>
 #include <boost/asynchronous/scheduler/cpu_load_policies.hpp>
 #include <boost/asynchronous/scheduler/detail/execute_in_all_threads.hpp>
+#include <boost/asynchronous/scheduler/detail/eventcount.hpp>
 
 namespace boost { namespace asynchronous
 {
 
+// A threadpool for blocking tasks (typically I/O), with min_number_of_workers threads always present
+// and up to max_number_of_workers threads.
+// A temporary thread is created when more jobs are waiting than threads are idle.
+// Posters only read atomic counters to decide, at most one thread is created at a time,
+// and the newly created thread checks again whether another one is needed (thread creations are rate-limited
+// to one in flight without losing a burst of jobs).
+// An idle temporary thread is parked and woken up by the next posted job. It ends if it stayed idle KeepAliveMs.
 template<class Q, class CPULoad =
 #ifdef BOOST_ASYNCHRONOUS_NO_SAVING_CPU_LOAD
          boost::asynchronous::no_cpu_load_saving
 #else
          boost::asynchronous::default_save_cpu_load<>
 #endif
+         , unsigned KeepAliveMs = 500
          >
 class io_threadpool_scheduler: public boost::asynchronous::detail::single_queue_scheduler_policy<Q>
 {
+private:
+    struct internal_data;
 public:
     typedef boost::asynchronous::detail::single_queue_scheduler_policy<Q> base_type;
-    typedef boost::asynchronous::io_threadpool_scheduler<Q,CPULoad> this_type;
+    typedef boost::asynchronous::io_threadpool_scheduler<Q,CPULoad,KeepAliveMs> this_type;
     typedef Q queue_type;
     typedef typename Q::job_type job_type;
     typedef typename boost::asynchronous::job_traits<typename Q::job_type>::diagnostic_table_type diag_type;
@@ -73,6 +87,7 @@ public:
         , m_data (std::make_shared<internal_data>(min_number_of_workers,max_number_of_workers, this->m_queue))
         , m_name(name)
     {
+        m_data->m_name = name;
         m_private_queues.reserve(max_number_of_workers);
         for (size_t i = 0; i< max_number_of_workers;++i)
         {
@@ -84,6 +99,7 @@ public:
     void constructor_done(std::weak_ptr<this_type> weak_self)
     {
         m_diagnostics = std::make_shared<diag_type>(m_data->m_max_number_of_workers);
+        m_data->m_diagnostics = m_diagnostics;
         m_data->m_weak_self = weak_self;
         for (size_t i = 0; i< m_data->m_min_number_of_workers;++i)
         {
@@ -91,10 +107,12 @@ public:
             std::shared_future<boost::thread*> fu = new_thread_promise.get_future();
             boost::mutex::scoped_lock lock(m_data->m_current_number_of_workers_mutex);
             ++m_data->m_current_number_of_workers;
+            ++m_data->m_idle_workers;
+            m_data->m_used_slots[i] = true;
             boost::thread* new_thread =
                     m_data->m_group->create_thread(
                         std::bind(&io_threadpool_scheduler::run_always,this->m_queue,
-                                    m_private_queues[i],m_diagnostics,fu,weak_self,i));
+                                    m_private_queues[i],m_diagnostics,fu,weak_self,m_data,i));
             new_thread_promise.set_value(new_thread);
             m_data->m_thread_ids.insert(new_thread->get_id());
         }
@@ -113,7 +131,7 @@ public:
             auto l = [fct,diag]() mutable
             {
                 if (fct)
-                    fct(boost::asynchronous::scheduler_diagnostics(diag->get_map(),diag->get_current()));
+                    fct(boost::asynchronous::scheduler_diagnostics(diag->get_map(),diag->get_current(),diag->dropped(),diag->get_latencies()));
             };
             boost::asynchronous::detail::default_termination_task<typename Q::diagnostic_type,boost::thread_group>
                     ttask(std::move(l));
@@ -134,6 +152,8 @@ public:
     {
         boost::mutex::scoped_lock lock(m_data->m_current_number_of_workers_mutex);
         m_data->m_joining = true;
+        // parked temporary threads have to end
+        m_data->m_wakeup.notify_all();
         return boost::asynchronous::any_joinable (boost::asynchronous::detail::worker_wrap<boost::thread_group>(m_data->m_group));
     }
 
@@ -145,7 +165,7 @@ public:
     boost::asynchronous::scheduler_diagnostics
     get_diagnostics(std::size_t =0)const
     {
-        return boost::asynchronous::scheduler_diagnostics(m_diagnostics->get_map(),m_diagnostics->get_current());
+        return boost::asynchronous::scheduler_diagnostics(m_diagnostics->get_map(),m_diagnostics->get_current(),m_diagnostics->dropped(),m_diagnostics->get_latencies());
     }
     void clear_diagnostics()
     {
@@ -162,29 +182,10 @@ public:
         // this scheduler does not steal
     }
 
+    // creates a temporary thread if more jobs are waiting than threads are idle
     void try_create_thread()
     {
-        boost::mutex::scoped_lock lock(m_data->m_current_number_of_workers_mutex);
-        if ((m_data->m_current_number_of_workers+1 <= m_data->m_max_number_of_workers) &&
-             this->m_data->calculate_queue_size() >1 &&
-             !m_data->m_joining)
-        {
-            ++m_data->m_current_number_of_workers;
-            std::promise<boost::thread*> new_thread_promise;
-            std::shared_future<boost::thread*> fu = new_thread_promise.get_future();
-            auto data = m_data;
-            std::function<void(boost::thread*)> d = [data](boost::thread* p)mutable{data->thread_finished(p);};
-            std::function<bool()> c = [data]()mutable{return data->test_worker_loop();};
-            boost::thread* new_thread =
-                     m_data->m_group->create_thread(std::bind(&io_threadpool_scheduler::run_once,this->m_queue,
-                                                                m_private_queues[m_data->m_current_number_of_workers-1],
-                                                                m_diagnostics,fu,m_data->m_weak_self,d,c,
-                                                                m_data->m_current_number_of_workers-1,
-                                                                m_name,
-                                                                m_data->m_execute_in_all_threads));
-            m_data->m_thread_ids.insert(new_thread->get_id());
-            new_thread_promise.set_value(new_thread);
-        }
+        create_thread_if_needed(m_data);
     }
     // overwrite from base
 #ifndef BOOST_NO_RVALUE_REFERENCES
@@ -192,10 +193,7 @@ public:
     {
         boost::asynchronous::job_traits<typename queue_type::job_type>::set_posted_time(job);
         this->m_queue->push(std::move(job),prio);
-        // create a new thread if needed
-        this->try_create_thread();
-        // join older threads
-        this->m_data->cleanup_threads();
+        job_posted();
     }
     void post(typename queue_type::job_type job)
     {
@@ -223,16 +221,12 @@ public:
         boost::asynchronous::interruptible_job<typename queue_type::job_type,this_type>
                 ijob(std::move(job),wpromise,state);
 
-        this->m_queue->push(std::forward<typename queue_type::job_type>(ijob),prio);
+        this->m_queue->push(std::move(ijob),prio);
+        job_posted();
 
         std::future<boost::thread*> fu = wpromise->get_future();
         boost::asynchronous::interrupt_helper interruptible(std::move(fu),state);
 
-        // create a new thread if needed
-        this->try_create_thread();
-        // join older threads
-        this->m_data->cleanup_threads();
-
         return boost::asynchronous::any_interruptible(interruptible);
     }
     boost::asynchronous::any_interruptible interruptible_post(typename queue_type::job_type job)
@@ -256,11 +250,8 @@ public:
     void post(typename queue_type::job_type& job, std::size_t prio=0)
     {
         boost::asynchronous::job_traits<typename queue_type::job_type>::set_posted_time(job);
-        m_queue->push(job,prio);
-        // create a new thread if needed
-        this->try_create_thread();
-        // join older threads
-        this->m_data->cleanup_threads();
+        this->m_queue->push(job,prio);
+        job_posted();
     }
     boost::asynchronous::any_interruptible interruptible_post(typename queue_type::job_type& job, std::size_t prio=0)
     {
@@ -270,16 +261,12 @@ public:
         boost::asynchronous::job_traits<typename queue_type::job_type>::set_posted_time(job);
         boost::asynchronous::interruptible_job<typename queue_type::job_type,this_type> ijob(job,wpromise,state);
 
-        m_queue->push(ijob,prio);
+        this->m_queue->push(ijob,prio);
+        job_posted();
 
         std::shared_future<boost::thread*> fu = wpromise->get_future();
         boost::asynchronous::interrupt_helper interruptible(fu,state);
 
-        // create a new thread if needed
-        this->try_create_thread();
-        // join older threads
-        m_data->cleanup_threads();
-
         return boost::asynchronous::any_interruptible(interruptible);
     }
 #endif
@@ -347,7 +334,8 @@ public:
 
     // try to execute a job, return true
     static bool execute_one_job(std::shared_ptr<queue_type> const& queue,CPULoad* cpu_load,std::shared_ptr<diag_type> diagnostics,
-                                std::list<boost::asynchronous::any_continuation>& waiting,size_t index)
+                                std::list<boost::asynchronous::any_continuation>& waiting,size_t index,
+                                std::shared_ptr<internal_data> const& data)
     {
         bool popped = false;
         // get a job
@@ -359,6 +347,9 @@ public:
             // did we manage to pop or steal?
             if (popped)
             {
+                // we are busy, maybe another thread is needed for the jobs still waiting
+                busy_guard busy(data);
+                create_thread_if_needed(data);
                 if (cpu_load)
                     cpu_load->popped_job();
                 // log time
@@ -414,12 +405,13 @@ public:
                          std::shared_ptr<boost::asynchronous::lockfree_queue<boost::asynchronous::any_callable> > const& private_queue,
                          std::list<boost::asynchronous::any_continuation>& waiting,
                          std::shared_ptr<diag_type> diagnostics,CPULoad* cpu_load,
+                         std::shared_ptr<internal_data> const& data,
                          size_t index)
     {
         bool executed_job=false;
         {
             {
-                executed_job = execute_one_job(queue,cpu_load,diagnostics,waiting,index);
+                executed_job = execute_one_job(queue,cpu_load,diagnostics,waiting,index,data);
                 if (!executed_job)
                 {
                     if (cpu_load)
@@ -447,6 +439,7 @@ public:
                            std::shared_ptr<diag_type> diagnostics,
                            std::shared_future<boost::thread*> self,
                            std::weak_ptr<this_type> this_,
+                           std::shared_ptr<internal_data> data,
                            size_t index)
     {
         boost::thread* t = self.get();
@@ -463,12 +456,12 @@ public:
         {
             try
             {
-                run_loop(queue,private_queue,waiting,diagnostics,&cpu_load,index);
+                run_loop(queue,private_queue,waiting,diagnostics,&cpu_load,data,index);
             }
             catch(boost::asynchronous::detail::shutdown_exception&)
             {
                 // we are done, execute jobs posted short before to the end, then shutdown
-                while(execute_one_job(queue,&cpu_load,diagnostics,waiting,index));
+                while(execute_one_job(queue,&cpu_load,diagnostics,waiting,index,data));
                 delete boost::asynchronous::detail::single_queue_scheduler_policy<Q>::m_self_thread.release();
                 return;
             }
@@ -486,16 +479,14 @@ public:
             }
         }
     }
-    static void run_once(std::shared_ptr<queue_type> const& queue,
-                         std::shared_ptr<boost::asynchronous::lockfree_queue<boost::asynchronous::any_callable> > const& /*private_queue*/,
-                         std::shared_ptr<diag_type> diagnostics,
-                         std::shared_future<boost::thread*> self,
-                         std::weak_ptr<this_type> this_,
-                         std::function<void(boost::thread*)> on_done,
-                         std::function<bool()> check_continue,
-                         size_t index,
-                         std::string name,
-                         std::vector<boost::asynchronous::any_callable> execute_in_all_threads_tasks)
+    static void run_temporary(std::shared_ptr<queue_type> const& queue,
+                              std::shared_ptr<diag_type> diagnostics,
+                              std::shared_future<boost::thread*> self,
+                              std::weak_ptr<this_type> this_,
+                              std::shared_ptr<internal_data> data,
+                              size_t index,
+                              std::string name,
+                              std::vector<boost::asynchronous::any_callable> execute_in_all_threads_tasks)
     {
         boost::thread* t = self.get();
         boost::asynchronous::detail::single_queue_scheduler_policy<Q>::m_self_thread.reset(new thread_ptr_wrapper(t));
@@ -513,17 +504,48 @@ public:
         {
             c();
         }
-        // we run once then end
-        do
+        // we are created, another thread may be created if jobs are still waiting
+        data->m_creating_thread = false;
+        create_thread_if_needed(data);
+
+        auto last_job = std::chrono::steady_clock::now();
+        bool retired = false;
+        while (!data->m_joining)
         {
             try
             {
-                run_loop(queue,std::shared_ptr<boost::asynchronous::lockfree_queue<boost::asynchronous::any_callable> >(),
-                         waiting,diagnostics,nullptr,index);
+                if (execute_one_job(queue,nullptr,diagnostics,waiting,index,data))
+                {
+                    last_job = std::chrono::steady_clock::now();
+                    continue;
+                }
+                auto idle_time = std::chrono::steady_clock::now() - last_job;
+                // waiting continuations would be lost, we stay until they are done
+                if (idle_time >= std::chrono::milliseconds(KeepAliveMs) && waiting.empty())
+                {
+                    if (data->try_retire(index))
+                    {
+                        retired = true;
+                        break;
+                    }
+                    // a job came in the meantime
+                    last_job = std::chrono::steady_clock::now();
+                    continue;
+                }
+                // park until a job is posted. Waiting continuations have to be polled
+                std::chrono::microseconds park_time =
+                        waiting.empty() ? std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::milliseconds(KeepAliveMs) - idle_time)
+                                        : std::chrono::microseconds(500);
+                std::uint32_t key = data->m_wakeup.prepare_wait();
+                if (data->m_waiting_jobs.load() > 0 || data->m_joining)
+                {
+                    data->m_wakeup.cancel_wait();
+                    continue;
+                }
+                data->m_wakeup.wait(key,park_time);
             }
             catch(boost::asynchronous::detail::shutdown_exception&)
             {
-                on_done(t);
                 // we are done
                 break;
             }
@@ -540,61 +562,186 @@ public:
                 // TODO, user-defined error
             }
         }
-        while (check_continue());
-        on_done(t);
+        // a retired thread already gave its slot back
+        data->thread_finished(t,index,!retired);
     }
 
 private:
+    // decrements the number of idle threads while a job is executed
+    struct busy_guard
+    {
+        explicit busy_guard(std::shared_ptr<internal_data> const& data):m_data(data)
+        {
+            --m_data->m_waiting_jobs;
+            --m_data->m_idle_workers;
+        }
+        ~busy_guard()
+        {
+            ++m_data->m_idle_workers;
+        }
+        std::shared_ptr<internal_data> const& m_data;
+    };
+
+    void job_posted()
+    {
+        ++m_data->m_waiting_jobs;
+        // wake up a parked thread, does nothing if none is parked
+        m_data->m_wakeup.notify_one();
+        // create a new thread if needed
+        create_thread_if_needed(m_data);
+        // join older threads
+        if (m_data->m_has_done_threads)
+            m_data->cleanup_threads();
+    }
+
+    static void create_thread_if_needed(std::shared_ptr<internal_data> const& data)
+    {
+        // lock-free checks first, posters only contend if a thread is really needed.
+        // The order of loads matters, see try_retire
+        if (data->m_waiting_jobs.load() <= static_cast<std::ptrdiff_t>(data->m_idle_workers.load()) ||
+            data->m_current_number_of_workers.load() >= data->m_max_number_of_workers ||
+            data->m_joining)
+        {
+            return;
+        }
+        // one thread creation at a time, the created thread will check again
+        bool expected = false;
+        if (!data->m_creating_thread.compare_exchange_strong(expected,true))
+        {
+            return;
+        }
+        std::size_t current = data->m_current_number_of_workers.load();
+        do
+        {
+            if (current >= data->m_max_number_of_workers)
+            {
+                data->m_creating_thread = false;
+                return;
+            }
+        }
+        while (!data->m_current_number_of_workers.compare_exchange_weak(current,current+1));
+        // the new thread is going to look for a job
+        ++data->m_idle_workers;
+
+        boost::mutex::scoped_lock lock(data->m_current_number_of_workers_mutex);
+        if (data->m_joining)
+        {
+            // too late, the thread group is already being joined
+            --data->m_idle_workers;
+            --data->m_current_number_of_workers;
+            data->m_creating_thread = false;
+            return;
+        }
+        // find a free diagnostics slot. Slots are given back before a worker stops being counted, so there is one
+        std::size_t index = data->find_free_slot();
+        if (index == data->m_used_slots.size())
+        {
+            --data->m_idle_workers;
+            --data->m_current_number_of_workers;
+            data->m_creating_thread = false;
+            return;
+        }
+        data->m_used_slots[index] = true;
+
+        std::promise<boost::thread*> new_thread_promise;
+        std::shared_future<boost::thread*> fu = new_thread_promise.get_future();
+        boost::thread* new_thread = nullptr;
+        try
+        {
+            new_thread = data->m_group->create_thread(std::bind(&io_threadpool_scheduler::run_temporary,data->m_queue,
+                                                                data->m_diagnostics,fu,data->m_weak_self,data,
+                                                                index,
+                                                                data->m_name,
+                                                                data->m_execute_in_all_threads));
+        }
+        catch(...)
+        {
+            data->m_used_slots[index] = false;
+            --data->m_idle_workers;
+            --data->m_current_number_of_workers;
+            data->m_creating_thread = false;
+            throw;
+        }
+        data->m_thread_ids.insert(new_thread->get_id());
+        new_thread_promise.set_value(new_thread);
+    }
+
     struct internal_data
     {
         internal_data(size_t min_number_of_workers, size_t max_number_of_workers, std::shared_ptr<queue_type> queue)
         : m_min_number_of_workers(min_number_of_workers <= max_number_of_workers ? min_number_of_workers:max_number_of_workers)
         , m_max_number_of_workers(min_number_of_workers <= max_number_of_workers ? max_number_of_workers:min_number_of_workers)
         , m_current_number_of_workers(0)
+        , m_idle_workers(0)
+        , m_waiting_jobs(0)
+        , m_creating_thread(false)
+        , m_joining(false)
+        , m_has_done_threads(false)
+        , m_used_slots(m_max_number_of_workers,false)
         , m_done_threads()
         , m_weak_self()
         , m_group(std::make_shared<boost::thread_group>())
         , m_queue(queue)
         {}
 
-        // check queue size. Used to find out when temporary threads have to shutdown
-        std::size_t calculate_queue_size()const
+        // called by an idle temporary thread whose keep-alive time elapsed.
+        // Returns false if a job was posted meanwhile and the thread has to stay.
+        // We decrement first the number of workers then the number of idle ones, then check for waiting jobs.
+        // A poster increments the number of waiting jobs, then loads the number of idle threads, then the number of workers.
+        // Either it sees us idle and we see its job, or it sees that we are gone and creates a new thread.
+        // Our diagnostics slot is given back first, as a thread created after the decrement needs one.
+        // If we have to stay, we take a free slot again and update index.
+        bool try_retire(std::size_t& index)
         {
-             std::vector<std::size_t> vec_sizes = this->m_queue->get_queue_size();
-             return std::accumulate(vec_sizes.begin(),vec_sizes.end(),0,[](std::size_t a, std::size_t b){return a+b;});
-        }
-        // checks if worker thread should continue
-        // if queue not empty, continue
-        bool test_worker_loop()
-        {
-           boost::mutex::scoped_lock lock(m_current_number_of_workers_mutex);
-           bool res = (this->calculate_queue_size() != 0);//(m_current_number_of_workers > m_min_number_of_workers);
-           /*if (res)
-           {
-               --m_current_number_of_workers;
-           }*/
-           return res && !m_joining;
+            {
+                boost::mutex::scoped_lock lock(m_current_number_of_workers_mutex);
+                m_used_slots[index] = false;
+            }
+            --m_current_number_of_workers;
+            --m_idle_workers;
+            if (m_waiting_jobs.load() <= 0 || m_joining)
+            {
+                return true;
+            }
+            std::size_t current = m_current_number_of_workers.load();
+            do
+            {
+                if (current >= m_max_number_of_workers)
+                {
+                    // another thread was created for this job
+                    return true;
+                }
+            }
+            while (!m_current_number_of_workers.compare_exchange_weak(current,current+1));
+            ++m_idle_workers;
+            boost::mutex::scoped_lock lock(m_current_number_of_workers_mutex);
+            index = find_free_slot();
+            m_used_slots[index] = true;
+            return false;
         }
-        void basic_thread_not_busy()
+        // first free slot of temporary threads, m_used_slots.size() if none. Call with m_current_number_of_workers_mutex locked
+        std::size_t find_free_slot()const
         {
-            //TODO needed?
-            // update number of workers
-            //boost::mutex::scoped_lock lock(m_current_number_of_workers_mutex);
-            //--m_current_number_of_workers;
+            std::size_t index = m_min_number_of_workers;
+            while (index < m_used_slots.size() && m_used_slots[index])
+                ++index;
+            return index;
         }
 
-        void thread_finished(boost::thread* finished_thread)
+        void thread_finished(boost::thread* finished_thread, std::size_t index, bool release_slot)
         {
-            // update number of workers
+            // update thread ids
             {
                 boost::mutex::scoped_lock lock(m_current_number_of_workers_mutex);
-                --m_current_number_of_workers;
                 m_thread_ids.erase(finished_thread->get_id());
+                if (release_slot)
+                    m_used_slots[index] = false;
             }
             // update set of finished threads
             {
                 boost::mutex::scoped_lock lock(m_done_threads_mutex);
                 m_done_threads.insert(finished_thread);
+                m_has_done_threads = true;
             }
         }
         // checks which threads are finished and can be removed from thread group and joined
@@ -611,6 +758,7 @@ private:
                 to_join_threads = m_done_threads;
     #endif
                 m_done_threads.clear();
+                m_has_done_threads = false;
             }
             // remove from group and join
             boost::thread_group cleanup_group;
@@ -632,18 +780,32 @@ private:
         std::set<boost::thread::id> m_thread_ids;
         size_t m_min_number_of_workers;
         size_t m_max_number_of_workers;
-        size_t m_current_number_of_workers;
+        // spawn / retire decisions are taken using these counters, without lock
+        std::atomic<size_t> m_current_number_of_workers;
+        // threads not executing a job
+        std::atomic<size_t> m_idle_workers;
+        // posted and not yet popped jobs
+        std::atomic<std::ptrdiff_t> m_waiting_jobs;
+        // true while a thread is being created
+        std::atomic<bool> m_creating_thread;
+        // remembers if the thread group has already been given for joining. If yes, no thread will be created
+        std::atomic<bool> m_joining;
+        std::atomic<bool> m_has_done_threads;
+        // parked temporary threads wait on it
+        boost::asynchronous::detail::eventcount m_wakeup;
+        // diagnostics index used by each thread
+        std::vector<bool> m_used_slots;
         std::set<boost::thread*> m_done_threads;
         std::weak_ptr<this_type> m_weak_self;
         std::shared_ptr<boost::thread_group> m_group;
         std::shared_ptr<queue_type> m_queue;
-        // remembers if the thread group has already been given for joining. If yes, no thread will be created
-        bool m_joining=false;
+        std::shared_ptr<diag_type> m_diagnostics;
+        std::string m_name;
         // pass them to any newly created thread
         std::vector<boost::asynchronous::any_callable> m_execute_in_all_threads;
         // protects m_done_threads
         boost::mutex m_done_threads_mutex;
-        // protects m_current_number_of_workers
+        // protects m_thread_ids, m_used_slots, m_execute_in_all_threads and thread creation
         mutable boost::mutex m_current_number_of_workers_mutex;
     };
     std::shared_ptr<internal_data> m_data;
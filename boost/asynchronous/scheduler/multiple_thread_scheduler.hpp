@@ -136,7 +136,7 @@ public:
             auto l = [fct,diag]() mutable
             {
                 if (fct)
-                    fct(boost::asynchronous::scheduler_diagnostics(diag->get_map(),diag->get_current()));
+                    fct(boost::asynchronous::scheduler_diagnostics(diag->get_map(),diag->get_current(),diag->dropped(),diag->get_latencies()));
             };
             boost::asynchronous::detail::default_termination_task<typename Q::diagnostic_type,boost::thread_group>
                     ttask(std::move(l));
@@ -159,7 +159,7 @@ public:
     boost::asynchronous::scheduler_diagnostics
     get_diagnostics(std::size_t =0)const
     {
-        return boost::asynchronous::scheduler_diagnostics(m_diagnostics->get_map(),m_diagnostics->get_current());
+        return boost::asynchronous::scheduler_diagnostics(m_diagnostics->get_map(),m_diagnostics->get_current(),m_diagnostics->dropped(),m_diagnostics->get_latencies());
     }
     void clear_diagnostics()
     {
@@ -91,6 +91,7 @@ public:
     void constructor_done(std::weak_ptr<this_type> weak_self)
     {
         m_diagnostics = std::make_shared<diag_type>(m_number_of_workers);
+        this->m_wakeup = boost::asynchronous::detail::make_wakeup<CPULoad>();
         m_thread_ids.reserve(m_number_of_workers);
         m_group.reset(new boost::thread_group);
         for (size_t i = 0; i< m_number_of_workers;++i)
@@ -99,7 +100,7 @@ public:
             std::shared_future<boost::thread*> fu = new_thread_promise.get_future();
             boost::thread* new_thread =
                     m_group->create_thread(std::bind(&multiqueue_threadpool_scheduler::run,this->m_queues,
-                                                       m_private_queues[i],i,m_diagnostics,fu,weak_self));
+                                                       m_private_queues[i],i,m_diagnostics,fu,weak_self,this->m_wakeup));
             new_thread_promise.set_value(new_thread);
             m_thread_ids.push_back(new_thread->get_id());
         }
@@ -114,7 +115,7 @@ public:
             auto l = [fct,diag]() mutable
             {
                 if (fct)
-                    fct(boost::asynchronous::scheduler_diagnostics(diag->get_map(),diag->get_current()));
+                    fct(boost::asynchronous::scheduler_diagnostics(diag->get_map(),diag->get_current(),diag->dropped(),diag->get_latencies()));
             };
             boost::asynchronous::detail::default_termination_task<typename Q::diagnostic_type,boost::thread_group>
                     ttask(std::move(l));
@@ -122,8 +123,10 @@ public:
 #ifndef BOOST_NO_RVALUE_REFERENCES
             boost::asynchronous::any_callable job(std::move(ttask));
             m_private_queues[i]->push(std::move(job),std::numeric_limits<std::size_t>::max());
+            this->wakeup_all_workers();
 #else
             m_private_queues[i]->push(boost::asynchronous::any_callable(ttask),std::numeric_limits<std::size_t>::max());
+            this->wakeup_all_workers();
 #endif
         }
     }
@@ -142,7 +145,7 @@ public:
     boost::asynchronous::scheduler_diagnostics
     get_diagnostics(std::size_t =0)const
     {
-        return boost::asynchronous::scheduler_diagnostics(m_diagnostics->get_map(),m_diagnostics->get_current());
+        return boost::asynchronous::scheduler_diagnostics(m_diagnostics->get_map(),m_diagnostics->get_current(),m_diagnostics->dropped(),m_diagnostics->get_latencies());
     }
     void clear_diagnostics()
     {
@@ -166,8 +169,10 @@ public:
 #ifndef BOOST_NO_RVALUE_REFERENCES
             boost::asynchronous::any_callable job(std::move(ntask));
             m_private_queues[i]->push(std::move(job),std::numeric_limits<std::size_t>::max());
+            this->wakeup_all_workers();
 #else
             m_private_queues[i]->push(boost::asynchronous::any_callable(ntask),std::numeric_limits<std::size_t>::max());
+            this->wakeup_all_workers();
 #endif
         }
     }
@@ -186,6 +191,7 @@ public:
                 boost::asynchronous::detail::processor_bind_task task(std::get<0>(v)+i);
                 boost::asynchronous::any_callable job(std::move(task));
                 m_private_queues[t++]->push(std::move(job),std::numeric_limits<std::size_t>::max());
+                this->wakeup_all_workers();
             }
         }
     }
@@ -200,6 +206,7 @@ public:
             res.emplace_back(std::move(fu));
             boost::asynchronous::detail::execute_in_all_threads_task task(c,std::move(p));
             m_private_queues[i]->push(std::move(task),std::numeric_limits<std::size_t>::max());
+            this->wakeup_all_workers();
         }
         return res;
     }
@@ -289,7 +296,8 @@ public:
                     std::shared_ptr<boost::asynchronous::lockfree_queue<boost::asynchronous::any_callable> > const& private_queue,
                     size_t index,std::shared_ptr<diag_type> diagnostics,
                     std::shared_future<boost::thread*> self,
-                    std::weak_ptr<this_type> this_)
+                    std::weak_ptr<this_type> this_,
+                    std::shared_ptr<boost::asynchronous::detail::eventcount> wakeup)
     {
         boost::thread* t = self.get();
         boost::asynchronous::detail::multi_queue_scheduler_policy<Q,FindPosition>::m_self_thread.reset(new thread_ptr_wrapper(t));
@@ -297,10 +305,25 @@ public:
         boost::asynchronous::any_weak_scheduler<job_type> self_as_weak = boost::asynchronous::detail::lockable_weak_scheduler<this_type>(this_);
         boost::asynchronous::get_thread_scheduler<job_type>(self_as_weak,true);
         boost::asynchronous::get_own_queue_index<>(index+1,true);
+        boost::asynchronous::get_own_queue<>(queues[index].get(),true);
 
         std::list<boost::asynchronous::any_continuation>& waiting =
                 boost::asynchronous::get_continuations(std::list<boost::asynchronous::any_continuation>(),true);
         CPULoad cpu_load;
+        boost::asynchronous::detail::set_wakeup(cpu_load,wakeup);
+        // last check before parking
+        auto recheck = [&]()
+        {
+            if (execute_one_job(queues,index,cpu_load,diagnostics,waiting))
+                return true;
+            boost::asynchronous::any_callable djob;
+            if (private_queue->try_pop(djob))
+            {
+                djob();
+                return true;
+            }
+            return false;
+        };
         while(true)
         {
             try
@@ -309,7 +332,7 @@ public:
                     bool popped = execute_one_job(queues,index,cpu_load,diagnostics,waiting);
                     if (!popped)
                     {
-                        cpu_load.loop_done_no_job();
+                        boost::asynchronous::detail::loop_done_no_job(cpu_load,recheck,!waiting.empty());
                         // nothing for us to do, give up our time slice
                         boost::this_thread::yield();
                     }
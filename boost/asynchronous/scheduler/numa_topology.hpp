@@ -0,0 +1,208 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNCHRONOUS_SCHEDULER_NUMA_TOPOLOGY_HPP
+#define BOOST_ASYNCHRONOUS_SCHEDULER_NUMA_TOPOLOGY_HPP
+
+#include <vector>
+#include <string>
+#include <tuple>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+#include <boost/thread/thread.hpp>
+
+namespace boost { namespace asynchronous
+{
+
+// one NUMA node: the cpus it contains and its distance to every node of the topology
+struct numa_node
+{
+    unsigned int m_id;
+    std::vector<unsigned int> m_cpus;
+    // in the order of numa_topology::nodes(), 10 being the distance of a node to itself
+    std::vector<unsigned int> m_distances;
+
+    // the cpus as (first core, number of cores) ranges, as expected by processor_bind
+    std::vector<std::tuple<unsigned int,unsigned int>> cpu_ranges()const
+    {
+        std::vector<std::tuple<unsigned int,unsigned int>> res;
+        for (unsigned int cpu : m_cpus)
+        {
+            if (!res.empty() && std::get<0>(res.back()) + std::get<1>(res.back()) == cpu)
+            {
+                ++std::get<1>(res.back());
+            }
+            else
+            {
+                res.emplace_back(cpu,1u);
+            }
+        }
+        return res;
+    }
+};
+
+// NUMA nodes of the machine, as found in /sys/devices/system/node (Linux).
+// Nodes without cpus (memory only) are left out.
+// If the information is not available, the machine is seen as a single node containing all cpus.
+class numa_topology
+{
+public:
+    explicit numa_topology(std::string const& sysfs_root = "/sys/devices/system/node")
+    {
+        std::string online;
+        if (read_file(sysfs_root + "/online",online))
+        {
+            std::vector<unsigned int> ids = parse_cpu_list(online);
+            std::vector<numa_node> all;
+            for (unsigned int id : ids)
+            {
+                std::string const node_dir = sysfs_root + "/node" + std::to_string(id);
+                numa_node node;
+                node.m_id = id;
+                std::string cpulist;
+                if (read_file(node_dir + "/cpulist",cpulist))
+                {
+                    node.m_cpus = parse_cpu_list(cpulist);
+                }
+                std::string distances;
+                if (read_file(node_dir + "/distance",distances))
+                {
+                    std::istringstream in(distances);
+                    unsigned int d = 0;
+                    while (in >> d)
+                    {
+                        node.m_distances.push_back(d);
+                    }
+                }
+                all.push_back(std::move(node));
+            }
+            // keep only nodes with cpus, and their distances to each other
+            std::vector<std::size_t> kept;
+            for (std::size_t i = 0; i < all.size(); ++i)
+            {
+                if (!all[i].m_cpus.empty())
+                    kept.push_back(i);
+            }
+            for (std::size_t i : kept)
+            {
+                numa_node node;
+                node.m_id = all[i].m_id;
+                node.m_cpus = std::move(all[i].m_cpus);
+                bool const has_distances = all[i].m_distances.size() == all.size();
+                for (std::size_t j : kept)
+                {
+                    node.m_distances.push_back(has_distances ? all[i].m_distances[j] : (i == j ? 10u : 20u));
+                }
+                m_nodes.push_back(std::move(node));
+            }
+        }
+        if (m_nodes.empty())
+        {
+            numa_node node;
+            node.m_id = 0;
+            for (unsigned int i = 0; i < std::max(1u,boost::thread::hardware_concurrency()); ++i)
+            {
+                node.m_cpus.push_back(i);
+            }
+            node.m_distances.push_back(10);
+            m_nodes.push_back(std::move(node));
+        }
+    }
+    explicit numa_topology(std::vector<boost::asynchronous::numa_node> nodes)
+        : m_nodes(std::move(nodes))
+    {
+    }
+
+    // the topology of this machine, read once
+    static numa_topology const& system()
+    {
+        static const numa_topology topology;
+        return topology;
+    }
+
+    std::vector<boost::asynchronous::numa_node> const& nodes()const
+    {
+        return m_nodes;
+    }
+    std::size_t size()const
+    {
+        return m_nodes.size();
+    }
+
+    // the other nodes (as indexes in nodes()), nearest first.
+    // Nodes at the same distance are ordered starting after node so that they do not all steal from the same node first.
+    std::vector<std::size_t> steal_order(std::size_t node)const
+    {
+        std::vector<std::size_t> res;
+        for (std::size_t i = 1; i < m_nodes.size(); ++i)
+        {
+            res.push_back((node + i) % m_nodes.size());
+        }
+        std::vector<unsigned int> const& distances = m_nodes.at(node).m_distances;
+        std::stable_sort(res.begin(),res.end(),
+                         [&distances](std::size_t lhs, std::size_t rhs)
+                         {
+                             unsigned int const dl = lhs < distances.size() ? distances[lhs] : 0;
+                             unsigned int const dr = rhs < distances.size() ? distances[rhs] : 0;
+                             return dl < dr;
+                         });
+        return res;
+    }
+
+    // parses the kernel's list format, for example "0-3,8,10-11"
+    static std::vector<unsigned int> parse_cpu_list(std::string const& list)
+    {
+        std::vector<unsigned int> res;
+        std::istringstream in(list);
+        std::string range;
+        while (std::getline(in,range,','))
+        {
+            range.erase(std::remove_if(range.begin(),range.end(),[](char c){return c == ' ' || c == '\n';}),range.end());
+            if (range.empty())
+                continue;
+            std::size_t const dash = range.find('-');
+            try
+            {
+                unsigned int const first = static_cast<unsigned int>(std::stoul(range.substr(0,dash)));
+                unsigned int const last = (dash == std::string::npos) ? first : static_cast<unsigned int>(std::stoul(range.substr(dash+1)));
+                for (unsigned int cpu = first; cpu <= last; ++cpu)
+                {
+                    res.push_back(cpu);
+                }
+            }
+            catch (std::exception&)
+            {
+                // ignore what we do not understand
+            }
+        }
+        return res;
+    }
+
+private:
+    static bool read_file(std::string const& path, std::string& content)
+    {
+        std::ifstream in(path);
+        if (!in)
+            return false;
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        content = buffer.str();
+        return true;
+    }
+
+    std::vector<boost::asynchronous::numa_node> m_nodes;
+};
+
+}} // boost::asynchronous
+
+#endif // BOOST_ASYNCHRONOUS_SCHEDULER_NUMA_TOPOLOGY_HPP
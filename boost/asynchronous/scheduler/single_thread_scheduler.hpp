@@ -76,10 +76,11 @@ public:
     void constructor_done(std::weak_ptr<this_type> weak_self)
     {
         m_diagnostics = std::make_shared<diag_type>(1);
+        this->m_wakeup = boost::asynchronous::detail::make_wakeup<CPULoad>();
         std::promise<boost::thread*> new_thread_promise;
         std::shared_future<boost::thread*> fu = new_thread_promise.get_future();
         boost::thread* new_thread =
-                new boost::thread(std::bind(&single_thread_scheduler::run,this->m_queue,m_diagnostics,m_private_queue,fu,weak_self));
+                new boost::thread(std::bind(&single_thread_scheduler::run,this->m_queue,m_diagnostics,m_private_queue,fu,weak_self,this->m_wakeup));
         new_thread_promise.set_value(new_thread);
         m_thread.reset(new_thread);
     }
@@ -91,13 +92,14 @@ public:
         auto l = [fct,diag]() mutable
         {
             if (fct)
-                fct(boost::asynchronous::scheduler_diagnostics(diag->get_map(),diag->get_current()));
+                fct(boost::asynchronous::scheduler_diagnostics(diag->get_map(),diag->get_current(),diag->dropped(),diag->get_latencies()));
         };
         boost::asynchronous::detail::default_termination_task<typename Q::diagnostic_type,boost::thread>
                 ttask(std::move(l));
         // this task has to be executed lat => lowest prio
         boost::asynchronous::any_callable job(std::move(ttask));
         m_private_queue->push(std::move(job),std::numeric_limits<std::size_t>::max());
+        this->wakeup_all_workers();
     }
     //TODO move?
     boost::asynchronous::any_joinable get_worker()const
@@ -120,7 +122,7 @@ public:
     boost::asynchronous::scheduler_diagnostics
     get_diagnostics(std::size_t =0)const
     {
-        return boost::asynchronous::scheduler_diagnostics(m_diagnostics->get_map(),m_diagnostics->get_current());
+        return boost::asynchronous::scheduler_diagnostics(m_diagnostics->get_map(),m_diagnostics->get_current(),m_diagnostics->dropped(),m_diagnostics->get_latencies());
     }
     void clear_diagnostics()
     {
@@ -147,8 +149,10 @@ public:
 #ifndef BOOST_NO_RVALUE_REFERENCES
         boost::asynchronous::any_callable job(std::move(ntask));
         m_private_queue->push(std::move(job),std::numeric_limits<std::size_t>::max());
+        this->wakeup_all_workers();
 #else
         m_private_queue->push(boost::asynchronous::any_callable(ntask),std::numeric_limits<std::size_t>::max());
+        this->wakeup_all_workers();
 #endif
     }
     std::string get_name()const
@@ -160,6 +164,7 @@ public:
         boost::asynchronous::detail::processor_bind_task task(std::get<0>(p[0]));
         boost::asynchronous::any_callable job(std::move(task));
         m_private_queue->push(std::move(job),std::numeric_limits<std::size_t>::max());
+        this->wakeup_all_workers();
     }
     std::vector<std::future<void>> execute_in_all_threads(boost::asynchronous::any_callable c)
     {
@@ -170,6 +175,7 @@ public:
         res.emplace_back(std::move(fu));
         boost::asynchronous::detail::execute_in_all_threads_task task(std::move(c),std::move(p));
         m_private_queue->push(std::move(task),std::numeric_limits<std::size_t>::max());
+        this->wakeup_all_workers();
         return res;
     }
 
@@ -244,7 +250,8 @@ public:
     static void run(std::shared_ptr<queue_type> const& queue,std::shared_ptr<diag_type> diagnostics,
                     std::shared_ptr<boost::asynchronous::lockfree_queue<boost::asynchronous::any_callable> > const& private_queue,
                     std::shared_future<boost::thread*> self,
-                    std::weak_ptr<this_type> this_)
+                    std::weak_ptr<this_type> this_,
+                    std::shared_ptr<boost::asynchronous::detail::eventcount> wakeup)
     {
         boost::thread* t = self.get();
         boost::asynchronous::detail::single_queue_scheduler_policy<Q>::m_self_thread.reset(new thread_ptr_wrapper(t));
@@ -258,6 +265,20 @@ public:
         boost::asynchronous::get_scheduler_diagnostics<job_type>(diagnostics,true);
 
         CPULoad cpu_load;
+        boost::asynchronous::detail::set_wakeup(cpu_load,wakeup);
+        // last check before parking
+        auto recheck = [&]()
+        {
+            if (execute_one_job(queue,cpu_load,diagnostics,waiting))
+                return true;
+            boost::asynchronous::any_callable djob;
+            if (private_queue->try_pop(djob))
+            {
+                djob();
+                return true;
+            }
+            return false;
+        };
         while(true)
         {
             try
@@ -266,7 +287,7 @@ public:
                     bool popped = execute_one_job(queue,cpu_load,diagnostics,waiting);
                     if (!popped)
                     {
-                        cpu_load.loop_done_no_job();
+                        boost::asynchronous::detail::loop_done_no_job(cpu_load,recheck,!waiting.empty());
                         // nothing for us to do, give up our time slice
                         boost::this_thread::yield();
                     }
@@ -90,6 +90,8 @@ public:
     void constructor_done(std::weak_ptr<this_type> weak_self)
     {
         m_weak_self = weak_self;
+        // before any post, threads might only be started later
+        this->m_wakeup = boost::asynchronous::detail::make_wakeup<CPULoad>();
         if (IsImmediate)
             init(m_number_of_workers,std::vector<boost::asynchronous::any_queue_ptr<job_type> >(),m_weak_self);
     }
@@ -104,7 +106,7 @@ public:
             std::shared_future<boost::thread*> fu = new_thread_promise.get_future();
             boost::thread* new_thread =
                     m_group->create_thread(std::bind(&stealing_multiqueue_threadpool_scheduler::run,this->m_queues,
-                                                       m_private_queues[i],others,i,m_diagnostics,fu,weak_self));
+                                                       m_private_queues[i],others,i,m_diagnostics,fu,weak_self,this->m_wakeup));
             new_thread_promise.set_value(new_thread);
             m_thread_ids.push_back(new_thread->get_id());
         }
@@ -119,7 +121,7 @@ public:
             auto l = [fct,diag]() mutable
             {
                 if (fct)
-                    fct(boost::asynchronous::scheduler_diagnostics(diag->get_map(),diag->get_current()));
+                    fct(boost::asynchronous::scheduler_diagnostics(diag->get_map(),diag->get_current(),diag->dropped(),diag->get_latencies()));
             };
             boost::asynchronous::detail::default_termination_task<typename Q::diagnostic_type,boost::thread_group>
                     ttask(std::move(l));
@@ -127,8 +129,10 @@ public:
 #ifndef BOOST_NO_RVALUE_REFERENCES
             boost::asynchronous::any_callable job(std::move(ttask));
             m_private_queues[i]->push(std::move(job),std::numeric_limits<std::size_t>::max());
+            this->wakeup_all_workers();
 #else
             m_private_queues[i]->push(boost::asynchronous::any_callable(ttask),std::numeric_limits<std::size_t>::max());
+            this->wakeup_all_workers();
 #endif
         }
     }
@@ -147,7 +151,7 @@ public:
     boost::asynchronous::scheduler_diagnostics
     get_diagnostics(std::size_t =0)const
     {
-        return boost::asynchronous::scheduler_diagnostics(m_diagnostics->get_map(),m_diagnostics->get_current());
+        return boost::asynchronous::scheduler_diagnostics(m_diagnostics->get_map(),m_diagnostics->get_current(),m_diagnostics->dropped(),m_diagnostics->get_latencies());
     }
     void clear_diagnostics()
     {
@@ -172,8 +176,10 @@ public:
 #ifndef BOOST_NO_RVALUE_REFERENCES
             boost::asynchronous::any_callable job(std::move(ntask));
             m_private_queues[i]->push(std::move(job),std::numeric_limits<std::size_t>::max());
+            this->wakeup_all_workers();
 #else
             m_private_queues[i]->push(boost::asynchronous::any_callable(ntask),std::numeric_limits<std::size_t>::max());
+            this->wakeup_all_workers();
 #endif
         }
     }
@@ -188,6 +194,7 @@ public:
                 boost::asynchronous::detail::processor_bind_task task(std::get<0>(v)+i);
                 boost::asynchronous::any_callable job(std::move(task));
                 m_private_queues[t++]->push(std::move(job),std::numeric_limits<std::size_t>::max());
+                this->wakeup_all_workers();
             }
         }
     }
@@ -202,6 +209,7 @@ public:
             res.emplace_back(std::move(fu));
             boost::asynchronous::detail::execute_in_all_threads_task task(c,std::move(p));
             m_private_queues[i]->push(std::move(task),std::numeric_limits<std::size_t>::max());
+            this->wakeup_all_workers();
         }
         return res;
     }
@@ -308,7 +316,8 @@ public:
                     std::shared_ptr<boost::asynchronous::lockfree_queue<boost::asynchronous::any_callable> > const& private_queue,
                     std::vector<boost::asynchronous::any_queue_ptr<job_type> > const& other_queues,
                     size_t index,std::shared_ptr<diag_type> diagnostics,std::shared_future<boost::thread*> self,
-                    std::weak_ptr<this_type> this_)
+                    std::weak_ptr<this_type> this_,
+                    std::shared_ptr<boost::asynchronous::detail::eventcount> wakeup)
     {
         boost::thread* t = self.get();
         boost::asynchronous::detail::multi_queue_scheduler_policy<Q,FindPosition>::m_self_thread.reset(new thread_ptr_wrapper(t));
@@ -316,11 +325,26 @@ public:
         boost::asynchronous::any_weak_scheduler<job_type> self_as_weak = boost::asynchronous::detail::lockable_weak_scheduler<this_type>(this_);
         boost::asynchronous::get_thread_scheduler<job_type>(self_as_weak,true);
         boost::asynchronous::get_own_queue_index<>(index+1,true);
+        boost::asynchronous::get_own_queue<>(queues[index].get(),true);
 
         std::list<boost::asynchronous::any_continuation>& waiting =
                 boost::asynchronous::get_continuations(std::list<boost::asynchronous::any_continuation>(),true);
 
         CPULoad cpu_load;
+        boost::asynchronous::detail::set_wakeup(cpu_load,wakeup);
+        // last check before parking
+        auto recheck = [&]()
+        {
+            if (execute_one_job(queues,index,other_queues,cpu_load,diagnostics,waiting))
+                return true;
+            boost::asynchronous::any_callable djob;
+            if (private_queue->try_pop(djob))
+            {
+                djob();
+                return true;
+            }
+            return false;
+        };
         while(true)
         {
             try
@@ -329,7 +353,7 @@ public:
                     bool popped = execute_one_job(queues,index,other_queues,cpu_load,diagnostics,waiting);
                     if (!popped)
                     {
-                        cpu_load.loop_done_no_job();
+                        boost::asynchronous::detail::loop_done_no_job(cpu_load,recheck,!waiting.empty());
                         // nothing for us to do, give up our time slice
                         boost::this_thread::yield();
                     }
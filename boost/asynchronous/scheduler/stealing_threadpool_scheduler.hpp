@@ -100,7 +100,7 @@ public:
             std::shared_future<boost::thread*> fu = new_thread_promise.get_future();
             boost::thread* new_thread =
                     m_group->create_thread(std::bind(&stealing_threadpool_scheduler::run,this->m_queue,
-                                                       m_private_queues[i],others,m_diagnostics,fu,weak_self,i));
+                                                       m_private_queues[i],others,m_diagnostics,fu,weak_self,i,this->m_wakeup));
             new_thread_promise.set_value(new_thread);
             m_thread_ids.push_back(new_thread->get_id());
         }
@@ -108,6 +108,8 @@ public:
     void constructor_done(std::weak_ptr<this_type> weak_self)
     {
         m_weak_self = weak_self;
+        // before any post, threads might only be started later
+        this->m_wakeup = boost::asynchronous::detail::make_wakeup<CPULoad>();
         if (IsImmediate)
             init(m_number_of_workers,std::vector<boost::asynchronous::any_queue_ptr<job_type> >(),m_weak_self);
     }
@@ -121,13 +123,14 @@ public:
             auto l = [fct,diag]() mutable
             {
                 if (fct)
-                    fct(boost::asynchronous::scheduler_diagnostics(diag->get_map(),diag->get_current()));
+                    fct(boost::asynchronous::scheduler_diagnostics(diag->get_map(),diag->get_current(),diag->dropped(),diag->get_latencies()));
             };
             boost::asynchronous::detail::default_termination_task<typename Q::diagnostic_type,boost::thread_group>
                     ttask(std::move(l));
             // this task has to be executed lat => lowest prio
             boost::asynchronous::any_callable job(std::move(ttask));
             m_private_queues[i]->push(std::move(job),std::numeric_limits<std::size_t>::max());
+            this->wakeup_all_workers();
         }
     }
 
@@ -145,7 +148,7 @@ public:
     boost::asynchronous::scheduler_diagnostics
     get_diagnostics(std::size_t =0)const
     {
-        return boost::asynchronous::scheduler_diagnostics(m_diagnostics->get_map(),m_diagnostics->get_current());
+        return boost::asynchronous::scheduler_diagnostics(m_diagnostics->get_map(),m_diagnostics->get_current(),m_diagnostics->dropped(),m_diagnostics->get_latencies());
     }
     void clear_diagnostics()
     {
@@ -165,8 +168,10 @@ public:
 #ifndef BOOST_NO_RVALUE_REFERENCES
             boost::asynchronous::any_callable job(std::move(ntask));
             m_private_queues[i]->push(std::move(job),std::numeric_limits<std::size_t>::max());
+            this->wakeup_all_workers();
 #else
             m_private_queues[i]->push(boost::asynchronous::any_callable(ntask),std::numeric_limits<std::size_t>::max());
+            this->wakeup_all_workers();
 #endif
         }
     }
@@ -185,6 +190,7 @@ public:
                 boost::asynchronous::detail::processor_bind_task task(std::get<0>(v)+i);
                 boost::asynchronous::any_callable job(std::move(task));
                 m_private_queues[t++]->push(std::move(job),std::numeric_limits<std::size_t>::max());
+                this->wakeup_all_workers();
             }
         }
     }
@@ -199,6 +205,7 @@ public:
             res.emplace_back(std::move(fu));
             boost::asynchronous::detail::execute_in_all_threads_task task(c,std::move(p));
             m_private_queues[i]->push(std::move(task),std::numeric_limits<std::size_t>::max());
+            this->wakeup_all_workers();
         }
         return res;
     }
@@ -286,7 +293,8 @@ public:
                     std::shared_ptr<diag_type> diagnostics,
                     std::shared_future<boost::thread*> self,
                     std::weak_ptr<this_type> this_,
-                    size_t index)
+                    size_t index,
+                    std::shared_ptr<boost::asynchronous::detail::eventcount> wakeup)
 
     {
         boost::thread* t = self.get();
@@ -299,6 +307,20 @@ public:
                 boost::asynchronous::get_continuations(std::list<boost::asynchronous::any_continuation>(),true);
 
         CPULoad cpu_load;
+        boost::asynchronous::detail::set_wakeup(cpu_load,wakeup);
+        // last check before parking
+        auto recheck = [&]()
+        {
+            if (execute_one_job(own_queue,other_queues,cpu_load,diagnostics,waiting,index))
+                return true;
+            boost::asynchronous::any_callable djob;
+            if (private_queue->try_pop(djob))
+            {
+                djob();
+                return true;
+            }
+            return false;
+        };
         while(true)
         {
             try
@@ -307,7 +329,7 @@ public:
                     bool popped = execute_one_job(own_queue,other_queues,cpu_load,diagnostics,waiting,index);
                     if (!popped)
                     {
-                        cpu_load.loop_done_no_job();
+                        boost::asynchronous::detail::loop_done_no_job(cpu_load,recheck,!waiting.empty());
                         // nothing for us to do, give up our time slice
                         boost::this_thread::yield();
                     }
@@ -51,6 +51,7 @@ struct client_request
         :m_cmd_id(cmd_id)
         ,m_task_id(0)
         ,m_load(data)
+        ,m_credits(0)
     {}
     template <typename Archive>
     void serialize(Archive& ar, const unsigned int /*version*/)
@@ -63,6 +64,11 @@ struct client_request
     // id of executed task if BOOST_ASYNCHRONOUS_TCP_CLIENT_JOB_RESULT
     long m_task_id;
     message_payload m_load;
+    // wire protocol version 2: m_load as archived by the client, not serialized. Read by the job directly.
+    std::string m_archived_load;
+    // wire protocol version 2, if BOOST_ASYNCHRONOUS_TCP_CLIENT_GET_JOB: how many jobs the client can take.
+    // 0 for version 1: one job, answered at once.
+    unsigned int m_credits;
 };
 }}}
 BOOST_CLASS_TRACKING(boost::asynchronous::tcp::client_request, boost::serialization::track_never)
@@ -10,6 +10,7 @@
 #ifndef BOOST_ASYNCHRONOUS_SCHEDULER_TCP_JOB_SERVER_HPP
 #define BOOST_ASYNCHRONOUS_SCHEDULER_TCP_JOB_SERVER_HPP
 
+#include <algorithm>
 #include <set>
 #include <vector>
 #include <deque>
@@ -23,7 +24,9 @@
 #include <boost/asynchronous/extensions/asio/asio_scheduler.hpp>
 #include <boost/asynchronous/scheduler_shared_proxy.hpp>
 #include <boost/asynchronous/scheduler/tcp/detail/server_connection.hpp>
+#include <boost/asynchronous/scheduler/tcp/detail/wire_protocol.hpp>
 #include <boost/asynchronous/scheduler/tcp/detail/asio_comm_server.hpp>
+#include <boost/asynchronous/scheduler/tcp/detail/shm_comm_server.hpp>
 #include <boost/asynchronous/scheduler/tcp/detail/client_request.hpp>
 #include <boost/asynchronous/diagnostics/any_loggable.hpp>
 #include <boost/asynchronous/diagnostics/any_loggable_serializable.hpp>
@@ -74,12 +77,7 @@ struct job_server : boost::asynchronous::trackable_servant<boost::asynchronous::
                                             diag);
                         this->m_unprocessed_jobs.emplace_back(std::move(new_job));
                         // if we have a waiting connection, immediately send
-                        if (!this->m_waiting_connections.empty())
-                        {
-                            // send
-                            this->send_first_job(this->m_waiting_connections.front());
-                            this->m_waiting_connections.pop_front();
-                        }
+                        this->dispatch_jobs();
                     },
                     "boost::asynchronous::tcp::job_server::serialize"
         );
@@ -90,23 +88,36 @@ struct job_server : boost::asynchronous::trackable_servant<boost::asynchronous::
     }
     void no_jobs()
     {
-        // inform waiting connections
-        for (typename std::deque<std::shared_ptr<server_connection_type> >::iterator it
-             = m_waiting_connections.begin();
+        // inform waiting connections expecting an answer (protocol version 1), the others keep waiting
+        for (typename std::deque<waiting_connection>::iterator it = m_waiting_connections.begin();
              it != m_waiting_connections.end(); ++it)
         {
-            std::function<void(boost::asynchronous::tcp::server_reponse)> cb=
-                    [this](boost::asynchronous::tcp::server_reponse ){};
-             (*it)->send(boost::asynchronous::tcp::server_reponse(0,"",""),cb);
+            if ((*it).m_credits == 0)
+            {
+                std::function<void(boost::asynchronous::tcp::server_reponse)> cb=
+                        [this](boost::asynchronous::tcp::server_reponse ){};
+                (*it).m_connection->send(boost::asynchronous::tcp::server_reponse(0,"",""),cb);
+            }
         }
-        m_waiting_connections.clear();
+        m_waiting_connections.erase(std::remove_if(m_waiting_connections.begin(),m_waiting_connections.end(),
+                                                   [](waiting_connection const& w){return w.m_credits == 0;}),
+                                    m_waiting_connections.end());
     }
 
 private:
 
     void handle_connect(std::shared_ptr<boost::asio::ip::tcp::socket> s)
     {
-        auto c = std::make_shared<server_connection_type >(m_asioWorkers,s);
+        start_connection(std::make_shared<server_connection_type >(m_asioWorkers,s));
+    }
+#ifdef BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+    void handle_shm_connect(std::shared_ptr<boost::asynchronous::tcp::detail::shm_stream> s)
+    {
+        start_connection(std::make_shared<server_connection_type >(m_asioWorkers,s));
+    }
+#endif
+    void start_connection(std::shared_ptr<server_connection_type > c)
+    {
         // short wait to see if we can steal some job
         m_keepalive_connections.insert(c);
 
@@ -125,17 +136,46 @@ private:
                                          [this](std::shared_ptr<boost::asio::ip::tcp::socket> socket)
                                          {this->handle_connect(socket);}),"",0);
         m_asio_comm.push_back(boost::asynchronous::tcp::asio_comm_server_proxy(m_asioWorkers, m_address, m_port, f));
+#ifdef BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+        // clients on this host can also come through shared memory
+        std::function<void(std::shared_ptr<boost::asynchronous::tcp::detail::shm_stream>)> fshm =
+                this->make_safe_callback(std::function<void(std::shared_ptr<boost::asynchronous::tcp::detail::shm_stream>)>(
+                                         [this](std::shared_ptr<boost::asynchronous::tcp::detail::shm_stream> stream)
+                                         {this->handle_shm_connect(stream);}),"",0);
+        m_shm_comm.push_back(boost::asynchronous::tcp::shm_comm_server_proxy(
+                                 m_asioWorkers,
+                                 boost::asynchronous::tcp::detail::shm_endpoint_name(m_address,std::to_string(m_port)),
+                                 fshm));
+#endif
     }
 
+    // send jobs to waiting connections, round-robin, as long as they have credits
+    void dispatch_jobs()
+    {
+        while (!m_unprocessed_jobs.empty() && !m_waiting_connections.empty())
+        {
+            waiting_connection waiting = m_waiting_connections.front();
+            m_waiting_connections.pop_front();
+            send_first_job(waiting.m_connection);
+            if (waiting.m_credits > 1)
+            {
+                --waiting.m_credits;
+                m_waiting_connections.push_back(waiting);
+            }
+        }
+    }
     void send_first_job(std::shared_ptr<server_connection_type > connection)
     {
         // prepare callback if failed
+        std::weak_ptr<server_connection_type> wconnection(connection);
         std::function<void(boost::asynchronous::tcp::server_reponse)> cb=
-                [this](boost::asynchronous::tcp::server_reponse msg){this->handle_error_send(msg);};
+                this->make_safe_callback(std::function<void(boost::asynchronous::tcp::server_reponse)>(
+                [this,wconnection](boost::asynchronous::tcp::server_reponse msg){this->handle_error_send(msg,wconnection);}),"",0);
 
         // set started time to when job gets stolen
         boost::asynchronous::job_traits<SerializableType>::set_started_time(m_unprocessed_jobs.front().m_job);
         connection->send(m_unprocessed_jobs.front().m_serialized,cb);
+        m_unprocessed_jobs.front().m_connection = connection;
         m_waiting_jobs.insert(m_unprocessed_jobs.front());
         m_unprocessed_jobs.pop_front();
     }
@@ -148,7 +188,22 @@ private:
             return;
 
         // is it a request for job?
-        if (request.m_cmd_id == BOOST_ASYNCHRONOUS_TCP_CLIENT_GET_JOB)
+        if (request.m_cmd_id == BOOST_ASYNCHRONOUS_TCP_CLIENT_GET_JOB && request.m_credits > 0)
+        {
+            // protocol version 2: the client waits for up to m_credits jobs, sent as they come
+            auto it = std::find_if(m_waiting_connections.begin(),m_waiting_connections.end(),
+                                   [&connection](waiting_connection const& w){return w.m_connection == connection;});
+            if (it != m_waiting_connections.end())
+            {
+                (*it).m_credits += request.m_credits;
+            }
+            else
+            {
+                m_waiting_connections.push_back(waiting_connection{connection,request.m_credits});
+            }
+            dispatch_jobs();
+        }
+        else if (request.m_cmd_id == BOOST_ASYNCHRONOUS_TCP_CLIENT_GET_JOB)
         {
             // send the first available job if any
             if (!m_unprocessed_jobs.empty())
@@ -165,7 +220,7 @@ private:
             else
             {
                 // short wait to see if we can steal some job
-                m_waiting_connections.push_back(connection);
+                m_waiting_connections.push_back(waiting_connection{connection,0});
             }
         }
         else if (request.m_cmd_id == BOOST_ASYNCHRONOUS_TCP_CLIENT_JOB_RESULT)
@@ -175,19 +230,32 @@ private:
             typename std::set<waiting_job,sort_tasks>::iterator it = m_waiting_jobs.find(searched_job);
             if (it != m_waiting_jobs.end())
             {
-                // return result. Serialize data and exception
-                std::ostringstream load_archive_stream;
-                typename SerializableType::oarchive load_archive(load_archive_stream);
-                load_archive << request.m_load;
-                std::string msg_load=load_archive_stream.str();
-
-                std::istringstream archive_stream(msg_load);
-                typename SerializableType::iarchive archive(archive_stream);
                 // set finish time to when result is sent, close diagnostics
                 boost::asynchronous::job_traits<SerializableType>::set_finished_time(const_cast<SerializableType&>((*it).m_job));
                 boost::asynchronous::job_traits<SerializableType>::add_diagnostic(const_cast<SerializableType&>((*it).m_job),(*it).m_diag.get());
+                if (!request.m_archived_load.empty())
+                {
+                    // protocol version 2, the job reads data and exception as archived by the client
+                    boost::asynchronous::tcp::detail::input_buffer_view load_buffer(request.m_archived_load.data(),
+                                                                                    request.m_archived_load.size());
+                    std::istream archive_stream(&load_buffer);
+                    typename SerializableType::iarchive archive(archive_stream);
+                    const_cast<SerializableType&>((*it).m_job).serialize(archive,0);
+                }
+                else
+                {
+                    // return result. Serialize data and exception
+                    std::ostringstream load_archive_stream;
+                    typename SerializableType::oarchive load_archive(load_archive_stream);
+                    load_archive << request.m_load;
+                    std::string msg_load=load_archive_stream.str();
 
-                const_cast<SerializableType&>((*it).m_job).serialize(archive,0);
+                    std::istringstream archive_stream(msg_load);
+                    typename SerializableType::iarchive archive(archive_stream);
+                    const_cast<SerializableType&>((*it).m_job).serialize(archive,0);
+                }
+                // result delivered, the job is not outstanding any more
+                m_waiting_jobs.erase(it);
             }
             // else ignore TODO log?
         }
@@ -195,17 +263,39 @@ private:
         {
             // let connection die
             m_keepalive_connections.erase(connection);
+            m_waiting_connections.erase(std::remove_if(m_waiting_connections.begin(),m_waiting_connections.end(),
+                                                       [&connection](waiting_connection const& w){return w.m_connection == connection;}),
+                                        m_waiting_connections.end());
+            // the jobs this client got will not come back, give them to others
+            for (auto it = m_waiting_jobs.begin(); it != m_waiting_jobs.end();)
+            {
+                if ((*it).sent_to(connection))
+                {
+                    m_unprocessed_jobs.emplace_front(std::move(*it));
+                    it = m_waiting_jobs.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            dispatch_jobs();
         }
         else
         {
             // unknown command, ignore
         }
     }
-    void handle_error_send(boost::asynchronous::tcp::server_reponse msg)
+    void handle_error_send(boost::asynchronous::tcp::server_reponse msg,std::weak_ptr<server_connection_type> wconnection)
     {
         // if this was not a real job, ignore
         if (msg.m_task_id != 0)
         {
+            // this connection will not take more jobs
+            std::shared_ptr<server_connection_type> connection = wconnection.lock();
+            m_waiting_connections.erase(std::remove_if(m_waiting_connections.begin(),m_waiting_connections.end(),
+                                                       [&connection](waiting_connection const& w){return w.m_connection == connection;}),
+                                        m_waiting_connections.end());
             // a real task got an error during communication and will no be processed this time, get it back
             waiting_job searched_job(SerializableType(),boost::asynchronous::tcp::server_reponse(msg.m_task_id,"",""),diag_type());
             auto it = m_waiting_jobs.find(searched_job);
@@ -214,6 +304,7 @@ private:
                 m_unprocessed_jobs.emplace_front(std::move(*it));
                 m_waiting_jobs.erase(it);
             }
+            dispatch_jobs();
         }
     }
 
@@ -226,6 +317,13 @@ private:
         SerializableType m_job;
         boost::asynchronous::tcp::server_reponse m_serialized;
         diag_type m_diag;
+        // compares owners, not addresses: a new connection can be allocated where a dead one was
+        bool sent_to(std::shared_ptr<server_connection_type> const& connection)const
+        {
+            return !m_connection.owner_before(connection) && !connection.owner_before(m_connection);
+        }
+        // connection the job was sent to, only compared, does not keep it alive
+        std::weak_ptr<server_connection_type> m_connection;
     };
     struct sort_tasks
     {
@@ -245,8 +343,17 @@ private:
     std::set<waiting_job,sort_tasks> m_waiting_jobs;
     boost::asynchronous::any_shared_scheduler_proxy<> m_asioWorkers;
     std::vector<boost::asynchronous::tcp::asio_comm_server_proxy> m_asio_comm;
+#ifdef BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+    std::vector<boost::asynchronous::tcp::shm_comm_server_proxy> m_shm_comm;
+#endif
     // connections for clients which connected and made a request but are waiting for us to answer
-    std::deque<std::shared_ptr<server_connection_type > > m_waiting_connections;
+    struct waiting_connection
+    {
+        std::shared_ptr<server_connection_type > m_connection;
+        // how many jobs we can still send (protocol version 2), 0 if the client waits for a single answer
+        unsigned int m_credits;
+    };
+    std::deque<waiting_connection> m_waiting_connections;
     // connections for clients who just connected and made no request yet
     // TODO timer which closes them after a timeout
     std::set<std::shared_ptr<server_connection_type > > m_keepalive_connections;
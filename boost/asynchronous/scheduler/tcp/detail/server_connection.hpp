@@ -13,12 +13,15 @@
 #include <array>
 #include <functional>
 #include <string>
-#include <sstream>
+#include <utility>
+#include <vector>
 
 #include <boost/asio.hpp>
 #include <boost/asynchronous/trackable_servant.hpp>
 #include <boost/asynchronous/scheduler/tcp/detail/client_request.hpp>
 #include <boost/asynchronous/scheduler/tcp/detail/server_response.hpp>
+#include <boost/asynchronous/scheduler/tcp/detail/wire_protocol.hpp>
+#include <boost/asynchronous/scheduler/tcp/detail/shm_stream.hpp>
 #include <boost/asynchronous/servant_proxy.hpp>
 #include <boost/asynchronous/diagnostics/any_loggable_serializable.hpp>
 
@@ -33,65 +36,60 @@ public:
         , m_socket(socket)
     {
     }
+#ifdef BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+    // a client on the same host, connected through shared memory
+    explicit server_connection(boost::asynchronous::any_weak_scheduler<boost::asynchronous::any_callable> scheduler,
+                               std::shared_ptr<boost::asynchronous::tcp::detail::shm_stream> stream)
+        : boost::asynchronous::trackable_servant<boost::asynchronous::any_callable>(scheduler)
+        , m_shm_stream(stream)
+    {
+    }
+    ~server_connection()
+    {
+        // pending operations keep the stream alive, end them
+        if (m_shm_stream)
+            m_shm_stream->close();
+    }
+#endif
 
     server_connection(server_connection const &) = delete;
     server_connection & operator=(server_connection const &) = delete;
 
     void start(std::function<void(boost::asynchronous::tcp::client_request)> callback)
     {
-        std::shared_ptr<std::vector<char> > inbound_header = std::make_shared<std::vector<char> >(m_header_length);
+        // read the shortest header first, this tells us which protocol version the client uses
         auto asocket= m_socket;
-        boost::asio::async_read(*m_socket,boost::asio::buffer(*inbound_header),
+        read_from_client(boost::asio::buffer(m_inbound_header.data(),boost::asynchronous::tcp::detail::wire_protocol_v1::header_length),
                                 this->make_safe_callback(std::function<void(boost::system::error_code ec, size_t )>(
-            [this, callback,inbound_header,asocket](boost::system::error_code ec, size_t /*bytes_transferred*/)mutable
+            [this, callback,asocket](boost::system::error_code ec, size_t /*bytes_transferred*/)mutable
             {
-                if (!ec)
+                if (ec)
                 {
-                    // reading header
-                    std::istringstream is(std::string(&(*inbound_header)[0], this->m_header_length));
-                    std::size_t inbound_data_size = 0;
-                    if (!(is >> std::hex >> inbound_data_size))
-                    {
-                        // Header doesn't seem to be valid. Close connection.
-                        // wrong header
-                        callback(boost::asynchronous::tcp::client_request(BOOST_ASYNCHRONOUS_TCP_CLIENT_COM_ERROR));
-                    }
-                    // read message
-                    std::shared_ptr<std::vector<char> > inbound_buffer = std::make_shared<std::vector<char> >();
-                    inbound_buffer->resize(inbound_data_size);
-                    auto asocket= m_socket;
-                    boost::asio::async_read(*m_socket,boost::asio::buffer(*inbound_buffer),
+                    callback(boost::asynchronous::tcp::client_request(BOOST_ASYNCHRONOUS_TCP_CLIENT_COM_ERROR));
+                    return;
+                }
+                if (boost::asynchronous::tcp::detail::wire_protocol_v2::is_header(m_inbound_header.data()))
+                {
+                    this->m_version = boost::asynchronous::tcp::detail::wire_protocol_v2::version;
+                    // read the rest of the header
+                    std::size_t read = boost::asynchronous::tcp::detail::wire_protocol_v1::header_length;
+                    this->read_from_client(boost::asio::buffer(m_inbound_header.data() + read,
+                                                                          boost::asynchronous::tcp::detail::wire_protocol_v2::header_length - read),
                                             this->make_safe_callback(std::function<void(boost::system::error_code ec, size_t )>(
-                                            [this, callback,inbound_buffer,inbound_header,asocket]
-                                            (boost::system::error_code ec1, size_t /*bytes_transferred*/)mutable
+                                            [this, callback,asocket](boost::system::error_code ec1, size_t /*bytes_transferred*/)mutable
                                             {
                                                 if (ec1)
                                                 {
                                                     callback(boost::asynchronous::tcp::client_request(BOOST_ASYNCHRONOUS_TCP_CLIENT_COM_ERROR));
+                                                    return;
                                                 }
-                                                else
-                                                {
-                                                    try
-                                                    {
-                                                        std::string archive_data(&(*inbound_buffer)[0], inbound_buffer->size());
-                                                        std::istringstream archive_stream(archive_data);
-                                                        typename SerializableType::iarchive archive(archive_stream);
-                                                        boost::asynchronous::tcp::client_request msg;
-                                                        archive >> msg;
-                                                        callback(msg);
-                                                        this->start(callback);
-                                                    }
-                                                    catch (std::exception& e)
-                                                    {
-                                                        // Unable to decode data.
-                                                        callback(boost::asynchronous::tcp::client_request(BOOST_ASYNCHRONOUS_TCP_CLIENT_COM_ERROR));
-                                                    }
-                                                }
+                                                this->template read_body<boost::asynchronous::tcp::detail::wire_protocol_v2>(std::move(callback));
                                             }),"",0));
                 }
                 else
                 {
-                    callback(boost::asynchronous::tcp::client_request(BOOST_ASYNCHRONOUS_TCP_CLIENT_COM_ERROR));
+                    this->m_version = boost::asynchronous::tcp::detail::wire_protocol_v1::version;
+                    this->template read_body<boost::asynchronous::tcp::detail::wire_protocol_v1>(std::move(callback));
                 }
             }),"",0));
     }
@@ -100,46 +98,126 @@ public:
     void send(boost::asynchronous::tcp::server_reponse const & reply,
               std::function<void(boost::asynchronous::tcp::server_reponse)> cb_if_failed)
     {
-        // Serialize the data first so we know how large it is.
-        std::ostringstream archive_stream;
-        typename SerializableType::oarchive archive(archive_stream);
-        archive << reply;
-        std::shared_ptr<std::string> outbound_buffer = std::make_shared<std::string>(archive_stream.str());
-
-        // Format the header.
-        std::ostringstream header_stream;
-        header_stream << std::setw(m_header_length)
-          << std::hex << outbound_buffer->size();
-        if (!header_stream || header_stream.str().size() != m_header_length)
+        // answer in the version of our client. Version 2 sends the already serialized task as is.
+        // Messages sent while we are writing are appended and go together in the next write
+        bool encoded = (m_version == boost::asynchronous::tcp::detail::wire_protocol_v1::version) ?
+                    boost::asynchronous::tcp::detail::wire_protocol_v1::encode_response<SerializableType>(*m_pending_buffer,reply):
+                    boost::asynchronous::tcp::detail::wire_protocol_v2::encode_response<SerializableType>(*m_pending_buffer,reply);
+        if (!encoded)
         {
             // Something went wrong
             cb_if_failed(reply);
+            return;
+        }
+        m_pending_replies.emplace_back(reply.m_task_id,std::move(cb_if_failed));
+        write_pending();
+    }
+
+private:
+    // our client uses either a tcp socket or shared memory
+    template <class Buffer, class Handler>
+    void read_from_client(Buffer const& buffer, Handler handler)
+    {
+#ifdef BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+        if (m_shm_stream)
+        {
+            boost::asio::async_read(*m_shm_stream,buffer,std::move(handler));
+            return;
+        }
+#endif
+        boost::asio::async_read(*m_socket,buffer,std::move(handler));
+    }
+    template <class Buffer, class Handler>
+    void write_to_client(Buffer const& buffer, Handler handler)
+    {
+#ifdef BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+        if (m_shm_stream)
+        {
+            boost::asio::async_write(*m_shm_stream,buffer,std::move(handler));
+            return;
         }
-        std::shared_ptr<std::string> outbound_header = std::make_shared<std::string>(header_stream.str());
-        // Write the serialized data to the socket. We use "gather-write" to send
-        // both the header and the data in a single write operation.
-        std::vector<boost::asio::const_buffer> buffers;
-        buffers.push_back(boost::asio::buffer(*outbound_header));
-        buffers.push_back(boost::asio::buffer(*outbound_buffer));
-        boost::asynchronous::tcp::server_reponse error_response(reply.m_task_id,"","");
+#endif
+        boost::asio::async_write(*m_socket,buffer,std::move(handler));
+    }
+    void write_pending()
+    {
+        if (m_is_writing || m_pending_buffer->empty())
+            return;
+        std::swap(m_pending_buffer,m_outbound_buffer);
+        std::swap(m_pending_replies,m_outbound_replies);
+        m_pending_buffer->clear();
+        m_pending_replies.clear();
+        m_is_writing = true;
         auto asocket= m_socket;
-        boost::asio::async_write(*m_socket, buffers,
+        auto outbound_buffer = m_outbound_buffer;
+        write_to_client(boost::asio::buffer(*outbound_buffer),
                                  this->make_safe_callback(std::function<void(boost::system::error_code ec, size_t )>(
-                                 [this,outbound_header,outbound_buffer,cb_if_failed,error_response,asocket](boost::system::error_code ec, size_t /*bytes_sent*/)
+                                 [this,outbound_buffer,asocket](boost::system::error_code ec, size_t /*bytes_sent*/)
                                  {
+                                    this->m_is_writing = false;
                                     if (ec)
                                     {
-                                        cb_if_failed(error_response);
+                                        for (auto const& reply : this->m_outbound_replies)
+                                        {
+                                            reply.second(boost::asynchronous::tcp::server_reponse(reply.first,"",""));
+                                        }
                                     }
+                                    this->m_outbound_replies.clear();
+                                    this->write_pending();
                                  }),"",0));
     }
+    template <class Protocol>
+    void read_body(std::function<void(boost::asynchronous::tcp::client_request)> callback)
+    {
+        std::size_t inbound_data_size = 0;
+        if (!Protocol::body_size(m_inbound_header.data(),inbound_data_size))
+        {
+            // Header doesn't seem to be valid. Close connection.
+            callback(boost::asynchronous::tcp::client_request(BOOST_ASYNCHRONOUS_TCP_CLIENT_COM_ERROR));
+            return;
+        }
+        // read message into our buffer, which keeps its capacity from message to message
+        m_inbound_buffer.resize(inbound_data_size);
+        auto asocket= m_socket;
+        read_from_client(boost::asio::buffer(m_inbound_buffer),
+                                this->make_safe_callback(std::function<void(boost::system::error_code ec, size_t )>(
+                                [this, callback,asocket](boost::system::error_code ec, size_t /*bytes_transferred*/)mutable
+                                {
+                                    if (ec)
+                                    {
+                                        callback(boost::asynchronous::tcp::client_request(BOOST_ASYNCHRONOUS_TCP_CLIENT_COM_ERROR));
+                                        return;
+                                    }
+                                    try
+                                    {
+                                        callback(Protocol::template decode_request<SerializableType>(
+                                                     m_inbound_header.data(),m_inbound_buffer.data(),m_inbound_buffer.size()));
+                                        this->start(callback);
+                                    }
+                                    catch (std::exception& e)
+                                    {
+                                        // Unable to decode data.
+                                        callback(boost::asynchronous::tcp::client_request(BOOST_ASYNCHRONOUS_TCP_CLIENT_COM_ERROR));
+                                    }
+                                }),"",0));
+    }
 
-private:
     std::shared_ptr<boost::asio::ip::tcp::socket> m_socket;
+#ifdef BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+    std::shared_ptr<boost::asynchronous::tcp::detail::shm_stream> m_shm_stream;
+#endif
     std::string m_address;
-    // The size of a fixed length header.
-    // TODO not fixed
-    enum { m_header_length = 10 };
+    // protocol version used by our client, known after its first message
+    int m_version = boost::asynchronous::tcp::detail::client_wire_protocol::version;
+    // receive buffers, reused for every message
+    std::array<char,boost::asynchronous::tcp::detail::wire_protocol_v2::header_length> m_inbound_header;
+    std::vector<char> m_inbound_buffer;
+    // send buffers, reused: one being written, one collecting the messages to send next, with the ids of their tasks
+    std::shared_ptr<std::vector<char>> m_outbound_buffer = std::make_shared<std::vector<char>>();
+    std::shared_ptr<std::vector<char>> m_pending_buffer = std::make_shared<std::vector<char>>();
+    std::vector<std::pair<long,std::function<void(boost::asynchronous::tcp::server_reponse)>>> m_outbound_replies;
+    std::vector<std::pair<long,std::function<void(boost::asynchronous::tcp::server_reponse)>>> m_pending_replies;
+    bool m_is_writing = false;
 };
 
 template <class Job>
@@ -154,6 +232,15 @@ public:
                                              boost::asynchronous::tcp::server_connection<Job>>
           (scheduler,std::move(socket))
     {}
+#ifdef BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+    template<class Scheduler>
+    server_connection_proxy( Scheduler scheduler,
+                            std::shared_ptr<boost::asynchronous::tcp::detail::shm_stream> stream)
+        : boost::asynchronous::servant_proxy<server_connection_proxy,
+                                             boost::asynchronous::tcp::server_connection<Job>>
+          (scheduler,std::move(stream))
+    {}
+#endif
     typedef typename boost::asynchronous::servant_proxy<server_connection_proxy<Job>,
                                              boost::asynchronous::tcp::server_connection<Job>>::servant_type servant_type;
     typedef typename boost::asynchronous::servant_proxy<server_connection_proxy<Job>,
@@ -0,0 +1,100 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNCHRONOUS_SCHEDULER_TCP_SHM_COMM_SERVER_HPP
+#define BOOST_ASYNCHRONOUS_SCHEDULER_TCP_SHM_COMM_SERVER_HPP
+
+#include <boost/asynchronous/scheduler/tcp/detail/shm_stream.hpp>
+
+#ifdef BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+
+#include <functional>
+#include <string>
+#include <memory>
+
+#include <boost/asio.hpp>
+
+#include <boost/asynchronous/trackable_servant.hpp>
+#include <boost/asynchronous/extensions/asio/tss_asio.hpp>
+#include <boost/asynchronous/servant_proxy.hpp>
+
+namespace boost { namespace asynchronous { namespace tcp {
+
+// accepts shared memory connections of clients on the same host, the counterpart of asio_comm_server
+struct shm_comm_server : boost::asynchronous::trackable_servant<>
+{
+    shm_comm_server(boost::asynchronous::any_weak_scheduler<> scheduler,
+                    std::string const & name,
+                    std::function<void(std::shared_ptr<boost::asynchronous::tcp::detail::shm_stream>)> connectionHandler)
+    : boost::asynchronous::trackable_servant<>(scheduler)
+        , m_connection_handler(std::move(connectionHandler))
+        , m_acceptor(*boost::asynchronous::get_io_service<>())
+    {
+        boost::asio::local::stream_protocol::endpoint endpoint(name);
+        boost::system::error_code ec;
+        m_acceptor.open(endpoint.protocol(),ec);
+        if (!ec)
+            m_acceptor.bind(endpoint,ec);
+        if (!ec)
+            m_acceptor.listen(boost::asio::socket_base::max_listen_connections,ec);
+        // if the name is taken, clients will reach the server through tcp only
+        if (!ec)
+            do_accept();
+    }
+
+private:
+    void do_accept()
+    {
+        auto stream = std::make_shared<boost::asynchronous::tcp::detail::shm_stream>(*boost::asynchronous::get_io_service<>());
+        m_acceptor.async_accept(stream->control_socket(),
+                                make_safe_callback(std::function<void(boost::system::error_code)>(
+                                [this,stream](boost::system::error_code ec)
+                                {
+                                    if (!m_acceptor.is_open())
+                                    {
+                                        return;
+                                    }
+                                    if (!ec)
+                                    {
+                                        // the client sends its shared memory right after connecting
+                                        stream->async_handshake(make_safe_callback(std::function<void(boost::system::error_code)>(
+                                        [this,stream](boost::system::error_code ec1)
+                                        {
+                                            if (!ec1)
+                                            {
+                                                m_connection_handler(stream);
+                                            }
+                                        }),"",0));
+                                    }
+                                    do_accept();
+                                }),"",0));
+    }
+
+    std::function<void(std::shared_ptr<boost::asynchronous::tcp::detail::shm_stream>)> m_connection_handler;
+    boost::asio::local::stream_protocol::acceptor m_acceptor;
+};
+
+class shm_comm_server_proxy : public boost::asynchronous::servant_proxy<shm_comm_server_proxy, boost::asynchronous::tcp::shm_comm_server>
+{
+public:
+    template<class Scheduler>
+    shm_comm_server_proxy( Scheduler scheduler,
+                           std::string const & name,
+                           std::function<void(std::shared_ptr<boost::asynchronous::tcp::detail::shm_stream>)> connectionHandler)
+        : boost::asynchronous::servant_proxy<shm_comm_server_proxy, boost::asynchronous::tcp::shm_comm_server>(scheduler,
+                                                                                                               name,
+                                                                                                               connectionHandler)
+    {}
+};
+
+}}}
+
+#endif // BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+
+#endif // BOOST_ASYNCHRONOUS_SCHEDULER_TCP_SHM_COMM_SERVER_HPP
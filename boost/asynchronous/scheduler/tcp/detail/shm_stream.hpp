@@ -0,0 +1,466 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNCHRONOUS_SCHEDULER_TCP_SHM_STREAM_HPP
+#define BOOST_ASYNCHRONOUS_SCHEDULER_TCP_SHM_STREAM_HPP
+
+// Shared memory connections between a tcp server and its clients on the same host need Linux (memfd, eventfd).
+// Define BOOST_ASYNCHRONOUS_NO_SHM_TRANSPORT to do without.
+#if defined(__linux__) && !defined(BOOST_ASYNCHRONOUS_NO_SHM_TRANSPORT)
+#define BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+#endif
+
+#ifdef BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <boost/asio.hpp>
+
+// size in bytes of each of the two rings (one per direction) of a shared memory connection, a power of 2
+#ifndef BOOST_ASYNCHRONOUS_SHM_RING_SIZE
+#define BOOST_ASYNCHRONOUS_SHM_RING_SIZE (1u << 20)
+#endif
+
+namespace boost { namespace asynchronous { namespace tcp { namespace detail {
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,"shared memory rings need lock-free atomics");
+
+// name of the local socket (abstract namespace) through which a server listening on address:port
+// hands out shared memory connections
+inline std::string shm_endpoint_name(std::string const& address, std::string const& port)
+{
+    return std::string(1,'\0') + "boost.asynchronous/" + address + ":" + port;
+}
+
+// single producer / single consumer ring of bytes in shared memory. Positions only grow.
+struct shm_ring
+{
+    enum { size = BOOST_ASYNCHRONOUS_SHM_RING_SIZE };
+    static_assert((size & (size - 1)) == 0,"BOOST_ASYNCHRONOUS_SHM_RING_SIZE must be a power of 2");
+
+    // written by the consumer
+    alignas(64) std::atomic<std::uint64_t> m_head;
+    // written by the producer
+    alignas(64) std::atomic<std::uint64_t> m_tail;
+    // set by a side before it sleeps, the other side rings the doorbell only then
+    alignas(64) std::atomic<std::uint32_t> m_consumer_waiting;
+    alignas(64) std::atomic<std::uint32_t> m_producer_waiting;
+    alignas(64) char m_data[size];
+};
+// ring 0 goes from client to server, ring 1 from server to client
+struct shm_segment
+{
+    shm_ring m_rings[2];
+};
+
+// A byte stream between two processes of a host, usable like a tcp socket with boost::asio::async_read / async_write.
+// Data goes through a ring in shared memory in each direction. A side going to sleep because its ring is empty (reader)
+// or full (writer) waits on an eventfd, the doorbell, which the other side rings only if someone sleeps. As long as
+// both sides are busy, no system call is made.
+// The client creates the shared memory and the eventfds and sends them to the server through a local socket (SCM_RIGHTS).
+// This control socket then only tells each side when the other is gone.
+// All operations of a stream must be done from the thread of its io_service.
+class shm_stream : public std::enable_shared_from_this<shm_stream>
+{
+public:
+    typedef boost::asio::io_service::executor_type executor_type;
+
+    explicit shm_stream(boost::asio::io_service& ios)
+        : m_io(ios)
+        , m_control(ios)
+        , m_data_ready(ios)
+        , m_space_ready(ios)
+    {
+    }
+    ~shm_stream()
+    {
+        if (m_segment)
+        {
+            ::munmap(m_segment,sizeof(shm_segment));
+        }
+        if (m_peer_data >= 0)
+        {
+            ::close(m_peer_data);
+        }
+        if (m_peer_space >= 0)
+        {
+            ::close(m_peer_space);
+        }
+    }
+    shm_stream(shm_stream const&) = delete;
+    shm_stream& operator=(shm_stream const&) = delete;
+
+    executor_type get_executor()
+    {
+        return m_io.get_executor();
+    }
+    boost::asio::local::stream_protocol::socket& control_socket()
+    {
+        return m_control;
+    }
+    bool is_open()const
+    {
+        return m_segment != nullptr && !m_closed;
+    }
+
+    // client: connect to the local socket of a server, create the shared memory and doorbells and send them
+    template <class ConnectHandler>
+    void async_connect(std::string const& name, ConnectHandler handler)
+    {
+        auto self = shared_from_this();
+        m_control.async_connect(boost::asio::local::stream_protocol::endpoint(name),
+                                [self,h=std::move(handler)](boost::system::error_code ec)mutable
+                                {
+                                    if (!ec)
+                                    {
+                                        ec = self->create_segment();
+                                    }
+                                    self->opened(ec);
+                                    h(ec);
+                                });
+    }
+    // server: after the control socket was accepted, receive the shared memory and doorbells of the client
+    template <class HandshakeHandler>
+    void async_handshake(HandshakeHandler handler)
+    {
+        auto self = shared_from_this();
+        m_control.async_wait(boost::asio::socket_base::wait_read,
+                             [self,h=std::move(handler)](boost::system::error_code ec)mutable
+                             {
+                                 if (!ec)
+                                 {
+                                     ec = self->receive_segment();
+                                 }
+                                 self->opened(ec);
+                                 h(ec);
+                             });
+    }
+
+    template <class MutableBufferSequence, class ReadHandler>
+    void async_read_some(MutableBufferSequence const& buffers, ReadHandler handler)
+    {
+        if (!m_segment)
+        {
+            complete(std::move(handler),boost::asio::error::not_connected,0);
+            return;
+        }
+        shm_ring& ring = m_segment->m_rings[1 - m_tx];
+        std::size_t read = read_ring(ring,buffers);
+        if (read > 0 || boost::asio::buffer_size(buffers) == 0)
+        {
+            complete(std::move(handler),boost::system::error_code(),read);
+            return;
+        }
+        if (m_closed)
+        {
+            complete(std::move(handler),boost::asio::error::eof,0);
+            return;
+        }
+        // announce that we sleep, then check again: a write in between sees it and rings
+        ring.m_consumer_waiting.store(1);
+        if (ring.m_tail.load() != ring.m_head.load(std::memory_order_relaxed))
+        {
+            ring.m_consumer_waiting.store(0);
+            async_read_some(buffers,std::move(handler));
+            return;
+        }
+        auto self = shared_from_this();
+        m_data_ready.async_wait(boost::asio::posix::descriptor_base::wait_read,
+                                [self,buffers,h=std::move(handler)](boost::system::error_code ec)mutable
+                                {
+                                    self->m_segment->m_rings[1 - self->m_tx].m_consumer_waiting.store(0);
+                                    drain(self->m_data_ready.native_handle());
+                                    if (ec && !self->m_closed)
+                                    {
+                                        h(ec,0);
+                                        return;
+                                    }
+                                    self->async_read_some(buffers,std::move(h));
+                                });
+    }
+    template <class ConstBufferSequence, class WriteHandler>
+    void async_write_some(ConstBufferSequence const& buffers, WriteHandler handler)
+    {
+        if (!m_segment || m_closed)
+        {
+            complete(std::move(handler),m_closed ? boost::asio::error::broken_pipe : boost::asio::error::not_connected,0);
+            return;
+        }
+        shm_ring& ring = m_segment->m_rings[m_tx];
+        std::size_t written = write_ring(ring,buffers);
+        if (written > 0 || boost::asio::buffer_size(buffers) == 0)
+        {
+            complete(std::move(handler),boost::system::error_code(),written);
+            return;
+        }
+        // ring full, same as for reading
+        ring.m_producer_waiting.store(1);
+        if (ring.m_tail.load(std::memory_order_relaxed) - ring.m_head.load() < shm_ring::size)
+        {
+            ring.m_producer_waiting.store(0);
+            async_write_some(buffers,std::move(handler));
+            return;
+        }
+        auto self = shared_from_this();
+        m_space_ready.async_wait(boost::asio::posix::descriptor_base::wait_read,
+                                 [self,buffers,h=std::move(handler)](boost::system::error_code ec)mutable
+                                 {
+                                     self->m_segment->m_rings[self->m_tx].m_producer_waiting.store(0);
+                                     drain(self->m_space_ready.native_handle());
+                                     if (ec && !self->m_closed)
+                                     {
+                                         h(ec,0);
+                                         return;
+                                     }
+                                     self->async_write_some(buffers,std::move(h));
+                                 });
+    }
+    // pending operations end, the other side sees the control socket closing. Data already written can still be read.
+    void close()
+    {
+        if (m_closed)
+            return;
+        m_closed = true;
+        boost::system::error_code ec;
+        m_control.close(ec);
+        m_data_ready.cancel(ec);
+        m_space_ready.cancel(ec);
+    }
+
+private:
+    template <class Handler>
+    void complete(Handler handler, boost::system::error_code ec, std::size_t bytes)
+    {
+        boost::asio::post(m_io,[h=std::move(handler),ec,bytes]()mutable{h(ec,bytes);});
+    }
+    template <class MutableBufferSequence>
+    std::size_t read_ring(shm_ring& ring, MutableBufferSequence const& buffers)
+    {
+        std::uint64_t head = ring.m_head.load(std::memory_order_relaxed);
+        std::size_t count = (std::size_t)(ring.m_tail.load(std::memory_order_acquire) - head);
+        std::size_t offset = (std::size_t)(head & (shm_ring::size - 1));
+        std::size_t first = (std::min)(count,shm_ring::size - offset);
+        std::array<boost::asio::const_buffer,2> parts{{boost::asio::buffer(ring.m_data + offset,first),
+                                                       boost::asio::buffer(ring.m_data,count - first)}};
+        std::size_t read = boost::asio::buffer_copy(buffers,parts);
+        if (read > 0)
+        {
+            ring.m_head.store(head + read);
+            // the writer may wait for room
+            if (ring.m_producer_waiting.load() != 0 && ring.m_producer_waiting.exchange(0) != 0)
+            {
+                ring_doorbell(m_peer_space);
+            }
+        }
+        return read;
+    }
+    template <class ConstBufferSequence>
+    std::size_t write_ring(shm_ring& ring, ConstBufferSequence const& buffers)
+    {
+        std::uint64_t tail = ring.m_tail.load(std::memory_order_relaxed);
+        std::size_t space = shm_ring::size - (std::size_t)(tail - ring.m_head.load(std::memory_order_acquire));
+        std::size_t offset = (std::size_t)(tail & (shm_ring::size - 1));
+        std::size_t first = (std::min)(space,shm_ring::size - offset);
+        std::array<boost::asio::mutable_buffer,2> parts{{boost::asio::buffer(ring.m_data + offset,first),
+                                                         boost::asio::buffer(ring.m_data,space - first)}};
+        std::size_t written = boost::asio::buffer_copy(parts,buffers);
+        if (written > 0)
+        {
+            ring.m_tail.store(tail + written);
+            // the reader may wait for data
+            if (ring.m_consumer_waiting.load() != 0 && ring.m_consumer_waiting.exchange(0) != 0)
+            {
+                ring_doorbell(m_peer_data);
+            }
+        }
+        return written;
+    }
+    static void ring_doorbell(int fd)
+    {
+        std::uint64_t one = 1;
+        ssize_t res = ::write(fd,&one,sizeof(one));
+        (void)res;
+    }
+    // reset a doorbell (non-blocking)
+    static void drain(int fd)
+    {
+        std::uint64_t count = 0;
+        ssize_t res = ::read(fd,&count,sizeof(count));
+        (void)res;
+    }
+    static boost::system::error_code last_error()
+    {
+        return boost::system::error_code(errno,boost::system::system_category());
+    }
+
+    // fds: memfd, then data and space doorbells of ring 0, of ring 1. Takes ownership.
+    boost::system::error_code map_segment(int const* fds, int tx)
+    {
+        void* addr = ::mmap(nullptr,sizeof(shm_segment),PROT_READ | PROT_WRITE,MAP_SHARED,fds[0],0);
+        boost::system::error_code ec = (addr == MAP_FAILED) ? last_error() : boost::system::error_code();
+        ::close(fds[0]);
+        if (ec)
+        {
+            for (int i = 1; i < 5; ++i)
+                ::close(fds[i]);
+            return ec;
+        }
+        m_segment = static_cast<shm_segment*>(addr);
+        m_tx = tx;
+        // we wait for data in the ring we read and for space in the one we write, and tell the other side about the opposite
+        m_data_ready.assign(fds[1 + 2 * (1 - tx)]);
+        m_space_ready.assign(fds[2 + 2 * tx]);
+        m_peer_data = fds[1 + 2 * tx];
+        m_peer_space = fds[2 + 2 * (1 - tx)];
+        return ec;
+    }
+    boost::system::error_code create_segment()
+    {
+        int fds[5] = {-1,-1,-1,-1,-1};
+        boost::system::error_code ec;
+        fds[0] = ::memfd_create("boost.asynchronous.shm",MFD_CLOEXEC);
+        if (fds[0] < 0 || ::ftruncate(fds[0],sizeof(shm_segment)) != 0)
+        {
+            ec = last_error();
+        }
+        for (int i = 1; i < 5 && !ec; ++i)
+        {
+            fds[i] = ::eventfd(0,EFD_NONBLOCK | EFD_CLOEXEC);
+            if (fds[i] < 0)
+                ec = last_error();
+        }
+        if (!ec)
+        {
+            ec = send_fds(fds);
+        }
+        if (ec)
+        {
+            for (int fd : fds)
+            {
+                if (fd >= 0)
+                    ::close(fd);
+            }
+            return ec;
+        }
+        // a new memfd is filled with zeros, which makes both rings empty
+        return map_segment(fds,0);
+    }
+    boost::system::error_code send_fds(int const* fds)
+    {
+        char byte = 'S';
+        struct iovec iov;
+        iov.iov_base = &byte;
+        iov.iov_len = 1;
+        union
+        {
+            struct cmsghdr m_header;
+            char m_buffer[CMSG_SPACE(5 * sizeof(int))];
+        } control;
+        std::memset(&control,0,sizeof(control));
+        struct msghdr msg;
+        std::memset(&msg,0,sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.m_buffer;
+        msg.msg_controllen = sizeof(control.m_buffer);
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(5 * sizeof(int));
+        std::memcpy(CMSG_DATA(cmsg),fds,5 * sizeof(int));
+        if (::sendmsg(m_control.native_handle(),&msg,MSG_NOSIGNAL) != 1)
+            return last_error();
+        return boost::system::error_code();
+    }
+    boost::system::error_code receive_segment()
+    {
+        char byte = 0;
+        struct iovec iov;
+        iov.iov_base = &byte;
+        iov.iov_len = 1;
+        union
+        {
+            struct cmsghdr m_header;
+            char m_buffer[CMSG_SPACE(5 * sizeof(int))];
+        } control;
+        std::memset(&control,0,sizeof(control));
+        struct msghdr msg;
+        std::memset(&msg,0,sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.m_buffer;
+        msg.msg_controllen = sizeof(control.m_buffer);
+        ssize_t res = ::recvmsg(m_control.native_handle(),&msg,MSG_CMSG_CLOEXEC);
+        if (res < 0)
+            return last_error();
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        if (res != 1 || byte != 'S' || !cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS ||
+            cmsg->cmsg_len != CMSG_LEN(5 * sizeof(int)))
+        {
+            if (cmsg && cmsg->cmsg_type == SCM_RIGHTS)
+            {
+                // do not leak what we got
+                std::size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                int* received = reinterpret_cast<int*>(CMSG_DATA(cmsg));
+                for (std::size_t i = 0; i < count; ++i)
+                    ::close(received[i]);
+            }
+            return boost::asio::error::invalid_argument;
+        }
+        int fds[5];
+        std::memcpy(fds,CMSG_DATA(cmsg),5 * sizeof(int));
+        return map_segment(fds,1);
+    }
+    // once opened, nothing more comes through the control socket until the other side closes it
+    void opened(boost::system::error_code const& ec)
+    {
+        if (ec)
+        {
+            close();
+            return;
+        }
+        auto self = shared_from_this();
+        m_control.async_read_some(boost::asio::buffer(&m_control_byte,1),
+                                  [self](boost::system::error_code, std::size_t){self->close();});
+    }
+
+    boost::asio::io_service& m_io;
+    boost::asio::local::stream_protocol::socket m_control;
+    char m_control_byte = 0;
+    shm_segment* m_segment = nullptr;
+    // ring we write to, the other one we read from
+    int m_tx = 0;
+    // doorbells we wait on
+    boost::asio::posix::stream_descriptor m_data_ready;
+    boost::asio::posix::stream_descriptor m_space_ready;
+    // doorbells we ring for the other side
+    int m_peer_data = -1;
+    int m_peer_space = -1;
+    bool m_closed = false;
+};
+
+}}}}
+
+#endif // BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+
+#endif // BOOST_ASYNCHRONOUS_SCHEDULER_TCP_SHM_STREAM_HPP
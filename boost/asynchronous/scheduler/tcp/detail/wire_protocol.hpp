@@ -0,0 +1,306 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNCHRONOUS_SCHEDULER_TCP_WIRE_PROTOCOL_HPP
+#define BOOST_ASYNCHRONOUS_SCHEDULER_TCP_WIRE_PROTOCOL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <boost/asynchronous/scheduler/tcp/detail/client_request.hpp>
+#include <boost/asynchronous/scheduler/tcp/detail/server_response.hpp>
+
+// Clients talk version 2 (binary header) unless this is defined, in which case they use the version 1 text header
+// (a client can also choose its protocol with the WireProtocol template argument of simple_tcp_client).
+// Servers understand both and answer each connection in the version its client uses.
+// #define BOOST_ASYNCHRONOUS_TCP_WIRE_PROTOCOL_V1
+
+// command of a server message carrying a task (or no task if the payload is empty), version 2 only
+#define BOOST_ASYNCHRONOUS_TCP_SERVER_TASK 4
+
+namespace boost { namespace asynchronous { namespace tcp { namespace detail {
+
+// read-only streambuf over memory we do not own, so that archives read directly from a receive buffer
+class input_buffer_view : public std::streambuf
+{
+public:
+    input_buffer_view(char const* data, std::size_t size)
+    {
+        char* begin = const_cast<char*>(data);
+        setg(begin, begin, begin + size);
+    }
+};
+
+// streambuf appending to a buffer, so that archives write directly into a (reused) send buffer.
+// Encoding functions append a message to the buffer, several messages can then be sent in a single write.
+// The buffer gets its final size when the view is destroyed, so the archive using it has to be destroyed first.
+class output_buffer_view : public std::streambuf
+{
+public:
+    explicit output_buffer_view(std::vector<char>& buffer)
+        : m_buffer(buffer)
+    {
+        grow(buffer.size());
+    }
+    ~output_buffer_view()
+    {
+        m_buffer.resize(written());
+    }
+    output_buffer_view(output_buffer_view const&)=delete;
+    output_buffer_view& operator=(output_buffer_view const&)=delete;
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        if (traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+        grow(written());
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+        return c;
+    }
+    std::streamsize xsputn(char const* s, std::streamsize n) override
+    {
+        if (epptr() - pptr() < n)
+            grow(written() + (std::size_t)n);
+        std::memcpy(pptr(), s, (std::size_t)n);
+        pbump((int)n);
+        return n;
+    }
+
+private:
+    std::size_t written() const
+    {
+        return (std::size_t)(pptr() - pbase());
+    }
+    // keep what is written, make room for at least one more char than needed
+    void grow(std::size_t needed)
+    {
+        std::size_t done = pbase() ? written() : m_buffer.size();
+        m_buffer.resize((std::max)(needed + 1, (std::max)(m_buffer.capacity(), (std::size_t)256)));
+        char* begin = m_buffer.data();
+        setp(begin, begin + m_buffer.size());
+        pbump((int)done);
+    }
+    std::vector<char>& m_buffer;
+};
+
+// Version 1: a 10 characters hex text header with the size of the message, then a text archive of a
+// client_request or of a server_reponse (which contains the task already serialized as a string).
+// A job request gets exactly one answer, with a task or none.
+struct wire_protocol_v1
+{
+    enum { version = 1 };
+    enum { header_length = 10 };
+
+    // size of the message following the header
+    static bool body_size(char const* header, std::size_t& size)
+    {
+        char text[header_length + 1];
+        std::memcpy(text, header, header_length);
+        text[header_length] = 0;
+        char* end = nullptr;
+        unsigned long long res = std::strtoull(text, &end, 16);
+        if (end == text || *end != 0)
+            return false;
+        size = (std::size_t)res;
+        return true;
+    }
+    template <class SerializableType>
+    static bool encode_request(std::vector<char>& buffer, boost::asynchronous::tcp::client_request const& request)
+    {
+        return encode<SerializableType>(buffer, request);
+    }
+    template <class SerializableType>
+    static bool encode_response(std::vector<char>& buffer, boost::asynchronous::tcp::server_reponse const& response)
+    {
+        return encode<SerializableType>(buffer, response);
+    }
+    template <class SerializableType>
+    static boost::asynchronous::tcp::client_request decode_request(char const* /*header*/, char const* body, std::size_t size)
+    {
+        boost::asynchronous::tcp::client_request request;
+        decode<SerializableType>(body, size, request);
+        return request;
+    }
+    template <class SerializableType>
+    static boost::asynchronous::tcp::server_reponse decode_response(char const* /*header*/, char const* body, std::size_t size)
+    {
+        boost::asynchronous::tcp::server_reponse response(0, "", "");
+        decode<SerializableType>(body, size, response);
+        return response;
+    }
+
+private:
+    template <class SerializableType, class T>
+    static bool encode(std::vector<char>& buffer, T const& t)
+    {
+        std::size_t start = buffer.size();
+        buffer.resize(start + header_length);
+        {
+            boost::asynchronous::tcp::detail::output_buffer_view view(buffer);
+            std::ostream archive_stream(&view);
+            typename SerializableType::oarchive archive(archive_stream);
+            archive << t;
+        }
+        std::size_t size = buffer.size() - start - header_length;
+        char text[header_length + 1];
+        if (std::snprintf(text, sizeof(text), "%10llx", (unsigned long long)size) != header_length)
+        {
+            buffer.resize(start);
+            return false;
+        }
+        std::memcpy(buffer.data() + start, text, header_length);
+        return true;
+    }
+    template <class SerializableType, class T>
+    static void decode(char const* body, std::size_t size, T& t)
+    {
+        boost::asynchronous::tcp::detail::input_buffer_view view(body, size);
+        std::istream archive_stream(&view);
+        typename SerializableType::iarchive archive(archive_stream);
+        archive >> t;
+    }
+};
+
+// Version 2: a fixed binary header, integers in little endian:
+// 'B' 'A' version command | task name size (uint32) | task id (uint64) | payload size (uint64)
+// then the task name and payload. The payload of a task is the job as serialized by the server, sent as is.
+// The payload of a result is the archived client_request::message_payload, read by the job directly from the buffer.
+// The payload of a job request is the number of jobs (uint32) the client is ready to take. The server sends them
+// as they come, without answering if it has none: the client keeps its request open and streams results back.
+struct wire_protocol_v2
+{
+    enum { version = 2 };
+    enum { header_length = 24 };
+
+    // is this the beginning of a version 2 header? Needs the first wire_protocol_v1::header_length bytes
+    static bool is_header(char const* header)
+    {
+        return header[0] == 'B' && header[1] == 'A' && header[2] == (char)version;
+    }
+    static bool body_size(char const* header, std::size_t& size)
+    {
+        if (!is_header(header))
+            return false;
+        std::uint64_t res = read_uint(header + 4, 4) + read_uint(header + 16, 8);
+        if (res > (std::uint64_t)(std::numeric_limits<std::size_t>::max)())
+            return false;
+        size = (std::size_t)res;
+        return true;
+    }
+    template <class SerializableType>
+    static bool encode_request(std::vector<char>& buffer, boost::asynchronous::tcp::client_request const& request)
+    {
+        std::size_t start = buffer.size();
+        buffer.resize(start + header_length);
+        if (request.m_cmd_id == BOOST_ASYNCHRONOUS_TCP_CLIENT_JOB_RESULT)
+        {
+            boost::asynchronous::tcp::detail::output_buffer_view view(buffer);
+            std::ostream archive_stream(&view);
+            typename SerializableType::oarchive archive(archive_stream);
+            archive << request.m_load;
+        }
+        else if (request.m_cmd_id == BOOST_ASYNCHRONOUS_TCP_CLIENT_GET_JOB)
+        {
+            // the payload is the number of jobs the client is ready to take
+            buffer.resize(start + header_length + 4);
+            write_uint(buffer.data() + start + header_length, 4, request.m_credits);
+        }
+        write_header(buffer.data() + start, request.m_cmd_id, 0, (std::uint64_t)request.m_task_id,
+                     buffer.size() - start - header_length);
+        return true;
+    }
+    template <class SerializableType>
+    static bool encode_response(std::vector<char>& buffer, boost::asynchronous::tcp::server_reponse const& response)
+    {
+        std::size_t start = buffer.size();
+        buffer.resize(start + header_length);
+        buffer.insert(buffer.end(), response.m_task_name.begin(), response.m_task_name.end());
+        buffer.insert(buffer.end(), response.m_task.begin(), response.m_task.end());
+        write_header(buffer.data() + start, BOOST_ASYNCHRONOUS_TCP_SERVER_TASK, response.m_task_name.size(),
+                     (std::uint64_t)response.m_task_id, response.m_task.size());
+        return true;
+    }
+    template <class SerializableType>
+    static boost::asynchronous::tcp::client_request decode_request(char const* header, char const* body, std::size_t size)
+    {
+        boost::asynchronous::tcp::client_request request(header[3]);
+        request.m_task_id = (long)read_uint(header + 8, 8);
+        if (request.m_cmd_id == BOOST_ASYNCHRONOUS_TCP_CLIENT_GET_JOB)
+        {
+            request.m_credits = size >= 4 ? (unsigned int)read_uint(body, 4) : 1;
+        }
+        else
+        {
+            // copied once as it is handed to the job server's thread, deserialized there by the job
+            request.m_archived_load.assign(body, body + size);
+        }
+        return request;
+    }
+    template <class SerializableType>
+    static boost::asynchronous::tcp::server_reponse decode_response(char const* header, char const* body, std::size_t size)
+    {
+        std::size_t name_size = (std::size_t)read_uint(header + 4, 4);
+        if (name_size > size)
+            return boost::asynchronous::tcp::server_reponse(0, "", "");
+        return boost::asynchronous::tcp::server_reponse((long)read_uint(header + 8, 8),
+                                                        std::string(body + name_size, size - name_size),
+                                                        std::string(body, name_size));
+    }
+
+private:
+    static void write_header(char* header, char command, std::size_t name_size, std::uint64_t task_id, std::size_t payload_size)
+    {
+        header[0] = 'B';
+        header[1] = 'A';
+        header[2] = (char)version;
+        header[3] = command;
+        write_uint(header + 4, 4, name_size);
+        write_uint(header + 8, 8, task_id);
+        write_uint(header + 16, 8, payload_size);
+    }
+    static void write_uint(char* out, std::size_t bytes, std::uint64_t value)
+    {
+        for (std::size_t i = 0; i < bytes; ++i)
+        {
+            out[i] = (char)((value >> (8 * i)) & 0xff);
+        }
+    }
+    static std::uint64_t read_uint(char const* in, std::size_t bytes)
+    {
+        std::uint64_t res = 0;
+        for (std::size_t i = 0; i < bytes; ++i)
+        {
+            res |= (std::uint64_t)(unsigned char)in[i] << (8 * i);
+        }
+        return res;
+    }
+};
+
+// protocol used by clients
+#ifdef BOOST_ASYNCHRONOUS_TCP_WIRE_PROTOCOL_V1
+typedef boost::asynchronous::tcp::detail::wire_protocol_v1 client_wire_protocol;
+#else
+typedef boost::asynchronous::tcp::detail::wire_protocol_v2 client_wire_protocol;
+#endif
+
+}}}}
+
+#endif // BOOST_ASYNCHRONOUS_SCHEDULER_TCP_WIRE_PROTOCOL_HPP
@@ -11,8 +11,12 @@
 #ifndef BOOST_ASYNCHRONOUS_SCHEDULER_TCP_SIMPLE_TCP_CLIENT_HPP
 #define BOOST_ASYNCHRONOUS_SCHEDULER_TCP_SIMPLE_TCP_CLIENT_HPP
 
+#include <array>
 #include <string>
 #include <sstream>
+#include <vector>
+#include <numeric>
+#include <algorithm>
 #include <atomic>
 #include <deque>
 
@@ -25,11 +29,18 @@
 #include <boost/asynchronous/scheduler/tcp/detail/client_request.hpp>
 #include <boost/asynchronous/scheduler/tcp/detail/server_response.hpp>
 #include <boost/asynchronous/scheduler/tcp/detail/transport_exception.hpp>
+#include <boost/asynchronous/scheduler/tcp/detail/wire_protocol.hpp>
+#include <boost/asynchronous/scheduler/tcp/detail/shm_stream.hpp>
 #include <boost/asynchronous/scheduler/tss_scheduler.hpp>
 #include <boost/asynchronous/any_serializable.hpp>
 #include <boost/asynchronous/callable_any.hpp>
 #include <boost/asynchronous/continuation_task.hpp>
 
+// jobs a client (protocol version 2) takes from the server before sending results back, if its policy does not say otherwise
+#ifndef BOOST_ASYNCHRONOUS_TCP_CLIENT_IN_FLIGHT_WINDOW
+#define BOOST_ASYNCHRONOUS_TCP_CLIENT_IN_FLIGHT_WINDOW 8
+#endif
+
 namespace boost { namespace asynchronous { namespace tcp {
 
 // this policy checks for work after a given time
@@ -38,9 +49,17 @@ struct client_time_check_policy: boost::asynchronous::trackable_servant<boost::a
 {
     client_time_check_policy(boost::asynchronous::any_weak_scheduler<boost::asynchronous::any_callable> scheduler,
                              boost::asynchronous::any_shared_scheduler_proxy<SerializableType> pool,
-                             long time_in_ms_between_requests)
+                             long time_in_ms_between_requests,
+                             unsigned int in_flight_window = BOOST_ASYNCHRONOUS_TCP_CLIENT_IN_FLIGHT_WINDOW)
         :boost::asynchronous::trackable_servant<boost::asynchronous::any_callable,SerializableType>(scheduler,pool)
-        , m_time_in_ms_between_requests(time_in_ms_between_requests){}
+        , m_time_in_ms_between_requests(time_in_ms_between_requests)
+        , m_in_flight_window(in_flight_window){}
+
+    // optional: how many jobs the client takes from the server before returning results (protocol version 2)
+    unsigned int in_flight_window()const
+    {
+        return m_in_flight_window;
+    }
 
     // every policy for tcp clients must implement this
     template <class T, class WS>
@@ -58,6 +77,7 @@ struct client_time_check_policy: boost::asynchronous::trackable_servant<boost::a
     }
 
     long m_time_in_ms_between_requests;
+    unsigned int m_in_flight_window;
 };
 
 // this policy checks for work if the queue size falls under a given length
@@ -68,10 +88,17 @@ struct queue_size_check_policy: boost::asynchronous::trackable_servant<boost::as
     queue_size_check_policy(boost::asynchronous::any_weak_scheduler<boost::asynchronous::any_callable> scheduler,
                              boost::asynchronous::any_shared_scheduler_proxy<SerializableType> pool,
                              long time_in_ms_between_requests,
-                             unsigned int min_queue_size)
+                             unsigned int min_queue_size,
+                             unsigned int in_flight_window = BOOST_ASYNCHRONOUS_TCP_CLIENT_IN_FLIGHT_WINDOW)
         :boost::asynchronous::trackable_servant<boost::asynchronous::any_callable,SerializableType>(scheduler,pool)
         , m_time_in_ms_between_requests(time_in_ms_between_requests)
-        , m_min_queue_size(min_queue_size){}
+        , m_min_queue_size(min_queue_size)
+        , m_in_flight_window(in_flight_window){}
+
+    unsigned int in_flight_window()const
+    {
+        return m_in_flight_window;
+    }
 
     // every policy for tcp clients must implement this
     template <class T, class WS>
@@ -111,9 +138,63 @@ struct queue_size_check_policy: boost::asynchronous::trackable_servant<boost::as
 
     long m_time_in_ms_between_requests;
     unsigned int m_min_queue_size;
+    unsigned int m_in_flight_window;
 };
 
-template <class CheckPolicy, class SerializableType = boost::asynchronous::any_serializable>
+namespace detail
+{
+// in-flight window of a client policy, 1 if it does not define one
+template <class CheckPolicy>
+auto in_flight_window(CheckPolicy const& policy, int) -> decltype(policy.in_flight_window(),0u)
+{
+    return (std::max)(policy.in_flight_window(),1u);
+}
+template <class CheckPolicy>
+unsigned int in_flight_window(CheckPolicy const&, long)
+{
+    return 1;
+}
+}
+
+// How a client reaches its server: through a tcp socket (default) or, if the server runs on the same host,
+// through shared memory (Linux only). A tcp_server_scheduler accepts both, on the address and port it listens on.
+struct tcp_transport
+{
+    typedef boost::asio::ip::tcp::socket stream_type;
+    static void prepare(stream_type& socket)
+    {
+        // no delay
+        boost::asio::ip::tcp::no_delay option(true);
+        boost::system::error_code ec;
+        socket.set_option(option,ec);
+    }
+    static void close(stream_type& socket)
+    {
+        boost::system::error_code ec;
+        socket.close(ec);
+    }
+};
+#ifdef BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+struct shm_transport
+{
+    typedef boost::asynchronous::tcp::detail::shm_stream stream_type;
+    static void prepare(stream_type&)
+    {
+    }
+    static void close(stream_type& stream)
+    {
+        stream.close();
+    }
+};
+#endif
+
+// With protocol version 2, a client asks for up to its in-flight window of jobs and keeps this request open.
+// The server sends jobs as they come, results are streamed back and the client asks for more when half of its window is free.
+// The policy then only decides when to retry connecting, the window limits the jobs waiting in the client's pool.
+// With version 1, the client asks for one job at a time and its policy decides when to ask again.
+template <class CheckPolicy, class SerializableType = boost::asynchronous::any_serializable,
+          class WireProtocol = boost::asynchronous::tcp::detail::client_wire_protocol,
+          class Transport = boost::asynchronous::tcp::tcp_transport>
 struct simple_tcp_client : boost::asynchronous::trackable_servant<boost::asynchronous::any_callable,SerializableType>
 {
     template <typename... Args>
@@ -130,13 +211,15 @@ struct simple_tcp_client : boost::asynchronous::trackable_servant<boost::asynchr
         , m_server(server)
         , m_path(path)
         , m_resolver(*boost::asynchronous::get_io_service<>())
-        , m_socket(std::make_shared<boost::asio::ip::tcp::socket>(*boost::asynchronous::get_io_service<>()))
+        , m_socket(std::make_shared<typename Transport::stream_type>(*boost::asynchronous::get_io_service<>()))
         , m_executor(executor)
+        , m_in_flight_window(boost::asynchronous::tcp::detail::in_flight_window(m_check_policy,0))
     {
-        // no delay
-        boost::asio::ip::tcp::no_delay option(true);
-        boost::system::error_code ec;
-        m_socket->set_option(option,ec);
+        Transport::prepare(*m_socket);
+    }
+    ~simple_tcp_client()
+    {
+        Transport::close(*m_socket);
     }
     std::future<void> run()
     {
@@ -149,8 +232,15 @@ private:
     // called in case of an error
     void stop()
     {
-         m_socket->close();
+         Transport::close(*m_socket);
          m_connection_state = connection_state::none;
+         // the server forgets what we asked for with this connection
+         m_requested_jobs = 0;
+    }
+    // protocol version 2: jobs are requested in advance and results streamed back
+    static constexpr bool pipelined()
+    {
+        return WireProtocol::version >= 2;
     }
 
     struct stealable_job
@@ -181,7 +271,8 @@ private:
 
             while(cpt_stolen > 0)
             {
-                std::istringstream task_stream(m_response.m_task);
+                boost::asynchronous::tcp::detail::input_buffer_view task_buffer(m_response.m_task.data(),m_response.m_task.size());
+                std::istream task_stream(&task_buffer);
                 typename SerializableType::iarchive task_archive(task_stream);
                 std::string as_string;
                 task_archive >> as_string;
@@ -238,63 +329,87 @@ private:
 
     void check_for_work()
     {
-        //TODO string&
-        std::function<void(std::string)> cb =
-        [this](std::string archive_data)
+        std::function<void(boost::asynchronous::tcp::server_reponse)> cb =
+        [this](boost::asynchronous::tcp::server_reponse resp)
         {
-            // if no data, give up
-            if (!archive_data.empty())
+            // if no task, give up
+            if (!resp.m_task.empty())
             {
-                // got work, deserialize message
-                std::istringstream archive_stream(archive_data);
-                typename SerializableType::iarchive archive(archive_stream);
-                boost::asynchronous::tcp::server_reponse resp(0,"","");
-                archive >> resp;
-                // if no task, give up
-                if (!resp.m_task.empty())
-                {
-                    std::function<void(std::shared_ptr<boost::asynchronous::tcp::client_request>)> sending_fct =
-                            this->make_safe_callback(std::function<void(std::shared_ptr<boost::asynchronous::tcp::client_request>)>(
-                                                         [this](std::shared_ptr<boost::asynchronous::tcp::client_request> req)
-                                                         {this->send_task_result(req);}),"",0);
-                    this->get_worker().post(
-                                stealable_job(std::move(resp),m_executor,this->get_scheduler(),sending_fct)
-                    );
-                }
+                this->post_task(std::move(resp));
+            }
+            // delegate next work checking to policy. When pipelined, only needed if we could not connect
+            if (!pipelined() || m_connection_state == connection_state::none)
+            {
+                this->retry_later();
             }
-            // delegate next work checking to policy
-            m_check_policy.template prepare_check_for_work([this](){this->check_for_work();},this->get_worker().get_weak_scheduler());
         };
         request_content(cb);
     }
-    void request_content(std::function<void(std::string)> cb)
+    void retry_later()
+    {
+        m_check_policy.template prepare_check_for_work([this](){this->check_for_work();},this->get_worker().get_weak_scheduler());
+    }
+    void post_task(boost::asynchronous::tcp::server_reponse resp)
+    {
+        std::function<void(std::shared_ptr<boost::asynchronous::tcp::client_request>)> sending_fct =
+                this->make_safe_callback(std::function<void(std::shared_ptr<boost::asynchronous::tcp::client_request>)>(
+                                             [this](std::shared_ptr<boost::asynchronous::tcp::client_request> req)
+                                             {this->send_task_result(req);}),"",0);
+        this->get_worker().post(
+                    stealable_job(std::move(resp),m_executor,this->get_scheduler(),sending_fct)
+        );
+    }
+    void request_content(std::function<void(boost::asynchronous::tcp::server_reponse)> cb)
     {
         if ((m_connection_state == connection_state::connecting)||(m_connection_state == connection_state::getting_work))
         {
             // we will have to wait
-            cb(std::string(""));
+            cb(boost::asynchronous::tcp::server_reponse(0,"",""));
             return;
         }
         else if (m_connection_state == connection_state::connected)
         {
             // we are connected and request data
-            get_task(cb);
+            if (pipelined())
+            {
+                request_tasks();
+                cb(boost::asynchronous::tcp::server_reponse(0,"",""));
+            }
+            else
+            {
+                get_task(cb);
+            }
         }
         else
         {
-            // resolve and connect
-            boost::asio::ip::tcp::resolver::query query(m_server, m_path);
-            m_resolver.async_resolve(
-                      query,
-                      this->make_safe_callback(std::function<void(const boost::system::error_code&,boost::asio::ip::tcp::tcp::resolver::iterator)>(
-                                             [cb,this](const boost::system::error_code& err,boost::asio::ip::tcp::tcp::resolver::iterator endpoint_iterator)mutable
-                                             {this->handle_resolve(err,endpoint_iterator,std::move(cb)); }),"",0));
+            m_connection_state = connection_state::connecting;
+            connect(std::move(cb),Transport());
         }
 
     }
+    void connect(std::function<void(boost::asynchronous::tcp::server_reponse)> cb, boost::asynchronous::tcp::tcp_transport)
+    {
+        // resolve and connect
+        boost::asio::ip::tcp::resolver::query query(m_server, m_path);
+        m_resolver.async_resolve(
+                  query,
+                  this->make_safe_callback(std::function<void(const boost::system::error_code&,boost::asio::ip::tcp::tcp::resolver::iterator)>(
+                                         [cb,this](const boost::system::error_code& err,boost::asio::ip::tcp::tcp::resolver::iterator endpoint_iterator)mutable
+                                         {this->handle_resolve(err,endpoint_iterator,std::move(cb)); }),"",0));
+    }
+#ifdef BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+    void connect(std::function<void(boost::asynchronous::tcp::server_reponse)> cb, boost::asynchronous::tcp::shm_transport)
+    {
+        // a closed stream cannot be reopened, and there is nothing to resolve: the server's address and port give the local name
+        m_socket = std::make_shared<typename Transport::stream_type>(*boost::asynchronous::get_io_service<>());
+        m_socket->async_connect(boost::asynchronous::tcp::detail::shm_endpoint_name(m_server,m_path),
+                                this->make_safe_callback(std::function<void(const boost::system::error_code&)>(
+                                                       [this,cb](const boost::system::error_code& err){this->handle_connect(err,std::move(cb));}),"",0));
+    }
+#endif
     void handle_resolve(const boost::system::error_code& err,
                         boost::asio::ip::tcp::tcp::resolver::iterator endpoint_iterator,
-                        std::function<void(std::string)> cb)
+                        std::function<void(boost::asynchronous::tcp::server_reponse)> cb)
     {
         if (!err)
         {
@@ -310,154 +425,201 @@ private:
         {
             //ignore
             m_connection_state = connection_state::none;
-            cb(std::string(""));
+            cb(boost::asynchronous::tcp::server_reponse(0,"",""));
         }
     }
-    void handle_connect(const boost::system::error_code& err,std::function<void(std::string)> cb)
+    void handle_connect(const boost::system::error_code& err,std::function<void(boost::asynchronous::tcp::server_reponse)> cb)
     {
         if (!err)
         {
             m_connection_state = connection_state::connected;
             // The connection was successful. Send the request for job.
-            get_task(cb);
+            if (pipelined())
+            {
+                read_tasks();
+                request_tasks();
+                cb(boost::asynchronous::tcp::server_reponse(0,"",""));
+            }
+            else
+            {
+                get_task(cb);
+            }
         }
         // else bad luck, will try later
         else
         {
             //ignore
             m_connection_state = connection_state::none;
-            cb(std::string(""));
+            cb(boost::asynchronous::tcp::server_reponse(0,"",""));
         }
     }
-    void get_task(std::function<void(std::string)> cb)
+    void get_task(std::function<void(boost::asynchronous::tcp::server_reponse)> cb)
     {
         if (m_is_writing)
         {
             // already writing give up
-            cb(std::string(""));
+            cb(boost::asynchronous::tcp::server_reponse(0,"",""));
             return;
         }
         m_connection_state = connection_state::getting_work;
-        m_is_writing = true;
-        std::ostringstream archive_stream;
-        typename SerializableType::oarchive archive(archive_stream);
         boost::asynchronous::tcp::client_request request (BOOST_ASYNCHRONOUS_TCP_CLIENT_GET_JOB);
-        archive << request;
-        // shared to keep it alive until end of sending
-        std::shared_ptr<std::string> outbound_buffer = std::make_shared<std::string>(archive_stream.str());
-        // Format the header.
-        std::ostringstream header_stream;
-        header_stream << std::setw(m_header_length)<< std::hex << outbound_buffer->size();
-        if (!header_stream || header_stream.str().size() != m_header_length)
+        m_outbound_buffer->clear();
+        if (!WireProtocol::template encode_request<SerializableType>(*m_outbound_buffer,request))
         {
-          // Something went wrong
-          stop();
-          cb(std::string(""));
+            // Something went wrong
+            stop();
+            cb(boost::asynchronous::tcp::server_reponse(0,"",""));
+            return;
         }
-        std::shared_ptr<std::string> outbound_header = std::make_shared<std::string>(header_stream.str());
-        // Write the serialized data to the socket. We use "gather-write" to send
-        // both the header and the data in a single write operation.
-        std::vector<boost::asio::const_buffer> buffers;
-        buffers.push_back(boost::asio::buffer(*outbound_header));
-        buffers.push_back(boost::asio::buffer(*outbound_buffer));
-        boost::asio::async_write(*m_socket, buffers,
+        m_is_writing = true;
+        boost::asio::async_write(*m_socket, boost::asio::buffer(*m_outbound_buffer),
                                  this->make_safe_callback(std::function<void(const boost::system::error_code&,std::size_t)>(
-                                                        [this,cb,outbound_buffer,outbound_header](const boost::system::error_code& err,std::size_t)mutable
-                                                        {this->m_is_writing = false;this->handle_write_request(err,cb);}),"",0));
+                                                        [this,cb](const boost::system::error_code& err,std::size_t)mutable
+                                                        {this->m_is_writing = false;this->write_pending();this->handle_write_request(err,cb);}),"",0));
     }
-    void handle_write_request(const boost::system::error_code& err,std::function<void(std::string)> callback)
+    void handle_write_request(const boost::system::error_code& err,std::function<void(boost::asynchronous::tcp::server_reponse)> callback)
     {
         if (err)
         {
             // ok, we'll try again later
             stop();
-            callback(std::string(""));
+            callback(boost::asynchronous::tcp::server_reponse(0,"",""));
             return;
         }
-        std::shared_ptr<std::vector<char> > inbound_header = std::make_shared<std::vector<char> >();
-        inbound_header->resize(m_header_length);
-        boost::asio::async_read(*m_socket,boost::asio::buffer(*inbound_header),
+        boost::asio::async_read(*m_socket,boost::asio::buffer(m_inbound_header),
             this->make_safe_callback(std::function<void(const boost::system::error_code&,size_t)>(
-            [this, callback,inbound_header](boost::system::error_code ec, size_t /*bytes_transferred*/)mutable
+            [this, callback](boost::system::error_code ec, size_t /*bytes_transferred*/)mutable
             {
-                if (!ec)
+                std::size_t inbound_data_size = 0;
+                if (ec || !WireProtocol::body_size(this->m_inbound_header.data(),inbound_data_size))
                 {
-                    std::istringstream is(std::string(&(*inbound_header)[0], this->m_header_length));
-                    std::size_t inbound_data_size = 0;
-                    if (!(is >> std::hex >> inbound_data_size))
-                    {
-                        // Header doesn't seem to be valid. Inform the caller.
-                        // ok, we'll try again later
-                        this->stop();
-                        callback(std::string(""));
-                        return;
-                    }
-                    // read message
-                    std::shared_ptr<std::vector<char> > inbound_buffer = std::make_shared<std::vector<char> >();
-                    inbound_buffer->resize(inbound_data_size);
-                    boost::asio::async_read(*(this->m_socket),boost::asio::buffer(*inbound_buffer),
-                                            this->make_safe_callback(std::function<void(const boost::system::error_code&,size_t)>(
-                                            [this, callback,inbound_buffer](boost::system::error_code ec, size_t /*bytes_transferred*/) mutable
-                                            {
-                                                if (ec)
-                                                {
-                                                    // ok, we'll try again later
-                                                    this->stop();
-                                                    callback(std::string(""));
-                                                }
-                                                else
-                                                {
-                                                    m_connection_state = connection_state::connected;
-                                                    std::string archive_data(&(*inbound_buffer)[0], inbound_buffer->size());
-                                                    callback(archive_data);
-                                                }
-                                            }),"",0));
+                    // Header doesn't seem to be valid.
+                    // ok, we'll try again later
+                    this->stop();
+                    callback(boost::asynchronous::tcp::server_reponse(0,"",""));
+                    return;
                 }
-                else
+                // read message into our buffer, which keeps its capacity from message to message
+                this->m_inbound_buffer.resize(inbound_data_size);
+                boost::asio::async_read(*(this->m_socket),boost::asio::buffer(this->m_inbound_buffer),
+                                        this->make_safe_callback(std::function<void(const boost::system::error_code&,size_t)>(
+                                        [this, callback](boost::system::error_code ec, size_t /*bytes_transferred*/) mutable
+                                        {
+                                            if (ec)
+                                            {
+                                                // ok, we'll try again later
+                                                this->stop();
+                                                callback(boost::asynchronous::tcp::server_reponse(0,"",""));
+                                                return;
+                                            }
+                                            m_connection_state = connection_state::connected;
+                                            boost::asynchronous::tcp::server_reponse resp(0,"","");
+                                            try
+                                            {
+                                                resp = WireProtocol::template decode_response<SerializableType>(
+                                                            this->m_inbound_header.data(),this->m_inbound_buffer.data(),this->m_inbound_buffer.size());
+                                            }
+                                            catch (std::exception&)
+                                            {
+                                                // Unable to decode data, ignore
+                                            }
+                                            callback(std::move(resp));
+                                        }),"",0));
+            }),"",0));
+    }
+    // protocol version 2: read jobs as they come
+    void read_tasks()
+    {
+        boost::asio::async_read(*m_socket,boost::asio::buffer(m_inbound_header),
+            this->make_safe_callback(std::function<void(const boost::system::error_code&,size_t)>(
+            [this](boost::system::error_code ec, size_t /*bytes_transferred*/)
+            {
+                std::size_t inbound_data_size = 0;
+                if (ec || !WireProtocol::body_size(this->m_inbound_header.data(),inbound_data_size))
                 {
+                    // ok, we'll try again later
                     this->stop();
-                    callback(std::string(""));
+                    this->retry_later();
+                    return;
                 }
+                this->m_inbound_buffer.resize(inbound_data_size);
+                boost::asio::async_read(*(this->m_socket),boost::asio::buffer(this->m_inbound_buffer),
+                                        this->make_safe_callback(std::function<void(const boost::system::error_code&,size_t)>(
+                                        [this](boost::system::error_code ec, size_t /*bytes_transferred*/)
+                                        {
+                                            if (ec)
+                                            {
+                                                this->stop();
+                                                this->retry_later();
+                                                return;
+                                            }
+                                            boost::asynchronous::tcp::server_reponse resp(0,"","");
+                                            try
+                                            {
+                                                resp = WireProtocol::template decode_response<SerializableType>(
+                                                            this->m_inbound_header.data(),this->m_inbound_buffer.data(),this->m_inbound_buffer.size());
+                                            }
+                                            catch (std::exception&)
+                                            {
+                                                // Unable to decode data, ignore
+                                            }
+                                            if (this->m_requested_jobs > 0)
+                                            {
+                                                --this->m_requested_jobs;
+                                            }
+                                            if (!resp.m_task.empty())
+                                            {
+                                                ++this->m_in_flight;
+                                                this->post_task(std::move(resp));
+                                            }
+                                            this->read_tasks();
+                                        }),"",0));
             }),"",0));
     }
-    void send_task_result(std::shared_ptr<boost::asynchronous::tcp::client_request> request)
+    // protocol version 2: ask for jobs to fill our window. Not after every job, when half of it is free
+    void request_tasks()
     {
-        // if writing, we will have to wait...
-        if (m_is_writing)
-        {
-            m_waiting_requests.push_back(request);
+        if (m_connection_state != connection_state::connected || m_in_flight + m_requested_jobs >= m_in_flight_window)
             return;
-        }
-        m_is_writing = true;
-        std::ostringstream archive_stream;
-        typename SerializableType::oarchive archive(archive_stream);
-        archive << *request;
-        std::shared_ptr<std::string> outbound_buffer = std::make_shared<std::string>(archive_stream.str());
-        // Format the header.
-        std::ostringstream header_stream;
-        header_stream << std::setw(m_header_length)<< std::hex << outbound_buffer->size();
-        if (!header_stream || header_stream.str().size() != m_header_length)
+        unsigned int free_slots = m_in_flight_window - m_in_flight - m_requested_jobs;
+        if (m_requested_jobs > 0 && 2 * free_slots < m_in_flight_window)
+            return;
+        std::shared_ptr<boost::asynchronous::tcp::client_request> request =
+                std::make_shared<boost::asynchronous::tcp::client_request>(BOOST_ASYNCHRONOUS_TCP_CLIENT_GET_JOB);
+        request->m_credits = free_slots;
+        m_requested_jobs += free_slots;
+        m_waiting_requests.push_back(request);
+        write_pending();
+    }
+    void send_task_result(std::shared_ptr<boost::asynchronous::tcp::client_request> request)
+    {
+        m_waiting_requests.push_back(request);
+        if (pipelined() && m_in_flight > 0)
         {
-          // Something went wrong, ignore
+            // a job less in flight, maybe ask for more together with this result
+            --m_in_flight;
+            request_tasks();
         }
-        std::shared_ptr<std::string> outbound_header = std::make_shared<std::string>(header_stream.str());
-        // Write the serialized data to the socket. We use "gather-write" to send
-        // both the header and the data in a single write operation.
-        std::vector<boost::asio::const_buffer> buffers;
-        buffers.push_back(boost::asio::buffer(*outbound_header));
-        buffers.push_back(boost::asio::buffer(*outbound_buffer));
-        boost::asio::async_write(*m_socket, buffers,
-                                 this->make_safe_callback(std::function<void(const boost::system::error_code&,std::size_t)>(
-                                 [this,outbound_buffer,outbound_header](const boost::system::error_code&,std::size_t )
-                                 {this->m_is_writing=false; this->try_send_one_waiting_request();}),"",0));
+        write_pending();
     }
-    void try_send_one_waiting_request()
+    // send all waiting requests in a single write. If writing or not connected, we will have to wait...
+    void write_pending()
     {
-        if (!m_is_writing && !m_waiting_requests.empty())
+        if (m_is_writing || m_waiting_requests.empty() ||
+            m_connection_state == connection_state::none || m_connection_state == connection_state::connecting)
+            return;
+        m_outbound_buffer->clear();
+        for (auto const& request : m_waiting_requests)
         {
-            send_task_result(m_waiting_requests.front());
-            m_waiting_requests.pop_front();
+            // if something went wrong, ignore
+            WireProtocol::template encode_request<SerializableType>(*m_outbound_buffer,*request);
         }
+        m_waiting_requests.clear();
+        m_is_writing = true;
+        boost::asio::async_write(*m_socket, boost::asio::buffer(*m_outbound_buffer),
+                                 this->make_safe_callback(std::function<void(const boost::system::error_code&,std::size_t)>(
+                                 [this](const boost::system::error_code&,std::size_t )
+                                 {this->m_is_writing=false; this->write_pending();}),"",0));
     }
 
     // TODO state machine...
@@ -476,13 +638,18 @@ private:
     std::string m_server;
     std::string m_path;
     boost::asio::ip::tcp::resolver m_resolver;
-    std::shared_ptr<boost::asio::ip::tcp::socket> m_socket;
+    std::shared_ptr<typename Transport::stream_type> m_socket;
     std::function<void(std::string const&,boost::asynchronous::tcp::server_reponse,
                        std::function<void(boost::asynchronous::tcp::client_request const&)>)> m_executor;
     std::promise<void> m_done;
-    // The size of a fixed length header.
-    // TODO not fixed
-    enum { m_header_length = 10 };
+    // receive and send buffers, reused for every message. We write once at a time
+    std::array<char,WireProtocol::header_length> m_inbound_header;
+    std::vector<char> m_inbound_buffer;
+    std::shared_ptr<std::vector<char>> m_outbound_buffer = std::make_shared<std::vector<char>>();
+    // protocol version 2: jobs we may have at once, jobs received and not done yet, jobs asked for and not received yet
+    unsigned int m_in_flight_window;
+    unsigned int m_in_flight = 0;
+    unsigned int m_requested_jobs = 0;
 };
 
 // the proxy of AsioCommunicationServant for use in an external thread
@@ -540,9 +707,11 @@ struct get_correct_simple_tcp_client_proxy<boost::asynchronous::tcp::queue_size_
 
 // the proxy of AsioCommunicationServant for use in an external thread
 template <class T = boost::asynchronous::tcp::client_time_check_policy<boost::asynchronous::any_serializable> ,
-          class SerializableType = boost::asynchronous::any_serializable>
-class simple_tcp_client_proxy_ext: public boost::asynchronous::servant_proxy<simple_tcp_client_proxy_ext<T,SerializableType>,
-                                                                         boost::asynchronous::tcp::simple_tcp_client<T> >
+          class SerializableType = boost::asynchronous::any_serializable,
+          class WireProtocol = boost::asynchronous::tcp::detail::client_wire_protocol,
+          class Transport = boost::asynchronous::tcp::tcp_transport>
+class simple_tcp_client_proxy_ext: public boost::asynchronous::servant_proxy<simple_tcp_client_proxy_ext<T,SerializableType,WireProtocol,Transport>,
+                                                                         boost::asynchronous::tcp::simple_tcp_client<T,SerializableType,WireProtocol,Transport> >
 {
 public:
     // ctor arguments are forwarded to AsioCommunicationServant
@@ -553,15 +722,16 @@ public:
                             std::function<void(std::string const&,boost::asynchronous::tcp::server_reponse,
                                                std::function<void(boost::asynchronous::tcp::client_request const&)>)> const& executor,
                             Args... args):
-        boost::asynchronous::servant_proxy<simple_tcp_client_proxy_ext<T,SerializableType>,boost::asynchronous::tcp::simple_tcp_client<T> >
+        boost::asynchronous::servant_proxy<simple_tcp_client_proxy_ext<T,SerializableType,WireProtocol,Transport>,
+                                           boost::asynchronous::tcp::simple_tcp_client<T,SerializableType,WireProtocol,Transport> >
             (s,pool,server,path,executor,args...)
     {}
     typedef typename boost::asynchronous::servant_proxy<
-                            simple_tcp_client_proxy_ext<T,SerializableType>,
-                            boost::asynchronous::tcp::simple_tcp_client<T> >::servant_type servant_type;
+                            simple_tcp_client_proxy_ext<T,SerializableType,WireProtocol,Transport>,
+                            boost::asynchronous::tcp::simple_tcp_client<T,SerializableType,WireProtocol,Transport> >::servant_type servant_type;
     typedef typename boost::asynchronous::servant_proxy<
-                            simple_tcp_client_proxy_ext<T,SerializableType>,
-                            boost::asynchronous::tcp::simple_tcp_client<T> >::callable_type callable_type;
+                            simple_tcp_client_proxy_ext<T,SerializableType,WireProtocol,Transport>,
+                            boost::asynchronous::tcp::simple_tcp_client<T,SerializableType,WireProtocol,Transport> >::callable_type callable_type;
 
     // we offer a single member for posting
     BOOST_ASYNC_FUTURE_MEMBER(run)
@@ -572,7 +742,8 @@ template <class Task, class SerializableType = boost::asynchronous::any_serializ
 void deserialize_and_call_task(Task& t,boost::asynchronous::tcp::server_reponse const& resp,
                                std::function<void(boost::asynchronous::tcp::client_request const&)>const& when_done)
 {
-    std::istringstream task_stream(resp.m_task);
+    boost::asynchronous::tcp::detail::input_buffer_view task_buffer(resp.m_task.data(),resp.m_task.size());
+    std::istream task_stream(&task_buffer);
     typename SerializableType::iarchive task_archive(task_stream);
     std::ostringstream res_archive_stream;
     typename SerializableType::oarchive res_archive(res_archive_stream);
@@ -605,7 +776,8 @@ void deserialize_and_call_top_level_continuation_task(
         std::function<void(boost::asynchronous::tcp::client_request const&)>const& when_done)
 {
     // deserialize job, execute code, serialize result
-    std::istringstream task_stream(resp.m_task);
+    boost::asynchronous::tcp::detail::input_buffer_view task_buffer(resp.m_task.data(),resp.m_task.size());
+    std::istream task_stream(&task_buffer);
     typename SerializableType::iarchive task_archive(task_stream);
     boost::asynchronous::tcp::client_request request (BOOST_ASYNCHRONOUS_TCP_CLIENT_JOB_RESULT);
     request.m_task_id = resp.m_task_id;
@@ -646,7 +818,8 @@ void deserialize_and_call_continuation_task(
         std::function<void(boost::asynchronous::tcp::client_request const&)>const& when_done)
 {
     // deserialize job, execute code, serialize result
-    std::istringstream task_stream(resp.m_task);
+    boost::asynchronous::tcp::detail::input_buffer_view task_buffer(resp.m_task.data(),resp.m_task.size());
+    std::istream task_stream(&task_buffer);
     typename SerializableType::iarchive task_archive(task_stream);
     boost::asynchronous::tcp::client_request request (BOOST_ASYNCHRONOUS_TCP_CLIENT_JOB_RESULT);
     request.m_task_id = resp.m_task_id;
@@ -689,7 +862,8 @@ void deserialize_and_call_callback_continuation_task(
         std::function<void(boost::asynchronous::tcp::client_request const&)>const& when_done)
 {
     // deserialize job, execute code, serialize result
-    std::istringstream task_stream(resp.m_task);
+    boost::asynchronous::tcp::detail::input_buffer_view task_buffer(resp.m_task.data(),resp.m_task.size());
+    std::istream task_stream(&task_buffer);
     typename SerializableType::iarchive task_archive(task_stream);
     boost::asynchronous::tcp::client_request request (BOOST_ASYNCHRONOUS_TCP_CLIENT_JOB_RESULT);
     request.m_task_id = resp.m_task_id;
@@ -729,7 +903,8 @@ void deserialize_and_call_top_level_callback_continuation_task(
         std::function<void(boost::asynchronous::tcp::client_request const&)>const& when_done)
 {
     // deserialize job, execute code, serialize result
-    std::istringstream task_stream(resp.m_task);
+    boost::asynchronous::tcp::detail::input_buffer_view task_buffer(resp.m_task.data(),resp.m_task.size());
+    std::istream task_stream(&task_buffer);
     typename SerializableType::iarchive task_archive(task_stream);
     boost::asynchronous::tcp::client_request request (BOOST_ASYNCHRONOUS_TCP_CLIENT_JOB_RESULT);
     request.m_task_id = resp.m_task_id;
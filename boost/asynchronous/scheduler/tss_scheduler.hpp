@@ -88,6 +88,20 @@ template <class dummy = void >
     return *s_index.get();
 }
 
+// the queue a worker thread pops from, to tell whether get_own_queue_index refers to a given pool
+template <class dummy = void >
+void const* get_own_queue(void const* q=nullptr,bool reset=false)
+{
+    static boost::thread_specific_ptr< void const* > s_queue;
+    if (reset)
+    {
+        s_queue.reset(new void const*(q));
+    }
+    if (s_queue.get() == 0)
+        return nullptr;
+    return *s_queue.get();
+}
+
  template <class Job = BOOST_ASYNCHRONOUS_DEFAULT_JOB >
  struct tss_weak_diagnostics_wrapper
  {
@@ -13,6 +13,7 @@
 #include <map>
 #include <list>
 #include <boost/asynchronous/diagnostics/diagnostic_item.hpp>
+#include <boost/asynchronous/diagnostics/latency_histogram.hpp>
 #include <boost/asynchronous/job_traits.hpp>
 
 namespace boost { namespace asynchronous
@@ -21,9 +22,10 @@ struct scheduler_diagnostics
 {
     typedef std::map<std::string,std::list<boost::asynchronous::diagnostic_item>> total_type;
     typedef std::vector<std::pair<std::string, boost::asynchronous::diagnostic_item>> current_type;
+    typedef std::map<std::string,boost::asynchronous::job_latency> latency_type;
 
-    scheduler_diagnostics(total_type const& t, current_type const& c)
-        : m_totals(t), m_current(c)
+    scheduler_diagnostics(total_type const& t, current_type const& c, std::size_t dropped=0, latency_type l=latency_type())
+        : m_totals(t), m_current(c), m_dropped(dropped), m_latencies(std::move(l))
     {}
     scheduler_diagnostics() = default;
     scheduler_diagnostics (scheduler_diagnostics&&)=default;
@@ -39,6 +41,16 @@ struct scheduler_diagnostics
     {
         return m_current;
     }
+    // finished jobs which are not in totals() because the diagnostics table had to overwrite them
+    std::size_t dropped() const
+    {
+        return m_dropped;
+    }
+    // wait and run time histograms per job name, of all jobs since the last clear, dropped ones included
+    latency_type const& latencies() const
+    {
+        return m_latencies;
+    }
     void merge(scheduler_diagnostics other)
     {
         for (auto const& diag : other.m_totals)
@@ -56,11 +68,18 @@ struct scheduler_diagnostics
             }
         }
         m_current.insert(m_current.end(),other.m_current.begin(),other.m_current.end());
+        m_dropped += other.m_dropped;
+        for (auto const& latency : other.m_latencies)
+        {
+            m_latencies[latency.first].merge(latency.second);
+        }
     }
 
 private:
     total_type m_totals;
     current_type m_current;
+    std::size_t m_dropped = 0;
+    latency_type m_latencies;
 };
 
 struct register_diagnostics_type
@@ -196,6 +215,8 @@ struct summary_diagnostics
     bool has_interrupts = false;
 
     std::map<std::string, summary_diagnostic_item> items;
+    // latency histograms per job name, merged from scheduler_diagnostics::latencies()
+    scheduler_diagnostics::latency_type latencies;
 
     summary_diagnostics() = default;
     summary_diagnostics(summary_diagnostics &&) = default;
@@ -216,6 +237,12 @@ struct summary_diagnostics
     // Merge scheduler_diagnostics into this summary
     void merge(scheduler_diagnostics diagnostics, std::map<std::string, std::vector<simple_diagnostic_item>> & simple_items)
     {
+        for (auto const& latency : diagnostics.latencies())
+        {
+            // Unnamed jobs cannot be logged
+            if (!latency.first.empty()) latencies[latency.first].merge(latency.second);
+        }
+
         // Only use the diagnostics' totals.
         for (auto it = diagnostics.totals().begin(); it != diagnostics.totals().end(); ++it)
         {
@@ -542,6 +542,242 @@ make_shared_scheduler_proxy(Args && ... args)
 #endif
 }
 
+/*!
+ * \class shared_scheduler_proxy
+ * A proxy to a scheduler keeping the concrete scheduler type S (and with it the queue type).
+ * Shares ownership of the scheduler like any_shared_scheduler_proxy but posting does not go through
+ * type erasure or a virtual call and can be inlined, which matters when posting many small jobs.
+ * It converts to any_shared_scheduler_proxy when type erasure is needed, both then share the same scheduler.
+ * Created with make_typed_shared_scheduler_proxy<S>(scheduler constructor arguments).
+ */
+template<class S>
+class shared_scheduler_proxy
+{
+public:
+    typedef S scheduler_type;
+    typedef shared_scheduler_proxy<S> this_type;
+    typedef typename S::job_type job_type;
+
+    /*!
+     * \brief default constructor, creates an invalid proxy
+     */
+    shared_scheduler_proxy() noexcept : m_impl(), m_scheduler(nullptr){}
+
+    /*!
+     * \brief returns whether the scheduler proxy is a proxy to a valid scheduler
+     * \return bool
+     */
+    bool is_valid() const
+    {
+        return !!m_impl;
+    }
+
+    /*!
+     * \brief posts a job into the scheduler queue. The call is resolved statically.
+     * \param job passed by value
+     */
+    void post(job_type job) const
+    {
+        BOOST_ASSERT_MSG(m_scheduler,"shared_scheduler_proxy::post has empty scheduler");
+        m_scheduler->scheduler_type::post(std::move(job),0);
+    }
+
+    /*!
+     * \brief posts a job into the scheduler queue with the given priority. The call is resolved statically.
+     * \param job passed by value
+     * \param priority. Depending on the scheduler, it can be queue or sub-pool. 0 means dont'care
+     */
+    void post(job_type job,std::size_t priority) const
+    {
+        BOOST_ASSERT_MSG(m_scheduler,"shared_scheduler_proxy::post has empty scheduler");
+        m_scheduler->scheduler_type::post(std::move(job),priority);
+    }
+
+    /*!
+     * \brief posts an interruptible job into the scheduler queue
+     * \param job passed by value
+     * \param priority. Depending on the scheduler, it can be queue or sub-pool. 0 means dont'care
+     * \return any_interruptible. Can be used to interrupt the job
+     */
+    boost::asynchronous::any_interruptible interruptible_post(job_type job,std::size_t priority=0) const
+    {
+        BOOST_ASSERT_MSG(m_scheduler,"shared_scheduler_proxy::interruptible_post has empty scheduler");
+        return m_scheduler->scheduler_type::interruptible_post(std::move(job),priority);
+    }
+
+    /*!
+     * \brief returns the number of waiting jobs in every queue
+     * \return a std::vector containing the queue sizes
+     */
+    std::vector<std::size_t> get_queue_size() const
+    {
+        return m_scheduler->scheduler_type::get_queue_size();
+    }
+
+    /*!
+     * \brief returns the max number of waiting jobs in every queue
+     * \return a std::vector containing the max queue sizes
+     */
+    std::vector<std::size_t> get_max_queue_size() const
+    {
+        return m_scheduler->scheduler_type::get_max_queue_size();
+    }
+
+    /*!
+     * \brief reset the max queue sizes
+     */
+    void reset_max_queue_size()
+    {
+        m_scheduler->reset_max_queue_size();
+    }
+
+    /*!
+     * \brief returns the ids of the threads run by this scheduler
+     * \return std::vector of thread ids
+     */
+    std::vector<boost::thread::id> thread_ids()const
+    {
+        return m_scheduler->thread_ids();
+    }
+
+    /*!
+     * \brief returns the diagnostics for this scheduler
+     * \return a scheduler_diagnostics containing totals or current diagnostics
+     */
+    boost::asynchronous::scheduler_diagnostics
+    get_diagnostics(std::size_t pos=0)const
+    {
+        return m_scheduler->get_diagnostics(pos);
+    }
+
+    /*!
+     * \brief reset the diagnostics
+     */
+    void clear_diagnostics()
+    {
+        m_scheduler->clear_diagnostics();
+    }
+
+    /*!
+     * \brief returns a weak scheduler. A weak scheduler is to a shared scheduler what weak_ptr is to a shared_ptr
+     * \return any_weak_scheduler
+     */
+    boost::asynchronous::any_weak_scheduler<job_type> get_weak_scheduler() const
+    {
+        return m_impl->get_weak_scheduler();
+    }
+
+    /*!
+     * \brief returns a reduced scheduler interface for internal needs
+     */
+    boost::asynchronous::internal_scheduler_aspect<job_type> get_internal_scheduler_aspect()
+    {
+        return m_impl->get_internal_scheduler_aspect();
+    }
+
+    /*!
+     * \brief sets a name to this scheduler. On posix, this will set the name with prctl for every thread of this scheduler
+     * \param name as string
+     */
+    void set_name(std::string const& name)
+    {
+        m_scheduler->set_name(name);
+    }
+
+    /*!
+     * \brief returns the name of this scheduler
+     * \return name as string
+     */
+    std::string get_name()const
+    {
+        return m_scheduler->get_name();
+    }
+
+    /*!
+     * \brief binds threads of this scheduler to processors
+     * \param p (first thread, processor id) pairs
+     */
+    void processor_bind(std::vector<std::tuple<unsigned int,unsigned int>> p)
+    {
+        m_scheduler->processor_bind(std::move(p));
+    }
+
+    /*!
+     * \brief Executes callable (no logging) in each thread of a scheduler.
+     * \param c callable object
+     * \return futures indicating when tasks have been executed
+     */
+    std::vector<std::future<void>> execute_in_all_threads(boost::asynchronous::any_callable c)
+    {
+        return m_scheduler->execute_in_all_threads(std::move(c));
+    }
+
+    /*!
+     * \brief releases this proxy. The last proxy to a scheduler stops it and blocks until its threads are joined.
+     */
+    void reset()
+    {
+        m_scheduler = nullptr;
+        m_impl.reset();
+    }
+
+    /*!
+     * \brief converts to a type-erased proxy sharing the same scheduler
+     * \return any_shared_scheduler_proxy<job_type>
+     */
+    operator boost::asynchronous::any_shared_scheduler_proxy<job_type>() const
+    {
+        if (!m_impl)
+        {
+            return boost::asynchronous::any_shared_scheduler_proxy<job_type>();
+        }
+#ifndef BOOST_ASYNCHRONOUS_USE_TYPE_ERASURE
+        return boost::asynchronous::any_shared_scheduler_proxy<job_type>(
+                    std::static_pointer_cast<boost::asynchronous::any_shared_scheduler_proxy_concept<job_type>>(m_impl));
+#else
+        boost::asynchronous::any_shared_scheduler_proxy_ptr<job_type> ptr (m_impl);
+        return boost::asynchronous::any_shared_scheduler_proxy<job_type>(ptr);
+#endif
+    }
+
+private:
+    explicit shared_scheduler_proxy(std::shared_ptr<scheduler_type>&& scheduler)
+        : m_impl(std::make_shared<boost::asynchronous::detail::scheduler_shared_proxy_impl<S> >(std::move(scheduler)))
+        , m_scheduler(m_impl->m_scheduler.get())
+    {
+    }
+
+    template< class Sched, class... Args >
+    friend
+    typename std::enable_if<!boost::asynchronous::has_self_proxy_creation<Sched>::value,
+                            boost::asynchronous::shared_scheduler_proxy<Sched> >::type
+    make_typed_shared_scheduler_proxy(Args && ... args);
+
+    // attributes
+    std::shared_ptr<boost::asynchronous::detail::scheduler_shared_proxy_impl<S> > m_impl;
+    // cached to avoid a double indirection when posting, kept alive by m_impl
+    S* m_scheduler;
+};
+
+/*!
+ * \brief creates a statically typed proxy to a given scheduler, forward passed arguments to it.
+ * \brief example: make_typed_shared_scheduler_proxy<
+ * \brief            threadpool_scheduler<boost::asynchronous::lockfree_queue<>>>(3)
+ * \brief The result can be used wherever a scheduler is expected (post_future, post_callback...)
+ * \brief and converts to any_shared_scheduler_proxy<job>.
+ * \tparam args the arguments passed to the scheduler upon creation
+ * \return shared_scheduler_proxy<S>
+ */
+template< class S, class... Args >
+typename std::enable_if<!boost::asynchronous::has_self_proxy_creation<S>::value,
+                           boost::asynchronous::shared_scheduler_proxy<S> >::type
+make_typed_shared_scheduler_proxy(Args && ... args)
+{
+    auto sps = std::make_shared<S>(std::forward<Args>(args)...);
+    sps->constructor_done(sps);
+    return boost::asynchronous::shared_scheduler_proxy<S>(std::move(sps));
+}
+
 #ifndef BOOST_ASYNCHRONOUS_USE_TYPE_ERASURE
 template<class JOB = BOOST_ASYNCHRONOUS_DEFAULT_JOB>
 class scheduler_weak_proxy
@@ -0,0 +1,197 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#ifndef BOOST_ASYNC_SMALL_CALLABLE_HPP
+#define BOOST_ASYNC_SMALL_CALLABLE_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+
+// A move-only job type, callable like any_callable: void task().
+// Unlike any_callable, callables up to BOOST_ASYNCHRONOUS_SMALL_CALLABLE_SIZE bytes are stored inline,
+// only bigger ones or ones with a throwing move constructor go to the heap.
+// To use it as default job for all schedulers, define before including any Asynchronous header:
+// #define BOOST_ASYNCHRONOUS_DEFAULT_JOB boost::asynchronous::small_callable
+
+// the default buffer size makes a small_callable exactly a cache line
+#ifndef BOOST_ASYNCHRONOUS_SMALL_CALLABLE_SIZE
+#define BOOST_ASYNCHRONOUS_SMALL_CALLABLE_SIZE 56
+#endif
+
+namespace boost { namespace asynchronous
+{
+
+class small_callable
+{
+    // pointer alignment: the default alignment of aligned_storage (16) would pad a small_callable to 80 bytes
+    typedef typename std::aligned_storage<BOOST_ASYNCHRONOUS_SMALL_CALLABLE_SIZE,alignof(void*)>::type storage_type;
+    // hand-made vtable, one static instance per stored type
+    struct vtable
+    {
+        void (*invoke)(storage_type&);
+        // move-constructs into to, destroys from
+        void (*move)(storage_type& from, storage_type& to);
+        void (*destroy)(storage_type&);
+    };
+    template <class T>
+    struct fits_inline : std::integral_constant<bool,
+            sizeof(T) <= sizeof(storage_type) &&
+            std::alignment_of<storage_type>::value % std::alignment_of<T>::value == 0 &&
+            std::is_nothrow_move_constructible<T>::value>
+    {};
+    template <class T>
+    struct inline_vtable
+    {
+        static T& get(storage_type& s)
+        {
+            return *reinterpret_cast<T*>(&s);
+        }
+        static void invoke(storage_type& s)
+        {
+            get(s)();
+        }
+        static void move(storage_type& from, storage_type& to)
+        {
+            new (&to) T(std::move(get(from)));
+            get(from).~T();
+        }
+        static void destroy(storage_type& s)
+        {
+            get(s).~T();
+        }
+        static vtable const* instance()
+        {
+            static const vtable v = {&invoke,&move,&destroy};
+            return &v;
+        }
+    };
+    template <class T>
+    struct heap_vtable
+    {
+        static T*& get(storage_type& s)
+        {
+            return *reinterpret_cast<T**>(&s);
+        }
+        static void invoke(storage_type& s)
+        {
+            (*get(s))();
+        }
+        static void move(storage_type& from, storage_type& to)
+        {
+            new (&to) T*(get(from));
+        }
+        static void destroy(storage_type& s)
+        {
+            delete get(s);
+        }
+        static vtable const* instance()
+        {
+            static const vtable v = {&invoke,&move,&destroy};
+            return &v;
+        }
+    };
+
+    template <class T>
+    void construct(T&& t, std::true_type /*inline*/)
+    {
+        typedef typename std::decay<T>::type value_type;
+        new (&m_storage) value_type(std::forward<T>(t));
+        m_vtable = inline_vtable<value_type>::instance();
+    }
+    template <class T>
+    void construct(T&& t, std::false_type /*heap*/)
+    {
+        typedef typename std::decay<T>::type value_type;
+        new (&m_storage) value_type*(new value_type(std::forward<T>(t)));
+        m_vtable = heap_vtable<value_type>::instance();
+    }
+    void reset()noexcept
+    {
+        if (m_vtable)
+        {
+            m_vtable->destroy(m_storage);
+            m_vtable = nullptr;
+        }
+    }
+
+public:
+    small_callable()noexcept : m_vtable(nullptr){}
+
+    // classes derived from small_callable (job wrappers) are moved, not wrapped
+    template <class T,
+              class Enable = typename std::enable_if<
+                  !std::is_base_of<small_callable,typename std::decay<T>::type>::value>::type>
+    small_callable(T&& t)
+        : m_vtable(nullptr)
+    {
+        construct(std::forward<T>(t),fits_inline<typename std::decay<T>::type>());
+    }
+    small_callable(small_callable&& rhs)noexcept
+        : m_vtable(rhs.m_vtable)
+    {
+        if (m_vtable)
+        {
+            m_vtable->move(rhs.m_storage,m_storage);
+            rhs.m_vtable = nullptr;
+        }
+    }
+    small_callable& operator=(small_callable&& rhs)noexcept
+    {
+        if (this != &rhs)
+        {
+            reset();
+            if (rhs.m_vtable)
+            {
+                rhs.m_vtable->move(rhs.m_storage,m_storage);
+                m_vtable = rhs.m_vtable;
+                rhs.m_vtable = nullptr;
+            }
+        }
+        return *this;
+    }
+    small_callable(small_callable const&) = delete;
+    small_callable& operator=(small_callable const&) = delete;
+    ~small_callable()
+    {
+        reset();
+    }
+
+    void operator()()
+    {
+        m_vtable->invoke(m_storage);
+    }
+    bool empty()const noexcept
+    {
+        return m_vtable == nullptr;
+    }
+    // true if T would be stored without allocation
+    template <class T>
+    static constexpr bool is_stored_inline()
+    {
+        return fits_inline<typename std::decay<T>::type>::value;
+    }
+
+    // dummies
+    typedef boost::archive::text_oarchive oarchive;
+    typedef boost::archive::text_iarchive iarchive;
+private:
+    storage_type m_storage;
+    vtable const* m_vtable;
+};
+static_assert(BOOST_ASYNCHRONOUS_SMALL_CALLABLE_SIZE != 56 || sizeof(void*) != 8 || sizeof(small_callable) == 64,
+              "with the default buffer size, a small_callable should be a cache line");
+
+}} // boost::async
+
+#endif /* BOOST_ASYNC_SMALL_CALLABLE_HPP */
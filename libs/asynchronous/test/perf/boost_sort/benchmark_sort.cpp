@@ -41,6 +41,7 @@
 #include <boost/asynchronous/scheduler_shared_proxy.hpp>
 #include <boost/asynchronous/algorithm/parallel_sort.hpp>
 #include <boost/asynchronous/algorithm/parallel_quicksort.hpp>
+#include <boost/asynchronous/algorithm/parallel_radix_sort.hpp>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/type_traits/is_same.hpp>
@@ -66,6 +67,7 @@ void Generator_sorted(void);
 void Generator_reverse_sorted(void);
 void Generator_uint64(void);
 void Generator_string(void);
+void Generator_float(void);
 
 template <class IA>
 void Generator(uint64_t N);
@@ -76,6 +78,9 @@ int Test(std::vector<IA> &B, compare comp = compare());
 template <class IA>
 int Test_spreadsort(std::vector<IA> &B);
 
+template <class IA, class KeyFunc>
+int Test_radix_sort(std::vector<IA> &B, KeyFunc key);
+
 int main(int argc, char *argv[])
 {    
     cout << "\n\n";
@@ -95,6 +100,7 @@ int main(int argc, char *argv[])
     Generator_sorted();
     Generator_reverse_sorted();
     Generator_uint64();
+    Generator_float();
     Generator_string();
 
     cout << "=============================================================\n";
@@ -132,6 +138,7 @@ void Generator_sorted(void)
     for (size_t i = 0; i < NELEM; ++i) A.push_back(i);
     Test<uint64_t, std::less<uint64_t>>(A);
     Test_spreadsort(A);
+    Test_radix_sort(A, boost::asynchronous::radix_identity());
     cout << std::endl;
 }
 void Generator_reverse_sorted(void)
@@ -145,6 +152,7 @@ void Generator_reverse_sorted(void)
     for (size_t i = NELEM; i > 0; --i) A.push_back(i);
     Test<uint64_t, std::less<uint64_t>>(A);
     Test_spreadsort(A);
+    Test_radix_sort(A, boost::asynchronous::radix_identity());
     cout << std::endl;
 }
 void Generator_uint64(void)
@@ -160,6 +168,20 @@ void Generator_uint64(void)
     };
     Test<uint64_t, std::less<uint64_t>>(A);
     Test_spreadsort(A);
+    Test_radix_sort(A, boost::asynchronous::radix_identity());
+    cout << std::endl;
+}
+void Generator_float(void)
+{
+    vector<float> A;
+    A.reserve(NELEM);
+    cout << "  " << NELEM << " float elements randomly filled\n";
+    cout << "=================================================\n";
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> dis(-1.0e9f, 1.0e9f);
+    for (size_t i = 0; i < NELEM; ++i) A.push_back(dis(gen));
+    Test<float, std::less<float>>(A);
+    Test_radix_sort(A, boost::asynchronous::radix_identity());
     cout << std::endl;
 }
 void Generator_string(void)
@@ -196,6 +218,8 @@ void Generator(uint64_t N)
     cout << "\n  L I G H T   C O M P A R I S O N \n";
     cout << "=======================================\n";
     Test(A, L_comp<IA>());
+    // key - payload: the key is the first number of the array
+    Test_radix_sort(A, [](IA const& a){return a.M[0];});
     cout << std::endl;
 };
 
@@ -493,5 +517,39 @@ int Test_spreadsort(std::vector<IA> &B)
     cout << duration << " secs\n\n";
 
 
+    return 0;
+};
+
+template <class IA, class KeyFunc>
+int Test_radix_sort(std::vector<IA> &B, KeyFunc key)
+{
+    double duration;
+    time_point start, finish;
+    std::vector<IA> A(B);
+
+    // Asynchronous scheduler
+    auto pool = boost::asynchronous::make_shared_scheduler_proxy<
+                  boost::asynchronous::multiqueue_threadpool_scheduler<
+                        boost::asynchronous::lockfree_queue<>,
+                        boost::asynchronous::default_find_position< boost::asynchronous::sequential_push_policy>,
+                        boost::asynchronous::no_cpu_load_saving
+                    >>(boost::thread::hardware_concurrency(),boost::thread::hardware_concurrency() * 4);
+    // set processor affinity to improve cache usage. We start at core 0, until tpsize-1
+    pool.processor_bind(0);
+
+    A = B;
+    cout << "Asynchronous parallel_radix_sort     : ";
+    start = now();
+    auto fu = boost::asynchronous::post_future(pool,
+    [&A,key]()
+    {
+        return boost::asynchronous::parallel_radix_sort(A.begin(), A.end(), key, sizeof(IA)<=16 ? NELEM/64:4096*2,"",0);
+    }
+    ,"",0);
+    fu.get();
+    finish = now();
+    duration = subtract_time(finish, start);
+    cout << duration << " secs\n\n";
+
     return 0;
 };
@@ -6,6 +6,9 @@
 #include <boost/asynchronous/queue/lockfree_queue.hpp>
 #include <boost/asynchronous/scheduler_shared_proxy.hpp>
 #include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/scheduler/stealing_multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/scheduler/composite_threadpool_scheduler.hpp>
+#include <boost/asynchronous/queue/work_stealing_deque.hpp>
 #include <boost/asynchronous/continuation_task.hpp>
 
 #include <boost/asynchronous/servant_proxy.hpp>
@@ -59,17 +62,8 @@ struct Servant : boost::asynchronous::trackable_servant<>
 {
     // optional, ctor is simple enough not to be posted
     typedef int simple_ctor;
-    Servant(boost::asynchronous::any_weak_scheduler<> scheduler, int threads)
-        : boost::asynchronous::trackable_servant<>(scheduler,
-                                               // threadpool and a simple lockfree_queue
-                                               boost::asynchronous::make_shared_scheduler_proxy<
-                                                   boost::asynchronous::multiqueue_threadpool_scheduler<
-                                                           boost::asynchronous::lockfree_queue<>,
-                                                           boost::asynchronous::default_find_position< >,
-                                                           //boost::asynchronous::default_save_cpu_load<10,80000,5000>
-                                                           //boost::asynchronous::default_save_cpu_load<10,80000,1000>
-                                                           boost::asynchronous::no_cpu_load_saving
-                                                       >>(threads))
+    Servant(boost::asynchronous::any_weak_scheduler<> scheduler, boost::asynchronous::any_shared_scheduler_proxy<> pool)
+        : boost::asynchronous::trackable_servant<>(scheduler,pool)
         // for testing purpose
         , m_promise(new std::promise<long>)
     {
@@ -110,8 +104,8 @@ class ServantProxy : public boost::asynchronous::servant_proxy<ServantProxy,Serv
 {
 public:
     template <class Scheduler>
-    ServantProxy(Scheduler s, int threads):
-        boost::asynchronous::servant_proxy<ServantProxy,Servant>(s,threads)
+    ServantProxy(Scheduler s, boost::asynchronous::any_shared_scheduler_proxy<> pool):
+        boost::asynchronous::servant_proxy<ServantProxy,Servant>(s,pool)
     {}
     // caller will get a future
     BOOST_ASYNC_FUTURE_MEMBER(calc_fibonacci,0)
@@ -119,7 +113,32 @@ public:
 
 }
 
-void example_fibonacci(long fibo_val,long cutoff, int threads)
+boost::asynchronous::any_shared_scheduler_proxy<> make_pool(int threads, bool work_stealing)
+{
+    if (work_stealing)
+    {
+        // one Chase-Lev deque per worker: sub-tasks stay on the worker creating them, idle workers steal the oldest ones.
+        // A stealing pool starts its threads once it knows from which pools it can steal
+        boost::asynchronous::any_shared_scheduler_proxy<> pool = boost::asynchronous::make_shared_scheduler_proxy<
+                boost::asynchronous::stealing_multiqueue_threadpool_scheduler<
+                        boost::asynchronous::work_stealing_deque<>,
+                        boost::asynchronous::default_find_position< >,
+                        boost::asynchronous::no_cpu_load_saving
+                    >>(threads);
+        return boost::asynchronous::make_shared_scheduler_proxy<boost::asynchronous::composite_threadpool_scheduler<>>(pool);
+    }
+    // threadpool and a simple lockfree_queue
+    return boost::asynchronous::make_shared_scheduler_proxy<
+                boost::asynchronous::multiqueue_threadpool_scheduler<
+                        boost::asynchronous::lockfree_queue<>,
+                        boost::asynchronous::default_find_position< >,
+                        //boost::asynchronous::default_save_cpu_load<10,80000,5000>
+                        //boost::asynchronous::default_save_cpu_load<10,80000,1000>
+                        boost::asynchronous::no_cpu_load_saving
+                    >>(threads);
+}
+
+void example_fibonacci(long fibo_val,long cutoff, int threads, bool work_stealing)
 {
     typename std::chrono::high_resolution_clock::time_point start;
     typename std::chrono::high_resolution_clock::time_point stop;
@@ -131,7 +150,7 @@ void example_fibonacci(long fibo_val,long cutoff, int threads)
                                      boost::asynchronous::lockfree_queue<>,
                                      boost::asynchronous::default_save_cpu_load<10,80000,1000>>>();
         {
-            ServantProxy proxy(scheduler,threads);
+            ServantProxy proxy(scheduler,make_pool(threads,work_stealing));
             start = std::chrono::high_resolution_clock::now();
             auto fu = proxy.calc_fibonacci(fibo_val,cutoff);
             auto resfu = fu.get();
@@ -149,9 +168,11 @@ int main(int argc, char* argv[])
   long fib = (argc>2) ? strtol(argv[1],0,0) : 48;
   long cutOff = (argc>2) ? strtol(argv[2],0,0) : 30;
   int threads = (argc>3) ? strtol(argv[3],0,0) : 12;
+  bool work_stealing = (argc>4) ? (strtol(argv[4],0,0) != 0) : false;
   std::cout << "fib=" << fib << std::endl;
   std::cout << "cutoff=" << cutOff << std::endl;
   std::cout << "threads=" << threads << std::endl;
-  example_fibonacci(fib,cutOff,threads);
+  std::cout << "work stealing deques=" << work_stealing << std::endl;
+  example_fibonacci(fib,cutOff,threads,work_stealing);
   return 0;
 }
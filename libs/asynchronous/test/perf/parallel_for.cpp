@@ -114,16 +114,31 @@ int main( int argc, const char *argv[] )
 {
     tpsize = (argc>1) ? strtol(argv[1],0,0) : boost::thread::hardware_concurrency();
     tasks = (argc>2) ? strtol(argv[2],0,0) : 500;
+    // 1: keep sub-tasks in the queue of the worker creating them (spawn locality)
+    bool local = (argc>3) ? (strtol(argv[3],0,0) != 0) : false;
     std::cout << "tpsize=" << tpsize << std::endl;
     std::cout << "tasks=" << tasks << std::endl;
+    std::cout << "local=" << local << std::endl;
 
-    scheduler =  boost::asynchronous::make_shared_scheduler_proxy<
-            boost::asynchronous::multiqueue_threadpool_scheduler<
-                    boost::asynchronous::lockfree_queue<>,
-                    boost::asynchronous::default_find_position< boost::asynchronous::sequential_push_policy>,
-                    //boost::asynchronous::default_save_cpu_load<10,80000,1000>
-                    boost::asynchronous::no_cpu_load_saving
-                >>(tpsize,tasks/tpsize);
+    if (local)
+    {
+        scheduler =  boost::asynchronous::make_shared_scheduler_proxy<
+                boost::asynchronous::multiqueue_threadpool_scheduler<
+                        boost::asynchronous::lockfree_queue<boost::asynchronous::any_callable,boost::asynchronous::lockfree_size>,
+                        boost::asynchronous::local_find_position<>,
+                        boost::asynchronous::no_cpu_load_saving
+                    >>(tpsize,tasks/tpsize);
+    }
+    else
+    {
+        scheduler =  boost::asynchronous::make_shared_scheduler_proxy<
+                boost::asynchronous::multiqueue_threadpool_scheduler<
+                        boost::asynchronous::lockfree_queue<>,
+                        boost::asynchronous::default_find_position< boost::asynchronous::sequential_push_policy>,
+                        //boost::asynchronous::default_save_cpu_load<10,80000,1000>
+                        boost::asynchronous::no_cpu_load_saving
+                    >>(tpsize,tasks/tpsize);
+    }
     // set processor affinity to improve cache usage. We start at core 0, until tpsize-1
     std::vector<std::tuple<unsigned int,unsigned int>> v;
     v.push_back(std::make_tuple(0,tpsize));
@@ -226,15 +226,30 @@ int main( int argc, const char *argv[] )
 {           
     tpsize = (argc>1) ? strtol(argv[1],0,0) : boost::thread::hardware_concurrency();
     tasks = (argc>2) ? strtol(argv[2],0,0) : 500;
+    // 1: keep sub-tasks in the queue of the worker creating them (spawn locality)
+    bool local = (argc>3) ? (strtol(argv[3],0,0) != 0) : false;
     std::cout << "tpsize=" << tpsize << std::endl;
     std::cout << "tasks=" << tasks << std::endl;   
-    
-    pool = boost::asynchronous::make_shared_scheduler_proxy<
-                  boost::asynchronous::multiqueue_threadpool_scheduler<
-                        boost::asynchronous::lockfree_queue<>,
-                        boost::asynchronous::default_find_position< boost::asynchronous::sequential_push_policy>,
-                        boost::asynchronous::no_cpu_load_saving
-                    >>(tpsize,tasks);
+    std::cout << "local=" << local << std::endl;
+
+    if (local)
+    {
+        pool = boost::asynchronous::make_shared_scheduler_proxy<
+                      boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<boost::asynchronous::any_callable,boost::asynchronous::lockfree_size>,
+                            boost::asynchronous::local_find_position<>,
+                            boost::asynchronous::no_cpu_load_saving
+                        >>(tpsize,tasks);
+    }
+    else
+    {
+        pool = boost::asynchronous::make_shared_scheduler_proxy<
+                      boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>,
+                            boost::asynchronous::default_find_position< boost::asynchronous::sequential_push_policy>,
+                            boost::asynchronous::no_cpu_load_saving
+                        >>(tpsize,tasks);
+    }
     // set processor affinity to improve cache usage. We start at core 0, until tpsize-1
     pool.processor_bind({{0,tpsize}});
 
@@ -33,6 +33,7 @@ using namespace std;
 
 std::chrono::high_resolution_clock::time_point servant_time;
 double servant_intern=0.0;
+double two_pass_intern=0.0;
 double serial_duration=0.0;
 
 long tpsize = 12;
@@ -111,7 +112,38 @@ void ParallelAsyncPostFuture(Iterator beg, Iterator end, Iterator out, element i
     servant_intern += (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - servant_time).count() / 1000);
 }
 
-
+// same scan, but the scan functor also takes the total, which forces the former reduce, then scan algorithm
+void ParallelAsyncPostFutureTwoPass(Iterator beg, Iterator end, Iterator out, element init)
+{
+    long tasksize = SIZE / tasks;
+    servant_time = std::chrono::high_resolution_clock::now();
+    auto fu = boost::asynchronous::post_future(scheduler,
+               [beg,end,out,init,tasksize]()
+               {
+                   return boost::asynchronous::parallel_scan(beg,end,out,init,
+                                                             [](Iterator beg, Iterator end)
+                                                             {
+                                                               element r=0;
+                                                               for (;beg != end; ++beg)
+                                                               {
+                                                                   r += (*beg + Foo(*beg));
+                                                               }
+                                                               return r;
+                                                             },
+                                                             std::plus<element>(),
+                                                             [](Iterator beg, Iterator end, Iterator out, element init, element /*total*/) mutable
+                                                             {
+                                                               for (;beg != end; ++beg)
+                                                               {
+                                                                   init += (*beg + Foo(*beg));
+                                                                   *out++ = init;
+                                                               };
+                                                             },
+                                                             tasksize,"",0);
+               });
+    fu.get();
+    two_pass_intern += (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - servant_time).count() / 1000);
+}
 
 
 int main( int argc, const char *argv[] )
@@ -139,6 +171,13 @@ int main( int argc, const char *argv[] )
         ParallelAsyncPostFuture(data.begin(),data.end(),res.begin(),(element)0.0);
     }
     for (int i=0;i<LOOP;++i)
+    {
+        container data;
+        container res(SIZE,(element)0.0);
+        generate(data,SIZE);
+        ParallelAsyncPostFutureTwoPass(data.begin(),data.end(),res.begin(),(element)0.0);
+    }
+    for (int i=0;i<LOOP;++i)
     {
         container data;
         container res(SIZE,(element)0.0);
@@ -149,7 +188,9 @@ int main( int argc, const char *argv[] )
         serial_duration += (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count() / 1000);
     }
     printf ("%24s: time = %.1f usec\n","parallel_scan", servant_intern);
+    printf ("%24s: time = %.1f usec\n","parallel_scan two pass", two_pass_intern);
     printf ("%24s: time = %.1f usec\n","serial_scan", serial_duration);
     std::cout << "speedup: " << serial_duration / servant_intern << std::endl;
+    std::cout << "speedup two pass: " << serial_duration / two_pass_intern << std::endl;
     return 0;
 }
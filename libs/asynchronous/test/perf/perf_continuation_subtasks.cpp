@@ -0,0 +1,104 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+// overhead of callback continuation sub-tasks: parallel_for / parallel_reduce with a tiny cutoff,
+// which creates millions of leaf tasks doing almost nothing. Prints time and heap allocations per leaf task.
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/post.hpp>
+#include <boost/asynchronous/algorithm/parallel_for.hpp>
+#include <boost/asynchronous/algorithm/parallel_reduce.hpp>
+
+using namespace std;
+#define SIZE 8000000
+#define CUTOFF 8
+#define LOOP 3
+
+// count every heap allocation of the process
+std::atomic<std::size_t> allocations(0);
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* p = std::malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+template <class F>
+void measure(std::string const& name, F&& f)
+{
+    // leaves of the binary split: SIZE / CUTOFF rounded to the next power of two
+    long leaves = 1;
+    while (leaves * CUTOFF < SIZE)
+        leaves *= 2;
+    double best = 0.0;
+    std::size_t alloc_count = 0;
+    for (int i = 0; i < LOOP; ++i)
+    {
+        std::size_t alloc_before = allocations.load();
+        auto start = std::chrono::high_resolution_clock::now();
+        f();
+        double elapsed = (double)std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count();
+        alloc_count = allocations.load() - alloc_before;
+        if (i == 0 || elapsed < best)
+            best = elapsed;
+    }
+    std::cout << name << ": " << leaves << " leaf tasks, " << best / 1000000.0 << " ms, "
+              << best / leaves << " ns per leaf task, "
+              << ((double)alloc_count / leaves) << " allocations per leaf task" << std::endl;
+}
+
+int main( int argc, const char *argv[] )
+{
+    long tpsize = (argc>1) ? strtol(argv[1],0,0) : boost::thread::hardware_concurrency();
+    std::cout << "tpsize=" << tpsize << std::endl;
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+            boost::asynchronous::multiqueue_threadpool_scheduler<
+                boost::asynchronous::lockfree_queue<>>>(tpsize);
+
+    std::vector<int> data(SIZE,1);
+    measure("parallel_for",[&]()
+    {
+        auto fu = boost::asynchronous::post_future(scheduler,
+                    [&data]()
+                    {
+                        return boost::asynchronous::parallel_for(data.begin(),data.end(),
+                                                                 [](int& i){++i;},CUTOFF);
+                    });
+        fu.get();
+    });
+    measure("parallel_reduce",[&]()
+    {
+        auto fu = boost::asynchronous::post_future(scheduler,
+                    [&data]()
+                    {
+                        return boost::asynchronous::parallel_reduce(data.begin(),data.end(),
+                                                                    [](int a, int b){return a + b;},CUTOFF);
+                    });
+        fu.get();
+    });
+    return 0;
+}
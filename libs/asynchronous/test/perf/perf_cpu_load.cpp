@@ -0,0 +1,80 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+// compares CPULoad policies: latency between post and start of a job posted to an idle pool (p50 / p99)
+// and CPU used by an idle pool
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <future>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <ctime>
+
+#include <boost/asynchronous/scheduler/threadpool_scheduler.hpp>
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler/cpu_load_policies.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/post.hpp>
+
+using namespace std;
+#define LOOP_COUNT 2000
+// pause between two posts, long enough for the pool to become idle
+#define PAUSE_US 1000
+#define IDLE_MS 2000
+
+template <class CPULoad>
+void test_cpu_load(std::string const& name, long tpsize)
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+            boost::asynchronous::multiqueue_threadpool_scheduler<
+                boost::asynchronous::lockfree_queue<>,
+                boost::asynchronous::default_find_position<>,
+                CPULoad>>(tpsize);
+
+    std::vector<long> latencies;
+    latencies.reserve(LOOP_COUNT);
+    for (auto i=0; i< LOOP_COUNT; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(PAUSE_US));
+        auto posted = std::chrono::high_resolution_clock::now();
+        auto fu = boost::asynchronous::post_future(scheduler,
+                   [posted]()
+                   {
+                       return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::high_resolution_clock::now() - posted).count();
+                   });
+        latencies.push_back(fu.get());
+    }
+    std::sort(latencies.begin(),latencies.end());
+
+    // let the pool do nothing and measure how much CPU it needs for this
+    std::clock_t cpu_start = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_MS));
+    double idle_cpu = 100.0 * (std::clock() - cpu_start) / CLOCKS_PER_SEC / (IDLE_MS / 1000.0);
+
+    std::cout << name << ": post to start latency p50: " << latencies[LOOP_COUNT / 2] / 1000.0 << " us"
+              << ", p99: " << latencies[LOOP_COUNT * 99 / 100] / 1000.0 << " us"
+              << ", max: " << latencies.back() / 1000.0 << " us"
+              << ", idle CPU: " << idle_cpu << "% of one core" << std::endl;
+}
+
+int main( int argc, const char *argv[] )
+{
+    long tpsize = (argc>1) ? strtol(argv[1],0,0) : boost::thread::hardware_concurrency();
+    std::cout << "tpsize=" << tpsize << std::endl;
+
+    test_cpu_load<boost::asynchronous::no_cpu_load_saving>("no_cpu_load_saving",tpsize);
+    test_cpu_load<boost::asynchronous::default_save_cpu_load<>>("default_save_cpu_load",tpsize);
+    test_cpu_load<boost::asynchronous::parking_cpu_load<>>("parking_cpu_load",tpsize);
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+// bursts of blocking "I/O" jobs (sleeps) posted to an io_threadpool_scheduler, with a pause between bursts.
+// Compares temporary threads ending as soon as they are idle (KeepAliveMs=0) with parked threads being reused.
+// Reports the average time to complete a burst and how many threads were created.
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <future>
+#include <chrono>
+#include <thread>
+
+#include <boost/asynchronous/scheduler/io_threadpool_scheduler.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/post.hpp>
+
+using namespace std;
+#define BURST_COUNT 200
+// pause between two bursts, shorter than the default keep-alive
+#define PAUSE_MS 20
+// duration of a blocking job
+#define IO_US 2000
+
+// thread ids can be reused by the OS, count threads seeing their first job instead
+std::atomic<long> created_threads(0);
+thread_local bool seen_thread = false;
+
+template <unsigned KeepAliveMs>
+void test_bursts(std::string const& name, long min_threads, long max_threads, long burst_size)
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+            boost::asynchronous::io_threadpool_scheduler<
+                boost::asynchronous::lockfree_queue<>,
+                boost::asynchronous::default_save_cpu_load<>,
+                KeepAliveMs>>(min_threads,max_threads);
+
+    created_threads = 0;
+    long total_us = 0;
+    for (auto b=0; b< BURST_COUNT; ++b)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_MS));
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::future<void>> fus;
+        fus.reserve(burst_size);
+        for (auto i=0; i< burst_size; ++i)
+        {
+            fus.emplace_back(boost::asynchronous::post_future(scheduler,
+                       []()
+                       {
+                           if (!seen_thread)
+                           {
+                               seen_thread = true;
+                               ++created_threads;
+                           }
+                           std::this_thread::sleep_for(std::chrono::microseconds(IO_US));
+                       }));
+        }
+        for (auto& fu : fus)
+        {
+            fu.get();
+        }
+        total_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+    std::cout << name << ": average burst in us: " << total_us / BURST_COUNT
+              << ", threads created: " << created_threads << std::endl;
+}
+
+int main( int argc, const char *argv[] )
+{
+    long min_threads = (argc>1) ? strtol(argv[1],0,0) : 2;
+    long max_threads = (argc>2) ? strtol(argv[2],0,0) : 16;
+    long burst_size = (argc>3) ? strtol(argv[3],0,0) : 16;
+    std::cout << "min threads=" << min_threads << " max threads=" << max_threads << " burst size=" << burst_size << std::endl;
+
+    test_bursts<0>("threads end when idle",min_threads,max_threads,burst_size);
+    test_bursts<500>("threads parked 500ms",min_threads,max_threads,burst_size);
+    return 0;
+}
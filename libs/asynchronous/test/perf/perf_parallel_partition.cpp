@@ -55,6 +55,17 @@ boost::asynchronous::any_shared_scheduler_proxy<> scheduler;
 
 SORTED_TYPE compare_with = NELEM/2;
 
+// define to measure the partition itself rather than the predicate
+//#define CHEAP_PREDICATE
+inline bool predicate(SORTED_TYPE const& i)
+{
+#ifdef CHEAP_PREDICATE
+    return i < compare_with;
+#else
+    return i/(i*i)/i/i < compare_with/(compare_with * compare_with)/compare_with/compare_with;
+#endif
+}
+
 void ParallelAsyncPostCb(std::vector<SORTED_TYPE>& a)
 {
     std::shared_ptr<std::vector<SORTED_TYPE>> vec = std::make_shared<std::vector<SORTED_TYPE>>(a);
@@ -65,10 +76,7 @@ void ParallelAsyncPostCb(std::vector<SORTED_TYPE>& a)
                          return boost::asynchronous::parallel_partition(std::move(*vec),
                                                                         [](SORTED_TYPE const& i)
                                                                         {
-                                                                           // cheap version
-                                                                           //return i < compare_with;
-                                                                           // expensive version
-                                                                           return i/(i*i)/i/i < compare_with/(compare_with * compare_with)/compare_with/compare_with;
+                                                                           return predicate(i);
                                                                         },tpsize,"",0);
                        },
                 "",0);
@@ -79,16 +87,30 @@ void ParallelAsyncPostCb(std::vector<SORTED_TYPE>& a)
         auto seq_start = std::chrono::high_resolution_clock::now();
         std::partition(a.begin(),a.end(),[](SORTED_TYPE const& i)
         {
-            // cheap version
-            //return i < compare_with;
-            // expensive version
-            return i/(i*i)/i/i < compare_with/(compare_with * compare_with)/compare_with/compare_with;
+            return predicate(i);
         });
         auto seq_stop = std::chrono::high_resolution_clock::now();
         double seq_time = (std::chrono::nanoseconds(seq_stop - seq_start).count() / 1000000);
         printf ("\n%50s: time = %.1f msec\n","sequential", seq_time);
     }
 }
+// half of the elements satisfy the predicate, in random order, like a quicksort pivot gives
+void test_random_elements_half_true(void(*pf)(std::vector<SORTED_TYPE>& ))
+{
+    std::vector<SORTED_TYPE> a(NELEM);
+    auto fu = boost::asynchronous::post_future(
+                scheduler,
+                [&]{
+                    return boost::asynchronous::parallel_generate(
+                                a.begin(), a.end(),
+                                []{
+                                    boost::random::uniform_int_distribution<> distribution(1, NELEM - 1);
+                                    return boost::asynchronous::random_provider<boost::random::mt19937>::generate(distribution);
+                                }, 1024);
+                });
+    fu.get();
+    (*pf)(a);
+}
 void test_sorted_elements(void(*pf)(std::vector<SORTED_TYPE>& ))
 {
     std::vector<SORTED_TYPE> a(NELEM);
@@ -212,6 +234,13 @@ int main( int argc, const char *argv[] )
     }
     printf ("%50s: time = %.1f msec\n","test_random_elements_quite_repeated", servant_intern);
 
+    servant_intern=0.0;
+    for (int i=0;i<LOOP;++i)
+    {
+        test_random_elements_half_true(ParallelAsyncPostCb);
+    }
+    printf ("%50s: time = %.1f msec\n","test_random_elements_half_true", servant_intern);
+
     servant_intern=0.0;
     for (int i=0;i<LOOP;++i)
     {
@@ -18,6 +18,7 @@
 #include <boost/asynchronous/scheduler/stealing_multiqueue_threadpool_scheduler.hpp>
 #include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
 #include <boost/asynchronous/scheduler/composite_threadpool_scheduler.hpp>
+#include <boost/asynchronous/queue/lockfree_ring_queue.hpp>
 #include <boost/asynchronous/scheduler_shared_proxy.hpp>
 #include <boost/asynchronous/post.hpp>
 #include <boost/asynchronous/diagnostics/any_loggable.hpp>
@@ -54,6 +55,125 @@ void test_callable_multiqueue_threadpool_scheduler_lockfree(long tpsize,long que
     std::cout << "test_callable_multiqueue_threadpool_scheduler_lockfree, average post in us: " << post_time / LOOP_COUNT <<std::endl;
 }
 
+void test_callable_typed_multiqueue_threadpool_scheduler_lockfree(long tpsize,long queue_size)
+{
+    // same as above but posting without type-erased / virtual dispatch
+    auto scheduler =  boost::asynchronous::make_typed_shared_scheduler_proxy<
+            boost::asynchronous::multiqueue_threadpool_scheduler<
+                    boost::asynchronous::lockfree_queue<>
+                >>(tpsize,queue_size);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::future<void>> fus;
+    for (auto i=0; i< LOOP_COUNT; ++i)
+    {
+        auto fu = boost::asynchronous::post_future(scheduler,
+                   []()mutable
+                   {
+                   });
+        fus.emplace_back(std::move(fu));
+    }
+    auto post_time = (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count() / 1000);
+    boost::wait_for_all(fus.begin(), fus.end());
+    std::cout << "test_callable_typed_multiqueue_threadpool_scheduler_lockfree, average post in us: " << post_time / LOOP_COUNT <<std::endl;
+}
+
+void test_callable_multiqueue_threadpool_scheduler_lockfree_ring(long tpsize,long queue_size)
+{
+    boost::asynchronous::any_shared_scheduler_proxy<> scheduler =  boost::asynchronous::make_shared_scheduler_proxy<
+            boost::asynchronous::multiqueue_threadpool_scheduler<
+                    boost::asynchronous::lockfree_ring_queue<>
+                >>(tpsize,queue_size);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::future<void>> fus;
+    for (auto i=0; i< LOOP_COUNT; ++i)
+    {
+        auto fu = boost::asynchronous::post_future(scheduler,
+                   []()mutable
+                   {
+                   });
+        fus.emplace_back(std::move(fu));
+    }
+    auto post_time = (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count() / 1000);
+    boost::wait_for_all(fus.begin(), fus.end());
+    std::cout << "test_callable_multiqueue_threadpool_scheduler_lockfree_ring, average post in us: " << post_time / LOOP_COUNT <<std::endl;
+}
+
+void test_callable_stealing_multiqueue_threadpool_scheduler_lockfree(long tpsize,long queue_size)
+{
+    // a stealing pool starts its threads once it knows from which pools it can steal
+    boost::asynchronous::any_shared_scheduler_proxy<> pool =  boost::asynchronous::make_shared_scheduler_proxy<
+            boost::asynchronous::stealing_multiqueue_threadpool_scheduler<
+                    boost::asynchronous::lockfree_queue<>
+                >>(tpsize,queue_size);
+    auto scheduler =
+            boost::asynchronous::make_shared_scheduler_proxy<boost::asynchronous::composite_threadpool_scheduler<>> (pool);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::future<void>> fus;
+    for (auto i=0; i< LOOP_COUNT; ++i)
+    {
+        auto fu = boost::asynchronous::post_future(scheduler,
+                   []()mutable
+                   {
+                   });
+        fus.emplace_back(std::move(fu));
+    }
+    auto post_time = (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count() / 1000);
+    boost::wait_for_all(fus.begin(), fus.end());
+    std::cout << "test_callable_stealing_multiqueue_threadpool_scheduler_lockfree, average post in us: " << post_time / LOOP_COUNT <<std::endl;
+}
+
+void test_callable_stealing_multiqueue_threadpool_scheduler_lockfree_ring(long tpsize,long queue_size)
+{
+    // a stealing pool starts its threads once it knows from which pools it can steal
+    boost::asynchronous::any_shared_scheduler_proxy<> pool =  boost::asynchronous::make_shared_scheduler_proxy<
+            boost::asynchronous::stealing_multiqueue_threadpool_scheduler<
+                    boost::asynchronous::lockfree_ring_queue<>
+                >>(tpsize,queue_size);
+    auto scheduler =
+            boost::asynchronous::make_shared_scheduler_proxy<boost::asynchronous::composite_threadpool_scheduler<>> (pool);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::future<void>> fus;
+    for (auto i=0; i< LOOP_COUNT; ++i)
+    {
+        auto fu = boost::asynchronous::post_future(scheduler,
+                   []()mutable
+                   {
+                   });
+        fus.emplace_back(std::move(fu));
+    }
+    auto post_time = (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count() / 1000);
+    boost::wait_for_all(fus.begin(), fus.end());
+    std::cout << "test_callable_stealing_multiqueue_threadpool_scheduler_lockfree_ring, average post in us: " << post_time / LOOP_COUNT <<std::endl;
+}
+
+void test_loggable_multiqueue_threadpool_scheduler_lockfree_ring(long tpsize,long queue_size)
+{
+    typedef boost::asynchronous::any_loggable servant_job;
+
+    boost::asynchronous::any_shared_scheduler_proxy<servant_job> scheduler =  boost::asynchronous::make_shared_scheduler_proxy<
+            boost::asynchronous::multiqueue_threadpool_scheduler<
+                    boost::asynchronous::lockfree_ring_queue<servant_job>
+                >>(tpsize,queue_size);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::future<void>> fus;
+    for (auto i=0; i< LOOP_COUNT; ++i)
+    {
+        auto fu = boost::asynchronous::post_future(scheduler,
+                   []()mutable
+                   {
+                   },"loooooooooooooooooonnnnnnnnnnnnnnngggggggggggggggggg",0);
+        fus.emplace_back(std::move(fu));
+    }
+    auto post_time = (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count() / 1000);
+    boost::wait_for_all(fus.begin(), fus.end());
+    std::cout << "test_loggable_multiqueue_threadpool_scheduler_lockfree_ring, average post in us: " << post_time / LOOP_COUNT <<std::endl;
+}
+
 void test_loggable_multiqueue_threadpool_scheduler_lockfree(long tpsize,long queue_size)
 {
     typedef boost::asynchronous::any_loggable servant_job;
@@ -268,7 +388,12 @@ int main( int argc, const char *argv[] )
     std::cout << "queue size=" << queue_size << std::endl;
 
     test_callable_multiqueue_threadpool_scheduler_lockfree(tpsize,queue_size);
+    test_callable_typed_multiqueue_threadpool_scheduler_lockfree(tpsize,queue_size);
+    test_callable_multiqueue_threadpool_scheduler_lockfree_ring(tpsize,queue_size);
+    test_callable_stealing_multiqueue_threadpool_scheduler_lockfree(tpsize,queue_size);
+    test_callable_stealing_multiqueue_threadpool_scheduler_lockfree_ring(tpsize,queue_size);
     test_loggable_multiqueue_threadpool_scheduler_lockfree(tpsize,queue_size);
+    test_loggable_multiqueue_threadpool_scheduler_lockfree_ring(tpsize,queue_size);
     test_loggable_composite_threadpool_scheduler_lockfree(tpsize,queue_size);
     test_servant_post_time(tpsize,queue_size);
     test_servant_post_time_log(tpsize,queue_size);
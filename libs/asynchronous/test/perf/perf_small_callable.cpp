@@ -0,0 +1,121 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+// compares posting with any_callable and small_callable as job type: posts/s and heap allocations per post
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <future>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <boost/thread/future.hpp> // for wait_for_all
+
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/queue/lockfree_ring_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/small_callable.hpp>
+#include <boost/asynchronous/post.hpp>
+
+using namespace std;
+#define LOOP_COUNT 1000000
+
+// count every heap allocation of the process
+std::atomic<std::size_t> allocations(0);
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* p = std::malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+template <class Job, class Queue>
+void test_post(std::string const& name, long tpsize,long queue_size)
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+            boost::asynchronous::multiqueue_threadpool_scheduler<Queue>>(tpsize,queue_size);
+    std::shared_ptr<std::atomic<long>> counter = std::make_shared<std::atomic<long>>(0);
+    std::promise<void> done;
+    auto fu = done.get_future();
+    std::promise<void>* pdone = &done;
+
+    std::size_t alloc_before = allocations.load();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (auto i=0; i< LOOP_COUNT; ++i)
+    {
+        // a typical small closure: a few captured pointers
+        scheduler.post(Job([counter,pdone]()
+                           {
+                               if (++(*counter) == LOOP_COUNT)
+                                   pdone->set_value();
+                           }));
+    }
+    auto post_time = std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count();
+    fu.get();
+    std::size_t alloc_count = allocations.load() - alloc_before;
+    std::cout << name << " post: " << (LOOP_COUNT * 1000000000.0 / post_time) << " posts/s, "
+              << ((double)alloc_count / LOOP_COUNT) << " allocations per post" << std::endl;
+}
+
+template <class Job, class Queue>
+void test_post_future(std::string const& name, long tpsize,long queue_size)
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+            boost::asynchronous::multiqueue_threadpool_scheduler<Queue>>(tpsize,queue_size);
+    std::vector<std::future<int>> fus;
+    fus.reserve(LOOP_COUNT);
+
+    std::size_t alloc_before = allocations.load();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (auto i=0; i< LOOP_COUNT; ++i)
+    {
+        fus.emplace_back(boost::asynchronous::post_future(scheduler,[i](){return i;}));
+    }
+    auto post_time = std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count();
+    boost::wait_for_all(fus.begin(), fus.end());
+    std::size_t alloc_count = allocations.load() - alloc_before;
+    // the promise / future shared state accounts for one allocation per post
+    std::cout << name << " post_future: " << (LOOP_COUNT * 1000000000.0 / post_time) << " posts/s, "
+              << ((double)alloc_count / LOOP_COUNT) << " allocations per post" << std::endl;
+}
+
+int main( int argc, const char *argv[] )
+{
+    long tpsize = (argc>1) ? strtol(argv[1],0,0) : boost::thread::hardware_concurrency();
+    long queue_size = (argc>2) ? strtol(argv[2],0,0) : 1024;
+    std::cout << "tpsize=" << tpsize << std::endl;
+    std::cout << "queue size=" << queue_size << std::endl;
+
+    test_post<boost::asynchronous::any_callable,
+              boost::asynchronous::lockfree_queue<boost::asynchronous::any_callable>>("any_callable/lockfree_queue",tpsize,queue_size);
+    test_post<boost::asynchronous::small_callable,
+              boost::asynchronous::lockfree_queue<boost::asynchronous::small_callable>>("small_callable/lockfree_queue",tpsize,queue_size);
+    test_post<boost::asynchronous::small_callable,
+              boost::asynchronous::lockfree_ring_queue<boost::asynchronous::small_callable>>("small_callable/lockfree_ring_queue",tpsize,queue_size);
+
+    test_post_future<boost::asynchronous::any_callable,
+                     boost::asynchronous::lockfree_queue<boost::asynchronous::any_callable>>("any_callable/lockfree_queue",tpsize,queue_size);
+    test_post_future<boost::asynchronous::small_callable,
+                     boost::asynchronous::lockfree_queue<boost::asynchronous::small_callable>>("small_callable/lockfree_queue",tpsize,queue_size);
+    test_post_future<boost::asynchronous::small_callable,
+                     boost::asynchronous::lockfree_ring_queue<boost::asynchronous::small_callable>>("small_callable/lockfree_ring_queue",tpsize,queue_size);
+    return 0;
+}
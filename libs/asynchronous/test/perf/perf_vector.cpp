@@ -1,10 +1,13 @@
 #include <iostream>
+#include <mutex>
 #include <vector>
 
 #include <boost/asynchronous/queue/lockfree_queue.hpp>
 #include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
 #include <boost/asynchronous/scheduler_shared_proxy.hpp>
 #include <boost/asynchronous/container/vector.hpp>
+#include <boost/asynchronous/container/segmented_vector.hpp>
+#include <boost/asynchronous/post.hpp>
 
 using namespace std;
 
@@ -163,5 +166,134 @@ int main( int argc, const char *argv[] )
     std::cout << "Resize of boost::asynchronous::vector<LongOne>(" << asyncv.size() << ") took in ms: " << duration2 << std::endl;
     std::cout << "speedup asynchronous: " << duration1 / duration2 << std::endl << std::endl;
 
+    // release memory before push_back tests
+    stdv = std::vector<LongOne>();
+    stdv2 = std::vector<LongOne>();
+    asyncv.clear();
+    asyncv.shrink_to_fit();
+    asyncv2.shrink_to_fit();
+
+    // push_back of many small vectors std
+    const std::size_t small_vectors = 1000;
+    const std::size_t small_size = 1000;
+    duration1=0.0;
+    start = std::chrono::high_resolution_clock::now();
+    for (std::size_t i = 0; i < small_vectors; ++i)
+    {
+        std::vector<LongOne> v;
+        for (std::size_t j = 0; j < small_size; ++j)
+        {
+            v.push_back(LongOne((int)j));
+        }
+    }
+    duration1 = (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count() / 1000000);
+    std::cout << "push_back into " << small_vectors << " std::vector<LongOne>(" << small_size << ") took in ms: " << duration1 << std::endl;
+
+    // push_back of many small vectors asynchronous
+    duration2=0.0;
+    start = std::chrono::high_resolution_clock::now();
+    for (std::size_t i = 0; i < small_vectors; ++i)
+    {
+        boost::asynchronous::vector<LongOne> v(pool,vec_size/tasks);
+        for (std::size_t j = 0; j < small_size; ++j)
+        {
+            v.push_back(LongOne((int)j));
+        }
+    }
+    duration2 = (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count() / 1000000);
+    std::cout << "push_back into " << small_vectors << " boost::asynchronous::vector<LongOne>(" << small_size << ") took in ms: " << duration2 << std::endl;
+    std::cout << "speedup asynchronous: " << duration1 / duration2 << std::endl << std::endl;
+
+    // push_back of a large vector std
+    duration1=0.0;
+    start = std::chrono::high_resolution_clock::now();
+    {
+        std::vector<LongOne> v;
+        for (std::size_t j = 0; j < vec_size; ++j)
+        {
+            v.push_back(LongOne((int)j));
+        }
+    }
+    duration1 = (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count() / 1000000);
+    std::cout << "push_back into std::vector<LongOne>(" << vec_size << ") took in ms: " << duration1 << std::endl;
+
+    // push_back of a large vector asynchronous
+    duration2=0.0;
+    start = std::chrono::high_resolution_clock::now();
+    {
+        boost::asynchronous::vector<LongOne> v(pool,vec_size/tasks);
+        for (std::size_t j = 0; j < vec_size; ++j)
+        {
+            v.push_back(LongOne((int)j));
+        }
+    }
+    duration2 = (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count() / 1000000);
+    std::cout << "push_back into boost::asynchronous::vector<LongOne>(" << vec_size << ") took in ms: " << duration2 << std::endl;
+    std::cout << "speedup asynchronous: " << duration1 / duration2 << std::endl << std::endl;
+
+    // collect results of many tasks into a std::vector protected by a mutex
+    const std::size_t per_task = vec_size / tasks;
+    duration1=0.0;
+    start = std::chrono::high_resolution_clock::now();
+    {
+        std::mutex m;
+        std::vector<LongOne> v;
+        std::vector<std::future<void>> fus;
+        for (long t = 0; t < tasks; ++t)
+        {
+            fus.push_back(boost::asynchronous::post_future(pool,[&m,&v,per_task]()
+            {
+                for (std::size_t j = 0; j < per_task; ++j)
+                {
+                    LongOne l((int)j);
+                    std::lock_guard<std::mutex> lock(m);
+                    v.push_back(std::move(l));
+                }
+            }));
+        }
+        for (auto& fu : fus)
+        {
+            fu.get();
+        }
+    }
+    duration1 = (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count() / 1000000);
+    std::cout << "collect from " << tasks << " tasks into std::vector<LongOne>(" << per_task * tasks << ") took in ms: " << duration1 << std::endl;
+
+    // collect results of many tasks with a segmented_collector, then flatten
+    duration2=0.0;
+    start = std::chrono::high_resolution_clock::now();
+    {
+        auto collector = std::make_shared<boost::asynchronous::segmented_collector<LongOne>>();
+        std::vector<std::future<void>> fus;
+        for (long t = 0; t < tasks; ++t)
+        {
+            fus.push_back(boost::asynchronous::post_future(pool,[collector,per_task]()
+            {
+                auto appender = collector->make_appender();
+                for (std::size_t j = 0; j < per_task; ++j)
+                {
+                    appender.push_back(LongOne((int)j));
+                }
+            }));
+        }
+        for (auto& fu : fus)
+        {
+            fu.get();
+        }
+        duration2 = (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count() / 1000000);
+        std::cout << "collect from " << tasks << " tasks with segmented_collector<LongOne>(" << per_task * tasks << ") took in ms: " << duration2 << std::endl;
+        std::cout << "speedup segmented: " << duration1 / duration2 << std::endl;
+
+        // flatten into a boost::asynchronous::vector
+        start = std::chrono::high_resolution_clock::now();
+        auto fu = boost::asynchronous::post_future(pool,[collector]()
+        {
+            return boost::asynchronous::parallel_flatten(collector->take(),vec_size/tasks);
+        });
+        auto flat = fu.get();
+        duration2 = (std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start).count() / 1000000);
+        std::cout << "parallel_flatten into boost::asynchronous::vector<LongOne>(" << flat.size() << ") took in ms: " << duration2 << std::endl << std::endl;
+    }
+
     return 0;
 }
@@ -0,0 +1,141 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+// TCP ping-pong over loopback against an echo server running in an asio_scheduler, with a pause between pings
+// so that the scheduler becomes idle. Compares round trip latencies (p50 / p99) and idle CPU of the CPULoad policies.
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <future>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <ctime>
+
+#include <boost/asynchronous/extensions/asio/asio_scheduler.hpp>
+#include <boost/asynchronous/scheduler/cpu_load_policies.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/post.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+#define PING_COUNT 300
+// pause between two pings, long enough for the scheduler to become idle
+#define PAUSE_US 2000
+#define IDLE_MS 1000
+
+struct echo_session : std::enable_shared_from_this<echo_session>
+{
+    echo_session(boost::asio::io_service& ios): m_acceptor(ios), m_socket(ios){}
+    void start(std::promise<unsigned short>& port)
+    {
+        boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(),0);
+        m_acceptor.open(endpoint.protocol());
+        m_acceptor.bind(endpoint);
+        m_acceptor.listen();
+        port.set_value(m_acceptor.local_endpoint().port());
+        auto self = shared_from_this();
+        m_acceptor.async_accept(m_socket,[self](boost::system::error_code const& ec)
+        {
+            if (!ec)
+            {
+                self->m_socket.set_option(boost::asio::ip::tcp::no_delay(true));
+                self->read();
+            }
+        });
+    }
+    void read()
+    {
+        auto self = shared_from_this();
+        m_socket.async_read_some(boost::asio::buffer(&m_byte,1),[self](boost::system::error_code const& ec, std::size_t)
+        {
+            if (!ec)
+                self->write();
+        });
+    }
+    void write()
+    {
+        auto self = shared_from_this();
+        boost::asio::async_write(m_socket,boost::asio::buffer(&m_byte,1),[self](boost::system::error_code const& ec, std::size_t)
+        {
+            if (!ec)
+                self->read();
+        });
+    }
+    boost::asio::ip::tcp::acceptor m_acceptor;
+    boost::asio::ip::tcp::socket m_socket;
+    char m_byte;
+};
+
+template <class CPULoad>
+void ping_pong(std::string const& name)
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+            boost::asynchronous::asio_scheduler<
+                boost::asynchronous::default_find_position<>,CPULoad>>(1);
+
+    std::promise<unsigned short> port;
+    auto fu_port = port.get_future();
+    boost::asynchronous::post_future(scheduler,[&port]()
+    {
+        std::make_shared<echo_session>(*boost::asynchronous::get_io_service<>())->start(port);
+    }).get();
+
+    boost::asio::io_service client_ios;
+    boost::asio::ip::tcp::socket client(client_ios);
+    client.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(),fu_port.get()));
+    client.set_option(boost::asio::ip::tcp::no_delay(true));
+
+    std::vector<long> latencies;
+    latencies.reserve(PING_COUNT);
+    bool echoed = true;
+    for (int i = 0; i < PING_COUNT; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(PAUSE_US));
+        char ping = (char)i;
+        char pong = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        boost::asio::write(client,boost::asio::buffer(&ping,1));
+        boost::asio::read(client,boost::asio::buffer(&pong,1));
+        latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::high_resolution_clock::now() - start).count());
+        echoed = echoed && (pong == ping);
+    }
+    BOOST_CHECK_MESSAGE(echoed,name << ": wrong echo");
+    std::sort(latencies.begin(),latencies.end());
+
+    // let the scheduler do nothing and measure how much CPU it needs for this
+    std::clock_t cpu_start = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_MS));
+    double idle_cpu = 100.0 * (std::clock() - cpu_start) / CLOCKS_PER_SEC / (IDLE_MS / 1000.0);
+
+    std::cout << name << ": round trip p50: " << latencies[PING_COUNT / 2] / 1000.0 << " us"
+              << ", p99: " << latencies[PING_COUNT * 99 / 100] / 1000.0 << " us"
+              << ", idle CPU: " << idle_cpu << "% of one core" << std::endl;
+    client.close();
+}
+}
+
+BOOST_AUTO_TEST_CASE( test_asio_ping_pong_blocking_reactor )
+{
+    ping_pong<boost::asynchronous::blocking_reactor_cpu_load<>>("blocking_reactor_cpu_load");
+}
+
+BOOST_AUTO_TEST_CASE( test_asio_ping_pong_default_save_cpu_load )
+{
+    ping_pong<boost::asynchronous::default_save_cpu_load<>>("default_save_cpu_load");
+}
+
+BOOST_AUTO_TEST_CASE( test_asio_ping_pong_no_cpu_load_saving )
+{
+    ping_pong<boost::asynchronous::no_cpu_load_saving>("no_cpu_load_saving");
+}
@@ -0,0 +1,180 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include <random>
+#include <chrono>
+
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/post.hpp>
+#include <boost/asynchronous/algorithm/parallel_for.hpp>
+#include <boost/asynchronous/algorithm/parallel_reduce.hpp>
+#include <boost/asynchronous/algorithm/parallel_transform.hpp>
+#include <boost/asynchronous/algorithm/parallel_sort.hpp>
+#include <boost/asynchronous/algorithm/parallel_scan.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+typedef std::vector<int>::iterator Iterator;
+
+struct increment
+{
+    void operator()(int& i)const
+    {
+        ++i;
+    }
+};
+// about 5us per element
+struct slow_increment
+{
+    void operator()(int& i)const
+    {
+        auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < std::chrono::microseconds(5));
+        ++i;
+    }
+};
+template <class Func>
+long learnt_cutoff()
+{
+    return boost::asynchronous::detail::adaptive_cutoff<
+            boost::asynchronous::detail::parallel_for_helper<Iterator,Func,BOOST_ASYNCHRONOUS_DEFAULT_JOB>>::value().load();
+}
+struct test_tag{};
+}
+
+BOOST_AUTO_TEST_CASE( test_auto_cutoff_record )
+{
+    typedef boost::asynchronous::detail::adaptive_cutoff<test_tag> cutoff;
+    cutoff::value() = 1000;
+    // 1us per element, target is 100 elements, but at most halved per leaf task
+    cutoff::record(1000,std::chrono::milliseconds(1));
+    BOOST_CHECK_MESSAGE(cutoff::value().load() == 500,"cutoff should be halved, is " << cutoff::value().load());
+    cutoff::record(500,std::chrono::microseconds(500));
+    cutoff::record(250,std::chrono::microseconds(250));
+    cutoff::record(125,std::chrono::microseconds(125));
+    BOOST_CHECK_MESSAGE(cutoff::value().load() == 100,"cutoff should reach the target, is " << cutoff::value().load());
+    // cheap elements, at most doubled per leaf task
+    cutoff::record(100,std::chrono::nanoseconds(100));
+    BOOST_CHECK_MESSAGE(cutoff::value().load() == 200,"cutoff should be doubled, is " << cutoff::value().load());
+    // a fixed cutoff is left alone
+    BOOST_CHECK_MESSAGE(boost::asynchronous::detail::effective_cutoff<test_tag>(42) == 42,"fixed cutoff changed");
+    BOOST_CHECK_MESSAGE(boost::asynchronous::detail::effective_cutoff<test_tag>(boost::asynchronous::auto_cutoff) == 200,
+                        "auto_cutoff should use the learnt cutoff");
+}
+
+BOOST_AUTO_TEST_CASE( test_auto_cutoff_adapts )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>>>(3);
+    std::vector<int> data(2000000,0);
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+        auto fu = boost::asynchronous::post_future(scheduler,
+                    [&data]()
+                    {
+                        return boost::asynchronous::parallel_for(data.begin(),data.end(),increment(),boost::asynchronous::auto_cutoff);
+                    });
+        fu.get();
+    }
+    BOOST_CHECK_MESSAGE(std::all_of(data.begin(),data.end(),[](int i){return i == 3;}),"parallel_for failed");
+    BOOST_CHECK_MESSAGE(learnt_cutoff<increment>() > BOOST_ASYNCHRONOUS_AUTO_CUTOFF_INITIAL,
+                        "cheap elements should give a bigger cutoff, got " << learnt_cutoff<increment>());
+
+    std::vector<int> data2(20000,0);
+    auto fu = boost::asynchronous::post_future(scheduler,
+                [&data2]()
+                {
+                    return boost::asynchronous::parallel_for(data2.begin(),data2.end(),slow_increment(),boost::asynchronous::auto_cutoff);
+                });
+    fu.get();
+    BOOST_CHECK_MESSAGE(std::all_of(data2.begin(),data2.end(),[](int i){return i == 1;}),"parallel_for failed");
+    BOOST_CHECK_MESSAGE(learnt_cutoff<slow_increment>() < BOOST_ASYNCHRONOUS_AUTO_CUTOFF_INITIAL,
+                        "expensive elements should give a smaller cutoff, got " << learnt_cutoff<slow_increment>());
+}
+
+BOOST_AUTO_TEST_CASE( test_auto_cutoff_algorithms )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>>>(3);
+    std::vector<int> data(100000);
+    std::mt19937 mt(42);
+    std::uniform_int_distribution<> dis(0, 1000);
+    std::generate(data.begin(), data.end(), std::bind(dis, std::ref(mt)));
+    // run several times so that leaf tasks run with a learnt cutoff too
+    for (int round = 0 ; round < 3 ; ++round)
+    {
+        auto fu_reduce = boost::asynchronous::post_future(scheduler,
+                    [&data]()
+                    {
+                        return boost::asynchronous::parallel_reduce(data.begin(),data.end(),
+                                                                    [](int a, int b){return a + b;},
+                                                                    boost::asynchronous::auto_cutoff);
+                    });
+        BOOST_CHECK_MESSAGE(fu_reduce.get() == std::accumulate(data.begin(),data.end(),0),"parallel_reduce gave a wrong value");
+
+        std::vector<int> transformed(data.size());
+        auto fu_transform = boost::asynchronous::post_future(scheduler,
+                    [&data,&transformed]()
+                    {
+                        return boost::asynchronous::parallel_transform(data.begin(),data.end(),transformed.begin(),
+                                                                       [](int i){return 2 * i;},
+                                                                       boost::asynchronous::auto_cutoff);
+                    });
+        fu_transform.get();
+        BOOST_CHECK_MESSAGE(std::equal(data.begin(),data.end(),transformed.begin(),[](int i, int j){return j == 2 * i;}),
+                            "parallel_transform gave a wrong value");
+
+        std::vector<int> scanned(data.size());
+        auto fu_scan = boost::asynchronous::post_future(scheduler,
+                    [&data,&scanned]()
+                    {
+                        return boost::asynchronous::parallel_scan(data.begin(),data.end(),scanned.begin(),0,
+                                                                  [](Iterator beg, Iterator end)
+                                                                  {
+                                                                      return std::accumulate(beg,end,0);
+                                                                  },
+                                                                  std::plus<int>(),
+                                                                  [](Iterator beg, Iterator end, Iterator out, int init) mutable
+                                                                  {
+                                                                      for (;beg != end; ++beg)
+                                                                      {
+                                                                          init = *beg + init;
+                                                                          *out++ = init;
+                                                                      };
+                                                                  },
+                                                                  boost::asynchronous::auto_cutoff);
+                    });
+        fu_scan.get();
+        std::vector<int> expected_scan(data.size());
+        std::partial_sum(data.begin(),data.end(),expected_scan.begin());
+        BOOST_CHECK_MESSAGE(scanned == expected_scan,"parallel_scan gave a wrong value");
+
+        std::vector<int> sorted = data;
+        auto fu_sort = boost::asynchronous::post_future(scheduler,
+                    [&sorted]()
+                    {
+                        return boost::asynchronous::parallel_sort(sorted.begin(),sorted.end(),std::less<int>(),
+                                                                  boost::asynchronous::auto_cutoff);
+                    });
+        fu_sort.get();
+        std::vector<int> expected_sort = data;
+        std::sort(expected_sort.begin(),expected_sort.end());
+        BOOST_CHECK_MESSAGE(sorted == expected_sort,"parallel_sort gave a wrong value");
+    }
+}
@@ -0,0 +1,212 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#include <tuple>
+#include <future>
+#include <atomic>
+#include <stdexcept>
+
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/post.hpp>
+#include <boost/asynchronous/continuation_task.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+// number of continuations added to the waiting list by create_continuation
+std::atomic<std::size_t> polled_continuations(0);
+
+long serial_fib(long n)
+{
+    return (n < 2) ? n : serial_fib(n-1) + serial_fib(n-2);
+}
+
+struct fib_task : public boost::asynchronous::continuation_task<long>
+{
+    fib_task(long n,long cutoff):boost::asynchronous::continuation_task<long>("fib_task"),n_(n),cutoff_(cutoff){}
+    void operator()()const
+    {
+        boost::asynchronous::continuation_result<long> task_res = this_task_result();
+        if (n_ < cutoff_)
+        {
+            task_res.set_value(serial_fib(n_));
+        }
+        else
+        {
+            std::size_t waiting = boost::asynchronous::get_continuations().size();
+            boost::asynchronous::create_continuation(
+                        [task_res](std::tuple<std::future<long>,std::future<long> > res)
+                        {
+                            try
+                            {
+                                task_res.set_value(std::get<0>(res).get() + std::get<1>(res).get());
+                            }
+                            catch(...)
+                            {
+                                task_res.set_exception(std::current_exception());
+                            }
+                        },
+                        fib_task(n_-1,cutoff_),
+                        fib_task(n_-2,cutoff_));
+            polled_continuations += boost::asynchronous::get_continuations().size() - waiting;
+        }
+    }
+    long n_;
+    long cutoff_;
+};
+
+struct throwing_task : public boost::asynchronous::continuation_task<int>
+{
+    void operator()()const
+    {
+        boost::asynchronous::continuation_result<int> task_res = this_task_result();
+        task_res.set_exception(std::make_exception_ptr(std::runtime_error("sub-task failed")));
+    }
+};
+// throws instead of setting its result
+struct escaping_exception_task : public boost::asynchronous::continuation_task<int>
+{
+    void operator()()const
+    {
+        throw std::runtime_error("sub-task threw");
+    }
+};
+struct void_task : public boost::asynchronous::continuation_task<void>
+{
+    void operator()()const
+    {
+        this_task_result().set_value();
+    }
+};
+}
+
+BOOST_AUTO_TEST_CASE( test_continuation_push_fibonacci )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>>>(3);
+    polled_continuations = 0;
+    auto fu = boost::asynchronous::post_future(scheduler,
+                []()
+                {
+                    return boost::asynchronous::top_level_continuation<long>(fib_task(25,10));
+                });
+    BOOST_CHECK_MESSAGE(fu.get() == serial_fib(25),"wrong fibonacci result");
+    // sub-tasks notify their continuation, nothing had to be polled
+    BOOST_CHECK_MESSAGE(polled_continuations.load() == 0,"continuations were added to the waiting list");
+}
+
+BOOST_AUTO_TEST_CASE( test_continuation_push_exception_and_void )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>>>(3);
+    auto fu = boost::asynchronous::post_future(scheduler,
+                []()
+                {
+                    return boost::asynchronous::top_level_continuation<int>(
+                        boost::asynchronous::make_top_level_lambda_continuation<int>(
+                        [](boost::asynchronous::continuation_result<int> task_res)
+                        {
+                            std::size_t waiting = boost::asynchronous::get_continuations().size();
+                            boost::asynchronous::create_continuation(
+                                [task_res](std::tuple<std::future<int>,std::future<void> > res)
+                                {
+                                    bool void_ok = true;
+                                    try
+                                    {
+                                        std::get<1>(res).get();
+                                    }
+                                    catch(...)
+                                    {
+                                        void_ok = false;
+                                    }
+                                    BOOST_CHECK_MESSAGE(void_ok,"void sub-task failed");
+                                    try
+                                    {
+                                        std::get<0>(res).get();
+                                        task_res.set_value(0);
+                                    }
+                                    catch(std::runtime_error&)
+                                    {
+                                        task_res.set_value(42);
+                                    }
+                                },
+                                throwing_task(),void_task());
+                            BOOST_CHECK_MESSAGE(boost::asynchronous::get_continuations().size() == waiting,"continuation should not be polled");
+                        }));
+                });
+    BOOST_CHECK_MESSAGE(fu.get() == 42,"exception not forwarded to continuation");
+}
+
+BOOST_AUTO_TEST_CASE( test_continuation_push_throwing_subtask )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>>>(3);
+    auto fu = boost::asynchronous::post_future(scheduler,
+                []()
+                {
+                    return boost::asynchronous::top_level_continuation<int>(
+                        boost::asynchronous::make_top_level_lambda_continuation<int>(
+                        [](boost::asynchronous::continuation_result<int> task_res)
+                        {
+                            boost::asynchronous::create_continuation(
+                                [task_res](std::tuple<std::future<int>,std::future<void> > res)
+                                {
+                                    try
+                                    {
+                                        std::get<1>(res).get();
+                                        std::get<0>(res).get();
+                                        task_res.set_value(0);
+                                    }
+                                    catch(std::runtime_error&)
+                                    {
+                                        task_res.set_value(42);
+                                    }
+                                    catch(...)
+                                    {
+                                        task_res.set_value(-1);
+                                    }
+                                },
+                                escaping_exception_task(),void_task());
+                        }));
+                });
+    BOOST_CHECK_MESSAGE(fu.get() == 42,"exception thrown by sub-task not forwarded to continuation");
+}
+
+BOOST_AUTO_TEST_CASE( test_continuation_timeout_still_polled )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>>>(3);
+    auto fu = boost::asynchronous::post_future(scheduler,
+                []()
+                {
+                    return boost::asynchronous::top_level_continuation<long>(
+                        boost::asynchronous::make_top_level_lambda_continuation<long>(
+                        [](boost::asynchronous::continuation_result<long> task_res)
+                        {
+                            std::size_t waiting = boost::asynchronous::get_continuations().size();
+                            boost::asynchronous::create_continuation_timeout(
+                                [task_res](std::tuple<std::future<long>,std::future<long> > res)
+                                {
+                                    task_res.set_value(std::get<0>(res).get() + std::get<1>(res).get());
+                                },
+                                std::chrono::milliseconds(10000),
+                                fib_task(10,5),fib_task(11,5));
+                            // timeouts are checked by the scheduler
+                            BOOST_CHECK_MESSAGE(boost::asynchronous::get_continuations().size() == waiting + 1,"timeout continuation should be polled");
+                        }));
+                });
+    BOOST_CHECK_MESSAGE(fu.get() == serial_fib(10) + serial_fib(11),"wrong result");
+}
@@ -0,0 +1,169 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <future>
+
+#include <boost/asynchronous/diagnostics/diagnostics_ring_table.hpp>
+#include <boost/asynchronous/diagnostics/diagnostic_item.hpp>
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/post.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+typedef boost::asynchronous::diagnostics_ring_table<std::string,boost::asynchronous::diagnostic_item> table_type;
+
+boost::asynchronous::diagnostic_item make_item(bool failed=false)
+{
+    auto now = boost::asynchronous::diagnostic_item::Clock::now();
+    return boost::asynchronous::diagnostic_item(now,now,now,false,failed,boost::this_thread::get_id());
+}
+}
+
+BOOST_AUTO_TEST_CASE( test_diagnostics_ring_table_add )
+{
+    table_type table(2,16);
+    table.add("a",make_item());
+    table.add("b",make_item(true));
+    table.add("a",make_item());
+    auto res = table.get_map();
+    BOOST_CHECK_MESSAGE(res.size() == 2,"expected 2 job names, got " << res.size());
+    BOOST_CHECK_MESSAGE(res["a"].size() == 2,"expected 2 jobs a, got " << res["a"].size());
+    BOOST_CHECK_MESSAGE(res["b"].size() == 1,"expected 1 job b, got " << res["b"].size());
+    BOOST_CHECK_MESSAGE(res["b"].front().is_failed(),"job b should have failed");
+    BOOST_CHECK_MESSAGE(table.dropped() == 0,"nothing should be dropped");
+
+    table.clear();
+    BOOST_CHECK_MESSAGE(table.get_map().empty(),"table should be empty after clear");
+    table.add("c",make_item());
+    res = table.get_map();
+    BOOST_CHECK_MESSAGE(res.size() == 1 && res["c"].size() == 1,"expected only job c after clear");
+}
+
+BOOST_AUTO_TEST_CASE( test_diagnostics_ring_table_retention )
+{
+    table_type table(1,16);
+    for (int i = 0; i < 20; ++i)
+    {
+        table.add("old",make_item());
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        table.add("new",make_item());
+    }
+    auto res = table.get_map();
+    BOOST_CHECK_MESSAGE(res["new"].size() == 10,"expected 10 new jobs, got " << res["new"].size());
+    BOOST_CHECK_MESSAGE(res["old"].size() == 6,"expected 6 old jobs, got " << res["old"].size());
+    BOOST_CHECK_MESSAGE(table.dropped() == 14,"expected 14 dropped jobs, got " << table.dropped());
+    table.clear();
+    BOOST_CHECK_MESSAGE(table.dropped() == 0,"clear should reset the drop counter");
+}
+
+BOOST_AUTO_TEST_CASE( test_diagnostics_ring_table_current )
+{
+    table_type table(2,16);
+    table.set_current(1,"running",make_item());
+    auto current = table.get_current();
+    BOOST_CHECK_MESSAGE(current.size() == 2,"expected one current job per thread");
+    BOOST_CHECK_MESSAGE(current[0].first.empty(),"thread 0 should be idle");
+    BOOST_CHECK_MESSAGE(current[1].first == "running","thread 1 should run job running");
+    table.reset_current(1);
+    current = table.get_current();
+    BOOST_CHECK_MESSAGE(current[1].first.empty(),"thread 1 should be idle");
+}
+
+BOOST_AUTO_TEST_CASE( test_diagnostics_ring_table_threads )
+{
+    // more threads than rings, the last ones share a ring.
+    // Threads stay alive until all are done, an ended thread would give its ring back
+    table_type table(2,1000);
+    std::atomic<int> done(0);
+    std::vector<boost::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&table,&done,t]()
+        {
+            for (int i = 0; i < 500; ++i)
+            {
+                table.add("job" + std::to_string(t),make_item());
+            }
+            ++done;
+            while (done.load() < 4)
+            {
+                boost::this_thread::yield();
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    auto res = table.get_map();
+    std::size_t total = 0;
+    for (auto const& jobs : res)
+    {
+        total += jobs.second.size();
+    }
+    // 2 rings for 500 jobs each, a shared one keeping 1000 of 1000
+    BOOST_CHECK_MESSAGE(total == 2000,"expected 2000 jobs, got " << total);
+    BOOST_CHECK_MESSAGE(table.dropped() == 0,"nothing should be dropped, got " << table.dropped());
+}
+
+BOOST_AUTO_TEST_CASE( test_diagnostics_ring_table_ring_reuse )
+{
+    // threads one after the other, each gets the ring of the ended one instead of the shared ring
+    table_type table(1,4);
+    for (int t = 0; t < 3; ++t)
+    {
+        boost::thread thread([&table,t]()
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                table.add("job" + std::to_string(t),make_item());
+            }
+        });
+        thread.join();
+    }
+    auto res = table.get_map();
+    BOOST_CHECK_MESSAGE(res.size() == 1 && res["job2"].size() == 4,"expected only the jobs of the last thread");
+    BOOST_CHECK_MESSAGE(table.dropped() == 8,"expected 8 dropped jobs, got " << table.dropped());
+}
+
+BOOST_AUTO_TEST_CASE( test_diagnostics_ring_table_scheduler )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<boost::asynchronous::any_loggable>>>(2);
+    std::vector<std::future<void>> fus;
+    for (int i = 0; i < 10; ++i)
+    {
+        fus.push_back(boost::asynchronous::post_future(scheduler,[](){},"ring_job"));
+    }
+    for (auto& fu : fus)
+    {
+        fu.get();
+    }
+    auto diag = scheduler.get_diagnostics();
+    auto it = diag.totals().find("ring_job");
+    // the future is set before the job is added to the diagnostics, give the last one a bit of time
+    for (int i = 0; i < 100 && (it == diag.totals().end() || (*it).second.size() < 10); ++i)
+    {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+        diag = scheduler.get_diagnostics();
+        it = diag.totals().find("ring_job");
+    }
+    BOOST_CHECK_MESSAGE(it != diag.totals().end() && (*it).second.size() == 10,"expected 10 ring_job");
+    BOOST_CHECK_MESSAGE(diag.dropped() == 0,"nothing should be dropped");
+}
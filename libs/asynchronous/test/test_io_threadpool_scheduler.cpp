@@ -11,6 +11,7 @@
 #include <vector>
 #include <set>
 #include <future>
+#include <atomic>
 
 #include <boost/asynchronous/scheduler/single_thread_scheduler.hpp>
 #include <boost/asynchronous/queue/lockfree_queue.hpp>
@@ -19,6 +20,7 @@
 
 #include <boost/asynchronous/servant_proxy.hpp>
 #include <boost/asynchronous/post.hpp>
+#include <boost/asynchronous/continuation_task.hpp>
 #include <boost/asynchronous/trackable_servant.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -246,3 +248,156 @@ BOOST_AUTO_TEST_CASE( test_io_threadpool_many_tasks )
     BOOST_CHECK_MESSAGE(dtor_called,"servant dtor not called.");
 }
 
+
+namespace
+{
+// posts n jobs blocking until all of them started, returns the ids of the threads which executed them
+template <class Scheduler>
+std::set<boost::thread::id> run_blocking_burst(Scheduler& scheduler, std::size_t n)
+{
+    std::shared_ptr<std::atomic<std::size_t>> started = std::make_shared<std::atomic<std::size_t>>(0);
+    std::vector<std::future<boost::thread::id>> fus;
+    for (std::size_t i = 0; i < n ; ++i)
+    {
+        fus.push_back(boost::asynchronous::post_future(scheduler,
+                        [started,n]()
+                        {
+                            ++*started;
+                            while (started->load() < n)
+                            {
+                                boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+                            }
+                            return boost::this_thread::get_id();
+                        }));
+    }
+    std::set<boost::thread::id> ids;
+    for (auto& fu : fus)
+    {
+        ids.insert(fu.get());
+    }
+    return ids;
+}
+}
+
+BOOST_AUTO_TEST_CASE( test_io_threadpool_keep_alive )
+{
+    // temporary threads stay 200ms after their last job
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::io_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>,
+                            boost::asynchronous::no_cpu_load_saving,200>>(1,4);
+    auto ids = run_blocking_burst(scheduler,4);
+    BOOST_CHECK_MESSAGE(ids.size() == 4,"incorrect number of workers: " << ids.size());
+    // a second burst is served by the parked threads, none is created
+    auto ids2 = run_blocking_burst(scheduler,4);
+    BOOST_CHECK_MESSAGE(ids2 == ids,"parked threads should have been reused");
+    BOOST_CHECK_MESSAGE(scheduler.thread_ids().size() == 4,"incorrect number of threads: " << scheduler.thread_ids().size());
+    // after keep-alive, only the basic thread remains
+    std::size_t remaining = 0;
+    for (int i = 0; i < 100 ; ++i)
+    {
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+        remaining = scheduler.thread_ids().size();
+        if (remaining == 1)
+            break;
+    }
+    BOOST_CHECK_MESSAGE(remaining == 1,"temporary threads should have ended: " << remaining);
+    // and it still grows again
+    auto ids3 = run_blocking_burst(scheduler,3);
+    BOOST_CHECK_MESSAGE(ids3.size() == 3,"incorrect number of workers: " << ids3.size());
+}
+
+BOOST_AUTO_TEST_CASE( test_io_threadpool_never_exceeds_max )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::io_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>>>(2,5);
+    std::shared_ptr<std::atomic<int>> running = std::make_shared<std::atomic<int>>(0);
+    std::shared_ptr<std::atomic<int>> max_running = std::make_shared<std::atomic<int>>(0);
+    std::vector<std::future<void>> fus;
+    for (int i = 0; i < 200 ; ++i)
+    {
+        fus.push_back(boost::asynchronous::post_future(scheduler,
+                        [running,max_running]()
+                        {
+                            int r = ++*running;
+                            int m = max_running->load();
+                            while (r > m && !max_running->compare_exchange_weak(m,r));
+                            boost::this_thread::sleep_for(boost::chrono::microseconds(200));
+                            --*running;
+                        }));
+    }
+    for (auto& fu : fus)
+    {
+        fu.get();
+    }
+    BOOST_CHECK_MESSAGE(max_running->load() <= 5,"too many threads: " << max_running->load());
+    BOOST_CHECK_MESSAGE(scheduler.thread_ids().size() <= 5,"too many threads: " << scheduler.thread_ids().size());
+}
+
+BOOST_AUTO_TEST_CASE( test_io_threadpool_retire_at_max )
+{
+    // temporary threads end as soon as they are idle, a new one is created while the last one retires
+    // (loggable jobs use the diagnostics table, build with -D_GLIBCXX_ASSERTIONS to catch a wrong thread slot)
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::io_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<boost::asynchronous::any_loggable>,
+                            boost::asynchronous::no_cpu_load_saving,0>>(1,2);
+    for (int i = 0; i < 500 ; ++i)
+    {
+        auto ids = run_blocking_burst(scheduler,2);
+        BOOST_REQUIRE_MESSAGE(ids.size() == 2,"incorrect number of workers: " << ids.size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_io_threadpool_keep_alive_waiting_continuation )
+{
+    // temporary threads stay 50ms after their last job
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::io_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>,
+                            boost::asynchronous::no_cpu_load_saving,50>>(1,2);
+    // keep the basic thread busy, the continuation is created by a temporary thread
+    std::promise<void> block_promise;
+    std::shared_future<void> fub = block_promise.get_future();
+    std::promise<void> blocked;
+    auto fu_blocked = blocked.get_future();
+    auto fu_block = boost::asynchronous::post_future(scheduler,
+                        [fub,&blocked]()
+                        {
+                            blocked.set_value();
+                            fub.get();
+                        });
+    fu_blocked.get();
+    // the continuation waits for a result coming much later than the keep-alive time
+    std::promise<int> late_promise;
+    auto late_future = std::make_shared<std::future<int>>(late_promise.get_future());
+    auto fu = boost::asynchronous::post_future(scheduler,
+                [late_future]()
+                {
+                    return boost::asynchronous::top_level_continuation<int>(
+                        boost::asynchronous::make_top_level_lambda_continuation<int>(
+                        [late_future](boost::asynchronous::continuation_result<int> task_res)
+                        {
+                            boost::asynchronous::create_continuation(
+                                [task_res](std::tuple<std::future<int>> res)
+                                {
+                                    task_res.set_value(std::get<0>(res).get());
+                                },
+                                std::move(*late_future));
+                        }));
+                });
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(300));
+    late_promise.set_value(42);
+    int res = 0;
+    try
+    {
+        res = fu.get();
+    }
+    catch(...)
+    {
+    }
+    BOOST_CHECK_MESSAGE(res == 42,"waiting continuation was lost");
+    block_promise.set_value();
+    fu_block.get();
+}
@@ -0,0 +1,133 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#include <string>
+#include <vector>
+#include <future>
+#include <chrono>
+
+#include <boost/asynchronous/diagnostics/latency_histogram.hpp>
+#include <boost/asynchronous/diagnostics/html_formatter.hpp>
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/scheduler/composite_threadpool_scheduler.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/post.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+typedef std::chrono::nanoseconds ns;
+
+// relative error of a percentile must stay below 1/16
+bool close_to(ns value, long expected)
+{
+    return value.count() >= expected && value.count() <= expected + expected / 16 + 1;
+}
+}
+
+BOOST_AUTO_TEST_CASE( test_latency_histogram_percentiles )
+{
+    boost::asynchronous::latency_histogram hist;
+    BOOST_CHECK_MESSAGE(hist.percentile(0.5).count() == 0,"empty histogram should give 0");
+    for (long i = 1; i <= 100000; ++i)
+    {
+        hist.record(ns(i * 10));
+    }
+    BOOST_CHECK_MESSAGE(hist.count() == 100000,"wrong count " << hist.count());
+    BOOST_CHECK_MESSAGE(hist.min().count() == 10,"wrong min " << hist.min().count());
+    BOOST_CHECK_MESSAGE(hist.max().count() == 1000000,"wrong max " << hist.max().count());
+    BOOST_CHECK_MESSAGE(hist.average().count() == 500005,"wrong average " << hist.average().count());
+    BOOST_CHECK_MESSAGE(close_to(hist.percentile(0.5),500000),"wrong p50 " << hist.percentile(0.5).count());
+    BOOST_CHECK_MESSAGE(close_to(hist.percentile(0.99),990000),"wrong p99 " << hist.percentile(0.99).count());
+    BOOST_CHECK_MESSAGE(close_to(hist.percentile(0.999),999000),"wrong p999 " << hist.percentile(0.999).count());
+    BOOST_CHECK_MESSAGE(hist.percentile(1.0).count() == 1000000,"p100 should be the max");
+    // small values are exact
+    boost::asynchronous::latency_histogram small;
+    small.record(ns(3));
+    small.record(ns(7));
+    BOOST_CHECK_MESSAGE(small.percentile(0.5).count() == 3,"wrong small p50 " << small.percentile(0.5).count());
+}
+
+BOOST_AUTO_TEST_CASE( test_latency_histogram_merge )
+{
+    boost::asynchronous::latency_histogram fast;
+    boost::asynchronous::latency_histogram slow;
+    boost::asynchronous::concurrent_latency_histogram concurrent;
+    for (int i = 0; i < 990; ++i)
+    {
+        fast.record(ns(1000));
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        concurrent.record(std::chrono::milliseconds(10));
+    }
+    slow = concurrent.snapshot();
+    fast.merge(slow);
+    BOOST_CHECK_MESSAGE(fast.count() == 1000,"wrong count " << fast.count());
+    BOOST_CHECK_MESSAGE(close_to(fast.percentile(0.5),1000),"wrong p50 " << fast.percentile(0.5).count());
+    BOOST_CHECK_MESSAGE(close_to(fast.percentile(0.99),1000),"wrong p99 " << fast.percentile(0.99).count());
+    BOOST_CHECK_MESSAGE(close_to(fast.percentile(0.999),10000000),"wrong p999 " << fast.percentile(0.999).count());
+    concurrent.reset();
+    BOOST_CHECK_MESSAGE(concurrent.snapshot().count() == 0,"reset failed");
+}
+
+BOOST_AUTO_TEST_CASE( test_latency_histogram_scheduler )
+{
+    auto pool1 = boost::asynchronous::make_shared_scheduler_proxy<
+                    boost::asynchronous::multiqueue_threadpool_scheduler<
+                        boost::asynchronous::lockfree_queue<boost::asynchronous::any_loggable>>>(2);
+    auto pool2 = boost::asynchronous::make_shared_scheduler_proxy<
+                    boost::asynchronous::multiqueue_threadpool_scheduler<
+                        boost::asynchronous::lockfree_queue<boost::asynchronous::any_loggable>>>(2);
+    auto composite = boost::asynchronous::make_shared_scheduler_proxy<
+                    boost::asynchronous::composite_threadpool_scheduler<boost::asynchronous::any_loggable>>(pool1,pool2);
+    std::vector<std::future<void>> fus;
+    for (int i = 0; i < 20; ++i)
+    {
+        auto& pool = (i % 2 == 0) ? pool1 : pool2;
+        fus.push_back(boost::asynchronous::post_future(pool,
+                      [](){boost::this_thread::sleep(boost::posix_time::milliseconds(1));},"latency_job"));
+    }
+    for (auto& fu : fus)
+    {
+        fu.get();
+    }
+    // the future is set before the job is added to the diagnostics
+    auto count = [&composite]()
+    {
+        auto latencies = composite.get_diagnostics().latencies();
+        auto it = latencies.find("latency_job");
+        return it == latencies.end() ? 0u : (unsigned)(*it).second.run.count();
+    };
+    for (int i = 0; i < 100 && count() < 20; ++i)
+    {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    }
+    auto diag = composite.get_diagnostics();
+    auto it = diag.latencies().find("latency_job");
+    BOOST_REQUIRE_MESSAGE(it != diag.latencies().end(),"latency_job not found in latencies");
+    BOOST_CHECK_MESSAGE((*it).second.run.count() == 20,"expected 20 jobs in both pools, got " << (*it).second.run.count());
+    BOOST_CHECK_MESSAGE((*it).second.run.percentile(0.5) >= std::chrono::milliseconds(1),"jobs should run at least 1ms");
+
+    // rendered by the html formatter
+    boost::asynchronous::html_formatter::formatter<> formatter;
+    std::vector<boost::asynchronous::scheduler_diagnostics> all{diag};
+    std::vector<boost::asynchronous::summary_diagnostics> summaries{boost::asynchronous::summary_diagnostics(diag)};
+    std::string html = formatter.format(1,std::vector<std::string>{"composite"},std::vector<std::vector<std::size_t>>(1),
+                                        std::vector<boost::asynchronous::scheduler_diagnostics::current_type>(1),
+                                        std::move(all),std::move(summaries));
+    BOOST_CHECK_MESSAGE(html.find("Execution time percentiles") != std::string::npos,"percentiles not rendered");
+
+    // clear resets the histograms
+    pool1.clear_diagnostics();
+    pool2.clear_diagnostics();
+    BOOST_CHECK_MESSAGE(composite.get_diagnostics().latencies().empty(),"latencies should be empty after clear");
+}
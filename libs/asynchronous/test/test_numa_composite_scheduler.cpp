@@ -0,0 +1,164 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#include <vector>
+#include <set>
+#include <future>
+#include <mutex>
+#include <string>
+#include <fstream>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/scheduler/stealing_multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/scheduler/composite_threadpool_scheduler.hpp>
+#include <boost/asynchronous/scheduler/numa_topology.hpp>
+#include <boost/asynchronous/algorithm/parallel_placement.hpp>
+#include <boost/asynchronous/container/vector.hpp>
+#include <boost/asynchronous/post.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+void write_file(std::string const& path, std::string const& content)
+{
+    std::ofstream out(path);
+    out << content;
+}
+// a 4 nodes machine: node 2 has no cpus, node 3 is closer to node 0 than node 1
+std::string make_fake_sysfs()
+{
+    std::string root = "/tmp/test_numa_composite_scheduler_" + std::to_string(::getpid());
+    ::mkdir(root.c_str(),0755);
+    write_file(root + "/online","0-3\n");
+    const char* cpulists[] = {"0-1,4\n","2-3\n","\n","5,6\n"};
+    const char* distances[] = {"10 21 31 12\n","21 10 31 21\n","31 31 10 31\n","12 21 31 10\n"};
+    for (int i = 0; i < 4; ++i)
+    {
+        std::string node = root + "/node" + std::to_string(i);
+        ::mkdir(node.c_str(),0755);
+        write_file(node + "/cpulist",cpulists[i]);
+        write_file(node + "/distance",distances[i]);
+    }
+    return root;
+}
+}
+
+BOOST_AUTO_TEST_CASE( test_numa_parse_cpu_list )
+{
+    std::vector<unsigned int> expected = {0,1,2,3,8,10,11};
+    BOOST_CHECK(boost::asynchronous::numa_topology::parse_cpu_list("0-3,8,10-11\n") == expected);
+    BOOST_CHECK(boost::asynchronous::numa_topology::parse_cpu_list("\n").empty());
+
+    boost::asynchronous::numa_node node;
+    node.m_cpus = expected;
+    auto ranges = node.cpu_ranges();
+    BOOST_REQUIRE_EQUAL(ranges.size(),3u);
+    BOOST_CHECK(ranges[0] == std::make_tuple(0u,4u));
+    BOOST_CHECK(ranges[1] == std::make_tuple(8u,1u));
+    BOOST_CHECK(ranges[2] == std::make_tuple(10u,2u));
+}
+
+BOOST_AUTO_TEST_CASE( test_numa_topology_from_sysfs )
+{
+    boost::asynchronous::numa_topology topology(make_fake_sysfs());
+    // node 2 has no cpu, it gets no pool
+    BOOST_REQUIRE_EQUAL(topology.size(),3u);
+    BOOST_CHECK_EQUAL(topology.nodes()[0].m_id,0u);
+    BOOST_CHECK_EQUAL(topology.nodes()[1].m_id,1u);
+    BOOST_CHECK_EQUAL(topology.nodes()[2].m_id,3u);
+    BOOST_CHECK((topology.nodes()[0].m_cpus == std::vector<unsigned int>{0,1,4}));
+    BOOST_CHECK((topology.nodes()[2].m_cpus == std::vector<unsigned int>{5,6}));
+    BOOST_CHECK((topology.nodes()[0].m_distances == std::vector<unsigned int>{10,21,12}));
+
+    // nearest first
+    BOOST_CHECK((topology.steal_order(0) == std::vector<std::size_t>{2,1}));
+    BOOST_CHECK((topology.steal_order(1) == std::vector<std::size_t>{2,0}));
+    BOOST_CHECK((topology.steal_order(2) == std::vector<std::size_t>{0,1}));
+}
+
+BOOST_AUTO_TEST_CASE( test_numa_topology_fallback )
+{
+    boost::asynchronous::numa_topology topology("/nonexistent/sys/devices/system/node");
+    BOOST_REQUIRE_EQUAL(topology.size(),1u);
+    BOOST_CHECK_EQUAL(topology.nodes()[0].m_cpus.size(),std::max(1u,boost::thread::hardware_concurrency()));
+    BOOST_CHECK(topology.steal_order(0).empty());
+
+    // whatever the machine, every cpu belongs to a single node
+    std::set<unsigned int> cpus;
+    std::size_t count = 0;
+    for (auto const& node : boost::asynchronous::numa_topology::system().nodes())
+    {
+        cpus.insert(node.m_cpus.begin(),node.m_cpus.end());
+        count += node.m_cpus.size();
+    }
+    BOOST_CHECK(count > 0);
+    BOOST_CHECK_EQUAL(cpus.size(),count);
+}
+
+BOOST_AUTO_TEST_CASE( test_numa_composite_stealing )
+{
+    // two nodes, same cpu as this test machine may have only one
+    std::vector<boost::asynchronous::numa_node> nodes(2);
+    nodes[0].m_id = 0; nodes[0].m_cpus = {0}; nodes[0].m_distances = {10,20};
+    nodes[1].m_id = 1; nodes[1].m_cpus = {0}; nodes[1].m_distances = {20,10};
+    boost::asynchronous::numa_topology topology(nodes);
+
+    auto scheduler = boost::asynchronous::make_numa_composite_scheduler<
+            boost::asynchronous::stealing_multiqueue_threadpool_scheduler<boost::asynchronous::lockfree_queue<>>>(1,topology);
+    BOOST_CHECK_EQUAL(scheduler.thread_ids().size(),2u);
+
+    // post everything to the first node, the second one has to steal
+    std::mutex m;
+    std::set<boost::thread::id> executing;
+    std::vector<std::future<void>> fus;
+    for (int i = 0; i < 100; ++i)
+    {
+        fus.emplace_back(boost::asynchronous::post_future(scheduler,
+                        [&m,&executing]()
+                        {
+                            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+                            std::lock_guard<std::mutex> lock(m);
+                            executing.insert(boost::this_thread::get_id());
+                        },"",1));
+    }
+    for (auto& fu : fus)
+    {
+        fu.get();
+    }
+    BOOST_CHECK_EQUAL(executing.size(),2u);
+}
+
+BOOST_AUTO_TEST_CASE( test_numa_placement_page_split )
+{
+    // splits are on a page boundary, close to the middle
+    std::vector<char> buffer(1024*1024);
+    // starting on a page
+    char* data = buffer.data() + BOOST_ASYNCHRONOUS_PAGE_SIZE - reinterpret_cast<std::uintptr_t>(buffer.data()) % BOOST_ASYNCHRONOUS_PAGE_SIZE;
+    std::size_t split = boost::asynchronous::detail::placement_split<double>(0,100000,data);
+    BOOST_CHECK(split > 0 && split < 100000);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(data + split*sizeof(double)) % BOOST_ASYNCHRONOUS_PAGE_SIZE,0u);
+    BOOST_CHECK(split + BOOST_ASYNCHRONOUS_PAGE_SIZE/sizeof(double) > 50000);
+    // less than a page, keep the middle
+    BOOST_CHECK_EQUAL(boost::asynchronous::detail::placement_split<double>(0,10,data),5u);
+
+    // a vector constructed on the numa composite is correctly initialized
+    auto scheduler = boost::asynchronous::make_numa_composite_scheduler<
+            boost::asynchronous::stealing_multiqueue_threadpool_scheduler<boost::asynchronous::lockfree_queue<>>>(2);
+    boost::asynchronous::vector<int> v(scheduler,1000,(std::size_t)10000,42);
+    BOOST_REQUIRE_EQUAL(v.size(),10000u);
+    for (auto i : v)
+    {
+        BOOST_REQUIRE_EQUAL(i,42);
+    }
+}
@@ -93,6 +93,17 @@ const std::string caesar_search_string = "Gallia";
 std::string repeated(100000, 'A');
 std::string repeated_search_string = "AAA";
 
+// Many candidates for the first/last element filter of char ranges, but few matches
+std::string make_pathological()
+{
+    std::string res(100000, 'A');
+    res[40000] = 'B';
+    res[90000] = 'B';
+    return res;
+}
+std::string pathological = make_pathological();
+std::string pathological_search_string = std::string(60, 'A') + "BA";
+
 // Test functor that lists all indices in order
 struct kmp_functor
 {
@@ -181,4 +192,6 @@ SINGLE_TEST(test_parallel_kmp_aaaaaa_iter_move, repeated, repeated_search_string
 SINGLE_TEST(test_parallel_kmp_aaaaaa_cont_iter, repeated, repeated_search_string, CONT, ITER)
 SINGLE_TEST(test_parallel_kmp_aaaaaa_rnge_cont, repeated, repeated_search_string, RNGE, CONT)
 
+SINGLE_TEST(test_parallel_kmp_pathological_iter_iter, pathological, pathological_search_string, ITER, ITER)
+
 }
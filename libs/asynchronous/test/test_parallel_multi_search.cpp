@@ -0,0 +1,187 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#include <vector>
+#include <string>
+#include <random>
+#include <future>
+#include <algorithm>
+#include <utility>
+
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+
+#include <boost/asynchronous/post.hpp>
+#include <boost/asynchronous/algorithm/parallel_for.hpp>
+#include <boost/asynchronous/algorithm/parallel_multi_search.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+typedef std::vector<std::pair<std::size_t,std::size_t>> matches_type;
+
+// collects (position, pattern) pairs
+struct multi_search_functor
+{
+    void operator()(std::ptrdiff_t position, std::size_t pattern)
+    {
+        matches.emplace_back(static_cast<std::size_t>(position),pattern);
+    }
+    void merge(multi_search_functor&& other)
+    {
+        matches.insert(matches.end(),other.matches.begin(),other.matches.end());
+    }
+    matches_type matches;
+};
+
+template <class Haystack, class Patterns>
+matches_type naive_search(Haystack const& haystack, Patterns const& patterns)
+{
+    matches_type res;
+    for (std::size_t p = 0; p < patterns.size(); ++p)
+    {
+        if (patterns[p].empty() || patterns[p].size() > haystack.size())
+            continue;
+        for (std::size_t i = 0; i + patterns[p].size() <= haystack.size(); ++i)
+        {
+            if (std::equal(patterns[p].begin(),patterns[p].end(),haystack.begin() + i))
+                res.emplace_back(i,p);
+        }
+    }
+    std::sort(res.begin(),res.end());
+    return res;
+}
+
+std::string random_string(std::size_t n, std::mt19937& mt, char max_char)
+{
+    std::uniform_int_distribution<int> dis('a',max_char);
+    std::string s(n,'a');
+    for (auto& c : s)
+    {
+        c = static_cast<char>(dis(mt));
+    }
+    return s;
+}
+
+auto make_scheduler()
+{
+    return boost::asynchronous::make_shared_scheduler_proxy<
+                boost::asynchronous::multiqueue_threadpool_scheduler<
+                    boost::asynchronous::lockfree_queue<>>>(4);
+}
+
+template <class Haystack, class Patterns>
+void check(Haystack const& haystack, Patterns const& patterns, long cutoff)
+{
+    auto scheduler = make_scheduler();
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [&haystack,&patterns,cutoff]()
+        {
+            return boost::asynchronous::parallel_multi_search(haystack.begin(),haystack.end(),patterns,multi_search_functor(),cutoff);
+        });
+    matches_type res = fu.get().matches;
+    std::sort(res.begin(),res.end());
+    BOOST_CHECK(res == naive_search(haystack,patterns));
+}
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_multi_search_random )
+{
+    std::mt19937 mt(42);
+    std::string haystack = random_string(20000,mt,'d');
+    std::vector<std::string> patterns;
+    std::uniform_int_distribution<std::size_t> len(1,8);
+    for (int i = 0; i < 200; ++i)
+    {
+        patterns.push_back(random_string(len(mt),mt,'e'));
+    }
+    // duplicates, prefixes and suffixes of each other, an empty pattern
+    patterns.push_back("ab");
+    patterns.push_back("ab");
+    patterns.push_back("abcab");
+    patterns.push_back("cab");
+    patterns.push_back("");
+    for (long cutoff : {10L,100L,1500L,100000L})
+    {
+        check(haystack,patterns,cutoff);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_multi_search_overlapping_chunks )
+{
+    // every match crosses chunk boundaries for small cutoffs
+    std::string haystack(5000,'a');
+    std::vector<std::string> patterns = {"a","aa",std::string(40,'a'),"b"};
+    for (long cutoff : {1L,7L,64L})
+    {
+        check(haystack,patterns,cutoff);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_multi_search_no_pattern )
+{
+    std::mt19937 mt(1);
+    std::string haystack = random_string(1000,mt,'z');
+    check(haystack,std::vector<std::string>(),100);
+    check(haystack,std::vector<std::string>{""},100);
+    check(std::string(),std::vector<std::string>{"a"},100);
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_multi_search_ints )
+{
+    std::mt19937 mt(3);
+    std::uniform_int_distribution<int> dis(-3,3);
+    std::vector<int> haystack(10000);
+    for (auto& i : haystack)
+    {
+        i = dis(mt) * 1000;
+    }
+    std::vector<std::vector<int>> patterns = {{0},{1000,-1000},{3000,3000,3000},{0,0,1000},{42}};
+    check(haystack,patterns,500);
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_multi_search_moved_range )
+{
+    std::mt19937 mt(5);
+    std::string haystack = random_string(10000,mt,'c');
+    std::vector<std::string> patterns = {"abc","cc","a","bbbb"};
+    auto scheduler = make_scheduler();
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [haystack,patterns]()
+        {
+            return boost::asynchronous::parallel_multi_search(std::string(haystack),patterns,multi_search_functor(),500,"multi_search",0);
+        });
+    matches_type res = fu.get().matches;
+    std::sort(res.begin(),res.end());
+    BOOST_CHECK(res == naive_search(haystack,patterns));
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_multi_search_continuation )
+{
+    std::mt19937 mt(7);
+    std::vector<int> haystack(10000);
+    for (auto& i : haystack)
+    {
+        i = static_cast<int>(mt() % 4);
+    }
+    std::vector<std::vector<int>> patterns = {{1,2,3},{0,0},{3}};
+    auto scheduler = make_scheduler();
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [haystack,patterns]()
+        {
+            return boost::asynchronous::parallel_multi_search(
+                        boost::asynchronous::parallel_for(std::vector<int>(haystack),[](int&){},500),
+                        patterns,multi_search_functor(),500,"multi_search",0);
+        });
+    matches_type res = fu.get().matches;
+    std::sort(res.begin(),res.end());
+    BOOST_CHECK(res == naive_search(haystack,patterns));
+}
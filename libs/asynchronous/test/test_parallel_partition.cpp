@@ -9,8 +9,10 @@
 
 #include <vector>
 #include <set>
+#include <stdexcept>
 #include <functional>
 #include <random>
+#include <numeric>
 #include <future>
 
 #include <boost/lexical_cast.hpp>
@@ -302,6 +304,101 @@ public:
 
 }
 
+namespace
+{
+// partitions with many threads and checks the result is a permutation of the input, correctly partitioned
+template <class Pred>
+void check_partition(std::vector<int> data, Pred pred, uint32_t thread_num)
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+            boost::asynchronous::threadpool_scheduler<boost::asynchronous::lockfree_queue<>>>(4);
+    std::vector<int> res = data;
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [&res,pred,thread_num]()
+        {
+            return boost::asynchronous::parallel_partition(res.begin(),res.end(),pred,thread_num,"",0);
+        });
+    Iterator it = fu.get();
+    BOOST_CHECK_EQUAL(it - res.begin(),std::count_if(data.begin(),data.end(),pred));
+    BOOST_CHECK_MESSAGE(std::all_of(res.begin(),it,pred),"parallel_partition gave a wrong value.");
+    BOOST_CHECK_MESSAGE(std::none_of(it,res.end(),pred),"parallel_partition gave a wrong value.");
+    std::sort(data.begin(),data.end());
+    std::sort(res.begin(),res.end());
+    BOOST_CHECK_MESSAGE(data == res,"parallel_partition lost elements.");
+}
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_partition_blocks )
+{
+    std::vector<int> data;
+    generate(data,1000000,10000);
+    for (uint32_t thread_num : {1u,4u,16u})
+    {
+        for (int limit : {0,1,100,5000,9999,10001})
+        {
+            check_partition(data,[limit](int i){return i < limit;},thread_num);
+        }
+        check_partition(data,[](int i){return i % 2 == 0;},thread_num);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_partition_blocks_sorted )
+{
+    std::vector<int> data(500000);
+    std::iota(data.begin(),data.end(),0);
+    for (int limit : {0,1000,250000,499999})
+    {
+        check_partition(data,[limit](int i){return i < limit;},8);
+        check_partition(data,[limit](int i){return i >= limit;},8);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_partition_exception )
+{
+    std::vector<int> data;
+    generate(data,200000,1000);
+    data[123456] = -1;
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+            boost::asynchronous::threadpool_scheduler<boost::asynchronous::lockfree_queue<>>>(4);
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [&data]()
+        {
+            return boost::asynchronous::parallel_partition(data.begin(),data.end(),
+                                                           [](int i)
+                                                           {
+                                                               if (i < 0)
+                                                                   throw std::runtime_error("negative value");
+                                                               return i < 500;
+                                                           },8,"",0);
+        });
+    BOOST_CHECK_THROW(fu.get(),std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE( test_median_of_medians )
+{
+    std::mt19937 mt(42);
+    std::less<int> less;
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::vector<int> data(3 + mt() % 40);
+        for (auto& d : data)
+        {
+            d = static_cast<int>(mt() % 20);
+        }
+        std::vector<int> copy = data;
+        int median = boost::asynchronous::detail::median_of_medians(data.begin(),data.end(),less);
+        // no element is moved and the result is one of the elements
+        BOOST_CHECK(data == copy);
+        BOOST_CHECK(std::find(data.begin(),data.end(),median) != data.end());
+    }
+    std::vector<int> three = {3,1,2};
+    BOOST_CHECK_EQUAL(boost::asynchronous::detail::median_of_medians(three.begin(),three.end(),less),2);
+    std::vector<int> sorted(100);
+    std::iota(sorted.begin(),sorted.end(),0);
+    int median = boost::asynchronous::detail::median_of_medians(sorted.begin(),sorted.end(),less);
+    BOOST_CHECK(median > 20 && median < 80);
+}
+
 BOOST_AUTO_TEST_CASE( test_parallel_partition )
 {
     servant_dtor=false;
@@ -0,0 +1,204 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#include <vector>
+#include <functional>
+#include <random>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/post.hpp>
+#include <boost/asynchronous/algorithm/parallel_radix_sort.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+template <class T, class Distribution>
+std::vector<T> generate(std::size_t n, Distribution dis)
+{
+    std::vector<T> data(n);
+    std::mt19937 mt(static_cast<unsigned int>(std::time(nullptr)));
+    std::generate(data.begin(), data.end(), std::bind(dis, std::ref(mt)));
+    return data;
+}
+template <class T>
+void check_sort(std::vector<T> data)
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>>>(4);
+    std::vector<T> expected = data;
+    std::sort(expected.begin(),expected.end());
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [&data]()
+        {
+            return boost::asynchronous::parallel_radix_sort(data.begin(),data.end(),boost::asynchronous::radix_identity(),1500);
+        },
+        "test_parallel_radix_sort",0);
+    try
+    {
+        fu.get();
+    }
+    catch(...)
+    {
+        BOOST_FAIL( "unexpected exception" );
+    }
+    BOOST_CHECK_MESSAGE(data == expected,"parallel_radix_sort gave a wrong value.");
+}
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_radix_sort_unsigned )
+{
+    check_sort(generate<std::uint32_t>(100000,std::uniform_int_distribution<std::uint32_t>()));
+    check_sort(generate<std::uint64_t>(100000,std::uniform_int_distribution<std::uint64_t>()));
+    // only the lowest byte differs, other passes are skipped
+    check_sort(generate<std::uint64_t>(100000,std::uniform_int_distribution<std::uint64_t>(0,255)));
+    // all equal
+    check_sort(std::vector<std::uint32_t>(10000,42));
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_radix_sort_signed_and_float )
+{
+    check_sort(generate<int>(100000,std::uniform_int_distribution<int>(std::numeric_limits<int>::min(),std::numeric_limits<int>::max())));
+    check_sort(generate<std::int64_t>(100000,std::uniform_int_distribution<std::int64_t>(-1000,1000)));
+    check_sort(generate<float>(100000,std::uniform_real_distribution<float>(-1e6f,1e6f)));
+    check_sort(generate<double>(100000,std::uniform_real_distribution<double>(-1.0,1.0)));
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_radix_sort_small )
+{
+    // below cutoff
+    check_sort(generate<std::uint32_t>(1000,std::uniform_int_distribution<std::uint32_t>()));
+    check_sort(std::vector<std::uint32_t>());
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_radix_sort_msd )
+{
+    // big enough and spread by the top byte: MSD first
+    check_sort(generate<std::uint64_t>(2000000,std::uniform_int_distribution<std::uint64_t>()));
+    check_sort(generate<std::int64_t>(2000000,std::uniform_int_distribution<std::int64_t>(std::numeric_limits<std::int64_t>::min(),
+                                                                                          std::numeric_limits<std::int64_t>::max())));
+    // 32 big buckets of the top byte and many small ones, sorted with std::stable_sort
+    std::vector<std::uint32_t> data = generate<std::uint32_t>(2000000,std::uniform_int_distribution<std::uint32_t>(0,0xFFFFFF));
+    std::mt19937 mt(static_cast<unsigned int>(std::time(nullptr)));
+    std::uniform_int_distribution<std::uint32_t> dis(0,255);
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        std::uint32_t top = (i % 1000 == 0) ? dis(mt) : (dis(mt) & 0xF8);
+        data[i] |= top << 24;
+    }
+    check_sort(data);
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_radix_sort_msd_key_payload_stable )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>>>(4);
+    // key, original position. Many equal keys in every bucket of the top byte
+    std::vector<std::pair<std::uint32_t,std::size_t>> data(2000000);
+    std::mt19937 mt(static_cast<unsigned int>(std::time(nullptr)));
+    std::uniform_int_distribution<std::uint32_t> dis(0,0xFFFF);
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = std::make_pair(dis(mt) << 16,i);
+    }
+    auto expected = data;
+    std::stable_sort(expected.begin(),expected.end(),
+                     [](std::pair<std::uint32_t,std::size_t> const& lhs, std::pair<std::uint32_t,std::size_t> const& rhs)
+                     {return lhs.first < rhs.first;});
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [&data]()
+        {
+            return boost::asynchronous::parallel_radix_sort(data.begin(),data.end(),
+                                                            [](std::pair<std::uint32_t,std::size_t> const& p){return p.first;},
+                                                            1500);
+        },
+        "test_parallel_radix_sort_msd_key_payload_stable",0);
+    try
+    {
+        fu.get();
+        BOOST_CHECK_MESSAGE(data == expected,"parallel_radix_sort is not stable.");
+    }
+    catch(...)
+    {
+        BOOST_FAIL( "unexpected exception" );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_radix_sort_key_payload_stable )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>>>(4);
+    // key, original position
+    std::vector<std::pair<std::uint16_t,std::size_t>> data(100000);
+    std::mt19937 mt(static_cast<unsigned int>(std::time(nullptr)));
+    std::uniform_int_distribution<std::uint16_t> dis(0,1000);
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = std::make_pair(dis(mt),i);
+    }
+    auto expected = data;
+    std::stable_sort(expected.begin(),expected.end(),
+                     [](std::pair<std::uint16_t,std::size_t> const& lhs, std::pair<std::uint16_t,std::size_t> const& rhs)
+                     {return lhs.first < rhs.first;});
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [data]()mutable
+        {
+            return boost::asynchronous::parallel_radix_sort(std::move(data),
+                                                            [](std::pair<std::uint16_t,std::size_t> const& p){return p.first;},
+                                                            1500);
+        },
+        "test_parallel_radix_sort_key_payload_stable",0);
+    try
+    {
+        auto res = fu.get();
+        BOOST_CHECK_MESSAGE(res == expected,"parallel_radix_sort is not stable.");
+    }
+    catch(...)
+    {
+        BOOST_FAIL( "unexpected exception" );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_radix_sort_continuation )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>>>(4);
+    std::vector<std::uint32_t> data = generate<std::uint32_t>(100000,std::uniform_int_distribution<std::uint32_t>());
+    // sort by the low 16 bits, then by the high 16 bits, a stable sort makes it a sort by the whole value
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [data]()mutable
+        {
+            return boost::asynchronous::parallel_radix_sort(
+                        boost::asynchronous::parallel_radix_sort(std::move(data),
+                                                                 [](std::uint32_t i){return static_cast<std::uint16_t>(i & 0xFFFF);},
+                                                                 1500),
+                        [](std::uint32_t i){return static_cast<std::uint16_t>(i >> 16);},
+                        1500);
+        },
+        "test_parallel_radix_sort_continuation",0);
+    std::sort(data.begin(),data.end());
+    try
+    {
+        auto res = fu.get();
+        BOOST_CHECK_MESSAGE(res == data,"parallel_radix_sort gave a wrong value.");
+    }
+    catch(...)
+    {
+        BOOST_FAIL( "unexpected exception" );
+    }
+}
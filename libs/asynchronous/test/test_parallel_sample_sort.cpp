@@ -0,0 +1,148 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#include <vector>
+#include <functional>
+#include <random>
+#include <string>
+#include <numeric>
+#include <cstdint>
+
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/post.hpp>
+#include <boost/asynchronous/algorithm/parallel_sample_sort.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+template <class T, class Distribution>
+std::vector<T> generate(std::size_t n, Distribution dis)
+{
+    std::vector<T> data(n);
+    std::mt19937 mt(static_cast<unsigned int>(std::time(nullptr)));
+    std::generate(data.begin(), data.end(), std::bind(dis, std::ref(mt)));
+    return data;
+}
+template <class T, class Func = std::less<T>>
+void check_sort(std::vector<T> data, Func func = Func(), long cutoff = 1500)
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>>>(4);
+    std::vector<T> expected = data;
+    std::sort(expected.begin(),expected.end(),func);
+    std::vector<T> data_inplace = data;
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [&data,func,cutoff]()
+        {
+            return boost::asynchronous::parallel_sample_sort(data.begin(),data.end(),func,cutoff,4);
+        },
+        "test_parallel_sample_sort",0);
+    auto fu2 = boost::asynchronous::post_future(scheduler,
+        [&data_inplace,func,cutoff]()
+        {
+            return boost::asynchronous::parallel_sample_sort_inplace(data_inplace.begin(),data_inplace.end(),func,cutoff,4);
+        },
+        "test_parallel_sample_sort_inplace",0);
+    try
+    {
+        fu.get();
+        fu2.get();
+    }
+    catch(...)
+    {
+        BOOST_FAIL( "unexpected exception" );
+    }
+    BOOST_CHECK_MESSAGE(data == expected,"parallel_sample_sort gave a wrong value.");
+    BOOST_CHECK_MESSAGE(data_inplace == expected,"parallel_sample_sort_inplace gave a wrong value.");
+}
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_sample_sort_random )
+{
+    check_sort(generate<std::uint32_t>(100000,std::uniform_int_distribution<std::uint32_t>()));
+    check_sort(generate<double>(100000,std::uniform_real_distribution<double>(-1.0,1.0)));
+    check_sort(generate<int>(100000,std::uniform_int_distribution<int>()),std::greater<int>());
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_sample_sort_duplicates )
+{
+    // many splitters are equal
+    check_sort(generate<int>(100000,std::uniform_int_distribution<int>(0,10)));
+    // one very frequent value among others
+    std::vector<int> data = generate<int>(100000,std::uniform_int_distribution<int>());
+    for (std::size_t i = 0; i < data.size(); i += 2)
+    {
+        data[i] = 42;
+    }
+    check_sort(data);
+    // all equal
+    check_sort(std::vector<int>(100000,42));
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_sample_sort_sorted )
+{
+    std::vector<int> data(100000);
+    std::iota(data.begin(),data.end(),0);
+    check_sort(data);
+    std::reverse(data.begin(),data.end());
+    check_sort(data);
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_sample_sort_small )
+{
+    // below cutoff
+    check_sort(generate<std::uint32_t>(1000,std::uniform_int_distribution<std::uint32_t>()));
+    check_sort(std::vector<std::uint32_t>());
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_sample_sort_cutoff_0 )
+{
+    check_sort(generate<int>(10000,std::uniform_int_distribution<int>()),std::less<int>(),0);
+    check_sort(generate<int>(10,std::uniform_int_distribution<int>()),std::less<int>(),0);
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_sample_sort_strings_moved_range )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>>>(4);
+    std::vector<std::string> data;
+    for (auto i : generate<int>(20000,std::uniform_int_distribution<int>(0,5000)))
+    {
+        data.push_back(std::to_string(i));
+    }
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [data]()mutable
+        {
+            return boost::asynchronous::parallel_sample_sort(std::move(data),std::less<std::string>(),1000);
+        },
+        "test_parallel_sample_sort_strings_moved_range",0);
+    auto fu2 = boost::asynchronous::post_future(scheduler,
+        [data]()mutable
+        {
+            return boost::asynchronous::parallel_sample_sort_inplace(std::move(data),std::less<std::string>(),1000);
+        },
+        "test_parallel_sample_sort_strings_moved_range",0);
+    std::sort(data.begin(),data.end());
+    try
+    {
+        auto res = fu.get();
+        BOOST_CHECK_MESSAGE(res == data,"parallel_sample_sort gave a wrong value.");
+        auto res2 = fu2.get();
+        BOOST_CHECK_MESSAGE(res2 == data,"parallel_sample_sort_inplace gave a wrong value.");
+    }
+    catch(...)
+    {
+        BOOST_FAIL( "unexpected exception" );
+    }
+}
@@ -8,7 +8,9 @@
 // For more information, see http://www.boost.org
 
 #include <vector>
+#include <list>
 #include <set>
+#include <stdexcept>
 #include <functional>
 #include <random>
 #include <future>
@@ -560,6 +562,46 @@ public:
 };
 }
 
+namespace
+{
+// affine function x -> a*x+b, composition is not commutative
+struct affine
+{
+    unsigned a=1;
+    unsigned b=0;
+    bool operator==(affine const& rhs)const
+    {
+        return a == rhs.a && b == rhs.b;
+    }
+};
+// applies f, then g
+affine compose(affine const& f, affine const& g)
+{
+    affine res;
+    res.a = g.a * f.a;
+    res.b = g.a * f.b + g.b;
+    return res;
+}
+using AffineIterator = std::vector<affine>::iterator;
+
+auto make_scan_threadpool()
+{
+    return boost::asynchronous::make_shared_scheduler_proxy<
+                boost::asynchronous::threadpool_scheduler<
+                    boost::asynchronous::lockfree_queue<>>>(4);
+}
+template <class It>
+int sum(It beg, It end)
+{
+    int r=0;
+    for (;beg != end; ++beg)
+    {
+        r = r + *beg;
+    }
+    return r;
+}
+}
+
 BOOST_AUTO_TEST_CASE( test_scan_inclusive_scan )
 {
     servant_dtor=false;
@@ -720,3 +762,140 @@ BOOST_AUTO_TEST_CASE( test_scan_classify )
     }
     BOOST_CHECK_MESSAGE(servant_dtor,"servant dtor not called.");
 }
+
+BOOST_AUTO_TEST_CASE( test_scan_single_pass_many_chunks )
+{
+    std::vector<int> data;
+    generate(data,100000,100);
+    std::vector<int> res(data.size(),0);
+    auto scheduler = make_scan_threadpool();
+    for (long cutoff : {1L,7L,64L,1000L,200000L})
+    {
+        auto fu = boost::asynchronous::post_future(scheduler,
+            [&data,&res,cutoff]()
+            {
+                return boost::asynchronous::parallel_scan(data.begin(),data.end(),res.begin(),10,
+                                                          [](Iterator beg, Iterator end){return sum(beg,end);},
+                                                          std::plus<int>(),
+                                                          [](Iterator beg, Iterator end, Iterator out, int init)
+                                                          {
+                                                            for (;beg != end; ++beg)
+                                                            {
+                                                                init = *beg + init;
+                                                                *out++ = init;
+                                                            };
+                                                          },
+                                                          cutoff);
+            });
+        int total = fu.get();
+        std::vector<int> expected(data.size(),0);
+        inclusive_scan(data.begin(),data.end(),expected.begin(),10,std::plus<int>());
+        BOOST_CHECK_MESSAGE(res == expected,"parallel_scan gave a wrong value.");
+        // the total does not contain init
+        BOOST_CHECK_EQUAL(total,sum(data.begin(),data.end()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_scan_single_pass_non_commutative )
+{
+    std::mt19937 mt(42);
+    std::uniform_int_distribution<unsigned> dis(0,5);
+    std::vector<affine> data(20000);
+    for (auto& f : data)
+    {
+        f.a = dis(mt);
+        f.b = dis(mt);
+    }
+    std::vector<affine> res(data.size());
+    auto scheduler = make_scan_threadpool();
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [&data,&res]()
+        {
+            return boost::asynchronous::parallel_scan(data.begin(),data.end(),res.begin(),affine(),
+                                                      [](AffineIterator beg, AffineIterator end)
+                                                      {
+                                                        affine r;
+                                                        for (;beg != end; ++beg)
+                                                        {
+                                                            r = compose(r,*beg);
+                                                        }
+                                                        return r;
+                                                      },
+                                                      [](affine const& f, affine const& g){return compose(f,g);},
+                                                      [](AffineIterator beg, AffineIterator end, AffineIterator out, affine init)
+                                                      {
+                                                        for (;beg != end; ++beg)
+                                                        {
+                                                            init = compose(init,*beg);
+                                                            *out++ = init;
+                                                        };
+                                                      },
+                                                      50);
+        });
+    affine total = fu.get();
+    std::vector<affine> expected(data.size());
+    inclusive_scan(data.begin(),data.end(),expected.begin(),affine(),[](affine const& f, affine const& g){return compose(f,g);});
+    BOOST_CHECK_MESSAGE(res == expected,"parallel_scan gave a wrong value.");
+    BOOST_CHECK_MESSAGE(total == expected.back(),"parallel_scan gave a wrong total.");
+}
+
+BOOST_AUTO_TEST_CASE( test_scan_single_pass_exception )
+{
+    std::vector<int> data(10000,1);
+    data[5555] = -1;
+    std::vector<int> res(data.size(),0);
+    auto scheduler = make_scan_threadpool();
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [&data,&res]()
+        {
+            return boost::asynchronous::parallel_scan(data.begin(),data.end(),res.begin(),0,
+                                                      [](Iterator beg, Iterator end)
+                                                      {
+                                                        if (std::find(beg,end,-1) != end)
+                                                            throw std::runtime_error("negative value");
+                                                        return sum(beg,end);
+                                                      },
+                                                      std::plus<int>(),
+                                                      [](Iterator beg, Iterator end, Iterator out, int init)
+                                                      {
+                                                        for (;beg != end; ++beg)
+                                                        {
+                                                            init = *beg + init;
+                                                            *out++ = init;
+                                                        };
+                                                      },
+                                                      100);
+        });
+    BOOST_CHECK_THROW(fu.get(),std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE( test_scan_two_pass_list )
+{
+    // no random access, reduce then scan
+    std::vector<int> data;
+    generate(data,10000,100);
+    std::list<int> input(data.begin(),data.end());
+    std::list<int> res(data.size(),0);
+    auto scheduler = make_scan_threadpool();
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [&input,&res]()
+        {
+            return boost::asynchronous::parallel_scan(input.begin(),input.end(),res.begin(),0,
+                                                      [](std::list<int>::iterator beg, std::list<int>::iterator end){return sum(beg,end);},
+                                                      std::plus<int>(),
+                                                      [](std::list<int>::iterator beg, std::list<int>::iterator end, std::list<int>::iterator out, int init)
+                                                      {
+                                                        for (;beg != end; ++beg)
+                                                        {
+                                                            init = *beg + init;
+                                                            *out++ = init;
+                                                        };
+                                                      },
+                                                      100);
+        });
+    int total = fu.get();
+    std::vector<int> expected(data.size(),0);
+    inclusive_scan(data.begin(),data.end(),expected.begin(),0,std::plus<int>());
+    BOOST_CHECK_MESSAGE(std::equal(res.begin(),res.end(),expected.begin()),"parallel_scan gave a wrong value.");
+    BOOST_CHECK_EQUAL(total,expected.back());
+}
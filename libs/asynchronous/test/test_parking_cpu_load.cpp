@@ -0,0 +1,164 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#include <vector>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <boost/asynchronous/scheduler/single_thread_scheduler.hpp>
+#include <boost/asynchronous/scheduler/threadpool_scheduler.hpp>
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/scheduler/stealing_multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/scheduler/composite_threadpool_scheduler.hpp>
+#include <boost/asynchronous/scheduler/multiple_thread_scheduler.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler/cpu_load_policies.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/post.hpp>
+#include <boost/asynchronous/algorithm/parallel_for.hpp>
+#include <boost/thread/future.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+typedef boost::asynchronous::parking_cpu_load<16,1000000,500> parking;
+
+template <class Scheduler>
+void post_after_idle(Scheduler scheduler)
+{
+    for (int round = 0 ; round < 3 ; ++round)
+    {
+        // give workers time to park. The maximum park time is 1s, so a missed wakeup would be noticed
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        auto start = std::chrono::steady_clock::now();
+        auto fu = boost::asynchronous::post_future(scheduler,[](){return 42;});
+        BOOST_CHECK_MESSAGE(fu.get() == 42,"wrong result");
+        auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        BOOST_CHECK_MESSAGE(waited < 500,"parked worker not woken up by post, took " << waited << " ms");
+    }
+    std::vector<std::future<int>> fus;
+    for (int i = 0 ; i< 1000 ; ++i)
+    {
+        fus.emplace_back(boost::asynchronous::post_future(scheduler,[i](){return i;}));
+    }
+    for (int i = 0 ; i< 1000 ; ++i)
+    {
+        BOOST_CHECK_MESSAGE(fus[i].get() == i,"wrong result");
+    }
+}
+struct add_two
+{
+    void operator()(int& i)const
+    {
+        i += 2;
+    }
+};
+}
+
+BOOST_AUTO_TEST_CASE( test_eventcount_wakeup )
+{
+    boost::asynchronous::detail::eventcount ec;
+    std::atomic<bool> ready(false);
+    std::atomic<bool> woken(false);
+    std::thread waiter([&]()
+    {
+        while (!ready.load())
+        {
+            auto key = ec.prepare_wait();
+            if (ready.load())
+            {
+                ec.cancel_wait();
+                break;
+            }
+            ec.wait(key,std::chrono::microseconds(10000000));
+        }
+        woken = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ready = true;
+    ec.notify_one();
+    waiter.join();
+    BOOST_CHECK_MESSAGE(woken.load(),"waiter not woken");
+    BOOST_CHECK_MESSAGE(ec.waiters() == 0,"waiter still registered");
+}
+
+BOOST_AUTO_TEST_CASE( test_parking_single_thread_scheduler )
+{
+    post_after_idle(boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::single_thread_scheduler<
+                            boost::asynchronous::lockfree_queue<>,parking>>());
+}
+
+BOOST_AUTO_TEST_CASE( test_parking_threadpool_scheduler )
+{
+    post_after_idle(boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>,parking>>(3));
+}
+
+BOOST_AUTO_TEST_CASE( test_parking_multiqueue_threadpool_scheduler )
+{
+    post_after_idle(boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>,
+                            boost::asynchronous::default_find_position<>,parking>>(3));
+}
+
+BOOST_AUTO_TEST_CASE( test_parking_stealing_multiqueue_threadpool_scheduler )
+{
+    boost::asynchronous::any_shared_scheduler_proxy<> pool = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::stealing_multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>,
+                            boost::asynchronous::default_find_position<>,parking>>(3);
+    post_after_idle(boost::asynchronous::make_shared_scheduler_proxy<boost::asynchronous::composite_threadpool_scheduler<>>(pool));
+}
+
+BOOST_AUTO_TEST_CASE( test_parking_multiple_thread_scheduler )
+{
+    // no parking support, sleeps between polls
+    post_after_idle(boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiple_thread_scheduler<
+                            boost::asynchronous::lockfree_queue<>,parking>>(3,10));
+}
+
+BOOST_AUTO_TEST_CASE( test_parking_execute_in_all_threads )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>,
+                            boost::asynchronous::default_find_position<>,parking>>(3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::atomic<int> called(0);
+    auto fus = scheduler.execute_in_all_threads([&called](){++called;});
+    boost::wait_for_all(fus.begin(), fus.end());
+    BOOST_CHECK_MESSAGE(called.load() == 3,"private jobs not executed by parked workers");
+}
+
+BOOST_AUTO_TEST_CASE( test_parking_continuations )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>,
+                            boost::asynchronous::default_find_position<>,parking>>(3);
+    std::vector<int> data(10000,1);
+    for (int round = 0 ; round < 3 ; ++round)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        auto fu = boost::asynchronous::post_future(scheduler,
+                    [&data]()
+                    {
+                        return boost::asynchronous::parallel_for(data.begin(),data.end(),add_two(),100);
+                    });
+        fu.get();
+    }
+    BOOST_CHECK_MESSAGE(std::all_of(data.begin(),data.end(),[](int i){return i == 7;}),"parallel_for failed");
+}
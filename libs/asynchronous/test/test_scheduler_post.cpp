@@ -10,11 +10,14 @@
 #include <vector>
 #include <set>
 #include <future>
+#include <atomic>
 
 #include <boost/asynchronous/scheduler/single_thread_scheduler.hpp>
 #include <boost/asynchronous/queue/lockfree_queue.hpp>
 #include <boost/asynchronous/queue/lockfree_queue.hpp>
 #include <boost/asynchronous/queue/any_queue_container.hpp>
+#include <boost/asynchronous/queue/lockfree_ring_queue.hpp>
+#include <boost/asynchronous/queue/work_stealing_deque.hpp>
 #include <boost/asynchronous/scheduler_shared_proxy.hpp>
 #include <boost/asynchronous/scheduler/threadpool_scheduler.hpp>
 #include <boost/asynchronous/scheduler/stealing_threadpool_scheduler.hpp>
@@ -284,3 +287,267 @@ BOOST_AUTO_TEST_CASE( post_multiqueue_threadpool_scheduler_tbb_concurrent_queue
     }
     BOOST_CHECK_MESSAGE(ids.size() <=4,"too many threads used in scheduler");
 }
+
+BOOST_AUTO_TEST_CASE( lockfree_ring_queue_wrap_around )
+{
+    // capacity rounded up to 8
+    boost::asynchronous::lockfree_ring_queue<boost::asynchronous::any_callable> queue(5);
+    BOOST_CHECK_MESSAGE(queue.capacity() == 8,"wrong capacity");
+    int called = 0;
+    for (int round = 0 ; round < 5 ; ++round)
+    {
+        for (int i = 0 ; i< 8 ; ++i)
+        {
+            BOOST_CHECK_MESSAGE(queue.try_push(boost::asynchronous::any_callable([&called](){++called;})),"push should succeed");
+        }
+        BOOST_CHECK_MESSAGE(!queue.try_push(boost::asynchronous::any_callable([&called](){++called;})),"queue should be full");
+        BOOST_CHECK_MESSAGE(queue.get_queue_size()[0] == 8,"wrong queue size");
+        boost::asynchronous::any_callable job;
+        for (int i = 0 ; i< 8 ; ++i)
+        {
+            BOOST_CHECK_MESSAGE(queue.try_pop(job),"pop should succeed");
+            job();
+        }
+        BOOST_CHECK_MESSAGE(!queue.try_pop(job),"queue should be empty");
+    }
+    BOOST_CHECK_MESSAGE(called == 40,"wrong number of jobs called");
+}
+
+BOOST_AUTO_TEST_CASE( post_multiqueue_threadpool_scheduler_lockfree_ring_queue )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                boost::asynchronous::multiqueue_threadpool_scheduler<boost::asynchronous::lockfree_ring_queue<>>>(4,4);
+
+    std::vector<boost::thread::id> sids = scheduler.thread_ids();
+    BOOST_CHECK_MESSAGE(number_of_threads(sids.begin(),sids.end())==4,"scheduler has wrong number of threads");
+    std::vector<std::future<boost::thread::id> > fus;
+    for (int i = 0 ; i< 40 ; ++i)
+    {
+        std::shared_ptr<std::promise<boost::thread::id> > p = std::make_shared<std::promise<boost::thread::id> >();
+        fus.push_back(p->get_future());
+        scheduler.post(boost::asynchronous::any_callable(DummyJob(p)));
+    }
+    boost::wait_for_all(fus.begin(), fus.end());
+    std::set<boost::thread::id> ids;
+
+    for (std::vector<std::future<boost::thread::id> >::iterator it = fus.begin(); it != fus.end() ; ++it)
+    {
+        boost::thread::id tid = (*it).get();
+        std::vector<boost::thread::id> itids = scheduler.thread_ids();
+        BOOST_CHECK_MESSAGE(contains_id(itids.begin(),itids.end(),tid),"task executed in the wrong thread");
+        ids.insert(tid);
+    }
+    BOOST_CHECK_MESSAGE(ids.size() <=4,"too many threads used in scheduler");
+}
+
+BOOST_AUTO_TEST_CASE( post_stealing_multiqueue_threadpool_scheduler_lockfree_ring_queue )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                boost::asynchronous::stealing_multiqueue_threadpool_scheduler<
+                        boost::asynchronous::lockfree_ring_queue<>,boost::asynchronous::default_find_position<>,
+                                boost::asynchronous::no_cpu_load_saving,true>>
+                            (4,4);
+
+    std::vector<boost::thread::id> sids = scheduler.thread_ids();
+    BOOST_CHECK_MESSAGE(number_of_threads(sids.begin(),sids.end())==4,"scheduler has wrong number of threads");
+    std::vector<std::future<boost::thread::id> > fus;
+    for (int i = 0 ; i< 40 ; ++i)
+    {
+        std::shared_ptr<std::promise<boost::thread::id> > p = std::make_shared<std::promise<boost::thread::id> >();
+        fus.push_back(p->get_future());
+        scheduler.post(boost::asynchronous::any_callable(DummyJob(p)));
+    }
+    boost::wait_for_all(fus.begin(), fus.end());
+    std::set<boost::thread::id> ids;
+
+    for (std::vector<std::future<boost::thread::id> >::iterator it = fus.begin(); it != fus.end() ; ++it)
+    {
+        boost::thread::id tid = (*it).get();
+        std::vector<boost::thread::id> itids = scheduler.thread_ids();
+        BOOST_CHECK_MESSAGE(contains_id(itids.begin(),itids.end(),tid),"task executed in the wrong thread");
+        ids.insert(tid);
+    }
+    BOOST_CHECK_MESSAGE(ids.size() <=4,"too many threads used in scheduler");
+}
+
+BOOST_AUTO_TEST_CASE( work_stealing_deque_owner_lifo_thief_fifo )
+{
+    boost::asynchronous::work_stealing_deque<boost::asynchronous::any_callable> queue(4);
+    boost::asynchronous::any_callable job;
+    // the first thread popping becomes the owner
+    BOOST_CHECK_MESSAGE(!queue.try_pop(job),"queue should be empty");
+    std::vector<int> order;
+    // more jobs than capacity, the last ones go to the inbox
+    for (int i = 0 ; i< 6 ; ++i)
+    {
+        queue.push(boost::asynchronous::any_callable([&order,i](){order.push_back(i);}));
+    }
+    BOOST_CHECK_MESSAGE(queue.get_queue_size()[0] == 6,"wrong queue size");
+    // thief takes the oldest
+    BOOST_CHECK_MESSAGE(queue.try_steal(job),"steal should succeed");
+    job();
+    // owner takes the newest of its deque
+    BOOST_CHECK_MESSAGE(queue.try_pop(job),"pop should succeed");
+    job();
+    while (queue.try_pop(job))
+    {
+        job();
+    }
+    std::vector<int> expected = {0,3,2,1,4,5};
+    BOOST_CHECK_MESSAGE(order == expected,"wrong execution order");
+    BOOST_CHECK_MESSAGE(queue.get_queue_size()[0] == 0,"queue should be empty");
+}
+
+BOOST_AUTO_TEST_CASE( work_stealing_deque_concurrent_steal )
+{
+    boost::asynchronous::work_stealing_deque<boost::asynchronous::any_callable> queue(64);
+    std::atomic<int> called(0);
+    std::atomic<bool> done(false);
+    boost::asynchronous::any_callable job;
+    BOOST_CHECK_MESSAGE(!queue.try_pop(job),"queue should be empty");
+    std::vector<boost::thread> thieves;
+    for (int t = 0 ; t < 3 ; ++t)
+    {
+        thieves.emplace_back([&queue,&done]()
+        {
+            boost::asynchronous::any_callable stolen;
+            while (!done.load())
+            {
+                if (queue.try_steal(stolen))
+                    stolen();
+            }
+            while (queue.try_steal(stolen))
+                stolen();
+        });
+    }
+    for (int i = 0 ; i< 100000 ; ++i)
+    {
+        queue.push(boost::asynchronous::any_callable([&called](){++called;}));
+        if (i % 3 == 0 && queue.try_pop(job))
+            job();
+    }
+    while (queue.try_pop(job))
+    {
+        job();
+    }
+    done = true;
+    for (auto& t : thieves)
+    {
+        t.join();
+    }
+    BOOST_CHECK_MESSAGE(called.load() == 100000,"jobs lost or executed twice: " << called.load());
+}
+
+BOOST_AUTO_TEST_CASE( post_stealing_multiqueue_threadpool_scheduler_work_stealing_deque )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                boost::asynchronous::stealing_multiqueue_threadpool_scheduler<
+                        boost::asynchronous::work_stealing_deque<>,boost::asynchronous::default_find_position<>,
+                                boost::asynchronous::no_cpu_load_saving,true>>
+                            (4,16);
+
+    std::vector<boost::thread::id> sids = scheduler.thread_ids();
+    BOOST_CHECK_MESSAGE(number_of_threads(sids.begin(),sids.end())==4,"scheduler has wrong number of threads");
+    std::vector<std::future<boost::thread::id> > fus;
+    for (int i = 0 ; i< 40 ; ++i)
+    {
+        std::shared_ptr<std::promise<boost::thread::id> > p = std::make_shared<std::promise<boost::thread::id> >();
+        fus.push_back(p->get_future());
+        scheduler.post(boost::asynchronous::any_callable(DummyJob(p)));
+    }
+    boost::wait_for_all(fus.begin(), fus.end());
+    std::set<boost::thread::id> ids;
+
+    for (std::vector<std::future<boost::thread::id> >::iterator it = fus.begin(); it != fus.end() ; ++it)
+    {
+        boost::thread::id tid = (*it).get();
+        std::vector<boost::thread::id> itids = scheduler.thread_ids();
+        BOOST_CHECK_MESSAGE(contains_id(itids.begin(),itids.end(),tid),"task executed in the wrong thread");
+        ids.insert(tid);
+    }
+    BOOST_CHECK_MESSAGE(ids.size() <=4,"too many threads used in scheduler");
+}
+
+BOOST_AUTO_TEST_CASE( local_find_position_spawn_locality )
+{
+    typedef boost::asynchronous::lockfree_ring_queue<> queue_type;
+    std::vector<std::shared_ptr<queue_type> > queues;
+    std::vector<std::shared_ptr<queue_type> > other_pool_queues;
+    for (int i = 0 ; i< 4 ; ++i)
+    {
+        queues.push_back(std::make_shared<queue_type>(16));
+        other_pool_queues.push_back(std::make_shared<queue_type>(16));
+    }
+    boost::asynchronous::local_find_position<4> policy;
+    // not a worker thread: random
+    std::set<std::size_t> positions;
+    for (int i = 0 ; i< 100 ; ++i)
+    {
+        positions.insert(boost::asynchronous::detail::find_queue_position(policy,0,queues));
+    }
+    BOOST_CHECK_MESSAGE(positions.size() > 1,"jobs posted from outside should be distributed");
+
+    // behave as worker 2 of the pool
+    boost::asynchronous::get_own_queue_index<>(3,true);
+    boost::asynchronous::get_own_queue<>(queues[2].get(),true);
+    for (int i = 0 ; i< 4 ; ++i)
+    {
+        std::size_t pos = boost::asynchronous::detail::find_queue_position(policy,0,queues);
+        BOOST_CHECK_MESSAGE(pos == 2,"job posted by a worker should stay local");
+        queues[pos]->push(boost::asynchronous::any_callable([](){}));
+    }
+    // local queue is full enough, spill
+    positions.clear();
+    for (int i = 0 ; i< 100 ; ++i)
+    {
+        positions.insert(boost::asynchronous::detail::find_queue_position(policy,0,queues));
+    }
+    BOOST_CHECK_MESSAGE(positions.size() > 1,"jobs should spill to other queues");
+    // continuations post sub-tasks to their own queue index, which spills the same way
+    positions.clear();
+    for (int i = 0 ; i< 100 ; ++i)
+    {
+        positions.insert(boost::asynchronous::detail::find_queue_position(policy,3,queues));
+    }
+    BOOST_CHECK_MESSAGE(positions.size() > 1,"sub-tasks should spill to other queues");
+    // a worker of another pool does not count as local
+    positions.clear();
+    for (int i = 0 ; i< 100 ; ++i)
+    {
+        positions.insert(boost::asynchronous::detail::find_queue_position(policy,0,other_pool_queues));
+    }
+    BOOST_CHECK_MESSAGE(positions.size() > 1,"worker of another pool should not be local");
+    // explicit positions are still honoured
+    BOOST_CHECK_MESSAGE(boost::asynchronous::detail::find_queue_position(policy,1,queues) == 0,"wrong explicit position");
+    boost::asynchronous::get_own_queue_index<>(0,true);
+    boost::asynchronous::get_own_queue<>(nullptr,true);
+}
+
+BOOST_AUTO_TEST_CASE( post_multiqueue_threadpool_scheduler_local_find_position )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                boost::asynchronous::multiqueue_threadpool_scheduler<
+                        boost::asynchronous::lockfree_ring_queue<>,
+                        boost::asynchronous::local_find_position<8>>>
+                            (4,128);
+    auto fu = boost::asynchronous::post_future(scheduler,
+                []()
+                {
+                    auto pool = boost::asynchronous::get_thread_scheduler<>().lock();
+                    std::vector<std::future<boost::thread::id> > fus;
+                    for (int i = 0 ; i< 100 ; ++i)
+                    {
+                        std::shared_ptr<std::promise<boost::thread::id> > p = std::make_shared<std::promise<boost::thread::id> >();
+                        fus.push_back(p->get_future());
+                        pool.post(boost::asynchronous::any_callable(DummyJob(p)));
+                    }
+                    return fus;
+                });
+    auto fus = fu.get();
+    boost::wait_for_all(fus.begin(), fus.end());
+    std::vector<boost::thread::id> itids = scheduler.thread_ids();
+    for (auto& sub : fus)
+    {
+        BOOST_CHECK_MESSAGE(contains_id(itids.begin(),itids.end(),sub.get()),"task executed in the wrong thread");
+    }
+}
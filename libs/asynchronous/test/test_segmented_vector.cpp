@@ -0,0 +1,264 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2015
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <vector>
+
+#include <boost/asynchronous/container/segmented_vector.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/post.hpp>
+#include <boost/asynchronous/algorithm/parallel_for.hpp>
+#include <boost/asynchronous/algorithm/parallel_reduce.hpp>
+#include <boost/asynchronous/algorithm/parallel_sort.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+std::atomic<int> ctor_count(0);
+std::atomic<int> dtor_count(0);
+struct some_type
+{
+    some_type(int d=0)
+        :data(d)
+    {
+        ++ctor_count;
+    }
+    some_type(some_type const& rhs)
+        :data(rhs.data)
+    {
+        ++ctor_count;
+    }
+    some_type(some_type&& rhs)
+        :data(rhs.data)
+    {
+        ++ctor_count;
+    }
+    some_type& operator=(some_type const&)=default;
+    some_type& operator=(some_type&&)=default;
+
+    ~some_type()
+    {
+        ++dtor_count;
+    }
+
+    int data;
+};
+
+bool operator== (some_type const& lhs, some_type const& rhs)
+{
+    return rhs.data == lhs.data;
+}
+
+typedef boost::asynchronous::segmented_vector<int,16> small_segments;
+
+auto make_scheduler()
+{
+    return boost::asynchronous::make_shared_scheduler_proxy<
+                boost::asynchronous::multiqueue_threadpool_scheduler<
+                    boost::asynchronous::lockfree_queue<>>>(4);
+}
+}
+
+BOOST_AUTO_TEST_CASE( test_segmented_vector_push_back )
+{
+    {
+        boost::asynchronous::segmented_vector<some_type,16> v;
+        BOOST_CHECK_MESSAGE(v.empty(),"segmented_vector should be empty.");
+        for (auto i = 0; i < 100; ++i)
+        {
+            v.push_back(some_type(i));
+        }
+        BOOST_CHECK_MESSAGE(v.size()==100,"segmented_vector size should be 100.");
+        BOOST_CHECK_MESSAGE(v.segments().size()==7,"segmented_vector should have 7 segments.");
+        bool ok = true;
+        for (auto i = 0; i < 100; ++i)
+        {
+            ok = ok && (v[i].data == i);
+        }
+        BOOST_CHECK_MESSAGE(ok,"segmented_vector[i] should have value i.");
+        BOOST_CHECK_MESSAGE(v.front().data == 0 && v.back().data == 99,"wrong front or back.");
+        // elements never move
+        some_type* first = &v[0];
+        v.emplace_back(v[0]);
+        BOOST_CHECK_MESSAGE(&v[0] == first,"elements should not move.");
+        BOOST_CHECK_MESSAGE(v.back().data == 0,"last element should have value 0.");
+        for (auto i = 0; i < 90; ++i)
+        {
+            v.pop_back();
+        }
+        BOOST_CHECK_MESSAGE(v.size()==11 && v.back().data == 10,"wrong size or back after pop_back.");
+        BOOST_CHECK_MESSAGE(v.segments().size()==1,"segmented_vector should have 1 segment.");
+        BOOST_CHECK_THROW(v.at(11),std::out_of_range);
+    }
+    // vector is destroyed, check we got one dtor for each ctor
+    BOOST_CHECK_MESSAGE(ctor_count.load()==dtor_count.load(),"wrong number of ctors/dtors called.");
+}
+
+BOOST_AUTO_TEST_CASE( test_segmented_vector_iterators )
+{
+    small_segments v;
+    small_segments v2;
+    for (auto i = 0; i < 40; ++i)
+    {
+        v.push_back(i);
+        v2.push_back(i + 40);
+    }
+    // partial segments in the middle
+    v.splice(std::move(v2));
+    for (auto i = 80; i < 100; ++i)
+    {
+        v.push_back(i);
+    }
+    std::vector<int> ref(100);
+    std::iota(ref.begin(),ref.end(),0);
+    BOOST_CHECK_MESSAGE(v.end() - v.begin() == 100,"wrong distance.");
+    BOOST_CHECK_MESSAGE(std::equal(v.begin(),v.end(),ref.begin()),"forward iteration failed.");
+    BOOST_CHECK_MESSAGE(std::equal(std::reverse_iterator<small_segments::iterator>(v.end()),
+                                   std::reverse_iterator<small_segments::iterator>(v.begin()),ref.rbegin()),
+                        "backward iteration failed.");
+    bool ok = true;
+    for (std::ptrdiff_t i = 0; i < 100; ++i)
+    {
+        for (std::ptrdiff_t j = 0; j < 100; j += 7)
+        {
+            auto it = v.begin() + i;
+            ok = ok && (*(it + (j - i)) == j) && (it[j - i] == j) && ((v.end() - (100 - i)) == it);
+        }
+    }
+    BOOST_CHECK_MESSAGE(ok,"random access failed.");
+    small_segments::const_iterator cit = v.begin();
+    BOOST_CHECK_MESSAGE(cit == v.cbegin() && cit < v.cend(),"const_iterator comparison failed.");
+    std::reverse(v.begin(),v.end());
+    std::sort(v.begin(),v.end());
+    BOOST_CHECK_MESSAGE(std::equal(v.begin(),v.end(),ref.begin()),"std::sort failed.");
+}
+
+BOOST_AUTO_TEST_CASE( test_segmented_vector_splice )
+{
+    {
+        boost::asynchronous::segmented_vector<some_type,16> v1(20,some_type(1));
+        boost::asynchronous::segmented_vector<some_type,16> v2(30,some_type(2));
+        some_type* first = &v2[0];
+        auto ctors = ctor_count.load();
+        v1.splice(std::move(v2));
+        BOOST_CHECK_MESSAGE(ctor_count.load() == ctors,"splice should not move elements.");
+        BOOST_CHECK_MESSAGE(v2.empty(),"spliced segmented_vector should be empty.");
+        BOOST_CHECK_MESSAGE(v1.size()==50,"segmented_vector size should be 50.");
+        BOOST_CHECK_MESSAGE(&v1[20] == first,"spliced elements should not move.");
+        BOOST_CHECK_MESSAGE(v1[19].data == 1 && v1[20].data == 2 && v1[49].data == 2,"wrong elements after splice.");
+        // the moved-from vector can be reused
+        v2.push_back(some_type(3));
+        BOOST_CHECK_MESSAGE(v2.size()==1 && v2[0].data == 3,"wrong element after reuse.");
+        boost::asynchronous::segmented_vector<some_type,16> v3(v1);
+        BOOST_CHECK_MESSAGE(v3 == v1,"copy should be equal.");
+    }
+    BOOST_CHECK_MESSAGE(ctor_count.load()==dtor_count.load(),"wrong number of ctors/dtors called.");
+}
+
+BOOST_AUTO_TEST_CASE( test_segmented_vector_parallel_algorithms )
+{
+    boost::asynchronous::segmented_vector<int,128> v;
+    for (auto i = 0; i < 10000; ++i)
+    {
+        v.push_back((i * 7919) % 10000);
+    }
+    auto scheduler = make_scheduler();
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [&v]()
+        {
+            return boost::asynchronous::parallel_for(v.begin(),v.end(),[](int& i){i *= 2;},500);
+        });
+    fu.get();
+    auto fu2 = boost::asynchronous::post_future(scheduler,
+        [&v]()
+        {
+            return boost::asynchronous::parallel_sort(v.begin(),v.end(),std::less<int>(),500);
+        });
+    fu2.get();
+    bool ok = true;
+    for (auto i = 0; i < 10000; ++i)
+    {
+        ok = ok && (v[i] == 2 * i);
+    }
+    BOOST_CHECK_MESSAGE(ok,"parallel_for or parallel_sort failed.");
+    auto fu3 = boost::asynchronous::post_future(scheduler,
+        [&v]()
+        {
+            return boost::asynchronous::parallel_reduce(v.begin(),v.end(),[](int a, int b){return a + b;},500);
+        });
+    BOOST_CHECK_MESSAGE(fu3.get() == 9999 * 10000,"parallel_reduce failed.");
+}
+
+BOOST_AUTO_TEST_CASE( test_segmented_collector )
+{
+    typedef boost::asynchronous::segmented_collector<int,64> collector_type;
+    auto collector = std::make_shared<collector_type>();
+    auto scheduler = make_scheduler();
+    std::vector<std::future<void>> fus;
+    for (int t = 0; t < 16; ++t)
+    {
+        fus.push_back(boost::asynchronous::post_future(scheduler,
+            [collector,t]()
+            {
+                auto appender = collector->make_appender();
+                for (int i = 0; i < 1000; ++i)
+                {
+                    appender.push_back(t * 1000 + i);
+                }
+            }));
+    }
+    for (auto& fu : fus)
+    {
+        fu.get();
+    }
+    boost::asynchronous::segmented_vector<int,64> v = collector->take();
+    BOOST_CHECK_MESSAGE(v.size()==16000,"collected size should be 16000.");
+    // elements of one appender keep their order
+    std::vector<int> last(16,-1);
+    bool ordered = true;
+    for (int i : v)
+    {
+        ordered = ordered && (i % 1000 == last[i / 1000] + 1);
+        last[i / 1000] = i % 1000;
+    }
+    BOOST_CHECK_MESSAGE(ordered,"appender order not kept.");
+    std::sort(v.begin(),v.end());
+    std::vector<int> ref(16000);
+    std::iota(ref.begin(),ref.end(),0);
+    BOOST_CHECK_MESSAGE(std::equal(v.begin(),v.end(),ref.begin()),"wrong collected elements.");
+    BOOST_CHECK_MESSAGE(collector->take().empty(),"collector should be empty after take.");
+}
+
+BOOST_AUTO_TEST_CASE( test_segmented_vector_flatten )
+{
+    small_segments v;
+    small_segments v2;
+    for (auto i = 0; i < 1000; ++i)
+    {
+        v.push_back(i);
+        v2.push_back(i + 1000);
+    }
+    v.push_back(2000);
+    v.splice(std::move(v2));
+    auto scheduler = make_scheduler();
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [v]()mutable
+        {
+            return boost::asynchronous::parallel_flatten(std::move(v),100);
+        });
+    boost::asynchronous::vector<int> res = fu.get();
+    BOOST_CHECK_MESSAGE(res.size()==2001,"flattened size should be 2001.");
+    BOOST_CHECK_MESSAGE(std::equal(v.begin(),v.end(),res.begin()),"wrong flattened elements.");
+}
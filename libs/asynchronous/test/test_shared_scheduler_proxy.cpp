@@ -0,0 +1,147 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#include <vector>
+#include <future>
+#include <atomic>
+
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/scheduler/single_thread_scheduler.hpp>
+#include <boost/asynchronous/scheduler/threadpool_scheduler.hpp>
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/servant_proxy.hpp>
+#include <boost/asynchronous/trackable_servant.hpp>
+#include <boost/asynchronous/post.hpp>
+#include "test_common.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::asynchronous::test;
+
+namespace
+{
+typedef boost::asynchronous::threadpool_scheduler<boost::asynchronous::lockfree_queue<>> pool_type;
+
+// the worker pool is kept typed, the servant's own worker is its type-erased version
+struct Servant : boost::asynchronous::trackable_servant<>
+{
+    Servant(boost::asynchronous::any_weak_scheduler<> scheduler,
+            boost::asynchronous::shared_scheduler_proxy<pool_type> pool)
+        : boost::asynchronous::trackable_servant<>(scheduler,pool)
+        , m_pool(pool)
+    {
+    }
+    std::future<int> start()
+    {
+        std::shared_ptr<std::promise<int>> p = std::make_shared<std::promise<int>>();
+        std::future<int> fu = p->get_future();
+        // free post_callback with the typed pool
+        boost::asynchronous::post_callback(
+                    m_pool,
+                    [](){return 21;},
+                    get_scheduler(),
+                    [this,p](boost::asynchronous::expected<int> res)
+                    {
+                        BOOST_CHECK_MESSAGE(!contains_id(m_pool.thread_ids().begin(),m_pool.thread_ids().end(),
+                                                         boost::this_thread::get_id()),"callback executed in the wrong thread(pool)");
+                        int first = res.get();
+                        // trackable_servant's post_callback, using the converted pool
+                        this->post_callback(
+                                    [](){return 21;},
+                                    [first,p](boost::asynchronous::expected<int> res)
+                                    {
+                                        p->set_value(first + res.get());
+                                    });
+                    });
+        return fu;
+    }
+    boost::asynchronous::shared_scheduler_proxy<pool_type> m_pool;
+};
+
+class ServantProxy : public boost::asynchronous::servant_proxy<ServantProxy,Servant>
+{
+public:
+    template <class Scheduler>
+    ServantProxy(Scheduler s, boost::asynchronous::shared_scheduler_proxy<pool_type> pool):
+        boost::asynchronous::servant_proxy<ServantProxy,Servant>(s,pool)
+    {}
+    BOOST_ASYNC_FUTURE_MEMBER(start)
+};
+}
+
+BOOST_AUTO_TEST_CASE( test_shared_scheduler_proxy_post_future )
+{
+    auto scheduler = boost::asynchronous::make_typed_shared_scheduler_proxy<pool_type>(3);
+    BOOST_CHECK_MESSAGE(scheduler.is_valid(),"typed proxy should be valid");
+    std::vector<boost::thread::id> tids = scheduler.thread_ids();
+    BOOST_CHECK_MESSAGE(number_of_threads(tids.begin(),tids.end())==3,"scheduler has wrong number of threads");
+
+    std::vector<std::future<boost::thread::id>> fus;
+    for (int i = 0 ; i < 100 ; ++i)
+    {
+        fus.push_back(boost::asynchronous::post_future(scheduler,[](){return boost::this_thread::get_id();}));
+    }
+    for (auto& fu : fus)
+    {
+        boost::thread::id tid = fu.get();
+        BOOST_CHECK_MESSAGE(contains_id(tids.begin(),tids.end(),tid),"task executed in the wrong thread");
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_shared_scheduler_proxy_post )
+{
+    auto scheduler = boost::asynchronous::make_typed_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<boost::asynchronous::lockfree_queue<>>>(2);
+    std::atomic<int> counter(0);
+    for (int i = 0 ; i < 1000 ; ++i)
+    {
+        scheduler.post([&counter](){++counter;},static_cast<std::size_t>(i%3));
+    }
+    // jobs are executed in order per queue, post a last one in each queue
+    auto fu1 = boost::asynchronous::post_future(scheduler,[](){},"",1);
+    auto fu2 = boost::asynchronous::post_future(scheduler,[](){},"",2);
+    fu1.get();
+    fu2.get();
+    // multiqueue schedulers report the sum of their queues
+    BOOST_CHECK_MESSAGE(scheduler.get_queue_size().size() == 1,"wrong queue size vector");
+    scheduler.reset();
+    BOOST_CHECK_MESSAGE(!scheduler.is_valid(),"reset proxy should be invalid");
+    // scheduler stopped and joined, all jobs must have run
+    BOOST_CHECK_MESSAGE(counter == 1000,"not all jobs executed");
+}
+
+BOOST_AUTO_TEST_CASE( test_shared_scheduler_proxy_conversion )
+{
+    auto scheduler = boost::asynchronous::make_typed_shared_scheduler_proxy<pool_type>(2);
+    boost::asynchronous::any_shared_scheduler_proxy<> erased = scheduler;
+    BOOST_CHECK_MESSAGE(erased.is_valid(),"converted proxy should be valid");
+    BOOST_CHECK_MESSAGE(erased.thread_ids() == scheduler.thread_ids(),"converted proxy should share the scheduler");
+
+    // the erased copy keeps the scheduler alive
+    scheduler.reset();
+    auto fu = boost::asynchronous::post_future(erased,[](){return 42;});
+    BOOST_CHECK_MESSAGE(fu.get() == 42,"wrong result");
+
+    boost::asynchronous::shared_scheduler_proxy<pool_type> empty;
+    boost::asynchronous::any_shared_scheduler_proxy<> erased_empty = empty;
+    BOOST_CHECK_MESSAGE(!erased_empty.is_valid(),"converted empty proxy should be invalid");
+}
+
+BOOST_AUTO_TEST_CASE( test_shared_scheduler_proxy_post_callback )
+{
+    auto servant_scheduler = boost::asynchronous::make_typed_shared_scheduler_proxy<
+                                boost::asynchronous::single_thread_scheduler<boost::asynchronous::lockfree_queue<>>>();
+    auto pool = boost::asynchronous::make_typed_shared_scheduler_proxy<pool_type>(2);
+    {
+        ServantProxy proxy(boost::asynchronous::any_shared_scheduler_proxy<>(servant_scheduler),pool);
+        auto fu = proxy.start();
+        BOOST_CHECK_MESSAGE(fu.get().get() == 42,"wrong result");
+    }
+}
@@ -0,0 +1,323 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#include <vector>
+#include <functional>
+#include <random>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <algorithm>
+#include <string>
+
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/post.hpp>
+#include <boost/asynchronous/algorithm/parallel_count.hpp>
+#include <boost/asynchronous/algorithm/parallel_find_all.hpp>
+#include <boost/asynchronous/algorithm/parallel_equal.hpp>
+#include <boost/asynchronous/algorithm/parallel_mismatch.hpp>
+#include <boost/asynchronous/algorithm/parallel_extremum.hpp>
+#include <boost/asynchronous/algorithm/parallel_all_of.hpp>
+#include <boost/asynchronous/algorithm/parallel_any_of.hpp>
+#include <boost/asynchronous/algorithm/parallel_none_of.hpp>
+#include <boost/asynchronous/algorithm/parallel_inner_product.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+namespace simd = boost::asynchronous::detail::simd;
+
+// every instruction set of this cpu, the kernels are tested with each
+std::vector<simd::level> levels()
+{
+    std::vector<simd::level> res = {simd::level::none};
+    for (simd::level l : {simd::level::sse2,simd::level::avx2,simd::level::avx512})
+    {
+        if (static_cast<int>(l) <= static_cast<int>(simd::detected_level()))
+            res.push_back(l);
+    }
+    return res;
+}
+struct restore_level
+{
+    ~restore_level()
+    {
+        simd::active_level() = simd::detected_level();
+    }
+};
+
+// small values, so that predicates are true for some elements
+template <class T>
+std::vector<T> generate(std::size_t n)
+{
+    std::mt19937 mt(static_cast<unsigned int>(n));
+    std::uniform_int_distribution<int> dis(0,20);
+    std::vector<T> data(n);
+    for (auto& d : data)
+    {
+        d = static_cast<T>(dis(mt));
+    }
+    return data;
+}
+const std::size_t sizes[] = {0,1,7,15,16,17,63,64,65,129,1000,4097};
+
+template <class T, class Pred>
+void check_value_kernels(T const* p, std::size_t n, Pred pred, bool expected_applied)
+{
+    long c = -1;
+    BOOST_CHECK_EQUAL(simd::count_if(p,p+n,pred,c),expected_applied);
+    if (expected_applied)
+        BOOST_CHECK_EQUAL(c,std::count_if(p,p+n,pred));
+
+    T const* it = nullptr;
+    BOOST_CHECK_EQUAL(simd::find_if(p,p+n,pred,true,it),expected_applied);
+    if (expected_applied)
+        BOOST_CHECK(it == std::find_if(p,p+n,pred));
+    BOOST_CHECK_EQUAL(simd::find_if(p,p+n,pred,false,it),expected_applied);
+    if (expected_applied)
+        BOOST_CHECK(it == std::find_if_not(p,p+n,pred));
+
+    std::vector<T> copied;
+    BOOST_CHECK_EQUAL(simd::copy_if(p,p+n,pred,std::back_inserter(copied)),expected_applied);
+    if (expected_applied)
+    {
+        std::vector<T> expected;
+        std::copy_if(p,p+n,std::back_inserter(expected),pred);
+        BOOST_CHECK(copied == expected);
+    }
+}
+
+template <class T>
+void check_kernels(simd::level l)
+{
+    bool const applied = (l != simd::level::none);
+    for (std::size_t n : sizes)
+    {
+        std::vector<T> data = generate<T>(n + 3);
+        // also unaligned
+        for (std::size_t offset = 0; offset < 3; ++offset)
+        {
+            T const* p = data.data() + offset;
+            check_value_kernels(p,n,boost::asynchronous::equal_to_value<T>(T(10)),applied);
+            check_value_kernels(p,n,boost::asynchronous::less_than_value<T>(T(3)),applied);
+            check_value_kernels(p,n,boost::asynchronous::greater_than_value<T>(T(19)),applied);
+            // never and always true
+            check_value_kernels(p,n,boost::asynchronous::equal_to_value<T>(T(42)),applied);
+            check_value_kernels(p,n,boost::asynchronous::less_than_value<T>(T(42)),applied);
+
+            // mismatch at every position of a vector and its tail
+            std::vector<T> copy(p,p+n);
+            for (std::size_t pos : {std::size_t(0),n/2,n > 0 ? n-1 : 0,n})
+            {
+                std::vector<T> other = copy;
+                if (pos < n)
+                    other[pos] = T(99);
+                std::pair<T const*,T*> res;
+                BOOST_CHECK_EQUAL(simd::mismatch(p,p+n,other.data(),std::equal_to<T>(),res),applied);
+                if (applied)
+                {
+                    BOOST_CHECK_EQUAL(res.first - p,std::mismatch(p,p+n,other.data()).first - p);
+                    BOOST_CHECK(res.second == other.data() + (res.first - p));
+                }
+            }
+
+            if (n > 0)
+            {
+                T min_value = 0;
+                BOOST_CHECK_EQUAL(simd::reduce(p,p+n,boost::asynchronous::detail::selector2<std::less<T>,T>(std::less<T>()),min_value),applied);
+                if (applied)
+                    BOOST_CHECK_EQUAL(min_value,*std::min_element(p,p+n));
+                T max_value = 0;
+                BOOST_CHECK_EQUAL(simd::reduce(p,p+n,boost::asynchronous::detail::selector2<std::greater<T>,T>(std::greater<T>()),max_value),applied);
+                if (applied)
+                    BOOST_CHECK_EQUAL(max_value,*std::max_element(p,p+n));
+
+                T dot = 0;
+                BOOST_CHECK_EQUAL(simd::inner_product(p,p+n,copy.data(),std::multiplies<T>(),std::plus<T>(),dot),applied);
+                if (applied)
+                {
+                    // small integers, exact also for floating point
+                    T expected = 0;
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        expected = static_cast<T>(expected + static_cast<T>(p[i] * p[i]));
+                    }
+                    BOOST_CHECK_EQUAL(dot,expected);
+                }
+            }
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE( test_simd_kernels_all_levels )
+{
+    restore_level r;
+    for (simd::level l : levels())
+    {
+        simd::active_level() = l;
+        check_kernels<std::uint8_t>(l);
+        check_kernels<std::int8_t>(l);
+        check_kernels<std::int16_t>(l);
+        check_kernels<std::int32_t>(l);
+        check_kernels<std::uint32_t>(l);
+        check_kernels<std::int64_t>(l);
+        check_kernels<float>(l);
+        check_kernels<double>(l);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_simd_kernels_not_applied )
+{
+    std::vector<int> data = generate<int>(100);
+    long c = 0;
+    // unknown predicate
+    BOOST_CHECK(!simd::count_if(data.begin(),data.end(),[](int i){return i == 10;},c));
+    // value of another type
+    BOOST_CHECK(!simd::count_if(data.begin(),data.end(),boost::asynchronous::equal_to_value<long>(10),c));
+    // not contiguous
+    std::list<int> l(data.begin(),data.end());
+    BOOST_CHECK(!simd::count_if(l.begin(),l.end(),boost::asynchronous::equal_to_value<int>(10),c));
+    // not std::multiplies / std::plus
+    int res = 0;
+    BOOST_CHECK(!simd::inner_product(data.begin(),data.end(),data.begin(),std::plus<int>(),std::plus<int>(),res));
+}
+
+BOOST_AUTO_TEST_CASE( test_simd_kernels_extremum_nan )
+{
+    restore_level r;
+    std::vector<double> data(100,1.0);
+    data[50] = std::numeric_limits<double>::quiet_NaN();
+    for (simd::level l : levels())
+    {
+        simd::active_level() = l;
+        double res = 0.0;
+        // the sequential loop is used, its result depends on the position of the NaN
+        BOOST_CHECK(!simd::reduce(data.begin(),data.end(),boost::asynchronous::detail::selector2<std::less<double>,double>(std::less<double>()),res));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_simd_kernels_search )
+{
+    restore_level r;
+    std::mt19937 mt(11);
+    std::uniform_int_distribution<int> dis('a','c');
+    std::string haystack(3000,'a');
+    for (auto& c : haystack)
+    {
+        c = static_cast<char>(dis(mt));
+    }
+    // the last one makes the kernel give up after a while
+    std::string long_a(100,'a');
+    std::string long_haystack(20000,'a');
+    long_haystack[15000] = 'b';
+    std::vector<std::pair<std::string,std::string>> inputs = {
+        {haystack,"a"},{haystack,"ab"},{haystack,"abc"},{haystack,"cabbac"},{haystack,std::string(haystack,100,40)},
+        {haystack,haystack},{"ab","abc"},{"",""},{long_haystack,long_a + "b"}};
+    for (simd::level l : levels())
+    {
+        simd::active_level() = l;
+        for (auto const& in : inputs)
+        {
+            std::vector<std::size_t> found;
+            auto f = [&found](std::size_t i){found.push_back(i);};
+            std::size_t done = 0;
+            bool const applied = simd::search(in.first.begin(),in.first.end(),in.second.begin(),in.second.end(),f,done);
+            BOOST_CHECK_EQUAL(applied,l != simd::level::none && !in.second.empty());
+            if (!applied)
+                continue;
+            BOOST_CHECK(done <= in.first.size());
+            std::vector<std::size_t> expected;
+            for (std::size_t pos = in.first.find(in.second); pos != std::string::npos && pos < done; pos = in.first.find(in.second,pos + 1))
+            {
+                expected.push_back(pos);
+            }
+            BOOST_CHECK(found == expected);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_simd_kernels_algorithms )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<>>>(4);
+    std::vector<int> data = generate<int>(100000);
+    std::vector<int> data2 = data;
+    data2[77777] = 1000;
+    auto fu = boost::asynchronous::post_future(scheduler,
+        [&data]()
+        {
+            return boost::asynchronous::parallel_count(data.begin(),data.end(),10,1500);
+        });
+    BOOST_CHECK_EQUAL(fu.get(),std::count(data.begin(),data.end(),10));
+    auto fu2 = boost::asynchronous::post_future(scheduler,
+        [&data]()
+        {
+            return boost::asynchronous::parallel_count_if(data.data(),data.data()+data.size(),boost::asynchronous::less_than_value<int>(5),1500);
+        });
+    BOOST_CHECK_EQUAL(fu2.get(),std::count_if(data.begin(),data.end(),[](int i){return i < 5;}));
+    auto fu3 = boost::asynchronous::post_future(scheduler,
+        [&data]()
+        {
+            return boost::asynchronous::parallel_find_all(data.begin(),data.end(),boost::asynchronous::greater_than_value<int>(18),1500);
+        });
+    std::vector<int> expected;
+    std::copy_if(data.begin(),data.end(),std::back_inserter(expected),[](int i){return i > 18;});
+    BOOST_CHECK(fu3.get() == expected);
+    auto fu4 = boost::asynchronous::post_future(scheduler,
+        [&data]()
+        {
+            return boost::asynchronous::parallel_all_of(data.begin(),data.end(),boost::asynchronous::less_than_value<int>(21),1500);
+        });
+    BOOST_CHECK(fu4.get());
+    auto fu5 = boost::asynchronous::post_future(scheduler,
+        [&data2]()
+        {
+            return boost::asynchronous::parallel_any_of(data2.begin(),data2.end(),boost::asynchronous::equal_to_value<int>(1000),1500);
+        });
+    BOOST_CHECK(fu5.get());
+    auto fu6 = boost::asynchronous::post_future(scheduler,
+        [&data]()
+        {
+            return boost::asynchronous::parallel_none_of(data.begin(),data.end(),boost::asynchronous::greater_than_value<int>(20),1500);
+        });
+    BOOST_CHECK(fu6.get());
+    auto fu7 = boost::asynchronous::post_future(scheduler,
+        [&data,&data2]()
+        {
+            return boost::asynchronous::parallel_equal(data.begin(),data.end(),data2.begin(),1500);
+        });
+    BOOST_CHECK(!fu7.get());
+    auto fu8 = boost::asynchronous::post_future(scheduler,
+        [&data,&data2]()
+        {
+            return boost::asynchronous::parallel_mismatch(data.begin(),data.end(),data2.begin(),std::equal_to<int>(),1500);
+        });
+    BOOST_CHECK(fu8.get().first == data.begin() + 77777);
+    auto fu9 = boost::asynchronous::post_future(scheduler,
+        [&data2]()
+        {
+            return boost::asynchronous::parallel_extremum(data2.begin(),data2.end(),std::greater<int>(),1500);
+        });
+    BOOST_CHECK_EQUAL(fu9.get(),1000);
+    auto fu10 = boost::asynchronous::post_future(scheduler,
+        [&data]()
+        {
+            return boost::asynchronous::parallel_inner_product(data.begin(),data.end(),data.begin(),
+                                                               std::multiplies<int>(),std::plus<int>(),0,1500);
+        });
+    BOOST_CHECK_EQUAL(fu10.get(),std::inner_product(data.begin(),data.end(),data.begin(),0));
+}
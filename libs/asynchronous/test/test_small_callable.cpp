@@ -0,0 +1,131 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+#include <vector>
+#include <future>
+#include <array>
+
+#include <boost/asynchronous/small_callable.hpp>
+#include <boost/asynchronous/scheduler/multiqueue_threadpool_scheduler.hpp>
+#include <boost/asynchronous/scheduler/threadpool_scheduler.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/queue/lockfree_ring_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/post.hpp>
+#include <boost/asynchronous/algorithm/parallel_for.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+typedef boost::asynchronous::small_callable servant_job;
+
+struct counted
+{
+    counted(int* alive):m_alive(alive){++*m_alive;}
+    counted(counted&& rhs)noexcept:m_alive(rhs.m_alive){++*m_alive;}
+    counted(counted const& rhs):m_alive(rhs.m_alive){++*m_alive;}
+    ~counted(){--*m_alive;}
+    void operator()(){}
+    int* m_alive;
+};
+struct big_counted : public counted
+{
+    big_counted(int* alive):counted(alive),m_data(){}
+    std::array<char,200> m_data;
+};
+struct move_only_task
+{
+    move_only_task(std::unique_ptr<int> i):m_i(std::move(i)){}
+    move_only_task(move_only_task&&)=default;
+    move_only_task(move_only_task const&)=delete;
+    int operator()()
+    {
+        return *m_i;
+    }
+    std::unique_ptr<int> m_i;
+};
+struct add_two
+{
+    void operator()(int& i)const
+    {
+        i += 2;
+    }
+};
+}
+
+BOOST_AUTO_TEST_CASE( test_small_callable_storage )
+{
+    int i = 0;
+    auto small = [&i](){++i;};
+    BOOST_CHECK_MESSAGE(servant_job::is_stored_inline<decltype(small)>(),"small lambda should be stored inline");
+    BOOST_CHECK_MESSAGE(!servant_job::is_stored_inline<big_counted>(),"big callable should be stored on the heap");
+
+    servant_job job(small);
+    BOOST_CHECK_MESSAGE(!job.empty(),"job should not be empty");
+    servant_job job2(std::move(job));
+    BOOST_CHECK_MESSAGE(job.empty(),"job should be empty after move");
+    job2();
+    BOOST_CHECK_MESSAGE(i == 1,"job not called");
+    job = std::move(job2);
+    job();
+    BOOST_CHECK_MESSAGE(i == 2,"job not called");
+}
+
+BOOST_AUTO_TEST_CASE( test_small_callable_destruction )
+{
+    int alive = 0;
+    {
+        servant_job job((counted(&alive)));
+        servant_job job2((big_counted(&alive)));
+        BOOST_CHECK_MESSAGE(alive == 2,"wrong number of living callables");
+        servant_job job3(std::move(job));
+        servant_job job4(std::move(job2));
+        BOOST_CHECK_MESSAGE(alive == 2,"wrong number of living callables after move");
+        job3 = std::move(job4);
+        BOOST_CHECK_MESSAGE(alive == 1,"move assignment did not destroy the previous callable");
+    }
+    BOOST_CHECK_MESSAGE(alive == 0,"callables not destroyed");
+}
+
+BOOST_AUTO_TEST_CASE( test_small_callable_post_future )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::multiqueue_threadpool_scheduler<
+                            boost::asynchronous::lockfree_ring_queue<servant_job>>>(3);
+
+    std::vector<std::future<int>> fus;
+    for (int i = 0 ; i< 100 ; ++i)
+    {
+        fus.emplace_back(boost::asynchronous::post_future(scheduler,[i](){return i;}));
+    }
+    fus.emplace_back(boost::asynchronous::post_future(scheduler,move_only_task(std::unique_ptr<int>(new int(100)))));
+    for (int i = 0 ; i< 101 ; ++i)
+    {
+        BOOST_CHECK_MESSAGE(fus[i].get() == i,"wrong result");
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_small_callable_parallel_for )
+{
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::threadpool_scheduler<
+                            boost::asynchronous::lockfree_queue<servant_job>>>(3);
+
+    std::vector<int> data(10000,1);
+    auto fu = boost::asynchronous::post_future(scheduler,
+                [&data]()
+                {
+                    // algorithms need to know the job type of the pool
+                    return boost::asynchronous::parallel_for<std::vector<int>::iterator,add_two,servant_job>
+                            (data.begin(),data.end(),add_two(),500);
+                });
+    fu.get();
+    BOOST_CHECK_MESSAGE(std::all_of(data.begin(),data.end(),[](int i){return i == 3;}),"parallel_for with small_callable failed");
+}
@@ -0,0 +1,157 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+// Many small jobs executed by a tcp client with different in-flight windows, with a tcp_server_scheduler
+// receiving them or stealing them from a threadpool.
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <future>
+#include <chrono>
+#include <atomic>
+#include <thread>
+
+#include <boost/asynchronous/scheduler/tcp/tcp_server_scheduler.hpp>
+#include <boost/asynchronous/scheduler/tcp/simple_tcp_client.hpp>
+#include <boost/asynchronous/scheduler/serializable_task.hpp>
+#include <boost/asynchronous/scheduler/composite_threadpool_scheduler.hpp>
+#include <boost/asynchronous/extensions/asio/asio_scheduler.hpp>
+#include <boost/asynchronous/scheduler/threadpool_scheduler.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/any_serializable.hpp>
+#include <boost/asynchronous/post.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+#define JOB_COUNT 1000
+// jobs executed by all clients
+std::atomic<int> executed(0);
+
+struct square_task : public boost::asynchronous::serializable_task
+{
+    square_task(int d = 0): boost::asynchronous::serializable_task("square_task"), m_data(d){}
+    template <class Archive>
+    void serialize(Archive & ar, const unsigned int /*version*/)
+    {
+        ar & m_data;
+    }
+    int operator()()const
+    {
+        return m_data * m_data;
+    }
+    int m_data;
+};
+
+typedef boost::asynchronous::tcp::simple_tcp_client_proxy_ext<
+            boost::asynchronous::tcp::client_time_check_policy<boost::asynchronous::any_serializable>,
+            boost::asynchronous::any_serializable> client_type;
+
+client_type make_client(std::string const& port, unsigned int window)
+{
+    std::function<void(std::string const&,boost::asynchronous::tcp::server_reponse,
+                       std::function<void(boost::asynchronous::tcp::client_request const&)>)> executor=
+    [](std::string const& task_name,boost::asynchronous::tcp::server_reponse resp,
+       std::function<void(boost::asynchronous::tcp::client_request const&)> when_done)
+    {
+        if (task_name=="square_task")
+        {
+            ++executed;
+            square_task t;
+            boost::asynchronous::tcp::deserialize_and_call_task(t,resp,when_done);
+        }
+    };
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<boost::asynchronous::asio_scheduler<>>();
+    auto pool = boost::asynchronous::make_shared_scheduler_proxy<
+                    boost::asynchronous::threadpool_scheduler<
+                        boost::asynchronous::lockfree_queue<boost::asynchronous::any_serializable>>>(1);
+    client_type client(scheduler,pool,"127.0.0.1",port,executor,10/*ms between retries*/,window);
+    client.run();
+    return client;
+}
+
+template <class Scheduler>
+double run_jobs(Scheduler pool)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::future<int>> fus;
+    fus.reserve(JOB_COUNT);
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        fus.push_back(boost::asynchronous::post_future(pool,square_task(i)));
+    }
+    bool ok = true;
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        ok = ok && (fus[i].get() == i * i);
+    }
+    BOOST_CHECK_MESSAGE(ok,"wrong results");
+    return JOB_COUNT / (std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::high_resolution_clock::now() - start).count() / 1000000.0);
+}
+}
+
+BOOST_AUTO_TEST_CASE( test_tcp_in_flight_window )
+{
+    auto workers = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::threadpool_scheduler<boost::asynchronous::lockfree_queue<>>>(1);
+    auto tcp_server = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::tcp_server_scheduler<
+                            boost::asynchronous::lockfree_queue<boost::asynchronous::any_serializable>>>
+                                (workers,"127.0.0.1",12361);
+    for (unsigned int window : {1u,4u,32u})
+    {
+        auto client = make_client("12361",window);
+        std::cout << "in-flight window " << window << ": " << run_jobs(tcp_server) << " jobs/s" << std::endl;
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_tcp_batched_stealing )
+{
+    auto workers = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::threadpool_scheduler<boost::asynchronous::lockfree_queue<>>>(1);
+    auto pool = boost::asynchronous::make_shared_scheduler_proxy<
+                    boost::asynchronous::threadpool_scheduler<
+                        boost::asynchronous::lockfree_queue<boost::asynchronous::any_serializable>>>(1);
+    auto tcp_server = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::tcp_server_scheduler<
+                            boost::asynchronous::lockfree_queue<boost::asynchronous::any_serializable>,
+                            boost::asynchronous::any_callable,true>>
+                                (workers,"127.0.0.1",12362);
+    // the tcp server steals from the pool for its clients
+    auto composite = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::composite_threadpool_scheduler<boost::asynchronous::any_serializable>>(pool,tcp_server);
+    auto client = make_client("12362",16);
+    std::cout << "stealing, in-flight window 16: " << run_jobs(pool) << " jobs/s" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE( test_tcp_disconnect_after_results )
+{
+    auto workers = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::threadpool_scheduler<boost::asynchronous::lockfree_queue<>>>(1);
+    auto tcp_server = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::tcp_server_scheduler<
+                            boost::asynchronous::lockfree_queue<boost::asynchronous::any_serializable>>>
+                                (workers,"127.0.0.1",12365);
+    executed = 0;
+    {
+        auto client = make_client("12365",16);
+        run_jobs(tcp_server);
+    }
+    // let the server see the disconnection. The jobs of this client all returned, none may be sent again
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    {
+        auto client = make_client("12365",16);
+        run_jobs(tcp_server);
+    }
+    BOOST_CHECK_MESSAGE(executed.load() == 2 * JOB_COUNT,"jobs executed " << executed.load() << " times instead of " << 2 * JOB_COUNT);
+}
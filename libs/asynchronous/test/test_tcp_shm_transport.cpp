@@ -0,0 +1,289 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+// Shared memory transport of the tcp server and client: the stream alone, then many small jobs executed by a client
+// connected through tcp or shared memory, printing the jobs/s of each, and a server stealing jobs for a shared memory client.
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <future>
+#include <functional>
+#include <array>
+#include <chrono>
+
+#include <boost/asynchronous/scheduler/tcp/detail/shm_stream.hpp>
+#include <boost/asynchronous/scheduler/tcp/tcp_server_scheduler.hpp>
+#include <boost/asynchronous/scheduler/tcp/simple_tcp_client.hpp>
+#include <boost/asynchronous/scheduler/serializable_task.hpp>
+#include <boost/asynchronous/scheduler/composite_threadpool_scheduler.hpp>
+#include <boost/asynchronous/extensions/asio/asio_scheduler.hpp>
+#include <boost/asynchronous/scheduler/threadpool_scheduler.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/any_serializable.hpp>
+#include <boost/asynchronous/post.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#ifdef BOOST_ASYNCHRONOUS_HAS_SHM_TRANSPORT
+namespace
+{
+#define JOB_COUNT 2000
+// more than a ring can take at once
+#define MESSAGE_SIZE (3 * BOOST_ASYNCHRONOUS_SHM_RING_SIZE + 17)
+#define ROUND_TRIPS 20000
+
+struct square_task : public boost::asynchronous::serializable_task
+{
+    square_task(int d = 0): boost::asynchronous::serializable_task("square_task"), m_data(d){}
+    template <class Archive>
+    void serialize(Archive & ar, const unsigned int /*version*/)
+    {
+        ar & m_data;
+    }
+    int operator()()const
+    {
+        return m_data * m_data;
+    }
+    int m_data;
+};
+
+template <class Transport>
+using client_type = boost::asynchronous::tcp::simple_tcp_client_proxy_ext<
+                        boost::asynchronous::tcp::client_time_check_policy<boost::asynchronous::any_serializable>,
+                        boost::asynchronous::any_serializable,
+                        boost::asynchronous::tcp::detail::client_wire_protocol,
+                        Transport>;
+
+template <class Transport>
+client_type<Transport> make_client(std::string const& port)
+{
+    std::function<void(std::string const&,boost::asynchronous::tcp::server_reponse,
+                       std::function<void(boost::asynchronous::tcp::client_request const&)>)> executor=
+    [](std::string const& task_name,boost::asynchronous::tcp::server_reponse resp,
+       std::function<void(boost::asynchronous::tcp::client_request const&)> when_done)
+    {
+        if (task_name=="square_task")
+        {
+            square_task t;
+            boost::asynchronous::tcp::deserialize_and_call_task(t,resp,when_done);
+        }
+    };
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<boost::asynchronous::asio_scheduler<>>();
+    auto pool = boost::asynchronous::make_shared_scheduler_proxy<
+                    boost::asynchronous::threadpool_scheduler<
+                        boost::asynchronous::lockfree_queue<boost::asynchronous::any_serializable>>>(1);
+    client_type<Transport> client(scheduler,pool,"127.0.0.1",port,executor,10/*ms between retries*/,32/*in-flight window*/);
+    client.run();
+    return client;
+}
+
+// a message goes back and forth between two connected streams, returns round trips per second
+template <class Stream>
+double round_trips(Stream& first, Stream& second, boost::asio::io_service& ios)
+{
+    std::array<char,100> ping{};
+    std::array<char,100> pong{};
+    int count = 0;
+    std::function<void()> next;
+    next = [&]()
+    {
+        boost::asio::async_write(first,boost::asio::buffer(ping),[&](boost::system::error_code ec, std::size_t)
+        {
+            BOOST_REQUIRE(!ec);
+        });
+        boost::asio::async_read(second,boost::asio::buffer(pong),[&](boost::system::error_code ec, std::size_t)
+        {
+            BOOST_REQUIRE(!ec);
+            boost::asio::async_write(second,boost::asio::buffer(pong),[&](boost::system::error_code ec1, std::size_t)
+            {
+                BOOST_REQUIRE(!ec1);
+            });
+            boost::asio::async_read(first,boost::asio::buffer(ping),[&](boost::system::error_code ec1, std::size_t)
+            {
+                BOOST_REQUIRE(!ec1);
+                if (++count < ROUND_TRIPS)
+                    next();
+                else
+                    ios.stop();
+            });
+        });
+    };
+    auto start = std::chrono::high_resolution_clock::now();
+    next();
+    ios.restart();
+    ios.run();
+    return ROUND_TRIPS / (std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::high_resolution_clock::now() - start).count() / 1000000.0);
+}
+
+template <class Scheduler>
+double run_jobs(Scheduler pool)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::future<int>> fus;
+    fus.reserve(JOB_COUNT);
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        fus.push_back(boost::asynchronous::post_future(pool,square_task(i)));
+    }
+    bool ok = true;
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        ok = ok && (fus[i].get() == i * i);
+    }
+    BOOST_CHECK_MESSAGE(ok,"wrong results");
+    return JOB_COUNT / (std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::high_resolution_clock::now() - start).count() / 1000000.0);
+}
+}
+
+BOOST_AUTO_TEST_CASE( test_shm_stream )
+{
+    typedef boost::asynchronous::tcp::detail::shm_stream shm_stream;
+    boost::asio::io_service ios;
+    std::string name = boost::asynchronous::tcp::detail::shm_endpoint_name("test_shm_stream",std::to_string(::getpid()));
+    boost::asio::local::stream_protocol::acceptor acceptor(ios,boost::asio::local::stream_protocol::endpoint(name));
+    auto server = std::make_shared<shm_stream>(ios);
+    auto client = std::make_shared<shm_stream>(ios);
+
+    std::vector<char> sent(MESSAGE_SIZE);
+    for (std::size_t i = 0; i < sent.size(); ++i)
+    {
+        sent[i] = (char)(i * 7);
+    }
+    std::vector<char> received(MESSAGE_SIZE);
+    char answer = 0;
+    boost::system::error_code read_error, eof_error;
+    std::size_t read_size = 0;
+
+    acceptor.async_accept(server->control_socket(),[&](boost::system::error_code ec)
+    {
+        BOOST_REQUIRE(!ec);
+        server->async_handshake([&](boost::system::error_code ec1)
+        {
+            BOOST_REQUIRE_MESSAGE(!ec1,"handshake failed: " << ec1.message());
+            boost::asio::async_read(*server,boost::asio::buffer(received),[&](boost::system::error_code ec2, std::size_t n)
+            {
+                read_error = ec2;
+                read_size = n;
+                boost::asio::async_write(*server,boost::asio::buffer("!",1),[&](boost::system::error_code, std::size_t){});
+                // the client closes after the answer
+                boost::asio::async_read(*server,boost::asio::buffer(&answer,1),[&](boost::system::error_code ec3, std::size_t)
+                {
+                    eof_error = ec3;
+                });
+            });
+        });
+    });
+    client->async_connect(name,[&](boost::system::error_code ec)
+    {
+        BOOST_REQUIRE_MESSAGE(!ec,"connect failed: " << ec.message());
+        // the server reads while we write
+        boost::asio::async_write(*client,boost::asio::buffer(sent),[&](boost::system::error_code ec1, std::size_t)
+        {
+            BOOST_REQUIRE(!ec1);
+            boost::asio::async_read(*client,boost::asio::buffer(&answer,1),[&](boost::system::error_code ec2, std::size_t)
+            {
+                BOOST_REQUIRE(!ec2);
+                client->close();
+            });
+        });
+    });
+    ios.run();
+    BOOST_CHECK_MESSAGE(!read_error,"read failed: " << read_error.message());
+    BOOST_CHECK_MESSAGE(read_size == sent.size() && received == sent,"wrong data received");
+    BOOST_CHECK_MESSAGE(answer == '!',"wrong answer");
+    BOOST_CHECK_MESSAGE(eof_error == boost::asio::error::eof,"expected end of stream, got " << eof_error.message());
+}
+
+BOOST_AUTO_TEST_CASE( test_shm_stream_round_trips )
+{
+    boost::asio::io_service ios;
+    // tcp over loopback
+    boost::asio::ip::tcp::acceptor tcp_acceptor(ios,boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(),0));
+    boost::asio::ip::tcp::socket tcp_client(ios);
+    boost::asio::ip::tcp::socket tcp_server(ios);
+    tcp_client.connect(tcp_acceptor.local_endpoint());
+    tcp_acceptor.accept(tcp_server);
+    tcp_client.set_option(boost::asio::ip::tcp::no_delay(true));
+    tcp_server.set_option(boost::asio::ip::tcp::no_delay(true));
+    double tcp = round_trips(tcp_client,tcp_server,ios);
+
+    // shared memory
+    std::string name = boost::asynchronous::tcp::detail::shm_endpoint_name("test_shm_stream_round_trips",std::to_string(::getpid()));
+    boost::asio::local::stream_protocol::acceptor shm_acceptor(ios,boost::asio::local::stream_protocol::endpoint(name));
+    auto shm_server = std::make_shared<boost::asynchronous::tcp::detail::shm_stream>(ios);
+    auto shm_client = std::make_shared<boost::asynchronous::tcp::detail::shm_stream>(ios);
+    shm_acceptor.async_accept(shm_server->control_socket(),[&](boost::system::error_code ec)
+    {
+        BOOST_REQUIRE(!ec);
+        shm_server->async_handshake([](boost::system::error_code ec1){BOOST_REQUIRE(!ec1);});
+    });
+    shm_client->async_connect(name,[](boost::system::error_code ec){BOOST_REQUIRE(!ec);});
+    // until both are open, the streams then watch each other and keep the io_service busy
+    ios.restart();
+    while (!shm_server->is_open() || !shm_client->is_open())
+    {
+        ios.run_one();
+    }
+    double shm = round_trips(*shm_client,*shm_server,ios);
+    shm_client->close();
+    shm_server->close();
+    ios.restart();
+    ios.run();
+    std::cout << "round trips of 100 bytes, tcp: " << tcp << "/s, shared memory: " << shm << "/s" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE( test_tcp_shm_transport )
+{
+    auto workers = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::threadpool_scheduler<boost::asynchronous::lockfree_queue<>>>(1);
+    auto tcp_server = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::tcp_server_scheduler<
+                            boost::asynchronous::lockfree_queue<boost::asynchronous::any_serializable>>>
+                                (workers,"127.0.0.1",12363);
+    double tcp = 0;
+    double shm = 0;
+    {
+        auto client = make_client<boost::asynchronous::tcp::tcp_transport>("12363");
+        tcp = run_jobs(tcp_server);
+    }
+    {
+        auto client = make_client<boost::asynchronous::tcp::shm_transport>("12363");
+        shm = run_jobs(tcp_server);
+    }
+    std::cout << "tcp: " << tcp << " jobs/s, shared memory: " << shm << " jobs/s" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE( test_tcp_shm_transport_stealing )
+{
+    auto workers = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::threadpool_scheduler<boost::asynchronous::lockfree_queue<>>>(1);
+    auto pool = boost::asynchronous::make_shared_scheduler_proxy<
+                    boost::asynchronous::threadpool_scheduler<
+                        boost::asynchronous::lockfree_queue<boost::asynchronous::any_serializable>>>(1);
+    auto tcp_server = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::tcp_server_scheduler<
+                            boost::asynchronous::lockfree_queue<boost::asynchronous::any_serializable>,
+                            boost::asynchronous::any_callable,true>>
+                                (workers,"127.0.0.1",12364);
+    // the tcp server steals from the pool for its clients
+    auto composite = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::composite_threadpool_scheduler<boost::asynchronous::any_serializable>>(pool,tcp_server);
+    auto client = make_client<boost::asynchronous::tcp::shm_transport>("12364");
+    run_jobs(pool);
+}
+#else
+BOOST_AUTO_TEST_CASE( test_tcp_shm_transport )
+{
+    BOOST_TEST_MESSAGE("no shared memory transport on this platform");
+}
+#endif
@@ -0,0 +1,219 @@
+// Boost.Asynchronous library
+//  Copyright (C) Christophe Henry 2017
+//
+//  Use, modification and distribution is subject to the Boost
+//  Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// For more information, see http://www.boost.org
+
+// Wire protocols of the tcp server and client: encoding / decoding of both versions, then a server
+// executing jobs on a version 1 and a version 2 client, printing the jobs/s of each.
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <future>
+#include <numeric>
+#include <chrono>
+#include <sstream>
+
+#include <boost/serialization/vector.hpp>
+
+#include <boost/asynchronous/scheduler/tcp/detail/wire_protocol.hpp>
+#include <boost/asynchronous/scheduler/tcp/tcp_server_scheduler.hpp>
+#include <boost/asynchronous/scheduler/tcp/simple_tcp_client.hpp>
+#include <boost/asynchronous/scheduler/serializable_task.hpp>
+#include <boost/asynchronous/extensions/asio/asio_scheduler.hpp>
+#include <boost/asynchronous/scheduler/threadpool_scheduler.hpp>
+#include <boost/asynchronous/queue/lockfree_queue.hpp>
+#include <boost/asynchronous/scheduler_shared_proxy.hpp>
+#include <boost/asynchronous/any_serializable.hpp>
+#include <boost/asynchronous/post.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+#define JOB_COUNT 500
+#define JOB_SIZE 10
+#define MESSAGE_COUNT 2000
+#define MESSAGE_SIZE 100000
+
+struct sum_task : public boost::asynchronous::serializable_task
+{
+    sum_task(std::vector<int> data = std::vector<int>())
+        : boost::asynchronous::serializable_task("sum_task"), m_data(std::move(data)){}
+    template <class Archive>
+    void serialize(Archive & ar, const unsigned int /*version*/)
+    {
+        ar & m_data;
+    }
+    long operator()()const
+    {
+        return std::accumulate(m_data.begin(),m_data.end(),0L);
+    }
+    std::vector<int> m_data;
+};
+
+template <class Protocol>
+void check_roundtrip()
+{
+    typedef boost::asynchronous::any_serializable serializable;
+    std::vector<char> buffer;
+    // server => client
+    boost::asynchronous::tcp::server_reponse response(42,"serialized task","sum_task");
+    BOOST_REQUIRE(Protocol::template encode_response<serializable>(buffer,response));
+    std::size_t size = 0;
+    BOOST_REQUIRE(Protocol::body_size(buffer.data(),size));
+    BOOST_CHECK_MESSAGE(size + Protocol::header_length == buffer.size(),"wrong body size " << size);
+    auto decoded = Protocol::template decode_response<serializable>(buffer.data(),buffer.data() + Protocol::header_length,size);
+    BOOST_CHECK_MESSAGE(decoded.m_task_id == 42,"wrong task id " << decoded.m_task_id);
+    BOOST_CHECK_MESSAGE(decoded.m_task == "serialized task","wrong task " << decoded.m_task);
+    BOOST_CHECK_MESSAGE(decoded.m_task_name == "sum_task","wrong task name " << decoded.m_task_name);
+
+    // client => server, the send buffer is reused
+    boost::asynchronous::tcp::client_request request(BOOST_ASYNCHRONOUS_TCP_CLIENT_JOB_RESULT,"result");
+    request.m_task_id = 43;
+    buffer.clear();
+    BOOST_REQUIRE(Protocol::template encode_request<serializable>(buffer,request));
+    char const* data = buffer.data();
+    buffer.clear();
+    BOOST_REQUIRE(Protocol::template encode_request<serializable>(buffer,request));
+    BOOST_CHECK_MESSAGE(buffer.data() == data,"send buffer should be reused");
+    BOOST_REQUIRE(Protocol::body_size(buffer.data(),size));
+    auto decoded_request = Protocol::template decode_request<serializable>(buffer.data(),buffer.data() + Protocol::header_length,size);
+    BOOST_CHECK(decoded_request.m_cmd_id == BOOST_ASYNCHRONOUS_TCP_CLIENT_JOB_RESULT);
+    BOOST_CHECK_MESSAGE(decoded_request.m_task_id == 43,"wrong task id " << decoded_request.m_task_id);
+    // version 2 leaves the payload archived for the job
+    boost::asynchronous::tcp::client_request::message_payload payload = decoded_request.m_load;
+    if (!decoded_request.m_archived_load.empty())
+    {
+        boost::asynchronous::tcp::detail::input_buffer_view view(decoded_request.m_archived_load.data(),
+                                                                 decoded_request.m_archived_load.size());
+        std::istream archive_stream(&view);
+        serializable::iarchive archive(archive_stream);
+        archive >> payload;
+    }
+    BOOST_CHECK_MESSAGE(payload.m_data == "result","wrong payload " << payload.m_data);
+    BOOST_CHECK(!payload.m_has_exception);
+}
+
+// encoded and decoded messages (a task and its result) per second
+template <class Protocol>
+double messages_per_second(std::string const& task)
+{
+    typedef boost::asynchronous::any_serializable serializable;
+    std::vector<char> send_buffer;
+    boost::asynchronous::tcp::server_reponse response(1,task,"sum_task");
+    boost::asynchronous::tcp::client_request request(BOOST_ASYNCHRONOUS_TCP_CLIENT_JOB_RESULT,"4999950000");
+    std::size_t total = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < MESSAGE_COUNT; ++i)
+    {
+        std::size_t size = 0;
+        send_buffer.clear();
+        Protocol::template encode_response<serializable>(send_buffer,response);
+        Protocol::body_size(send_buffer.data(),size);
+        total += Protocol::template decode_response<serializable>(send_buffer.data(),send_buffer.data() + Protocol::header_length,size).m_task.size();
+        send_buffer.clear();
+        Protocol::template encode_request<serializable>(send_buffer,request);
+        Protocol::body_size(send_buffer.data(),size);
+        total += Protocol::template decode_request<serializable>(send_buffer.data(),send_buffer.data() + Protocol::header_length,size).m_task_id;
+    }
+    double elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - start).count() / 1000000.0;
+    BOOST_CHECK_MESSAGE(total == task.size() * MESSAGE_COUNT,"wrong decoded data");
+    return MESSAGE_COUNT / elapsed;
+}
+
+template <class Protocol>
+double run_client(boost::asynchronous::any_shared_scheduler_proxy<boost::asynchronous::any_serializable> tcp_server,
+                  std::string const& port)
+{
+    std::function<void(std::string const&,boost::asynchronous::tcp::server_reponse,
+                       std::function<void(boost::asynchronous::tcp::client_request const&)>)> executor=
+    [](std::string const& task_name,boost::asynchronous::tcp::server_reponse resp,
+       std::function<void(boost::asynchronous::tcp::client_request const&)> when_done)
+    {
+        if (task_name=="sum_task")
+        {
+            sum_task t;
+            boost::asynchronous::tcp::deserialize_and_call_task(t,resp,when_done);
+        }
+    };
+    auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<boost::asynchronous::asio_scheduler<>>();
+    auto pool = boost::asynchronous::make_shared_scheduler_proxy<
+                    boost::asynchronous::threadpool_scheduler<
+                        boost::asynchronous::lockfree_queue<boost::asynchronous::any_serializable>>>(1);
+    boost::asynchronous::tcp::simple_tcp_client_proxy_ext<
+            boost::asynchronous::tcp::client_time_check_policy<boost::asynchronous::any_serializable>,
+            boost::asynchronous::any_serializable,Protocol>
+            client(scheduler,pool,"127.0.0.1",port,executor,0/*ms between calls to server*/);
+    client.run();
+
+    std::vector<int> data(JOB_SIZE);
+    std::iota(data.begin(),data.end(),0);
+    long expected = std::accumulate(data.begin(),data.end(),0L);
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::future<long>> fus;
+    fus.reserve(JOB_COUNT);
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        fus.push_back(boost::asynchronous::post_future(tcp_server,sum_task(data)));
+    }
+    bool ok = true;
+    for (auto& fu : fus)
+    {
+        ok = ok && (fu.get() == expected);
+    }
+    double elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - start).count() / 1000000.0;
+    BOOST_CHECK_MESSAGE(ok,"wrong results with protocol version " << Protocol::version);
+    return JOB_COUNT / elapsed;
+}
+}
+
+BOOST_AUTO_TEST_CASE( test_tcp_wire_protocol_v1_roundtrip )
+{
+    check_roundtrip<boost::asynchronous::tcp::detail::wire_protocol_v1>();
+}
+
+BOOST_AUTO_TEST_CASE( test_tcp_wire_protocol_v2_roundtrip )
+{
+    check_roundtrip<boost::asynchronous::tcp::detail::wire_protocol_v2>();
+    // not to be mistaken for a version 1 header
+    char v1_header[] = "       1f0";
+    BOOST_CHECK(!boost::asynchronous::tcp::detail::wire_protocol_v2::is_header(v1_header));
+}
+
+BOOST_AUTO_TEST_CASE( test_tcp_wire_protocol_throughput )
+{
+    // a task as serialized by the server
+    std::vector<int> data(MESSAGE_SIZE);
+    std::iota(data.begin(),data.end(),0);
+    std::ostringstream archive_stream;
+    {
+        boost::asynchronous::any_serializable::oarchive archive(archive_stream);
+        archive << data;
+    }
+    std::string task = archive_stream.str();
+    double v1 = messages_per_second<boost::asynchronous::tcp::detail::wire_protocol_v1>(task);
+    double v2 = messages_per_second<boost::asynchronous::tcp::detail::wire_protocol_v2>(task);
+    std::cout << "task of " << task.size() << " bytes, protocol version 1: " << v1
+              << " messages/s, version 2: " << v2 << " messages/s" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE( test_tcp_wire_protocol_server )
+{
+    auto workers = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::threadpool_scheduler<boost::asynchronous::lockfree_queue<>>>(1);
+    auto tcp_server = boost::asynchronous::make_shared_scheduler_proxy<
+                        boost::asynchronous::tcp_server_scheduler<
+                            boost::asynchronous::lockfree_queue<boost::asynchronous::any_serializable>>>
+                                (workers,"127.0.0.1",12360);
+    // the same server serves clients of both versions
+    double v1 = run_client<boost::asynchronous::tcp::detail::wire_protocol_v1>(tcp_server,"12360");
+    double v2 = run_client<boost::asynchronous::tcp::detail::wire_protocol_v2>(tcp_server,"12360");
+    std::cout << "protocol version 1: " << v1 << " jobs/s, version 2: " << v2 << " jobs/s" << std::endl;
+}
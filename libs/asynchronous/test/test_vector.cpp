@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <vector>
 #include <atomic>
+#include <string>
 
 #include <boost/thread.hpp>
 
@@ -548,7 +549,7 @@ BOOST_AUTO_TEST_CASE( test_vector_push_back_realloc )
         }
         BOOST_CHECK_MESSAGE(v[10].data == 10,"vector[10] should have value 10.");
         BOOST_CHECK_MESSAGE(v.size()==11,"vector size should be 11.");
-        BOOST_CHECK_MESSAGE(v.capacity()== 30,"vector capacity should be 30.");
+        BOOST_CHECK_MESSAGE(v.capacity()== 20,"vector capacity should be 20.");
     }
     // vector is destroyed, check we got one dtor for each ctor
     BOOST_CHECK_MESSAGE(ctor_count.load()==dtor_count.load(),"wrong number of ctors/dtors called.");
@@ -579,7 +580,7 @@ BOOST_AUTO_TEST_CASE( test_vector_push_back_realloc_std )
         }
         BOOST_CHECK_MESSAGE(v[10].data == 10,"vector[10] should have value 10.");
         BOOST_CHECK_MESSAGE(v.size()==11,"vector size should be 11.");
-        BOOST_CHECK_MESSAGE(v.capacity()== 30,"vector capacity should be 30.");
+        BOOST_CHECK_MESSAGE(v.capacity()== 20,"vector capacity should be 20.");
     }
     // vector is destroyed, check we got one dtor for each ctor
     BOOST_CHECK_MESSAGE(ctor_count.load()==dtor_count.load(),"wrong number of ctors/dtors called.");
@@ -1409,3 +1410,80 @@ BOOST_AUTO_TEST_CASE( test_vector_emplace_std)
     // vector is destroyed, check we got one dtor for each ctor
     BOOST_CHECK_MESSAGE(ctor_count.load()==dtor_count.load(),"wrong number of ctors/dtors called.");
 }
+
+BOOST_AUTO_TEST_CASE( test_vector_push_back_growth )
+{
+    {
+        auto scheduler = boost::asynchronous::make_shared_scheduler_proxy<boost::asynchronous::multiqueue_threadpool_scheduler<
+                                                                            boost::asynchronous::lockfree_queue<>>>(8);
+
+        // reallocations below the cutoff are done sequentially, above in the pool
+        boost::asynchronous::vector<some_type> v(scheduler, 100 /* cutoff */);
+        std::size_t reallocations = 0;
+        for (auto i = 0; i < 10000; ++i)
+        {
+            auto capacity = v.capacity();
+            v.push_back(some_type(i));
+            if (v.capacity() != capacity)
+            {
+                ++reallocations;
+                BOOST_CHECK_MESSAGE(v.capacity() == 2 * capacity,"vector capacity should double.");
+            }
+        }
+        BOOST_CHECK_MESSAGE(reallocations == 10,"vector should have reallocated 10 times.");
+        BOOST_CHECK_MESSAGE(v.size()==10000,"vector size should be 10000.");
+        bool ok = true;
+        for (auto i = 0; i < 10000; ++i)
+        {
+            ok = ok && (v[i].data == i);
+        }
+        BOOST_CHECK_MESSAGE(ok,"vector[i] should have value i.");
+    }
+    // vector is destroyed, check we got one dtor for each ctor
+    BOOST_CHECK_MESSAGE(ctor_count.load()==dtor_count.load(),"wrong number of ctors/dtors called.");
+}
+
+BOOST_AUTO_TEST_CASE( test_vector_push_back_self_realloc )
+{
+    {
+        boost::asynchronous::vector<some_type> v;
+        for (auto i = 0; i < 10; ++i)
+        {
+            v.push_back(some_type(i));
+        }
+        // the pushed element belongs to the vector which is about to reallocate
+        v.push_back(v[3]);
+        v.emplace_back(v[4]);
+        BOOST_CHECK_MESSAGE(v.size()==12,"vector size should be 12.");
+        BOOST_CHECK_MESSAGE(v[10].data == 3,"vector[10] should have value 3.");
+        BOOST_CHECK_MESSAGE(v[11].data == 4,"vector[11] should have value 4.");
+    }
+    // vector is destroyed, check we got one dtor for each ctor
+    BOOST_CHECK_MESSAGE(ctor_count.load()==dtor_count.load(),"wrong number of ctors/dtors called.");
+}
+
+BOOST_AUTO_TEST_CASE( test_vector_emplace_back_args )
+{
+    boost::asynchronous::vector<std::pair<int,std::string>> v;
+    for (auto i = 0; i < 20; ++i)
+    {
+        v.emplace_back(i,"value");
+    }
+    BOOST_CHECK_MESSAGE(v.size()==20,"vector size should be 20.");
+    BOOST_CHECK_MESSAGE(v[15].first == 15 && v[15].second == "value","vector[15] should have value (15,value).");
+}
+
+BOOST_AUTO_TEST_CASE( test_vector_push_back_moved_from )
+{
+    {
+        boost::asynchronous::vector<some_type> v1;
+        v1.push_back(some_type(1));
+        boost::asynchronous::vector<some_type> v2(std::move(v1));
+        // a moved-from vector has no memory but can be reused
+        v1.push_back(some_type(2));
+        BOOST_CHECK_MESSAGE(v1.size()==1 && v1[0].data == 2,"moved-from vector should accept new elements.");
+        BOOST_CHECK_MESSAGE(v2.size()==1 && v2[0].data == 1,"vector[0] should have value 1.");
+    }
+    // vector is destroyed, check we got one dtor for each ctor
+    BOOST_CHECK_MESSAGE(ctor_count.load()==dtor_count.load(),"wrong number of ctors/dtors called.");
+}